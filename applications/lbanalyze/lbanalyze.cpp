@@ -51,6 +51,7 @@ void showHelp()
     cout << "                       LightTools/Zemax BSDF (\".bsdf\")" << endl;
     cout << "                       ASTM E1392-96(2002) (\".astm\")" << endl;
     cout << "                       MERL binary Files (\".binary\")" << endl;
+    cout << "                       libbsdf binary (\".lbb\")" << endl;
     cout << endl;
     cout << "Options:" << endl;
     cout << "  -h, --help       show this help message and exit" << endl;
@@ -6,12 +6,17 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
 // =================================================================== //
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <libbsdf/Brdf/Processor.h>
 
-#include <libbsdf/Reader/DdrReader.h>
 #include <libbsdf/Reader/ReaderUtility.h>
 
 #include <libbsdf/Writer/DdrWriter.h>
@@ -26,7 +31,7 @@ using namespace lb;
  */
 
 const std::string APP_NAME("lbaverage");
-const std::string APP_VERSION("1.0.0");
+const std::string APP_VERSION("1.0.1");
 
 void showHelp()
 {
@@ -77,7 +82,7 @@ int main(int argc, char** argv)
 
     const std::string& inFileName1 = fileNames.at(0);
 
-    // Set and validate the file type of the first input file.
+    // Set and validate the file types of input files.
     FileType inFileType = reader_utility::classifyFile(inFileName1);
     if (inFileType != INTEGRA_DDR_FILE &&
         inFileType != INTEGRA_DDT_FILE) {
@@ -85,46 +90,56 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    // Load the first input BRDF/BTDF file.
-    std::unique_ptr<SpecularCoordinatesBrdf> inBrdf1(DdrReader::read(inFileName1));
-    if (!inBrdf1) {
-        std::cerr << "Failed to load: " << inFileName1 << std::endl;
-        return 1;
-    }
-
-    // Create an output BRDF with the same angle attributes as in_file1;
-    std::unique_ptr<SpecularCoordinatesBrdf> outBrdf(inBrdf1->clone());
-
-    Spectrum::Scalar avgCoeff = Spectrum::Scalar(1) / numInputFiles;
-
-    // Set a scaled BRDF to compute the average of spectra.
-    multiplySpectra(outBrdf->getSampleSet(), avgCoeff);
-
-    // Read input files and compute averaged spectra.
-    for (size_t i = 1; i < numInputFiles; ++i) {
-        const std::string& fileName = fileNames.at(i);
-
-        // Validate a file type.
-        if (inFileType != reader_utility::classifyFile(fileName)) {
-            std::cerr << "Input file types do not match: " << fileName << std::endl;
+    for (int i = 1; i < numInputFiles; ++i) {
+        if (inFileType != reader_utility::classifyFile(fileNames.at(i))) {
+            std::cerr << "Input file types do not match: " << fileNames.at(i) << std::endl;
             return 1;
         }
+    }
 
-        // Load an input BRDF/BTDF file.
-        std::unique_ptr<SpecularCoordinatesBrdf> inBrdf(DdrReader::read(fileName));
-        if (!inBrdf) {
-            std::cerr << "Failed to load: " << fileName << std::endl;
-            return 1;
-        }
+    std::unique_ptr<SpecularCoordinatesBrdf> outBrdf;
 
-        // Copy previously processed BRDF.
-        std::unique_ptr<SpecularCoordinatesBrdf> prevOutBrdf(outBrdf->clone());
+    Spectrum::Scalar avgCoeff = Spectrum::Scalar(1) / numInputFiles;
 
-        // Add a scaled BRDF to compute the average of spectra.
-        auto add = [avgCoeff](const Spectrum& sp1, const Spectrum& sp2) { return sp1 + sp2 * avgCoeff; };
-        if (!compute(*prevOutBrdf, *inBrdf, outBrdf.get(), add)) {
-            std::cerr << "Failed to process: " << fileName << std::endl;
-            return 1;
+    // Input files are loaded concurrently in batches to bound memory usage.
+    // Spectra are accumulated in the order of input files.
+#ifdef _OPENMP
+    const int batchSize = std::max(omp_get_max_threads(), 1);
+#else
+    const int batchSize = 1;
+#endif
+    for (int batchBegin = 0; batchBegin < numInputFiles; batchBegin += batchSize) {
+        int batchEnd = std::min(batchBegin + batchSize, numInputFiles);
+        std::vector<std::string> batchFileNames(fileNames.begin() + batchBegin, fileNames.begin() + batchEnd);
+        std::vector<reader_utility::ReadResult> results = reader_utility::readAll(batchFileNames);
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            const std::string& fileName = batchFileNames.at(i);
+
+            auto inBrdf = std::dynamic_pointer_cast<SpecularCoordinatesBrdf>(results.at(i).brdf);
+            if (!inBrdf) {
+                std::cerr << results.at(i).errorMessage << std::endl;
+                return 1;
+            }
+
+            if (!outBrdf) {
+                // Create an output BRDF with the same angle attributes as in_file1;
+                outBrdf.reset(inBrdf->clone());
+
+                // Set a scaled BRDF to compute the average of spectra.
+                multiplySpectra(outBrdf->getSampleSet(), avgCoeff);
+                continue;
+            }
+
+            // Copy previously processed BRDF.
+            std::unique_ptr<SpecularCoordinatesBrdf> prevOutBrdf(outBrdf->clone());
+
+            // Add a scaled BRDF to compute the average of spectra.
+            auto add = [avgCoeff](const Spectrum& sp1, const Spectrum& sp2) { return sp1 + sp2 * avgCoeff; };
+            if (!compute(*prevOutBrdf, *inBrdf, outBrdf.get(), add)) {
+                std::cerr << "Failed to process: " << fileName << std::endl;
+                return 1;
+            }
         }
     }
 
@@ -8,10 +8,11 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include <libbsdf/Brdf/Processor.h>
+#include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
 
-#include <libbsdf/Reader/DdrReader.h>
 #include <libbsdf/Reader/ReaderUtility.h>
 
 #include <libbsdf/Writer/DdrWriter.h>
@@ -26,7 +27,7 @@ using namespace lb;
  */
 
 const std::string APP_NAME("lbcompare");
-const std::string APP_VERSION("1.0.0");
+const std::string APP_VERSION("1.0.1");
 
 void showHelp()
 {
@@ -85,19 +86,20 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    // Load BRDF/BTDF files.
-    std::unique_ptr<SpecularCoordinatesBrdf> inBrdf1(DdrReader::read(inFileName1));
-    std::unique_ptr<SpecularCoordinatesBrdf> inBrdf2(DdrReader::read(inFileName2));
+    // Load BRDF/BTDF files concurrently.
+    std::vector<std::string> inFileNames = { inFileName1, inFileName2 };
+    std::vector<reader_utility::ReadResult> results = reader_utility::readAll(inFileNames);
 
-    if (!inBrdf1) {
-        std::cerr << "Failed to load: " << inFileName1 << std::endl;
-        return 1;
-    }
-    else if (!inBrdf2) {
-        std::cerr << "Failed to load: " << inFileName2 << std::endl;
-        return 1;
+    for (auto it = results.begin(); it != results.end(); ++it) {
+        if (!it->brdf) {
+            std::cerr << it->errorMessage << std::endl;
+            return 1;
+        }
     }
 
+    auto inBrdf1 = std::dynamic_pointer_cast<SpecularCoordinatesBrdf>(results.at(0).brdf);
+    auto inBrdf2 = std::dynamic_pointer_cast<SpecularCoordinatesBrdf>(results.at(1).brdf);
+
     // Validate color models.
     if (!hasSameColor(*inBrdf1->getSampleSet(), *inBrdf2->getSampleSet())) {
         std::cerr << "Color models or wavelengths do not match." << std::endl;
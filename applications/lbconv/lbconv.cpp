@@ -9,10 +9,16 @@
 #include <iostream>
 #include <memory>
 
+#include <libbsdf/Brdf/Processor.h>
+
 #include <libbsdf/Reader/AstmReader.h>
+#include <libbsdf/Reader/BinaryReader.h>
 #include <libbsdf/Reader/DdrReader.h>
+#include <libbsdf/Reader/DdrSlabReader.h>
 #include <libbsdf/Reader/ZemaxBsdfReader.h>
 
+#include <libbsdf/Writer/BinarySlabWriter.h>
+#include <libbsdf/Writer/BinaryWriter.h>
 #include <libbsdf/Writer/DdrWriter.h>
 
 #include <ArgumentParser.h>
@@ -25,11 +31,17 @@ using namespace lb;
  */
 
 const std::string APP_NAME("lbconv");
-const std::string APP_VERSION("1.0.1");
+const std::string APP_VERSION("1.1.0");
 
 // Paramters
 DataType dataType = BRDF_DATA;
 bool arranged = false;
+bool compressed = false;
+bool streaming = false;
+bool cosineDivided = false;
+bool negativeFixed = false;
+bool srgbConverted = false;
+float multiplier = 1.0f;
 
 void showHelp()
 {
@@ -46,8 +58,10 @@ void showHelp()
     cout << "                   Integra Diffuse Distribution (\".ddr, .ddt\")" << endl;
     cout << "                   Zemax BSDF (\".bsdf\")" << endl;
     cout << "                   ASTM E1392-96(2002) (\".astm\")" << endl;
+    cout << "                   libbsdf binary (\".lbb\")" << endl;
     cout << "  out_file     Name of an output BRDF/BTDF file." << endl;
     cout << "               \".ddr\" for BRDF or \".ddt\" for BTDF is acceptable as a suffix." << endl;
+    cout << "               If the suffix is \".lbb\", a libbsdf binary file is saved." << endl;
     cout << "               If an appropriate suffix is not obtained, \".ddr\" or \".ddt\" is appended." << endl;
     cout << endl;
     cout << "Options:" << endl;
@@ -55,6 +69,14 @@ void showHelp()
     cout << "  -v, --version    show program's version number and exit" << endl;
     cout << "  -scatterType     set either BRDF or BTDF for the input ASTM file (default: BRDF)" << endl;
     cout << "  -arrangement     arrange BRDF/BTDF with extrapolation and conservation of energy" << endl;
+    cout << "  -compression     compress spectra of the output libbsdf binary file" << endl;
+    cout << "  -streaming       convert a DDR/DDT file to a libbsdf binary file for each incoming direction" << endl;
+    cout << "                   with bounded memory" << endl;
+    cout << "  -divideByCosine  divide spectra by the cosine of the outgoing polar angle" << endl;
+    cout << "  -fixNegative     replace negative values of spectra with zeros" << endl;
+    cout << "  -multiply        multiply spectra by a value (default: 1.0)" << endl;
+    cout << "  -xyzToSrgb       convert spectra from CIE-XYZ to sRGB" << endl;
+    cout << "                   Processing options are applied in the order listed above." << endl;
 }
 
 bool readOptions(ArgumentParser* ap)
@@ -77,6 +99,113 @@ bool readOptions(ArgumentParser* ap)
         arranged = true;
     }
 
+    if (ap->read("-compression")) {
+        compressed = true;
+    }
+
+    if (ap->read("-streaming")) {
+        streaming = true;
+    }
+
+    if (ap->read("-divideByCosine")) {
+        cosineDivided = true;
+    }
+
+    if (ap->read("-fixNegative")) {
+        negativeFixed = true;
+    }
+
+    if (ap->read("-multiply", &multiplier) == ArgumentParser::ERROR) {
+        return false;
+    }
+
+    if (ap->read("-xyzToSrgb")) {
+        srgbConverted = true;
+    }
+
+    return true;
+}
+
+/*
+ * Applies processing options to a BRDF/BTDF or a slab of it.
+ * The processors only modify the samples of each incoming direction, so a BRDF/BTDF processed
+ * for each slab is equal to the one processed at once.
+ */
+bool process(Brdf* brdf)
+{
+    SampleSet* ss = brdf->getSampleSet();
+
+    if (srgbConverted && ss->getColorModel() != XYZ_MODEL) {
+        std::cerr << "-xyzToSrgb requires CIE-XYZ spectra." << std::endl;
+        return false;
+    }
+
+    if (cosineDivided) {
+        divideByCosineOutTheta(brdf);
+    }
+
+    if (negativeFixed) {
+        fixNegativeSpectra(brdf);
+    }
+
+    if (multiplier != 1.0f) {
+        multiplySpectra(ss, multiplier);
+    }
+
+    if (srgbConverted) {
+        xyzToSrgb(ss);
+    }
+
+    return true;
+}
+
+/*
+ * Converts a DDR/DDT file to a libbsdf binary file for each incoming direction.
+ */
+bool convertSlabs(const std::string& inFileName, const std::string& outFileName, FileType inFileType)
+{
+    DdrSlabReader reader;
+    if (!reader.open(inFileName)) {
+        std::cerr << "Failed to load: " << inFileName << std::endl;
+        return false;
+    }
+
+    FileInfo info = reader.getInfo();
+    info.dataType = (inFileType == INTEGRA_DDT_FILE) ? BTDF_DATA : BRDF_DATA;
+
+    // The header is written before slabs are processed.
+    if (srgbConverted) {
+        if (info.colorModel != XYZ_MODEL) {
+            std::cerr << "-xyzToSrgb requires CIE-XYZ spectra." << std::endl;
+            return false;
+        }
+
+        info.colorModel = RGB_MODEL;
+    }
+
+    binary_utility::EncodingType encoding = compressed ? binary_utility::PREDICTIVE_ENCODING
+                                                       : binary_utility::RAW_ENCODING;
+    BinarySlabWriter writer;
+    if (!writer.open(outFileName, info, encoding)) return false;
+
+    // Slabs are written in the order of lb::SampleSet::getIndex().
+    for (int inPhIndex = 0; inPhIndex < reader.getNumInPhi();   ++inPhIndex) {
+    for (int inThIndex = 0; inThIndex < reader.getNumInTheta(); ++inThIndex) {
+        std::unique_ptr<SpecularCoordinatesBrdf> slab(reader.readSlab(inThIndex, inPhIndex));
+        if (!slab) {
+            std::cerr << "Failed to load: " << inFileName << std::endl;
+            return false;
+        }
+
+        // Slabs are processed without conversion since they are already in the specular coordinate system.
+        if (!process(slab.get())) return false;
+
+        if (!writer.writeSlab(*slab)) return false;
+    }}
+
+    if (!writer.close()) return false;
+
+    std::cout << "Saved: " << outFileName << std::endl;
     return true;
 }
 
@@ -105,6 +234,26 @@ int main(int argc, char** argv)
 
     // Load a BRDF/BTDF file.
     FileType inFileType = reader_utility::classifyFile(inFileName);
+
+    if (streaming) {
+        if (inFileType != INTEGRA_DDR_FILE && inFileType != INTEGRA_DDT_FILE) {
+            std::cerr << "Unsupported file type for streaming: " << inFileType << std::endl;
+            return 1;
+        }
+
+        if (!reader_utility::hasSuffix(reader_utility::toLower(outFileName), ".lbb")) {
+            std::cerr << "The output file of streaming must be a libbsdf binary file: " << outFileName << std::endl;
+            return 1;
+        }
+
+        if (arranged) {
+            std::cerr << "-arrangement cannot be used with -streaming." << std::endl;
+            return 1;
+        }
+
+        return convertSlabs(inFileName, outFileName, inFileType) ? 0 : 1;
+    }
+
     std::unique_ptr<Brdf> inBrdf;
     switch (inFileType) {
         case ASTM_FILE:
@@ -121,6 +270,14 @@ int main(int argc, char** argv)
         case lb::ZEMAX_FILE:
             inBrdf.reset(ZemaxBsdfReader::read(inFileName, &dataType));
             break;
+        case lb::LIBBSDF_BINARY_FILE: {
+            DataType binaryDataType;
+            inBrdf.reset(BinaryReader::read(inFileName, &binaryDataType));
+            if (binaryDataType != UNKNOWN_DATA) {
+                dataType = binaryDataType;
+            }
+            break;
+        }
         default:
             std::cerr << "Unsupported file type: " << inFileType << std::endl;
             return 1;
@@ -133,10 +290,23 @@ int main(int argc, char** argv)
 
     // Convert the BRDF/BTDF.
     std::unique_ptr<SpecularCoordinatesBrdf> outBrdf(DdrWriter::convert(*inBrdf));
+    if (!process(outBrdf.get())) return 1;
+
     if (arranged) {
         outBrdf.reset(DdrWriter::arrange(*outBrdf, dataType));
     }
 
+    // Save a libbsdf binary file.
+    if (reader_utility::hasSuffix(reader_utility::toLower(outFileName), ".lbb")) {
+        binary_utility::EncodingType encoding = compressed ? binary_utility::PREDICTIVE_ENCODING
+                                                           : binary_utility::RAW_ENCODING;
+        if (BinaryWriter::write(outFileName, *outBrdf, dataType, encoding)) {
+            std::cout << "Saved: " << outFileName << std::endl;
+        }
+
+        return 0;
+    }
+
     // Fix the output filename.
     if (dataType == BRDF_DATA && !reader_utility::hasSuffix(outFileName, ".ddr")) {
         outFileName += ".ddr";
@@ -30,7 +30,7 @@ using namespace lb;
  */
 
 const std::string APP_NAME("lbgen");
-const std::string APP_VERSION("1.0.10");
+const std::string APP_VERSION("1.1.0");
 
 const std::string GgxName                       = "ggx";
 const std::string MultipleScatteringSmithName   = "multiple-scattering-smith";
@@ -45,6 +45,8 @@ float roughness = 0.3f;
 float n = 1.5f;
 float k = 0.0f;
 int numIterations = 10;
+float targetError = 0.0f;
+int maxNumIterations = 1000;
 
 void showHelp()
 {
@@ -88,9 +90,11 @@ void showList()
     cout << "          -k          set extinction coefficient (default: 0.0)" << endl;
     cout << "  " << MultipleScatteringSmithName << endl;
     cout << "      Valid options:" << endl;
-    cout << "          -roughness      set roughness of surface (default: 0.3, range: [0.01, 1.0])" << endl;
-    cout << "          -n              set refractive index (default: 1.5)" << endl;
-    cout << "          -numIterations  set the number of sampling iterations (default: 10)" << endl;
+    cout << "          -roughness         set roughness of surface (default: 0.3, range: [0.01, 1.0])" << endl;
+    cout << "          -n                 set refractive index (default: 1.5)" << endl;
+    cout << "          -numIterations     set the number of sampling iterations (default: 10)" << endl;
+    cout << "          -targetError       set the target relative standard error of adaptive iterations (default: 0.0, disabled)" << endl;
+    cout << "          -maxNumIterations  set the maximum number of adaptive iterations (default: 1000)" << endl;
     cout << "  " << LambertianName << endl;
     cout << "      Valid options: none" << endl;
 }
@@ -172,6 +176,21 @@ bool readOptions(ArgumentParser* ap)
         numIterations = app_utility::clampParameter("numIterations", numIterations, 1, 10000);
     }
 
+    if (ap->read("-targetError", &targetError) == ArgumentParser::ERROR) {
+        return false;
+    }
+    else if (targetError < 0.0f) {
+        std::cerr << "Invalid value (targetError): " << targetError << std::endl;
+        return false;
+    }
+
+    if (ap->read("-maxNumIterations", &maxNumIterations) == ArgumentParser::ERROR) {
+        return false;
+    }
+    else {
+        maxNumIterations = app_utility::clampParameter("maxNumIterations", maxNumIterations, 1, 100000);
+    }
+
     return true;
 }
 
@@ -247,7 +266,9 @@ int main(int argc, char** argv)
                                                 static_cast<int>(matType),
                                                 static_cast<int>(MultipleScatteringSmith::GAUSSIAN_HEIGHT),
                                                 static_cast<int>(MultipleScatteringSmith::BECKMANN_SLOPE),
-                                                numIterations));
+                                                numIterations,
+                                                targetError,
+                                                maxNumIterations));
     }
     else if (modelName == LambertianName) {
         n = 1.0f;
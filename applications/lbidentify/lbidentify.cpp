@@ -12,6 +12,7 @@
 #include <libbsdf/Brdf/HalfDifferenceCoordinatesBrdf.h>
 #include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
 #include <libbsdf/Brdf/SphericalCoordinatesBrdf.h>
+#include <libbsdf/Reader/FileInfo.h>
 #include <libbsdf/Reader/ReaderUtility.h>
 
 #include <ArgumentParser.h>
@@ -27,7 +28,10 @@ using std::endl;
  */
 
 const std::string APP_NAME("lbidentify");
-const std::string APP_VERSION("1.0.2");
+const std::string APP_VERSION("1.1.0");
+
+// Parameters
+bool headerOnly = false;
 
 void showHelp()
 {
@@ -39,13 +43,17 @@ void showHelp()
     cout << "  file     Name of the input BRDF/BTDF file." << endl;
     cout << "           Valid formats:" << endl;
     cout << "               Integra Diffuse Distribution (\".ddr, .ddt\")" << endl;
+    cout << "               Integra Specular Distribution (\".sdr, .sdt\", only with -headerOnly)" << endl;
     cout << "               LightTools/Zemax BSDF (\".bsdf\")" << endl;
     cout << "               ASTM E1392-96(2002) (\".astm\")" << endl;
     cout << "               MERL binary Files (\".binary\")" << endl;
+    cout << "               libbsdf binary (\".lbb\")" << endl;
     cout << endl;
     cout << "Options:" << endl;
     cout << "  -h, --help       show this help message and exit" << endl;
     cout << "  -v, --version    show program's version number and exit" << endl;
+    cout << "  -headerOnly      read only the header of the file without loading samples" << endl;
+    cout << "                   Angles listed in data blocks are shown as unknown." << endl;
 }
 
 void showFileType(FileType fileType)
@@ -60,6 +68,12 @@ void showFileType(FileType fileType)
         case INTEGRA_DDT_FILE:
             cout << "File type: Integra Diffuse Distribution Transparent" << endl;
             break;
+        case INTEGRA_SDR_FILE:
+            cout << "File type: Integra Specular Distribution Reflection" << endl;
+            break;
+        case INTEGRA_SDT_FILE:
+            cout << "File type: Integra Specular Distribution Transparent" << endl;
+            break;
         case lb::LIGHTTOOLS_FILE:
             cout << "File type: LightTools BSDF" << endl;
             break;
@@ -69,6 +83,9 @@ void showFileType(FileType fileType)
         case lb::ZEMAX_FILE:
             cout << "File type: Zemax BSDF" << endl;
             break;
+        case lb::LIBBSDF_BINARY_FILE:
+            cout << "File type: libbsdf binary" << endl;
+            break;
         default:
             cerr << "Unknown file type: " << fileType << endl;
             break;
@@ -84,6 +101,12 @@ void showDataType(DataType dataType)
         case lb::BTDF_DATA:
             cout << "Data type: BTDF" << endl;
             break;
+        case lb::SPECULAR_REFLECTANCE_DATA:
+            cout << "Data type: Specular reflectance" << endl;
+            break;
+        case lb::SPECULAR_TRANSMITTANCE_DATA:
+            cout << "Data type: Specular transmittance" << endl;
+            break;
         case lb::UNKNOWN_DATA:
             cout << "Data type is not distinguished between BRDF and BTDF." << endl;
             break;
@@ -114,9 +137,8 @@ void showSourceType(SourceType sourceType)
     }
 }
 
-void showColorInfo(const SampleSet& samples)
+void showColorInfo(ColorModel cm, int numWavelengths, const Arrayf& wavelengths)
 {
-    ColorModel cm = samples.getColorModel();
     switch (cm) {
         case lb::MONOCHROMATIC_MODEL:
             cout << "Color model: Monochromatic" << endl;
@@ -129,8 +151,13 @@ void showColorInfo(const SampleSet& samples)
             break;
         case lb::SPECTRAL_MODEL:
             cout << "Color model: Spectral" << endl;
-            cout << "Number of wavelengths: " << samples.getNumWavelengths() << endl;
-            cout << "Wavelength (nm): " << samples.getWavelengths().format(LB_EIGEN_IO_FMT) << endl;
+            cout << "Number of wavelengths: " << numWavelengths << endl;
+            if (wavelengths.size() != 0) {
+                cout << "Wavelength (nm): " << wavelengths.format(LB_EIGEN_IO_FMT) << endl;
+            }
+            else {
+                cout << "Wavelength (nm): unknown" << endl;
+            }
             break;
         default:
             cerr << "Unknown color model: " << cm << endl;
@@ -138,6 +165,19 @@ void showColorInfo(const SampleSet& samples)
     }
 }
 
+void showAngles(const std::string& name, const Arrayf& angles)
+{
+    using reader_utility::toLower;
+
+    if (angles.size() != 0) {
+        cout << "Number of " << toLower(name) << "s: " << angles.size() << endl;
+        cout << name << ": " << toDegrees(angles).format(LB_EIGEN_IO_FMT) << endl;
+    }
+    else {
+        cout << "Number of " << toLower(name) << "s: unknown" << endl;
+    }
+}
+
 void showAngleInfo(const Brdf& brdf)
 {
     auto halfDiffBrdf = dynamic_cast<const HalfDifferenceCoordinatesBrdf*>(&brdf);
@@ -160,24 +200,71 @@ void showAngleInfo(const Brdf& brdf)
 
     const SampleSet* ss = brdf.getSampleSet();
 
-    using reader_utility::toLower;
+    showAngles(brdf.getAngle0Name(), ss->getAngles0());
+    showAngles(brdf.getAngle1Name(), ss->getAngles1());
+    showAngles(brdf.getAngle2Name(), ss->getAngles2());
+    showAngles(brdf.getAngle3Name(), ss->getAngles3());
 
-    cout << "Number of " << toLower(brdf.getAngle0Name()) << "s: " << ss->getNumAngles0() << endl;
-    cout << brdf.getAngle0Name() << ": " << toDegrees(ss->getAngles0()).format(LB_EIGEN_IO_FMT) << endl;
+    if (specBrdf && specBrdf->getNumSpecularOffsets() != 0) {
+        cout << "Number of specular offsets: " << specBrdf->getNumSpecularOffsets() << endl;
+        cout << "Specular offsets: " << toDegrees(specBrdf->getSpecularOffsets()).format(LB_EIGEN_IO_FMT) << endl;
+    }
+}
 
-    cout << "Number of " << toLower(brdf.getAngle1Name()) << "s: " << ss->getNumAngles1() << endl;
-    cout << brdf.getAngle1Name() << ": " << toDegrees(ss->getAngles1()).format(LB_EIGEN_IO_FMT) << endl;
+template <typename CoordSysT>
+void showAngleInfo(const FileInfo& info)
+{
+    showAngles(CoordSysT::ANGLE0_NAME, info.angles0);
+    showAngles(CoordSysT::ANGLE1_NAME, info.angles1);
+    showAngles(CoordSysT::ANGLE2_NAME, info.angles2);
+    showAngles(CoordSysT::ANGLE3_NAME, info.angles3);
+}
 
-    cout << "Number of " << toLower(brdf.getAngle2Name()) << "s: " << ss->getNumAngles2() << endl;
-    cout << brdf.getAngle2Name() << ": " << toDegrees(ss->getAngles2()).format(LB_EIGEN_IO_FMT) << endl;
+void showAngleInfo(const FileInfo& info)
+{
+    switch (info.coordinateSystem) {
+        case lb::HALF_DIFFERENCE_COORDINATE_SYSTEM:
+            cout << "Type of parameterization: Half difference" << endl;
+            showAngleInfo<HalfDifferenceCoordinateSystem>(info);
+            break;
+        case lb::SPECULAR_COORDINATE_SYSTEM:
+            cout << "Type of parameterization: Specular" << endl;
+            showAngleInfo<SpecularCoordinateSystem>(info);
+            break;
+        case lb::SPHERICAL_COORDINATE_SYSTEM:
+            cout << "Type of parameterization: Spherical" << endl;
+            showAngleInfo<SphericalCoordinateSystem>(info);
+            break;
+        default:
+            cerr << "Unknown coordinate system: " << info.coordinateSystem << endl;
+            return;
+    }
 
-    cout << "Number of " << toLower(brdf.getAngle3Name()) << "s: " << ss->getNumAngles3() << endl;
-    cout << brdf.getAngle3Name() << ": " << toDegrees(ss->getAngles3()).format(LB_EIGEN_IO_FMT) << endl;
+    if (info.specularOffsets.size() != 0) {
+        cout << "Number of specular offsets: " << info.specularOffsets.size() << endl;
+        cout << "Specular offsets: " << toDegrees(info.specularOffsets).format(LB_EIGEN_IO_FMT) << endl;
+    }
+}
 
-    if (specBrdf && specBrdf->getNumSpecularOffsets() != 0) {
-        cout << "Number of specular offsets: " << specBrdf->getNumSpecularOffsets() << endl;
-        cout << "Specular offsets: " << toDegrees(specBrdf->getSpecularOffsets()).format(LB_EIGEN_IO_FMT) << endl;
+/*! Displays information from the header of a file without loading samples. */
+int identifyHeader(const std::string& fileName)
+{
+    FileInfo info;
+    if (reader_utility::readInfo(fileName, &info)) {
+        cout << "File name: " << fileName << endl;
+    }
+    else {
+        cerr << "Failed to read the header: " << fileName << endl;
+        return 1;
     }
+
+    showFileType(info.fileType);
+    showDataType(info.dataType);
+    showSourceType(info.sourceType);
+    showAngleInfo(info);
+    showColorInfo(info.colorModel, info.numWavelengths, info.wavelengths);
+
+    return 0;
 }
 
 int main(int argc, char** argv)
@@ -196,10 +283,18 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    if (ap.read("-headerOnly")) {
+        headerOnly = true;
+    }
+
     if (!ap.validateNumTokens(1)) return 1;
 
     std::string fileName = ap.getTokens().at(0);
 
+    if (headerOnly) {
+        return identifyHeader(fileName);
+    }
+
     // Load a BRDF/BTDF.
     FileType fileType;
     DataType dataType;
@@ -222,7 +317,8 @@ int main(int argc, char** argv)
     showDataType(dataType);
     showSourceType(brdf->getSourceType());
     showAngleInfo(*brdf);
-    showColorInfo(*brdf->getSampleSet());
+    const SampleSet* ss = brdf->getSampleSet();
+    showColorInfo(ss->getColorModel(), ss->getNumWavelengths(), ss->getWavelengths());
 
     return 0;
 }
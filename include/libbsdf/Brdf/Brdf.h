@@ -66,6 +66,25 @@ public:
     /*! Gets the value of the BRDF at incoming and outgoing directions and the index of wavelength. */
     virtual float getValue(const Vec3& inDir, const Vec3& outDir, int wavelengthIndex) const = 0;
 
+    /*!
+     * Gets the spectra of the BRDF at arrays of incoming and outgoing directions.
+     * The spectrum of the i-th pair of directions is stored from \a spectra[i * numWavelengths].
+     */
+    virtual void getSpectra(const Vec3* inDirs,
+                            const Vec3* outDirs,
+                            size_t      numDirs,
+                            float*      spectra) const;
+
+    /*!
+     * Gets the values of the BRDF at arrays of incoming and outgoing directions
+     * and the index of wavelength.
+     */
+    virtual void getValues(const Vec3*  inDirs,
+                           const Vec3*  outDirs,
+                           size_t       numDirs,
+                           int          wavelengthIndex,
+                           float*       values) const;
+
     /*!
      * Computes incoming and outgoing directions of a Cartesian coordinate system
      * using a set of angle indices.
@@ -0,0 +1,86 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_BRDF_SAMPLER_H
+#define LIBBSDF_BRDF_SAMPLER_H
+
+#include <vector>
+
+#include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
+
+namespace lb {
+
+/*!
+ * \class   BrdfSampler
+ * \brief   The BrdfSampler class provides importance sampling of outgoing directions for a tabulated BRDF.
+ *
+ * For each incoming direction of the sample points, the probability of a cell between four
+ * neighboring outgoing sample points is proportional to the mean of the BRDF times the cosine
+ * and the solid angle of the cell. The cell is selected with the marginal CDF of specular polar
+ * angles and the conditional CDF of specular azimuthal angles, and a direction is uniformly
+ * sampled by solid angle in the cell. The nearest incoming direction of sample points is used.
+ *
+ * The BRDF must outlive the sampler and must not be modified after the sampler is constructed.
+ */
+class BrdfSampler
+{
+public:
+    /*! Constructs the sampling tables from a BRDF. */
+    explicit BrdfSampler(const SpecularCoordinatesBrdf& brdf);
+
+    /*!
+     * Samples an outgoing direction with two random numbers in [0,1).
+     * False is returned if the sampled direction is below the surface.
+     *
+     * \param outDir    The sampled outgoing direction.
+     * \param pdf       The probability density of \a outDir with respect to solid angle.
+     */
+    bool sample(const Vec3& inDir, float u1, float u2, Vec3* outDir, float* pdf) const;
+
+    /*! Gets the probability density of an outgoing direction with respect to solid angle. */
+    float getPdf(const Vec3& inDir, const Vec3& outDir) const;
+
+    /*! Gets the BRDF used to construct the sampler. */
+    const SpecularCoordinatesBrdf& getBrdf() const;
+
+private:
+    /*! Copy operator is disabled. */
+    BrdfSampler& operator=(const BrdfSampler&);
+
+    /*! Builds CDFs for the incoming direction of sample points at \a inThIndex and \a inPhIndex. */
+    void buildCdfs(int inThIndex, int inPhIndex);
+
+    /*! Finds the index of the nearest incoming direction of sample points. */
+    int findInIndex(float inTheta, float inPhi) const;
+
+    /*!
+     * Finds the interval of a CDF including \a u and remaps \a u to [0,1) in the interval.
+     * The probability of the interval is assigned to \a probability.
+     */
+    static int sampleCdf(const float* cdf, int numIntervals, float* u, float* probability);
+
+    /*! Computes the solid angle of a cell in the specular coordinate system. */
+    float computeCellSolidAngle(int specThIndex, int specPhIndex) const;
+
+    const SpecularCoordinatesBrdf& brdf_; /*!< The BRDF to be sampled. */
+
+    int numSpecThetaIntervals_; /*!< The number of intervals of specular polar angles. */
+    int numSpecPhiIntervals_;   /*!< The number of intervals of specular azimuthal angles. */
+
+    /*! The marginal CDFs of specular polar angles for each incoming direction of sample points. */
+    std::vector<float> marginalCdfs_;
+
+    /*! The conditional CDFs of specular azimuthal angles for each incoming direction and specular polar angle. */
+    std::vector<float> conditionalCdfs_;
+};
+
+inline const SpecularCoordinatesBrdf& BrdfSampler::getBrdf() const { return brdf_; }
+
+} // namespace lb
+
+#endif // LIBBSDF_BRDF_SAMPLER_H
@@ -19,6 +19,9 @@ namespace lb {
  * \brief   The CatmullRomSplineInterpolator class provides the functions for Catmull-Rom spline interpolation.
  *
  * \a angle1 is not used for isotropic BRDFs.
+ *
+ * Spectra of monochromatic and three-channel data are interpolated with
+ * lb::FixedSpectrum to avoid dynamic memory allocation.
  */
 class CatmullRomSplineInterpolator
 {
@@ -38,6 +41,29 @@ public:
                             float               angle3,
                             Spectrum*           spectrum);
 
+    /*!
+     * Gets the interpolated spectrum of sample points at a set of angles.
+     * \a NumWavelengths must be 1, 3, or Eigen::Dynamic and match the number of wavelengths of \a samples.
+     */
+    template <int NumWavelengths>
+    static void getSpectrum(const SampleSet&                samples,
+                            float                           angle0,
+                            float                           angle1,
+                            float                           angle2,
+                            float                           angle3,
+                            FixedSpectrum<NumWavelengths>*  spectrum);
+
+    /*!
+     * Gets the interpolated spectrum of sample points at a set of angles.
+     * \a NumWavelengths must be 1, 3, or Eigen::Dynamic and match the number of wavelengths of \a samples.
+     */
+    template <int NumWavelengths>
+    static void getSpectrum(const SampleSet&                samples,
+                            float                           angle0,
+                            float                           angle2,
+                            float                           angle3,
+                            FixedSpectrum<NumWavelengths>*  spectrum);
+
     /*! Gets the interpolated value of sample points at a set of angles and the index of wavelength. */
     static float getValue(const SampleSet&  samples,
                           float             angle0,
@@ -66,41 +92,43 @@ public:
 
 private:
     /*! Finds four near indices and angles. */
-    static void findBounds(const Arrayf&    positions,
-                           float            posAngle,
-                           bool             equalIntervalPositions,
-                           bool             repeatBounds,
-                           int*             pos0Index,
-                           int*             pos1Index,
-                           int*             pos2Index,
-                           int*             pos3Index,
-                           float*           pos0Angle,
-                           float*           pos1Angle,
-                           float*           pos2Angle,
-                           float*           pos3Angle);
+    static void findBounds(const Arrayf&       positions,
+                           float               posAngle,
+                           bool                equalIntervalPositions,
+                           const BoundsTable&  table,
+                           bool                repeatBounds,
+                           int*                pos0Index,
+                           int*                pos1Index,
+                           int*                pos2Index,
+                           int*                pos3Index,
+                           float*              pos0Angle,
+                           float*              pos1Angle,
+                           float*              pos2Angle,
+                           float*              pos3Angle);
 
     /*! Interpolates spectra of 2D sample points. */
-    static Spectrum interpolate2D(const SampleSet&  samples,
-                                  int               index0,
-                                  int               index1,
-                                  int               pos0Index2,
-                                  int               pos1Index2,
-                                  int               pos2Index2,
-                                  int               pos3Index2,
-                                  int               pos0Index3,
-                                  int               pos1Index3,
-                                  int               pos2Index3,
-                                  int               pos3Index3,
-                                  float             pos0Angle2,
-                                  float             pos1Angle2,
-                                  float             pos2Angle2,
-                                  float             pos3Angle2,
-                                  float             pos0Angle3,
-                                  float             pos1Angle3,
-                                  float             pos2Angle3,
-                                  float             pos3Angle3,
-                                  float             angle2,
-                                  float             angle3);
+    template <int NumWavelengths>
+    static FixedSpectrum<NumWavelengths> interpolate2D(const SampleSet&  samples,
+                                                       int               index0,
+                                                       int               index1,
+                                                       int               pos0Index2,
+                                                       int               pos1Index2,
+                                                       int               pos2Index2,
+                                                       int               pos3Index2,
+                                                       int               pos0Index3,
+                                                       int               pos1Index3,
+                                                       int               pos2Index3,
+                                                       int               pos3Index3,
+                                                       float             pos0Angle2,
+                                                       float             pos1Angle2,
+                                                       float             pos2Angle2,
+                                                       float             pos3Angle2,
+                                                       float             pos0Angle3,
+                                                       float             pos1Angle3,
+                                                       float             pos2Angle3,
+                                                       float             pos3Angle3,
+                                                       float             angle2,
+                                                       float             angle3);
 
     /*! Interpolates values of 2D sample points. */
     static float interpolate2D(const SampleSet& samples,
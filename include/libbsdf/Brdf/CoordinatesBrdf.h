@@ -9,6 +9,8 @@
 #ifndef LIBBSDF_COORDINATES_BRDF_H
 #define LIBBSDF_COORDINATES_BRDF_H
 
+#include <algorithm>
+
 #include <libbsdf/Brdf/Brdf.h>
 #include <libbsdf/Brdf/Sampler.h>
 #include <libbsdf/Brdf/LinearInterpolator.h>
@@ -66,9 +68,31 @@ public:
     /*! Gets the spectrum of the BRDF at incoming and outgoing directions. */
     virtual Spectrum getSpectrum(const Vec3& inDir, const Vec3& outDir) const;
 
+    /*!
+     * Gets the spectrum of the BRDF at incoming and outgoing directions without dynamic memory allocation.
+     * \a NumWavelengths must be 1, 3, or Eigen::Dynamic and match the number of wavelengths.
+     */
+    template <int NumWavelengths>
+    void getSpectrum(const Vec3&                    inDir,
+                     const Vec3&                    outDir,
+                     FixedSpectrum<NumWavelengths>* spectrum) const;
+
     /*! Gets the value of the BRDF at incoming and outgoing directions and the index of wavelength. */
     virtual float getValue(const Vec3& inDir, const Vec3& outDir, int wavelengthIndex) const;
 
+    /*! Gets the spectra of the BRDF at arrays of incoming and outgoing directions. \sa Brdf::getSpectra() */
+    virtual void getSpectra(const Vec3* inDirs,
+                            const Vec3* outDirs,
+                            size_t      numDirs,
+                            float*      spectra) const;
+
+    /*! Gets the values of the BRDF at arrays of incoming and outgoing directions. \sa Brdf::getValues() */
+    virtual void getValues(const Vec3*  inDirs,
+                           const Vec3*  outDirs,
+                           size_t       numDirs,
+                           int          wavelengthIndex,
+                           float*       values) const;
+
     /*!
      * Computes incoming and outgoing directions of a Cartesian coordinate system
      * using a set of angle indices.
@@ -154,6 +178,16 @@ private:
 
     /*! Initializes angle lists consisting of equal interval angles. */
     void initializeEqualIntervalAngles();
+
+    /*!
+     * Converts arrays of incoming and outgoing directions to angles in blocks and interpolates them.
+     * \a interpolate is called with the arrays of angles, the number of angles, and the offset of the block.
+     */
+    template <typename InterpolateT>
+    void interpolateBlocks(const Vec3*  inDirs,
+                           const Vec3*  outDirs,
+                           size_t       numDirs,
+                           InterpolateT interpolate) const;
 };
 
 template <typename CoordSysT>
@@ -248,12 +282,89 @@ Spectrum CoordinatesBrdf<CoordSysT>::getSpectrum(const Vec3& inDir, const Vec3&
     return sp;
 }
 
+template <typename CoordSysT>
+template <int NumWavelengths>
+void CoordinatesBrdf<CoordSysT>::getSpectrum(const Vec3&                    inDir,
+                                             const Vec3&                    outDir,
+                                             FixedSpectrum<NumWavelengths>* spectrum) const
+{
+    Sampler::getSpectrum<CoordSysT, LinearInterpolator>(*samples_, inDir, outDir, spectrum);
+}
+
 template <typename CoordSysT>
 float CoordinatesBrdf<CoordSysT>::getValue(const Vec3& inDir, const Vec3& outDir, int wavelengthIndex) const
 {
     return Sampler::getValue<CoordSysT, LinearInterpolator>(*samples_, inDir, outDir, wavelengthIndex);
 }
 
+template <typename CoordSysT>
+void CoordinatesBrdf<CoordSysT>::getSpectra(const Vec3* inDirs,
+                                            const Vec3* outDirs,
+                                            size_t      numDirs,
+                                            float*      spectra) const
+{
+    const int numWavelengths = samples_->getNumWavelengths();
+    const SampleSet& samples = *samples_;
+
+    interpolateBlocks(inDirs, outDirs, numDirs,
+                      [&](const float* angles0, const float* angles1, const float* angles2, const float* angles3,
+                          size_t numAngles, size_t base) {
+        LinearInterpolator::getSpectra(samples, angles0, angles1, angles2, angles3, numAngles,
+                                       spectra + numWavelengths * base);
+    });
+}
+
+template <typename CoordSysT>
+void CoordinatesBrdf<CoordSysT>::getValues(const Vec3*  inDirs,
+                                           const Vec3*  outDirs,
+                                           size_t       numDirs,
+                                           int          wavelengthIndex,
+                                           float*       values) const
+{
+    const SampleSet& samples = *samples_;
+
+    interpolateBlocks(inDirs, outDirs, numDirs,
+                      [&](const float* angles0, const float* angles1, const float* angles2, const float* angles3,
+                          size_t numAngles, size_t base) {
+        LinearInterpolator::getValues(samples, angles0, angles1, angles2, angles3, numAngles,
+                                      wavelengthIndex, values + base);
+    });
+}
+
+template <typename CoordSysT>
+template <typename InterpolateT>
+void CoordinatesBrdf<CoordSysT>::interpolateBlocks(const Vec3*     inDirs,
+                                                   const Vec3*     outDirs,
+                                                   size_t          numDirs,
+                                                   InterpolateT    interpolate) const
+{
+    // Angles are converted in blocks to keep the working set on the stack.
+    const size_t blockSize = 256;
+    float angles0[blockSize], angles1[blockSize], angles2[blockSize], angles3[blockSize];
+
+    bool isotropic = samples_->isIsotropic();
+
+    for (size_t base = 0; base < numDirs; base += blockSize) {
+        size_t numAngles = std::min(blockSize, numDirs - base);
+
+        for (size_t i = 0; i < numAngles; ++i) {
+            const Vec3& inDir = inDirs[base + i];
+            const Vec3& outDir = outDirs[base + i];
+            assert(inDir.z() >= 0.0);
+
+            if (isotropic) {
+                CoordSysT::fromXyz(inDir, outDir, &angles0[i], &angles2[i], &angles3[i]);
+                angles1[i] = 0.0f;
+            }
+            else {
+                CoordSysT::fromXyz(inDir, outDir, &angles0[i], &angles1[i], &angles2[i], &angles3[i]);
+            }
+        }
+
+        interpolate(angles0, angles1, angles2, angles3, numAngles, base);
+    }
+}
+
 template <typename CoordSysT>
 void CoordinatesBrdf<CoordSysT>::getInOutDirection(int      index0,
                                                    int      index1,
@@ -344,7 +455,7 @@ bool CoordinatesBrdf<CoordSysT>::validate(bool verbose) const
 
         if (outDir.z() < 0) continue;
 
-        const Spectrum& sp = samples_->getSpectrum(i0, i1, i2, i3);
+        ConstSpectrumMap sp = getSampleSet()->getSpectrum(i0, i1, i2, i3);
 
         if (sp.allFinite() && sp.minCoeff() < -EPSILON_F * 10) {
             spectraValid = false;
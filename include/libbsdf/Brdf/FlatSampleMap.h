@@ -0,0 +1,159 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_FLAT_SAMPLE_MAP_H
+#define LIBBSDF_FLAT_SAMPLE_MAP_H
+
+#include <array>
+#include <cassert>
+#include <vector>
+
+#include <libbsdf/Common/Global.h>
+
+namespace lb {
+
+/*!
+ * \class   FlatSampleMap
+ * \brief   The FlatSampleMap class provides the hash map from a set of four angles to a spectrum.
+ *
+ * Samples are stored densely in the order of insertion and addressed by indices.
+ * Angles are kept in a vector and spectra in the columns of lb::SpectrumArray.
+ * Lookups use an open-addressing table with linear probing.
+ * Samples cannot be removed individually.
+ */
+class FlatSampleMap
+{
+public:
+    using Key = std::array<float, 4>;
+
+    /*! Constructs an empty map. The number of wavelengths is set by the first insertion if zero. */
+    explicit FlatSampleMap(int numWavelengths = 0);
+
+    /*! Gets the number of wavelengths of spectra. */
+    int getNumWavelengths() const;
+
+    /*! Sets the number of wavelengths of spectra. Samples are removed. */
+    void setNumWavelengths(int numWavelengths);
+
+    /*! Returns the number of samples. */
+    int size() const;
+
+    /*! Returns true if the map has no samples. */
+    bool empty() const;
+
+    /*! Reserves storage for \a numSamples samples. */
+    void reserve(int numSamples);
+
+    /*! Removes all samples. */
+    void clear();
+
+    /*! Finds the index of a sample. If the sample is not found, -1 is returned. */
+    int find(const Key& angles) const;
+
+    /*! Returns true if the map has a sample with \a angles. */
+    bool contains(const Key& angles) const;
+
+    /*!
+     * Inserts a sample and returns the index. The spectrum of an existing sample is overwritten.
+     * If the number of wavelengths is not matched, -1 is returned.
+     */
+    int insert(const Key& angles, const Spectrum& spectrum);
+
+    /*!
+     * Inserts samples at once. The spectrum of the i-th angles is stored in the i-th column of \a spectra.
+     * Returns false if the number of wavelengths or samples is not matched.
+     */
+    bool insert(const std::vector<Key>& angleList, const SpectrumArray& spectra);
+
+    /*! Gets the angles of a sample. */
+    const Key& getAngles(int index) const;
+
+    /*! Gets the spectrum of a sample. */
+    SpectrumMap getSpectrum(int index);
+
+    /*! Gets the spectrum of a sample. */
+    ConstSpectrumMap getSpectrum(int index) const;
+
+    /*! Gets the angles of all samples in the order of indices. */
+    const std::vector<Key>& getAngleList() const;
+
+private:
+    /*! Computes the hash value of angles. Negative zeros are equal to positive zeros. */
+    static size_t hash(const Key& angles);
+
+    /*! Finds the slot of angles. The slot is empty if the sample is not found. */
+    size_t findSlot(const Key& angles) const;
+
+    /*! Appends a sample without lookup and returns the index. */
+    int append(const Key& angles, size_t slot);
+
+    /*! Rebuilds the table with \a numSlots slots. \a numSlots must be a power of two. */
+    void rehash(size_t numSlots);
+
+    /*! Grows the table if the load factor exceeds the limit after inserting \a numSamples samples. */
+    void growTable(size_t numSamples);
+
+    int numWavelengths_; /*!< The number of wavelengths. */
+
+    std::vector<Key>    angleList_; /*!< The angles of samples. */
+    SpectrumArray       spectra_;   /*!< The spectra of samples. Columns beyond the size are reserved. */
+
+    std::vector<int> slots_; /*!< The hash table of sample indices. An empty slot is -1. */
+};
+
+inline FlatSampleMap::FlatSampleMap(int numWavelengths) : numWavelengths_(numWavelengths) {}
+
+inline int FlatSampleMap::getNumWavelengths() const { return numWavelengths_; }
+
+inline int  FlatSampleMap::size()  const { return static_cast<int>(angleList_.size()); }
+inline bool FlatSampleMap::empty() const { return angleList_.empty(); }
+
+inline int FlatSampleMap::find(const Key& angles) const
+{
+    if (slots_.empty()) return -1;
+
+    return slots_[findSlot(angles)];
+}
+
+inline bool FlatSampleMap::contains(const Key& angles) const { return (find(angles) != -1); }
+
+inline const FlatSampleMap::Key& FlatSampleMap::getAngles(int index) const
+{
+    assert(index >= 0 && index < size());
+    return angleList_[index];
+}
+
+inline SpectrumMap FlatSampleMap::getSpectrum(int index)
+{
+    assert(index >= 0 && index < size());
+    return SpectrumMap(spectra_.data() + spectra_.rows() * index, spectra_.rows());
+}
+
+inline ConstSpectrumMap FlatSampleMap::getSpectrum(int index) const
+{
+    assert(index >= 0 && index < size());
+    return ConstSpectrumMap(spectra_.data() + spectra_.rows() * index, spectra_.rows());
+}
+
+inline const std::vector<FlatSampleMap::Key>& FlatSampleMap::getAngleList() const { return angleList_; }
+
+inline size_t FlatSampleMap::findSlot(const Key& angles) const
+{
+    size_t mask = slots_.size() - 1;
+    size_t slot = hash(angles) & mask;
+
+    while (slots_[slot] != -1 && angleList_[slots_[slot]] != angles) {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_FLAT_SAMPLE_MAP_H
@@ -74,26 +74,26 @@ public:
                          float diffPhi) const;
 
     /*! Gets the spectrum of the BRDF at a set of angle indices. */
-    Spectrum& getSpectrum(int halfThetaIndex,
-                          int halfPhiIndex,
-                          int diffThetaIndex,
-                          int diffPhiIndex);
+    SpectrumMap getSpectrum(int halfThetaIndex,
+                            int halfPhiIndex,
+                            int diffThetaIndex,
+                            int diffPhiIndex);
 
     /*! Gets the spectrum of the BRDF at a set of angle indices. */
-    const Spectrum& getSpectrum(int halfThetaIndex,
-                                int halfPhiIndex,
-                                int diffThetaIndex,
-                                int diffPhiIndex) const;
+    ConstSpectrumMap getSpectrum(int halfThetaIndex,
+                                 int halfPhiIndex,
+                                 int diffThetaIndex,
+                                 int diffPhiIndex) const;
 
     /*! Gets the spectrum of the isotropic BRDF at a set of angle indices. */
-    Spectrum& getSpectrum(int halfThetaIndex,
-                          int diffThetaIndex,
-                          int diffPhiIndex);
+    SpectrumMap getSpectrum(int halfThetaIndex,
+                            int diffThetaIndex,
+                            int diffPhiIndex);
 
     /*! Gets the spectrum of the isotropic BRDF at a set of angle indices. */
-    const Spectrum& getSpectrum(int halfThetaIndex,
-                                int diffThetaIndex,
-                                int diffPhiIndex) const;
+    ConstSpectrumMap getSpectrum(int halfThetaIndex,
+                                 int diffThetaIndex,
+                                 int diffPhiIndex) const;
 
     /*! Sets the spectrum of the BRDF at a set of angle indices. */
     void setSpectrum(int                halfThetaIndex,
@@ -142,34 +142,34 @@ inline Spectrum HalfDifferenceCoordinatesBrdf::getSpectrum(float halfTheta,
     return sp;
 }
 
-inline Spectrum& HalfDifferenceCoordinatesBrdf::getSpectrum(int halfThetaIndex,
-                                                            int halfPhiIndex,
-                                                            int diffThetaIndex,
-                                                            int diffPhiIndex)
+inline SpectrumMap HalfDifferenceCoordinatesBrdf::getSpectrum(int halfThetaIndex,
+                                                              int halfPhiIndex,
+                                                              int diffThetaIndex,
+                                                              int diffPhiIndex)
 {
     return samples_->getSpectrum(halfThetaIndex, halfPhiIndex, diffThetaIndex, diffPhiIndex);
 }
 
-inline const Spectrum& HalfDifferenceCoordinatesBrdf::getSpectrum(int halfThetaIndex,
-                                                                  int halfPhiIndex,
-                                                                  int diffThetaIndex,
-                                                                  int diffPhiIndex) const
+inline ConstSpectrumMap HalfDifferenceCoordinatesBrdf::getSpectrum(int halfThetaIndex,
+                                                                   int halfPhiIndex,
+                                                                   int diffThetaIndex,
+                                                                   int diffPhiIndex) const
 {
-    return samples_->getSpectrum(halfThetaIndex, halfPhiIndex, diffThetaIndex, diffPhiIndex);
+    return getSampleSet()->getSpectrum(halfThetaIndex, halfPhiIndex, diffThetaIndex, diffPhiIndex);
 }
 
-inline Spectrum& HalfDifferenceCoordinatesBrdf::getSpectrum(int halfThetaIndex,
-                                                            int diffThetaIndex,
-                                                            int diffPhiIndex)
+inline SpectrumMap HalfDifferenceCoordinatesBrdf::getSpectrum(int halfThetaIndex,
+                                                              int diffThetaIndex,
+                                                              int diffPhiIndex)
 {
     return samples_->getSpectrum(halfThetaIndex, diffThetaIndex, diffPhiIndex);
 }
 
-inline const Spectrum& HalfDifferenceCoordinatesBrdf::getSpectrum(int halfThetaIndex,
-                                                                  int diffThetaIndex,
-                                                                  int diffPhiIndex) const
+inline ConstSpectrumMap HalfDifferenceCoordinatesBrdf::getSpectrum(int halfThetaIndex,
+                                                                   int diffThetaIndex,
+                                                                   int diffPhiIndex) const
 {
-    return samples_->getSpectrum(halfThetaIndex, diffThetaIndex, diffPhiIndex);
+    return getSampleSet()->getSpectrum(halfThetaIndex, diffThetaIndex, diffPhiIndex);
 }
 
 inline void HalfDifferenceCoordinatesBrdf::setSpectrum(int              halfThetaIndex,
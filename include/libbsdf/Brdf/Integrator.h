@@ -10,6 +10,8 @@
 #define LIBBSDF_INTEGRATOR_H
 
 #include <cmath>
+#include <cstdint>
+#include <vector>
 
 #include <libbsdf/Brdf/Brdf.h>
 #include <libbsdf/Brdf/Sampler.h>
@@ -20,7 +22,11 @@ namespace lb {
  * \class   Integrator
  * \brief   The Integrator class provides functions to calculate the reflectance of a BRDF.
  *
- * Monte Carlo integration is used.
+ * Monte Carlo integration is used. Samples are evaluated in blocks with lb::Brdf::getSpectra() and
+ * partial sums of blocks are reduced in a fixed order, so results do not depend on thread scheduling.
+ *
+ * Random outgoing directions are deterministic for a seed. Calls with the same seed return the same
+ * estimate, so different seeds must be used to reduce variance by averaging estimates.
  */
 class Integrator
 {
@@ -29,18 +35,51 @@ public:
      * Constructs the integrator for BRDF.
      *
      * \param numSampling   The number of samples of Monte Carlo integration.
+     * \param seed          The seed of random outgoing directions. Integrators with the same seed share directions.
      */
-    explicit Integrator(int numSampling = 100000);
+    explicit Integrator(int numSampling = 100000, uint32_t seed = 123456789);
 
     /*! Computes the reflectance of the BRDF at an incoming direction using precomputed outgoing directions. */
     Spectrum computeReflectance(const Brdf& brdf, const Vec3& inDir);
 
-    /*! Computes the reflectance of the BRDF at an incoming direction. */
-    static Spectrum computeReflectance(const Brdf& brdf, const Vec3& inDir, int numSampling);
+    /*!
+     * Computes the reflectance of the BRDF at an incoming direction.
+     * Random outgoing directions are generated from \a seed, so calls with the same arguments return the same value.
+     */
+    static Spectrum computeReflectance(const Brdf&  brdf,
+                                       const Vec3&  inDir,
+                                       int          numSampling,
+                                       uint32_t     seed = 123456789);
+
+    /*!
+     * Computes the reflectance of the BRDF at an incoming direction using randomized quasi-Monte Carlo
+     * integration with cosine-weighted outgoing directions.
+     *
+     * Independently scrambled Sobol sequences are integrated and the number of samples of each
+     * sequence is doubled until the standard error estimated from the sequences is less than or
+     * equal to \a tolerance for all wavelengths, or the total number of samples reaches \a maxNumSampling.
+     *
+     * \param error        The estimated standard error is assigned if not null.
+     * \param numSampling  The total number of used samples is assigned if not null.
+     */
+    static Spectrum computeReflectanceAdaptively(const Brdf&    brdf,
+                                                 const Vec3&    inDir,
+                                                 double         tolerance,
+                                                 int            maxNumSampling = 1000000,
+                                                 double*        error = 0,
+                                                 int*           numSampling = 0);
 
 private:
-    /*! Initializes outgoing directions for integration. */
-    void initializeOutDirs();
+    /*! Computes the sum of spectra weighted by cosine for a block of outgoing directions. */
+    static Arrayd sumBlock(const Brdf& brdf, const Vec3& inDir, const std::vector<Vec3>& outDirs);
+
+    /*! Reduces partial sums of blocks with pairwise summation. */
+    static Arrayd reduceBlockSums(std::vector<Arrayd>* blockSums);
+
+    /*! Initializes outgoing directions for integration with a seed. */
+    void initializeOutDirs(uint32_t seed);
+
+    static const int BLOCK_SIZE = 1024; /*!< The number of samples in a block. */
 
     int numSampling_; /*!< The number of samples of Monte Carlo integration. */
 
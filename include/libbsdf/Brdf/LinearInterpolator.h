@@ -20,6 +20,9 @@ class SampleSet2D;
  * \brief   The LinearInterpolator class provides the functions for linear interpolation.
  *
  * \a angle1 is not used for isotropic BRDFs.
+ *
+ * Spectra of monochromatic and three-channel data are interpolated with
+ * lb::FixedSpectrum to avoid dynamic memory allocation.
  */
 class LinearInterpolator
 {
@@ -39,6 +42,29 @@ public:
                             float               angle3,
                             Spectrum*           spectrum);
 
+    /*!
+     * Gets the interpolated spectrum of sample points at a set of angles.
+     * \a NumWavelengths must be Eigen::Dynamic or equal to the number of wavelengths of \a samples.
+     */
+    template <int NumWavelengths>
+    static void getSpectrum(const SampleSet&                samples,
+                            float                           angle0,
+                            float                           angle1,
+                            float                           angle2,
+                            float                           angle3,
+                            FixedSpectrum<NumWavelengths>*  spectrum);
+
+    /*!
+     * Gets the interpolated spectrum of sample points at a set of angles.
+     * \a NumWavelengths must be Eigen::Dynamic or equal to the number of wavelengths of \a samples.
+     */
+    template <int NumWavelengths>
+    static void getSpectrum(const SampleSet&                samples,
+                            float                           angle0,
+                            float                           angle2,
+                            float                           angle3,
+                            FixedSpectrum<NumWavelengths>*  spectrum);
+
     /*! Gets the interpolated value of sample points at a set of angles and the index of wavelength. */
     static float getValue(const SampleSet&  samples,
                           float             angle0,
@@ -54,6 +80,32 @@ public:
                           float             angle3,
                           int               wavelengthIndex);
 
+    /*!
+     * Gets the interpolated values of sample points at arrays of angles and the index of wavelength.
+     * Four sets of angles are interpolated at once with SIMD instructions. \a angles1 is ignored for isotropic data.
+     */
+    static void getValues(const SampleSet&  samples,
+                          const float*      angles0,
+                          const float*      angles1,
+                          const float*      angles2,
+                          const float*      angles3,
+                          size_t            numAngles,
+                          int               wavelengthIndex,
+                          float*            values);
+
+    /*!
+     * Gets the interpolated spectra of sample points at arrays of angles.
+     * The spectrum of the i-th set of angles is stored at \a spectra + (the number of wavelengths) * i.
+     * Weights and sample points of four sets of angles are found once and shared by all wavelengths.
+     */
+    static void getSpectra(const SampleSet& samples,
+                           const float*     angles0,
+                           const float*     angles1,
+                           const float*     angles2,
+                           const float*     angles3,
+                           size_t           numAngles,
+                           float*           spectra);
+
     /*! Gets the interpolated spectrum of sample points at a set of angles. */
     static void getSpectrum(const SampleSet2D&  ss2,
                             float               theta,
@@ -64,8 +116,143 @@ public:
     static void getSpectrum(const SampleSet2D&  ss2,
                             float               theta,
                             Spectrum*           spectrum);
+
+private:
+    /*!
+     * Interpolates \a numWavelengths values from \a firstWavelength at arrays of angles.
+     * The values of the i-th set of angles are stored at \a values + \a numWavelengths * i.
+     */
+    static void interpolateLanes(const SampleSet&   samples,
+                                 const float*       angles0,
+                                 const float*       angles1,
+                                 const float*       angles2,
+                                 const float*       angles3,
+                                 size_t             numAngles,
+                                 int                firstWavelength,
+                                 int                numWavelengths,
+                                 float*             values);
 };
 
+template <int NumWavelengths>
+inline void LinearInterpolator::getSpectrum(const SampleSet&                samples,
+                                            float                           angle0,
+                                            float                           angle1,
+                                            float                           angle2,
+                                            float                           angle3,
+                                            FixedSpectrum<NumWavelengths>*  spectrum)
+{
+    using SpectrumT = FixedSpectrum<NumWavelengths>;
+    using MapT = ConstFixedSpectrumMap<NumWavelengths>;
+
+    const Arrayf& angles0 = samples.getAngles0();
+    const Arrayf& angles1 = samples.getAngles1();
+    const Arrayf& angles2 = samples.getAngles2();
+    const Arrayf& angles3 = samples.getAngles3();
+
+    int lIdx0, lIdx1, lIdx2, lIdx3; // index of the lower bound sample point
+    int uIdx0, uIdx1, uIdx2, uIdx3; // index of the upper bound sample point
+    Vec4f lowerAngles, upperAngles;
+
+    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), &lIdx0, &uIdx0, &lowerAngles[0], &upperAngles[0]);
+    findBounds(angles1, angle1, samples.isEqualIntervalAngles1(), samples.getBoundsTable1(), &lIdx1, &uIdx1, &lowerAngles[1], &upperAngles[1]);
+    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), &lIdx2, &uIdx2, &lowerAngles[2], &upperAngles[2]);
+    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), &lIdx3, &uIdx3, &lowerAngles[3], &upperAngles[3]);
+
+    Vec4f angles(angle0, angle1, angle2, angle3);
+    Vec4f intervals = (upperAngles - lowerAngles).cwiseMax(EPSILON_F);
+    Vec4f weights = (angles - lowerAngles).cwiseQuotient(intervals);
+
+    MapT sp0000 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, lIdx1, lIdx2, lIdx3);
+    MapT sp0001 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, lIdx1, lIdx2, uIdx3);
+    MapT sp0010 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, lIdx1, uIdx2, lIdx3);
+    MapT sp0011 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, lIdx1, uIdx2, uIdx3);
+
+    MapT sp0100 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, uIdx1, lIdx2, lIdx3);
+    MapT sp0101 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, uIdx1, lIdx2, uIdx3);
+    MapT sp0110 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, uIdx1, uIdx2, lIdx3);
+    MapT sp0111 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, uIdx1, uIdx2, uIdx3);
+
+    MapT sp1000 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, lIdx1, lIdx2, lIdx3);
+    MapT sp1001 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, lIdx1, lIdx2, uIdx3);
+    MapT sp1010 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, lIdx1, uIdx2, lIdx3);
+    MapT sp1011 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, lIdx1, uIdx2, uIdx3);
+
+    MapT sp1100 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, uIdx1, lIdx2, lIdx3);
+    MapT sp1101 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, uIdx1, lIdx2, uIdx3);
+    MapT sp1110 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, uIdx1, uIdx2, lIdx3);
+    MapT sp1111 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, uIdx1, uIdx2, uIdx3);
+
+    SpectrumT sp000 = sp0000 + (sp0001 - sp0000) * weights[3];
+    SpectrumT sp001 = sp0010 + (sp0011 - sp0010) * weights[3];
+    SpectrumT sp010 = sp0100 + (sp0101 - sp0100) * weights[3];
+    SpectrumT sp011 = sp0110 + (sp0111 - sp0110) * weights[3];
+    SpectrumT sp100 = sp1000 + (sp1001 - sp1000) * weights[3];
+    SpectrumT sp101 = sp1010 + (sp1011 - sp1010) * weights[3];
+    SpectrumT sp110 = sp1100 + (sp1101 - sp1100) * weights[3];
+    SpectrumT sp111 = sp1110 + (sp1111 - sp1110) * weights[3];
+
+    SpectrumT sp00 = lerp(sp000, sp001, weights[2]);
+    SpectrumT sp01 = lerp(sp010, sp011, weights[2]);
+    SpectrumT sp10 = lerp(sp100, sp101, weights[2]);
+    SpectrumT sp11 = lerp(sp110, sp111, weights[2]);
+
+    SpectrumT sp0 = lerp(sp00, sp01, weights[1]);
+    SpectrumT sp1 = lerp(sp10, sp11, weights[1]);
+
+    *spectrum = lerp(sp0, sp1, weights[0]);
+
+    assert(spectrum->allFinite());
+}
+
+template <int NumWavelengths>
+inline void LinearInterpolator::getSpectrum(const SampleSet&                samples,
+                                            float                           angle0,
+                                            float                           angle2,
+                                            float                           angle3,
+                                            FixedSpectrum<NumWavelengths>*  spectrum)
+{
+    using SpectrumT = FixedSpectrum<NumWavelengths>;
+    using MapT = ConstFixedSpectrumMap<NumWavelengths>;
+
+    const Arrayf& angles0 = samples.getAngles0();
+    const Arrayf& angles2 = samples.getAngles2();
+    const Arrayf& angles3 = samples.getAngles3();
+
+    int lIdx0, lIdx2, lIdx3; // index of the lower bound sample point
+    int uIdx0, uIdx2, uIdx3; // index of the upper bound sample point
+    Vec4f lowerAngles, upperAngles;
+
+    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), &lIdx0, &uIdx0, &lowerAngles[0], &upperAngles[0]);
+    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), &lIdx2, &uIdx2, &lowerAngles[2], &upperAngles[2]);
+    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), &lIdx3, &uIdx3, &lowerAngles[3], &upperAngles[3]);
+
+    Vec4f angles(angle0, 0.0, angle2, angle3);
+    Vec4f intervals = (upperAngles - lowerAngles).cwiseMax(EPSILON_F);
+    Vec4f weights = (angles - lowerAngles).cwiseQuotient(intervals);
+
+    MapT sp0000 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, lIdx2, lIdx3);
+    MapT sp0001 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, lIdx2, uIdx3);
+    MapT sp0010 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, uIdx2, lIdx3);
+    MapT sp0011 = samples.getFixedSpectrum<NumWavelengths>(lIdx0, uIdx2, uIdx3);
+
+    MapT sp1000 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, lIdx2, lIdx3);
+    MapT sp1001 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, lIdx2, uIdx3);
+    MapT sp1010 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, uIdx2, lIdx3);
+    MapT sp1011 = samples.getFixedSpectrum<NumWavelengths>(uIdx0, uIdx2, uIdx3);
+
+    SpectrumT sp000 = sp0000 + (sp0001 - sp0000) * weights[3];
+    SpectrumT sp001 = sp0010 + (sp0011 - sp0010) * weights[3];
+    SpectrumT sp100 = sp1000 + (sp1001 - sp1000) * weights[3];
+    SpectrumT sp101 = sp1010 + (sp1011 - sp1010) * weights[3];
+
+    SpectrumT sp00 = lerp(sp000, sp001, weights[2]);
+    SpectrumT sp10 = lerp(sp100, sp101, weights[2]);
+
+    *spectrum = lerp(sp00, sp10, weights[0]);
+
+    assert(spectrum->allFinite());
+}
+
 } // namespace lb
 
 #endif // LIBBSDF_LINEAR_INTERPOLATOR_H
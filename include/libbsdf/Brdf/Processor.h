@@ -165,6 +165,9 @@ void fillSpectra(SampleSet* samples, Spectrum::Scalar value);
 /*! \brief Fills spectra with a value. */
 void fillSpectra(SpectrumList& spectra, Spectrum::Scalar value);
 
+/*! \brief Fills contiguous spectra with a value. */
+void fillSpectra(SpectrumArray& spectra, Spectrum::Scalar value);
+
 /*! \brief Computes spectra of a BRDF with two BRDFs. */
 bool compute(const Brdf& src0, const Brdf& src1, Brdf* dest,
              std::function<Spectrum(const Spectrum&, const Spectrum&)> manipulator);
@@ -184,6 +187,9 @@ void fixNegativeSpectra(SampleSet* samples);
 /*! \brief Fixes negative values of spectra to 0. */
 void fixNegativeSpectra(SpectrumList& spectra);
 
+/*! \brief Fixes negative values of contiguous spectra to 0. */
+void fixNegativeSpectra(SpectrumArray& spectra);
+
 } // namespace lb
 
 #endif // LIBBSDF_PROCESSOR_H
@@ -9,9 +9,13 @@
 #ifndef LIBBSDF_RANDOM_SAMPLE_SET_H
 #define LIBBSDF_RANDOM_SAMPLE_SET_H
 
-#include <map>
+#include <algorithm>
+#include <cmath>
+#include <typeinfo>
 #include <vector>
 
+#include <libbsdf/Brdf/FlatSampleMap.h>
+#include <libbsdf/Common/KdTree.h>
 #include <libbsdf/Common/Utility.h>
 
 namespace lb {
@@ -20,44 +24,167 @@ namespace lb {
  * \class   RandomSampleSet
  * \brief   The RandomSampleSet class provides the BRDF using random sample points.
  *
- * The data structure consists of pairs of angles and a spectrum.
+ * The data structure consists of pairs of angles and a spectrum stored in lb::FlatSampleMap.
  * The coordinate system of angles is defined by \a CoordSysT.
+ *
+ * Nearest-neighbor queries are accelerated with k-d trees built by updateIndex().
+ * The trees cache incoming and outgoing directions and converted angles of samples.
+ * If the index is out of date, the queries fall back to linear searches.
  */
 template <typename CoordSysT>
 class RandomSampleSet
 {
 public:
-    using AngleList = std::vector<float>;
-    using SampleMap = std::map<AngleList, Spectrum, std::less<AngleList>,
-                               Eigen::aligned_allocator<std::pair<const AngleList, Spectrum>>>;
+    using AngleList = FlatSampleMap::Key;
+    using SampleMap = FlatSampleMap;
+
+    RandomSampleSet();
+    RandomSampleSet(const RandomSampleSet& other);
 
     virtual ~RandomSampleSet() {}
 
-    /*! Gets random sample points. */
+    RandomSampleSet& operator=(const RandomSampleSet& other);
+
+    /*! Gets random sample points. The index is cleared since the samples may be modified. */
     SampleMap& getSampleMap();
 
     /*! Gets random sample points. */
     const SampleMap& getSampleMap() const;
 
+    /*!
+     * Builds the index of samples for nearest-neighbor queries.
+     * Angles converted to \a LocalCoordSysT are cached for estimateSpectrum().
+     * This function must be called again after samples are modified.
+     */
+    template <typename LocalCoordSysT = CoordSysT>
+    void updateIndex();
+
+    /*! Clears the index of samples. */
+    void clearIndex();
+
     /*! Finds the nearest sample and returns the spectrum. */
-    const Spectrum& findSpectrumOfNearestSample(const AngleList& angles,
-                                                bool             reciprocity = false) const;
+    ConstSpectrumMap findSpectrumOfNearestSample(const AngleList& angles,
+                                                 bool             reciprocity = false) const;
+
+    /*!
+     * Finds the indices of \a k nearest samples sorted in ascending order of the distance.
+     * The distance is the sum of angles between incoming and outgoing directions.
+     */
+    std::vector<int> findNearestSamples(const AngleList&    angles,
+                                        int                 k,
+                                        bool                reciprocity = false) const;
 
     /*! Estimates the spectrum of a set of angles using a coordinate system (\a LocalCoordSysT). */
     template <typename LocalCoordSysT>
-    const Spectrum& estimateSpectrum(const AngleList&   angles,
-                                     float              weight0 = 1.0f,
-                                     float              weight1 = 1.0f,
-                                     float              weight2 = 1.0f,
-                                     float              weight3 = 1.0f) const;
+    ConstSpectrumMap estimateSpectrum(const AngleList&  angles,
+                                      float             weight0 = 1.0f,
+                                      float             weight1 = 1.0f,
+                                      float             weight2 = 1.0f,
+                                      float             weight3 = 1.0f) const;
 
 protected:
     SampleMap sampleMap_; /*!< Random sample points. */
+
+private:
+    /*!
+     * \struct  DirectionDistance
+     * \brief   The DirectionDistance struct provides the metric of incoming and outgoing directions.
+     *
+     * The lower bound in a box uses the chord length, which never exceeds the angle.
+     */
+    struct DirectionDistance
+    {
+        DirectionDistance(const KdTree<6>& tree, const Vec3& inDir, const Vec3& outDir, bool reciprocity);
+
+        float operator()(int index) const;
+        float operator()(const float* lower, const float* upper) const;
+
+        /*! Computes the sum of angles between incoming and outgoing directions. */
+        static float computeDistance(const Vec3& inDir,
+                                     const Vec3& outDir,
+                                     const Vec3& sampleInDir,
+                                     const Vec3& sampleOutDir,
+                                     bool        reciprocity);
+
+        /*! Computes the lower bound of the angle between a direction and points in a box. */
+        static float computeAngleBound(const Vec3& dir, const float* lower, const float* upper);
+
+        const KdTree<6>& tree;
+        Vec3 inDir, outDir;
+        bool reciprocity;
+    };
+
+    /*!
+     * \struct  LocalAngleDistance
+     * \brief   The LocalAngleDistance struct provides the weighted metric of angles used in estimateSpectrum().
+     */
+    struct LocalAngleDistance
+    {
+        LocalAngleDistance(const KdTree<4>& tree, const float* angles, const float* weights);
+
+        float operator()(int index) const;
+        float operator()(const float* lower, const float* upper) const;
+
+        /*! Computes the weighted sum of differences between angles. */
+        static float computeDistance(const float* angles, const float* sampleAngles, const float* weights);
+
+        /*! Computes the difference of azimuthal angles. */
+        static float wrapDifference(float diff);
+
+        const KdTree<4>& tree;
+        float angles[4];
+        float weights[4];
+    };
+
+    /*! Returns true if the index is consistent with samples. */
+    bool isIndexed() const;
+
+    /*!
+     * Returns true if the sample of \a index precedes the sample of \a otherIndex in the order of angles.
+     * Any sample precedes the index of -1.
+     */
+    bool isPreceding(int index, int otherIndex) const;
+
+    /*!
+     * Finds the sample preceding all others in the order of angles. This sample is used
+     * if no sample has a valid distance, e.g. for NaN angles. -1 is returned if no sample exists.
+     */
+    int findFirstSample() const;
+
+    /*! Converts angles to incoming and outgoing directions. */
+    static void toXyz(const AngleList& angles, Vec3* inDir, Vec3* outDir);
+
+    std::vector<int> indexedSamples_; /*!< The indices of samples sorted by angles. */
+
+    KdTree<6> directionTree_; /*!< The k-d tree of incoming and outgoing directions. */
+    KdTree<4> localAngleTree_; /*!< The k-d tree of angles in a local coordinate system. */
+
+    const std::type_info* localCoordSysType_; /*!< The local coordinate system of \a localAngleTree_. */
 };
 
+template <typename CoordSysT>
+inline RandomSampleSet<CoordSysT>::RandomSampleSet() : localCoordSysType_(0) {}
+
+template <typename CoordSysT>
+inline RandomSampleSet<CoordSysT>::RandomSampleSet(const RandomSampleSet& other)
+                                                   : sampleMap_(other.sampleMap_),
+                                                     localCoordSysType_(0) {}
+
+template <typename CoordSysT>
+inline RandomSampleSet<CoordSysT>& RandomSampleSet<CoordSysT>::operator=(const RandomSampleSet& other)
+{
+    if (this != &other) {
+        sampleMap_ = other.sampleMap_;
+        clearIndex();
+    }
+
+    return *this;
+}
+
 template <typename CoordSysT>
 inline typename RandomSampleSet<CoordSysT>::SampleMap& RandomSampleSet<CoordSysT>::getSampleMap()
 {
+    clearIndex();
     return sampleMap_;
 }
 
@@ -68,105 +195,381 @@ inline const typename RandomSampleSet<CoordSysT>::SampleMap& RandomSampleSet<Coo
 }
 
 template <typename CoordSysT>
-const Spectrum& RandomSampleSet<CoordSysT>::findSpectrumOfNearestSample(const AngleList& angles,
-                                                                        bool             reciprocity) const
+template <typename LocalCoordSysT>
+void RandomSampleSet<CoordSysT>::updateIndex()
 {
-    using std::acos;
+    clearIndex();
+
+    // Sort samples by angles so that ties of distances are resolved independently of insertion order.
+    indexedSamples_.resize(sampleMap_.size());
+    for (int i = 0; i < sampleMap_.size(); ++i) {
+        indexedSamples_[i] = i;
+    }
+
+    const std::vector<AngleList>& angleList = sampleMap_.getAngleList();
+    std::stable_sort(indexedSamples_.begin(), indexedSamples_.end(),
+                     [&angleList](int lhs, int rhs) { return angleList[lhs] < angleList[rhs]; });
+
+    std::vector<KdTree<6>::Point> directions;
+    std::vector<KdTree<4>::Point> localAngles;
+    directions.reserve(sampleMap_.size());
+    localAngles.reserve(sampleMap_.size());
+
+    for (auto it = indexedSamples_.begin(); it != indexedSamples_.end(); ++it) {
+        const AngleList& angles = angleList[*it];
+
+        Vec3 inDir, outDir;
+        toXyz(angles, &inDir, &outDir);
+
+        KdTree<6>::Point dirPoint = {{ inDir[0],  inDir[1],  inDir[2],
+                                       outDir[0], outDir[1], outDir[2] }};
 
-    const Spectrum* sp = 0;
+        KdTree<4>::Point anglePoint;
+        convertCoordinateSystem<CoordSysT, LocalCoordSysT>(
+            angles.at(0), angles.at(1), angles.at(2), angles.at(3),
+            &anglePoint[0], &anglePoint[1], &anglePoint[2], &anglePoint[3]);
+
+        directions.push_back(dirPoint);
+        localAngles.push_back(anglePoint);
+    }
+
+    directionTree_.build(directions);
+    localAngleTree_.build(localAngles);
+    localCoordSysType_ = &typeid(LocalCoordSysT);
+}
+
+template <typename CoordSysT>
+void RandomSampleSet<CoordSysT>::clearIndex()
+{
+    indexedSamples_.clear();
+    directionTree_.clear();
+    localAngleTree_.clear();
+    localCoordSysType_ = 0;
+}
 
+template <typename CoordSysT>
+ConstSpectrumMap RandomSampleSet<CoordSysT>::findSpectrumOfNearestSample(const AngleList& angles,
+                                                                         bool             reciprocity) const
+{
     Vec3 inDir, outDir;
-    CoordSysT::toXyz(angles.at(0), angles.at(1), angles.at(2), angles.at(3),
-                     &inDir, &outDir);
+    toXyz(angles, &inDir, &outDir);
+
+    if (isIndexed()) {
+        // The lower bound is compared with a tolerance since acos() of a float is inaccurate near zero.
+        DirectionDistance distance(directionTree_, inDir, outDir, reciprocity);
+        int index = directionTree_.findNearest(distance, 0.002f);
+        int sampleIndex = (index == -1) ? findFirstSample() : indexedSamples_.at(index);
+        return sampleMap_.getSpectrum(sampleIndex);
+    }
 
+    int nearestIndex = -1;
     Vec3::Scalar minAngleDiff = std::numeric_limits<Vec3::Scalar>::max();
 
-    for (auto it = sampleMap_.begin(); it != sampleMap_.end(); ++it) {
-        const AngleList& sampleAngles = it->first;
+    for (int i = 0; i < sampleMap_.size(); ++i) {
         Vec3 sampleInDir, sampleOutDir;
-        CoordSysT::toXyz(sampleAngles.at(0), sampleAngles.at(1), sampleAngles.at(2), sampleAngles.at(3),
-                         &sampleInDir, &sampleOutDir);
+        toXyz(sampleMap_.getAngles(i), &sampleInDir, &sampleOutDir);
+
+        Vec3::Scalar angleDiff = DirectionDistance::computeDistance(inDir, outDir,
+                                                                    sampleInDir, sampleOutDir,
+                                                                    reciprocity);
+
+        if (angleDiff < minAngleDiff ||
+            (angleDiff == minAngleDiff && isPreceding(i, nearestIndex))) {
+            minAngleDiff = angleDiff;
+            nearestIndex = i;
+        }
+    }
+
+    if (nearestIndex == -1) {
+        nearestIndex = findFirstSample();
+    }
 
-        Vec3::Scalar inAngle = acos(inDir.dot(sampleInDir));
-        Vec3::Scalar outAngle = acos(outDir.dot(sampleOutDir));
-        Vec3::Scalar angleDiff = inAngle + outAngle;
+    return sampleMap_.getSpectrum(nearestIndex);
+}
 
-        if (reciprocity) {
-            Vec3::Scalar inOutAngle = acos(inDir.dot(sampleOutDir));
-            Vec3::Scalar outInAngle = acos(outDir.dot(sampleInDir));
-            Vec3::Scalar angleUsingReciprocity = inOutAngle + outInAngle;
+template <typename CoordSysT>
+std::vector<int> RandomSampleSet<CoordSysT>::findNearestSamples(const AngleList&    angles,
+                                                                int                 k,
+                                                                bool                reciprocity) const
+{
+    Vec3 inDir, outDir;
+    toXyz(angles, &inDir, &outDir);
 
-            if (angleUsingReciprocity < angleDiff) {
-                angleDiff = angleUsingReciprocity;
+    std::vector<int> samples;
+
+    if (isIndexed()) {
+        DirectionDistance distance(directionTree_, inDir, outDir, reciprocity);
+        std::vector<int> indices = directionTree_.findNearest(distance, k, 0.002f);
+
+        samples.reserve(indices.size());
+        for (auto it = indices.begin(); it != indices.end(); ++it) {
+            samples.push_back(indexedSamples_.at(*it));
+        }
+    }
+    else {
+        std::vector<std::pair<float, int>> candidates;
+        candidates.reserve(sampleMap_.size());
+
+        for (int i = 0; i < sampleMap_.size(); ++i) {
+            Vec3 sampleInDir, sampleOutDir;
+            toXyz(sampleMap_.getAngles(i), &sampleInDir, &sampleOutDir);
+
+            float angleDiff = DirectionDistance::computeDistance(inDir, outDir,
+                                                                 sampleInDir, sampleOutDir,
+                                                                 reciprocity);
+            if (angleDiff == angleDiff) { // Not NaN
+                candidates.push_back(std::make_pair(angleDiff, i));
             }
         }
 
-        if (angleDiff == 0) {
-            return it->second;
-        }
-        else if (angleDiff < minAngleDiff) {
-            minAngleDiff = angleDiff;
-            sp = &it->second;
+        size_t numSamples = std::min(candidates.size(), static_cast<size_t>(std::max(k, 0)));
+        std::partial_sort(candidates.begin(), candidates.begin() + numSamples, candidates.end(),
+                          [this](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
+                              return (lhs.first < rhs.first ||
+                                      (lhs.first == rhs.first && isPreceding(lhs.second, rhs.second)));
+                          });
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            samples.push_back(candidates.at(i).second);
         }
     }
 
-    return *sp;
+    return samples;
 }
 
 template <typename CoordSysT>
 template <typename LocalCoordSysT>
-const Spectrum& RandomSampleSet<CoordSysT>::estimateSpectrum(const AngleList&   angles,
-                                                             float              weight0,
-                                                             float              weight1,
-                                                             float              weight2,
-                                                             float              weight3) const
+ConstSpectrumMap RandomSampleSet<CoordSysT>::estimateSpectrum(const AngleList&  angles,
+                                                              float             weight0,
+                                                              float             weight1,
+                                                              float             weight2,
+                                                              float             weight3) const
 {
     using std::abs;
 
-    float angle0, angle1, angle2, angle3;
+    float localAngles[4];
     convertCoordinateSystem<CoordSysT, LocalCoordSysT>(
         angles.at(0), angles.at(1), angles.at(2), angles.at(3),
-        &angle0, &angle1, &angle2, &angle3);
+        &localAngles[0], &localAngles[1], &localAngles[2], &localAngles[3]);
+
+    float weights[4] = { weight0, weight1, weight2, weight3 };
+
+    if (isIndexed() && *localCoordSysType_ == typeid(LocalCoordSysT)) {
+        // The tolerance absorbs rounding errors of weighted sums.
+        float tolerance = 1e-5f * (abs(weight0) + abs(weight1) + abs(weight2) + abs(weight3));
 
-    const Spectrum* sp = 0;
+        LocalAngleDistance distance(localAngleTree_, localAngles, weights);
+        int index = localAngleTree_.findNearest(distance, tolerance);
+        int sampleIndex = (index == -1) ? findFirstSample() : indexedSamples_.at(index);
+        return sampleMap_.getSpectrum(sampleIndex);
+    }
+
+    int nearestIndex = -1;
     float minAngleDiff = std::numeric_limits<float>::max();
 
-    for (auto it = sampleMap_.begin(); it != sampleMap_.end(); ++it) {
-        const AngleList& sampleAngles = it->first;
-        float sampleAngle0, sampleAngle1, sampleAngle2, sampleAngle3;
+    for (int i = 0; i < sampleMap_.size(); ++i) {
+        const AngleList& sampleAngles = sampleMap_.getAngles(i);
+        KdTree<4>::Point sampleLocalAngles;
         convertCoordinateSystem<CoordSysT, LocalCoordSysT>(
             sampleAngles.at(0), sampleAngles.at(1), sampleAngles.at(2), sampleAngles.at(3),
-            &sampleAngle0, &sampleAngle1, &sampleAngle2, &sampleAngle3);
+            &sampleLocalAngles[0], &sampleLocalAngles[1], &sampleLocalAngles[2], &sampleLocalAngles[3]);
 
-        float angle0Diff = abs(angle0 - sampleAngle0);
+        float angleDiff = LocalAngleDistance::computeDistance(localAngles, sampleLocalAngles.data(), weights);
 
-        float angle1Diff = abs(angle1 - sampleAngle1);
-        if (angle1Diff > PI_F) {
-            angle1Diff = TAU_F - angle1Diff;
+        if (angleDiff < minAngleDiff ||
+            (angleDiff == minAngleDiff && isPreceding(i, nearestIndex))) {
+            minAngleDiff = angleDiff;
+            nearestIndex = i;
         }
+    }
+
+    if (nearestIndex == -1) {
+        nearestIndex = findFirstSample();
+    }
+
+    return sampleMap_.getSpectrum(nearestIndex);
+}
+
+template <typename CoordSysT>
+inline RandomSampleSet<CoordSysT>::DirectionDistance::DirectionDistance(const KdTree<6>&    tree,
+                                                                        const Vec3&         inDir,
+                                                                        const Vec3&         outDir,
+                                                                        bool                reciprocity)
+                                                                        : tree(tree),
+                                                                          inDir(inDir),
+                                                                          outDir(outDir),
+                                                                          reciprocity(reciprocity) {}
+
+template <typename CoordSysT>
+inline float RandomSampleSet<CoordSysT>::DirectionDistance::operator()(int index) const
+{
+    const KdTree<6>::Point& pt = tree.getPoint(index);
+    Vec3 sampleInDir(pt[0], pt[1], pt[2]);
+    Vec3 sampleOutDir(pt[3], pt[4], pt[5]);
+
+    return computeDistance(inDir, outDir, sampleInDir, sampleOutDir, reciprocity);
+}
+
+template <typename CoordSysT>
+inline float RandomSampleSet<CoordSysT>::DirectionDistance::operator()(const float* lower,
+                                                                      const float* upper) const
+{
+    float bound = computeAngleBound(inDir, lower, upper) + computeAngleBound(outDir, lower + 3, upper + 3);
+
+    if (reciprocity) {
+        float boundUsingReciprocity = computeAngleBound(inDir, lower + 3, upper + 3)
+                                    + computeAngleBound(outDir, lower, upper);
+        bound = std::min(bound, boundUsingReciprocity);
+    }
+
+    return bound;
+}
+
+template <typename CoordSysT>
+inline float RandomSampleSet<CoordSysT>::DirectionDistance::computeDistance(const Vec3& inDir,
+                                                                            const Vec3& outDir,
+                                                                            const Vec3& sampleInDir,
+                                                                            const Vec3& sampleOutDir,
+                                                                            bool        reciprocity)
+{
+    using std::acos;
 
-        float angle2Diff = abs(angle2 - sampleAngle2);
+    Vec3::Scalar inAngle = acos(inDir.dot(sampleInDir));
+    Vec3::Scalar outAngle = acos(outDir.dot(sampleOutDir));
+    Vec3::Scalar angleDiff = inAngle + outAngle;
 
-        float angle3Diff = abs(angle3 - sampleAngle3);
-        if (angle3Diff > PI_F) {
-            angle3Diff = TAU_F - angle3Diff;
+    if (reciprocity) {
+        Vec3::Scalar inOutAngle = acos(inDir.dot(sampleOutDir));
+        Vec3::Scalar outInAngle = acos(outDir.dot(sampleInDir));
+        Vec3::Scalar angleUsingReciprocity = inOutAngle + outInAngle;
+
+        if (angleUsingReciprocity < angleDiff) {
+            angleDiff = angleUsingReciprocity;
         }
+    }
+
+    return angleDiff;
+}
+
+template <typename CoordSysT>
+inline float RandomSampleSet<CoordSysT>::DirectionDistance::computeAngleBound(const Vec3&   dir,
+                                                                              const float*  lower,
+                                                                              const float*  upper)
+{
+    float sqDist = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        float diff = std::max(lower[i] - dir[i], 0.0f) + std::max(dir[i] - upper[i], 0.0f);
+        sqDist += diff * diff;
+    }
+
+    // The angle subtended by a chord of a unit circle.
+    float halfChord = std::min(std::sqrt(sqDist) / 2.0f, 1.0f);
+    return 2.0f * std::asin(halfChord);
+}
+
+template <typename CoordSysT>
+inline RandomSampleSet<CoordSysT>::LocalAngleDistance::LocalAngleDistance(const KdTree<4>&  tree,
+                                                                          const float*      angles,
+                                                                          const float*      weights)
+                                                                          : tree(tree)
+{
+    std::copy(angles, angles + 4, this->angles);
+    std::copy(weights, weights + 4, this->weights);
+}
+
+template <typename CoordSysT>
+inline float RandomSampleSet<CoordSysT>::LocalAngleDistance::operator()(int index) const
+{
+    return computeDistance(angles, tree.getPoint(index).data(), weights);
+}
+
+template <typename CoordSysT>
+inline float RandomSampleSet<CoordSysT>::LocalAngleDistance::operator()(const float* lower,
+                                                                       const float* upper) const
+{
+    using std::abs;
 
-        float angleDiff = weight0 * angle0Diff
-                        + weight1 * angle1Diff
-                        + weight2 * angle2Diff
-                        + weight3 * angle3Diff;
+    float bound = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        if (angles[i] >= lower[i] && angles[i] <= upper[i]) continue;
 
-        if (angleDiff == 0.0f) {
-            return it->second;
+        float minDiff = std::min(abs(angles[i] - lower[i]), abs(angles[i] - upper[i]));
+
+        float diff;
+        if (i == 1 || i == 3) {
+            // The difference of azimuthal angles increases up to pi and then decreases.
+            float maxDiff = std::max(abs(angles[i] - lower[i]), abs(angles[i] - upper[i]));
+            diff = std::min(wrapDifference(minDiff), wrapDifference(maxDiff));
         }
-        else if (angleDiff < minAngleDiff) {
-            minAngleDiff = angleDiff;
-            sp = &it->second;
+        else {
+            diff = minDiff;
         }
+
+        bound += weights[i] * diff;
     }
 
-    return *sp;
+    return bound;
+}
+
+template <typename CoordSysT>
+inline float RandomSampleSet<CoordSysT>::LocalAngleDistance::computeDistance(const float* angles,
+                                                                            const float* sampleAngles,
+                                                                            const float* weights)
+{
+    using std::abs;
+
+    float angle0Diff = abs(angles[0] - sampleAngles[0]);
+    float angle1Diff = wrapDifference(abs(angles[1] - sampleAngles[1]));
+    float angle2Diff = abs(angles[2] - sampleAngles[2]);
+    float angle3Diff = wrapDifference(abs(angles[3] - sampleAngles[3]));
+
+    return weights[0] * angle0Diff
+         + weights[1] * angle1Diff
+         + weights[2] * angle2Diff
+         + weights[3] * angle3Diff;
+}
+
+template <typename CoordSysT>
+inline float RandomSampleSet<CoordSysT>::LocalAngleDistance::wrapDifference(float diff)
+{
+    return (diff > PI_F) ? TAU_F - diff : diff;
+}
+
+template <typename CoordSysT>
+inline bool RandomSampleSet<CoordSysT>::isIndexed() const
+{
+    return (!directionTree_.isEmpty() &&
+            indexedSamples_.size() == static_cast<size_t>(sampleMap_.size()));
+}
+
+template <typename CoordSysT>
+inline bool RandomSampleSet<CoordSysT>::isPreceding(int index, int otherIndex) const
+{
+    return (otherIndex == -1 ||
+            sampleMap_.getAngles(index) < sampleMap_.getAngles(otherIndex));
+}
+
+template <typename CoordSysT>
+int RandomSampleSet<CoordSysT>::findFirstSample() const
+{
+    if (isIndexed()) {
+        return indexedSamples_.empty() ? -1 : indexedSamples_.front();
+    }
+
+    int firstIndex = -1;
+    for (int i = 0; i < sampleMap_.size(); ++i) {
+        if (isPreceding(i, firstIndex)) {
+            firstIndex = i;
+        }
+    }
+
+    return firstIndex;
+}
+
+template <typename CoordSysT>
+inline void RandomSampleSet<CoordSysT>::toXyz(const AngleList& angles, Vec3* inDir, Vec3* outDir)
+{
+    CoordSysT::toXyz(angles.at(0), angles.at(1), angles.at(2), angles.at(3), inDir, outDir);
 }
 
 } // namespace lb
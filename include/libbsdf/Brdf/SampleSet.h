@@ -10,8 +10,10 @@
 #define LIBBSDF_SAMPLE_SET_H
 
 #include <cassert>
+#include <stdexcept>
 
 #include <libbsdf/Common/Array.h>
+#include <libbsdf/Common/BoundsTable.h>
 
 namespace lb {
 
@@ -29,6 +31,9 @@ namespace lb {
  *   - \a angle3 (e.g. outgoing azimuthal angle of a spherical coordinate system)
  *
  * \a angle1 is not used for isotropic BRDFs.
+ *
+ * Spectra of all sample points are stored in a contiguous buffer, and
+ * getSpectrum() returns a view of the spectrum in the buffer.
  */
 class SampleSet
 {
@@ -45,51 +50,86 @@ public:
               int           numWavelengths = 3);
 
     /*! Gets the spectrum at a set of angle indices. */
-    Spectrum& getSpectrum(int index0,
-                          int index1,
-                          int index2,
-                          int index3);
+    SpectrumMap getSpectrum(int index0,
+                            int index1,
+                            int index2,
+                            int index3);
 
     /*! Gets the spectrum at a set of angle indices of isotropic data. */
-    Spectrum& getSpectrum(int index0,
-                          int index2,
-                          int index3);
+    SpectrumMap getSpectrum(int index0,
+                            int index2,
+                            int index3);
 
     /*! Gets the spectrum at a set of angle indices. */
-    const Spectrum& getSpectrum(int index0,
-                                int index1,
-                                int index2,
-                                int index3) const;
+    ConstSpectrumMap getSpectrum(int index0,
+                                 int index1,
+                                 int index2,
+                                 int index3) const;
 
     /*! Gets the spectrum at a set of angle indices of isotropic data. */
-    const Spectrum& getSpectrum(int index0,
-                                int index2,
-                                int index3) const;
+    ConstSpectrumMap getSpectrum(int index0,
+                                 int index2,
+                                 int index3) const;
+
+    /*!
+     * Gets the spectrum at a set of angle indices with a compile-time number of wavelengths.
+     * \a NumWavelengths must be Eigen::Dynamic or equal to getNumWavelengths().
+     */
+    template <int NumWavelengths>
+    ConstFixedSpectrumMap<NumWavelengths> getFixedSpectrum(int index0,
+                                                           int index1,
+                                                           int index2,
+                                                           int index3) const;
+
+    /*! Gets the spectrum of isotropic data with a compile-time number of wavelengths. \sa getFixedSpectrum() */
+    template <int NumWavelengths>
+    ConstFixedSpectrumMap<NumWavelengths> getFixedSpectrum(int index0,
+                                                           int index2,
+                                                           int index3) const;
 
     /*! Gets the spectrum at an index. */
-    Spectrum& getSpectrum(int index);
+    SpectrumMap getSpectrum(size_t index);
 
     /*! Gets the spectrum at an index. */
-    const Spectrum& getSpectrum(int index) const;
+    ConstSpectrumMap getSpectrum(size_t index) const;
 
-    /*! Sets the spectrum at a set of angle indices. */
+    /*!
+     * Sets the spectrum at a set of angle indices.
+     * std::out_of_range is thrown if the indices are out of range, and std::invalid_argument is
+     * thrown if the size of \a spectrum is not equal to the number of wavelengths.
+     */
     void setSpectrum(int                index0,
                      int                index1,
                      int                index2,
                      int                index3,
                      const Spectrum&    spectrum);
 
-    /*! Sets the spectrum at a set of angle indices of isotropic data. */
+    /*!
+     * Sets the spectrum at a set of angle indices of isotropic data.
+     * The same exceptions as the anisotropic version are thrown.
+     */
     void setSpectrum(int                index0,
                      int                index2,
                      int                index3,
                      const Spectrum&    spectrum);
 
-    /*! Gets all spectra. */
-    SpectrumList& getSpectra();
+    /*!
+     * Gets all spectra.
+     * The spectrum of a sample point is stored in the column at the index of the sample point.
+     */
+    SpectrumArray& getSpectra();
 
     /*! Gets all spectra. */
-    const SpectrumList& getSpectra() const;
+    const SpectrumArray& getSpectra() const;
+
+    /*! Gets the number of sample points. */
+    size_t getNumSamples() const;
+
+    /*! Gets the index of the spectrum from a set of angle indices. */
+    size_t getIndex(int index0,
+                    int index1,
+                    int index2,
+                    int index3) const;
 
     float getAngle0(int index) const; /*!< Gets the angle0 at an index. */
     float getAngle1(int index) const; /*!< Gets the angle1 at an index. */
@@ -121,6 +161,15 @@ public:
     bool isEqualIntervalAngles2() const; /*!< Returns true if angles2 are set at equal intervals. */
     bool isEqualIntervalAngles3() const; /*!< Returns true if angles3 are set at equal intervals. */
 
+    /*!
+     * Gets the lookup table to find bounds of angles0 in constant time.
+     * The table is built by updateAngleAttributes().
+     */
+    const BoundsTable& getBoundsTable0() const;
+    const BoundsTable& getBoundsTable1() const; /*!< Gets the lookup table of angles1. \sa getBoundsTable0() */
+    const BoundsTable& getBoundsTable2() const; /*!< Gets the lookup table of angles2. \sa getBoundsTable0() */
+    const BoundsTable& getBoundsTable3() const; /*!< Gets the lookup table of angles3. \sa getBoundsTable0() */
+
     /*! Gets the color model. */
     ColorModel getColorModel() const;
 
@@ -177,12 +226,6 @@ public:
     void resizeWavelengths(int numWavelengths);
 
 private:
-    /*! Gets the index of the spectrum from a set of angle indices. */
-    size_t getIndex(int index0,
-                    int index1,
-                    int index2,
-                    int index3) const;
-
     /*! Gets the index of the spectrum from a set of angle indices of isotropic data. */
     size_t getIndex(int index0,
                     int index2,
@@ -191,13 +234,20 @@ private:
     /*! Updates the attributes whether angles are set at equal intervals. */
     void updateEqualIntervalAngles();
 
+    /*! Updates lookup tables to find bounds of angles. */
+    void updateBoundsTables();
+
     /*! Distinguishes the attributes whether sample points are containd in one side of the plane of incidence. */
     bool distinguishOneSide() const;
 
     /*! Updates the attributes whether sample points are containd in one side of the plane of incidence. */
     void updateOneSide();
 
-    SpectrumList spectra_; /*!< The list of spectrum for each pair of incoming and outgoing directions. */
+    /*!
+     * The contiguous spectra for each pair of incoming and outgoing directions.
+     * The number of rows is the number of wavelengths, and the number of columns is the number of sample points.
+     */
+    SpectrumArray spectra_;
 
     Arrayf angles0_; /*!< The array of angle0. */
     Arrayf angles1_; /*!< The array of angle1. */
@@ -209,6 +259,11 @@ private:
     bool equalIntervalAngles2_; /*!< This attribute holds whether angles2 are set at equal intervals. */
     bool equalIntervalAngles3_; /*!< This attribute holds whether angles3 are set at equal intervals. */
 
+    BoundsTable boundsTable0_; /*!< The lookup table to find bounds of angles0. */
+    BoundsTable boundsTable1_; /*!< The lookup table to find bounds of angles1. */
+    BoundsTable boundsTable2_; /*!< The lookup table to find bounds of angles2. */
+    BoundsTable boundsTable3_; /*!< The lookup table to find bounds of angles3. */
+
     ColorModel colorModel_; /*!< The color model of spectra. */
 
     Arrayf wavelengths_; /*!< The array of wavelengths. */
@@ -217,38 +272,70 @@ private:
     bool oneSide_;
 };
 
-inline Spectrum& SampleSet::getSpectrum(int index0,
-                                        int index1,
-                                        int index2,
-                                        int index3)
+inline SpectrumMap SampleSet::getSpectrum(int index0,
+                                          int index1,
+                                          int index2,
+                                          int index3)
+{
+    return getSpectrum(getIndex(index0, index1, index2, index3));
+}
+
+inline SpectrumMap SampleSet::getSpectrum(int index0,
+                                          int index2,
+                                          int index3)
+{
+    return getSpectrum(getIndex(index0, index2, index3));
+}
+
+inline ConstSpectrumMap SampleSet::getSpectrum(int index0,
+                                               int index1,
+                                               int index2,
+                                               int index3) const
+{
+    return getSpectrum(getIndex(index0, index1, index2, index3));
+}
+
+inline ConstSpectrumMap SampleSet::getSpectrum(int index0,
+                                               int index2,
+                                               int index3) const
 {
-    return spectra_.at(getIndex(index0, index1, index2, index3));
+    return getSpectrum(getIndex(index0, index2, index3));
 }
 
-inline Spectrum& SampleSet::getSpectrum(int index0,
-                                        int index2,
-                                        int index3)
+template <int NumWavelengths>
+inline ConstFixedSpectrumMap<NumWavelengths> SampleSet::getFixedSpectrum(int index0,
+                                                                         int index1,
+                                                                         int index2,
+                                                                         int index3) const
 {
-    return spectra_.at(getIndex(index0, index2, index3));
+    assert(NumWavelengths == Eigen::Dynamic || NumWavelengths == spectra_.rows());
+
+    size_t index = getIndex(index0, index1, index2, index3);
+    return ConstFixedSpectrumMap<NumWavelengths>(spectra_.data() + spectra_.rows() * index, spectra_.rows());
 }
 
-inline const Spectrum& SampleSet::getSpectrum(int index0,
-                                              int index1,
-                                              int index2,
-                                              int index3) const
+template <int NumWavelengths>
+inline ConstFixedSpectrumMap<NumWavelengths> SampleSet::getFixedSpectrum(int index0,
+                                                                         int index2,
+                                                                         int index3) const
 {
-    return spectra_.at(getIndex(index0, index1, index2, index3));
+    assert(NumWavelengths == Eigen::Dynamic || NumWavelengths == spectra_.rows());
+
+    size_t index = getIndex(index0, index2, index3);
+    return ConstFixedSpectrumMap<NumWavelengths>(spectra_.data() + spectra_.rows() * index, spectra_.rows());
 }
 
-inline const Spectrum& SampleSet::getSpectrum(int index0,
-                                              int index2,
-                                              int index3) const
+inline SpectrumMap SampleSet::getSpectrum(size_t index)
 {
-    return spectra_.at(getIndex(index0, index2, index3));
+    assert(index < static_cast<size_t>(spectra_.cols()));
+    return SpectrumMap(spectra_.data() + spectra_.rows() * index, spectra_.rows());
 }
 
-inline       Spectrum& SampleSet::getSpectrum(int index)       { return spectra_.at(index); }
-inline const Spectrum& SampleSet::getSpectrum(int index) const { return spectra_.at(index); }
+inline ConstSpectrumMap SampleSet::getSpectrum(size_t index) const
+{
+    assert(index < static_cast<size_t>(spectra_.cols()));
+    return ConstSpectrumMap(spectra_.data() + spectra_.rows() * index, spectra_.rows());
+}
 
 inline void SampleSet::setSpectrum(int              index0,
                                    int              index1,
@@ -256,7 +343,18 @@ inline void SampleSet::setSpectrum(int              index0,
                                    int              index3,
                                    const Spectrum&  spectrum)
 {
-    spectra_.at(getIndex(index0, index1, index2, index3)) = spectrum;
+    if (index0 < 0 || index0 >= angles0_.size() ||
+        index1 < 0 || index1 >= angles1_.size() ||
+        index2 < 0 || index2 >= angles2_.size() ||
+        index3 < 0 || index3 >= angles3_.size()) {
+        throw std::out_of_range("lb::SampleSet::setSpectrum: index out of range");
+    }
+
+    if (spectrum.size() != spectra_.rows()) {
+        throw std::invalid_argument("lb::SampleSet::setSpectrum: invalid number of wavelengths");
+    }
+
+    getSpectrum(index0, index1, index2, index3) = spectrum;
 }
 
 inline void SampleSet::setSpectrum(int              index0,
@@ -264,11 +362,23 @@ inline void SampleSet::setSpectrum(int              index0,
                                    int              index3,
                                    const Spectrum&  spectrum)
 {
-    spectra_.at(getIndex(index0, index2, index3)) = spectrum;
+    if (index0 < 0 || index0 >= angles0_.size() ||
+        index2 < 0 || index2 >= angles2_.size() ||
+        index3 < 0 || index3 >= angles3_.size()) {
+        throw std::out_of_range("lb::SampleSet::setSpectrum: index out of range");
+    }
+
+    if (spectrum.size() != spectra_.rows()) {
+        throw std::invalid_argument("lb::SampleSet::setSpectrum: invalid number of wavelengths");
+    }
+
+    getSpectrum(index0, index2, index3) = spectrum;
 }
 
-inline       SpectrumList& SampleSet::getSpectra()       { return spectra_; }
-inline const SpectrumList& SampleSet::getSpectra() const { return spectra_; }
+inline       SpectrumArray& SampleSet::getSpectra()       { return spectra_; }
+inline const SpectrumArray& SampleSet::getSpectra() const { return spectra_; }
+
+inline size_t SampleSet::getNumSamples() const { return static_cast<size_t>(spectra_.cols()); }
 
 inline float SampleSet::getAngle0(int index) const { return angles0_[index]; }
 inline float SampleSet::getAngle1(int index) const { return angles1_[index]; }
@@ -319,6 +429,11 @@ inline bool SampleSet::isEqualIntervalAngles1() const { return equalIntervalAngl
 inline bool SampleSet::isEqualIntervalAngles2() const { return equalIntervalAngles2_; }
 inline bool SampleSet::isEqualIntervalAngles3() const { return equalIntervalAngles3_; }
 
+inline const BoundsTable& SampleSet::getBoundsTable0() const { return boundsTable0_; }
+inline const BoundsTable& SampleSet::getBoundsTable1() const { return boundsTable1_; }
+inline const BoundsTable& SampleSet::getBoundsTable2() const { return boundsTable2_; }
+inline const BoundsTable& SampleSet::getBoundsTable3() const { return boundsTable3_; }
+
 inline ColorModel SampleSet::getColorModel() const { return colorModel_; }
 
 inline void SampleSet::setColorModel(ColorModel colorModel)
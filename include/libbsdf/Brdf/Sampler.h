@@ -23,12 +23,15 @@ namespace lb {
 class Sampler
 {
 public:
-    /*! Gets the interpolated spectrum of sample points at incoming and outgoing directions. */
-    template <typename CoordSysT, typename InterpolatorT>
+    /*!
+     * Gets the interpolated spectrum of sample points at incoming and outgoing directions.
+     * \a SpectrumT is lb::Spectrum or lb::FixedSpectrum supported by \a InterpolatorT.
+     */
+    template <typename CoordSysT, typename InterpolatorT, typename SpectrumT>
     static void getSpectrum(const SampleSet&    samples,
                             const Vec3&         inDir,
                             const Vec3&         outDir,
-                            Spectrum*           spectrum);
+                            SpectrumT*          spectrum);
 
     /*!
      * Gets the interpolated value of sample points at incoming and outgoing directions
@@ -40,12 +43,15 @@ public:
                           const Vec3&       outDir,
                           int               wavelengthIndex);
 
-    /*! Gets the interpolated spectrum of sample points at incoming and outgoing directions. */
-    template <typename InterpolatorT>
+    /*!
+     * Gets the interpolated spectrum of sample points at incoming and outgoing directions.
+     * \a SpectrumT is lb::Spectrum or lb::FixedSpectrum supported by \a InterpolatorT.
+     */
+    template <typename InterpolatorT, typename SpectrumT>
     static void getSpectrum(const Brdf& brdf,
                             const Vec3& inDir,
                             const Vec3& outDir,
-                            Spectrum*   spectrum);
+                            SpectrumT*  spectrum);
 
     /*!
      * Gets the interpolated value of sample points at incoming and outgoing directions
@@ -78,11 +84,11 @@ private:
                         float* angle0, float* angle1, float* angle2, float* angle3);
 };
 
-template <typename CoordSysT, typename InterpolatorT>
+template <typename CoordSysT, typename InterpolatorT, typename SpectrumT>
 inline void Sampler::getSpectrum(const SampleSet&   samples,
                                  const Vec3&        inDir,
                                  const Vec3&        outDir,
-                                 Spectrum*          spectrum)
+                                 SpectrumT*         spectrum)
 {
     assert(inDir.z() >= 0.0);
 
@@ -116,11 +122,11 @@ inline float Sampler::getValue(const SampleSet& samples,
     }
 }
 
-template <typename InterpolatorT>
+template <typename InterpolatorT, typename SpectrumT>
 inline void Sampler::getSpectrum(const Brdf&    brdf,
                                  const Vec3&    inDir,
                                  const Vec3&    outDir,
-                                 Spectrum*      spectrum)
+                                 SpectrumT*     spectrum)
 {
     assert(inDir.z() >= 0.0);
 
@@ -90,9 +90,28 @@ public:
     /*! Gets the spectrum of the BRDF at incoming and outgoing directions. */
     virtual Spectrum getSpectrum(const Vec3& inDir, const Vec3& outDir) const;
 
+    /*! Gets the spectrum of the BRDF without dynamic memory allocation. \sa CoordinatesBrdf::getSpectrum() */
+    template <int NumWavelengths>
+    void getSpectrum(const Vec3&                    inDir,
+                     const Vec3&                    outDir,
+                     FixedSpectrum<NumWavelengths>* spectrum) const;
+
     /*! Gets the value of the BRDF at incoming and outgoing directions and the index of wavelength. */
     virtual float getValue(const Vec3& inDir, const Vec3& outDir, int wavelengthIndex) const;
 
+    /*! Gets the spectra of the BRDF at arrays of incoming and outgoing directions. \sa Brdf::getSpectra() */
+    virtual void getSpectra(const Vec3* inDirs,
+                            const Vec3* outDirs,
+                            size_t      numDirs,
+                            float*      spectra) const;
+
+    /*! Gets the values of the BRDF at arrays of incoming and outgoing directions. \sa Brdf::getValues() */
+    virtual void getValues(const Vec3*  inDirs,
+                           const Vec3*  outDirs,
+                           size_t       numDirs,
+                           int          wavelengthIndex,
+                           float*       values) const;
+
     /*!
      * Computes incoming and outgoing directions of a Cartesian coordinate system
      * using a set of angle indices.
@@ -126,26 +145,26 @@ public:
                          float specPhi) const;
 
     /*! Gets the spectrum of the BRDF at a set of angle indices. */
-    Spectrum& getSpectrum(int inThetaIndex,
-                          int inPhiIndex,
-                          int specThetaIndex,
-                          int specPhiIndex);
+    SpectrumMap getSpectrum(int inThetaIndex,
+                            int inPhiIndex,
+                            int specThetaIndex,
+                            int specPhiIndex);
 
     /*! Gets the spectrum of the BRDF at a set of angle indices. */
-    const Spectrum& getSpectrum(int inThetaIndex,
-                                int inPhiIndex,
-                                int specThetaIndex,
-                                int specPhiIndex) const;
+    ConstSpectrumMap getSpectrum(int inThetaIndex,
+                                 int inPhiIndex,
+                                 int specThetaIndex,
+                                 int specPhiIndex) const;
 
     /*! Gets the spectrum of the isotropic BRDF at a set of angle indices. */
-    Spectrum& getSpectrum(int inThetaIndex,
-                          int specThetaIndex,
-                          int specPhiIndex);
+    SpectrumMap getSpectrum(int inThetaIndex,
+                            int specThetaIndex,
+                            int specPhiIndex);
 
     /*! Gets the spectrum of the isotropic BRDF at a set of angle indices. */
-    const Spectrum& getSpectrum(int inThetaIndex,
-                                int specThetaIndex,
-                                int specPhiIndex) const;
+    ConstSpectrumMap getSpectrum(int inThetaIndex,
+                                 int specThetaIndex,
+                                 int specPhiIndex) const;
 
     /*! Sets the spectrum of the BRDF at a set of angle indices. */
     void setSpectrum(int                inThetaIndex,
@@ -265,6 +284,27 @@ inline Spectrum SpecularCoordinatesBrdf::getSpectrum(const Vec3& inDir, const Ve
     return sp;
 }
 
+template <int NumWavelengths>
+inline void SpecularCoordinatesBrdf::getSpectrum(const Vec3&                    inDir,
+                                                 const Vec3&                    outDir,
+                                                 FixedSpectrum<NumWavelengths>* spectrum) const
+{
+    if (specularOffsets_.size() == 0) {
+        BaseBrdf::getSpectrum(inDir, outDir, spectrum);
+        return;
+    }
+
+    float inTheta, inPhi, specTheta, specPhi;
+    fromXyz(inDir, outDir, &inTheta, &inPhi, &specTheta, &specPhi);
+
+    if (samples_->isIsotropic()) {
+        LinearInterpolator::getSpectrum(*samples_, inTheta, specTheta, specPhi, spectrum);
+    }
+    else {
+        LinearInterpolator::getSpectrum(*samples_, inTheta, inPhi, specTheta, specPhi, spectrum);
+    }
+}
+
 inline float SpecularCoordinatesBrdf::getValue(const Vec3& inDir, const Vec3& outDir, int wavelengthIndex) const
 {
     if (specularOffsets_.size() == 0) {
@@ -282,6 +322,33 @@ inline float SpecularCoordinatesBrdf::getValue(const Vec3& inDir, const Vec3& ou
     }
 }
 
+inline void SpecularCoordinatesBrdf::getSpectra(const Vec3*    inDirs,
+                                                const Vec3*    outDirs,
+                                                size_t         numDirs,
+                                                float*         spectra) const
+{
+    if (specularOffsets_.size() == 0) {
+        BaseBrdf::getSpectra(inDirs, outDirs, numDirs, spectra);
+    }
+    else {
+        Brdf::getSpectra(inDirs, outDirs, numDirs, spectra);
+    }
+}
+
+inline void SpecularCoordinatesBrdf::getValues(const Vec3*     inDirs,
+                                               const Vec3*     outDirs,
+                                               size_t          numDirs,
+                                               int             wavelengthIndex,
+                                               float*          values) const
+{
+    if (specularOffsets_.size() == 0) {
+        BaseBrdf::getValues(inDirs, outDirs, numDirs, wavelengthIndex, values);
+    }
+    else {
+        Brdf::getValues(inDirs, outDirs, numDirs, wavelengthIndex, values);
+    }
+}
+
 inline void SpecularCoordinatesBrdf::getInOutDirection(int      index0,
                                                        int      index1,
                                                        int      index2,
@@ -342,34 +409,34 @@ inline Spectrum SpecularCoordinatesBrdf::getSpectrum(float inTheta,
     return sp;
 }
 
-inline Spectrum& SpecularCoordinatesBrdf::getSpectrum(int inThetaIndex,
-                                                      int inPhiIndex,
-                                                      int specThetaIndex,
-                                                      int specPhiIndex)
+inline SpectrumMap SpecularCoordinatesBrdf::getSpectrum(int inThetaIndex,
+                                                        int inPhiIndex,
+                                                        int specThetaIndex,
+                                                        int specPhiIndex)
 {
     return samples_->getSpectrum(inThetaIndex, inPhiIndex, specThetaIndex, specPhiIndex);
 }
 
-inline const Spectrum& SpecularCoordinatesBrdf::getSpectrum(int inThetaIndex,
-                                                            int inPhiIndex,
-                                                            int specThetaIndex,
-                                                            int specPhiIndex) const
+inline ConstSpectrumMap SpecularCoordinatesBrdf::getSpectrum(int inThetaIndex,
+                                                             int inPhiIndex,
+                                                             int specThetaIndex,
+                                                             int specPhiIndex) const
 {
-    return samples_->getSpectrum(inThetaIndex, inPhiIndex, specThetaIndex, specPhiIndex);
+    return getSampleSet()->getSpectrum(inThetaIndex, inPhiIndex, specThetaIndex, specPhiIndex);
 }
 
-inline Spectrum& SpecularCoordinatesBrdf::getSpectrum(int inThetaIndex,
-                                                      int specThetaIndex,
-                                                      int specPhiIndex)
+inline SpectrumMap SpecularCoordinatesBrdf::getSpectrum(int inThetaIndex,
+                                                        int specThetaIndex,
+                                                        int specPhiIndex)
 {
     return samples_->getSpectrum(inThetaIndex, specThetaIndex, specPhiIndex);
 }
 
-inline const Spectrum&  SpecularCoordinatesBrdf::getSpectrum(int inThetaIndex,
+inline ConstSpectrumMap SpecularCoordinatesBrdf::getSpectrum(int inThetaIndex,
                                                              int specThetaIndex,
                                                              int specPhiIndex) const
 {
-    return samples_->getSpectrum(inThetaIndex, specThetaIndex, specPhiIndex);
+    return getSampleSet()->getSpectrum(inThetaIndex, specThetaIndex, specPhiIndex);
 }
 
 inline void SpecularCoordinatesBrdf::setSpectrum(int                inThetaIndex,
@@ -426,7 +493,7 @@ inline float SpecularCoordinatesBrdf::getSpecularOffset(float inTheta) const
     float lowerAngle0;
     float upperAngle0;
 
-    findBounds(samples_->getAngles0(), inTheta, samples_->isEqualIntervalAngles0(),
+    findBounds(samples_->getAngles0(), inTheta, samples_->isEqualIntervalAngles0(), samples_->getBoundsTable0(),
                &lIdx0, &uIdx0, &lowerAngle0, &upperAngle0);
 
     float interval = std::max(upperAngle0 - lowerAngle0, EPSILON_F);
@@ -73,26 +73,26 @@ public:
                          float outPhi) const;
 
     /*! Gets the spectrum of the BRDF at a set of angle indices. */
-    Spectrum& getSpectrum(int inThetaIndex,
-                          int inPhiIndex,
-                          int outThetaIndex,
-                          int outPhiIndex);
+    SpectrumMap getSpectrum(int inThetaIndex,
+                            int inPhiIndex,
+                            int outThetaIndex,
+                            int outPhiIndex);
 
     /*! Gets the spectrum of the BRDF at a set of angle indices. */
-    const Spectrum& getSpectrum(int inThetaIndex,
-                                int inPhiIndex,
-                                int outThetaIndex,
-                                int outPhiIndex) const;
+    ConstSpectrumMap getSpectrum(int inThetaIndex,
+                                 int inPhiIndex,
+                                 int outThetaIndex,
+                                 int outPhiIndex) const;
 
     /*! Gets the spectrum of the isotropic BRDF at a set of angle indices. */
-    Spectrum& getSpectrum(int inThetaIndex,
-                          int outThetaIndex,
-                          int outPhiIndex);
+    SpectrumMap getSpectrum(int inThetaIndex,
+                            int outThetaIndex,
+                            int outPhiIndex);
 
     /*! Gets the spectrum of the isotropic BRDF at a set of angle indices. */
-    const Spectrum& getSpectrum(int inThetaIndex,
-                                int outThetaIndex,
-                                int outPhiIndex) const;
+    ConstSpectrumMap getSpectrum(int inThetaIndex,
+                                 int outThetaIndex,
+                                 int outPhiIndex) const;
 
     /*! Sets the spectrum of the BRDF at a set of angle indices. */
     void setSpectrum(int                inThetaIndex,
@@ -141,34 +141,34 @@ inline Spectrum SphericalCoordinatesBrdf::getSpectrum(float inTheta,
     return sp;
 }
 
-inline Spectrum& SphericalCoordinatesBrdf::getSpectrum(int inThetaIndex,
-                                                       int inPhiIndex,
-                                                       int outThetaIndex,
-                                                       int outPhiIndex)
+inline SpectrumMap SphericalCoordinatesBrdf::getSpectrum(int inThetaIndex,
+                                                         int inPhiIndex,
+                                                         int outThetaIndex,
+                                                         int outPhiIndex)
 {
     return samples_->getSpectrum(inThetaIndex, inPhiIndex, outThetaIndex, outPhiIndex);
 }
 
-inline const Spectrum& SphericalCoordinatesBrdf::getSpectrum(int inThetaIndex,
-                                                             int inPhiIndex,
-                                                             int outThetaIndex,
-                                                             int outPhiIndex) const
+inline ConstSpectrumMap SphericalCoordinatesBrdf::getSpectrum(int inThetaIndex,
+                                                              int inPhiIndex,
+                                                              int outThetaIndex,
+                                                              int outPhiIndex) const
 {
-    return samples_->getSpectrum(inThetaIndex, inPhiIndex, outThetaIndex, outPhiIndex);
+    return getSampleSet()->getSpectrum(inThetaIndex, inPhiIndex, outThetaIndex, outPhiIndex);
 }
 
-inline Spectrum& SphericalCoordinatesBrdf::getSpectrum(int inThetaIndex,
-                                                       int outThetaIndex,
-                                                       int outPhiIndex)
+inline SpectrumMap SphericalCoordinatesBrdf::getSpectrum(int inThetaIndex,
+                                                         int outThetaIndex,
+                                                         int outPhiIndex)
 {
     return samples_->getSpectrum(inThetaIndex, outThetaIndex, outPhiIndex);
 }
 
-inline const Spectrum& SphericalCoordinatesBrdf::getSpectrum(int inThetaIndex,
-                                                             int outThetaIndex,
-                                                             int outPhiIndex) const
+inline ConstSpectrumMap SphericalCoordinatesBrdf::getSpectrum(int inThetaIndex,
+                                                              int outThetaIndex,
+                                                              int outPhiIndex) const
 {
-    return samples_->getSpectrum(inThetaIndex, outThetaIndex, outPhiIndex);
+    return getSampleSet()->getSpectrum(inThetaIndex, outThetaIndex, outPhiIndex);
 }
 
 inline void SphericalCoordinatesBrdf::setSpectrum(int               inThetaIndex,
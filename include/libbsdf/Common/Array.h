@@ -25,6 +25,8 @@ namespace lb {
 using Arrayf = Eigen::ArrayXf;
 using Arrayd = Eigen::ArrayXd;
 
+class BoundsTable;
+
 /*! \brief Copies an array. */
 template <typename SrcT, typename DestT>
 void copyArray(const SrcT& srcArray, DestT* destArray);
@@ -43,10 +45,10 @@ ArrayT createExponentialArray(int                       numElements,
  * \brief Interpolates arrays using centripetal Catmull-Rom spline at \a pos in [\a pos1,\a pos2].
  * \param array Interpolated array.
  */
-template <typename T>
+template <typename T, typename DestT>
 void catmullRomSpline(float pos0, float pos1, float pos2, float pos3,
                       const T& array0, const T& array1, const T& array2, const T& array3,
-                      float pos, T* array);
+                      float pos, DestT* array);
 
 /*! \brief Converts an array from degrees to radians. */
 template <typename T>
@@ -77,6 +79,19 @@ void findBounds(const Arrayf&   values,
                 float*          lowerValue,
                 float*          upperValue);
 
+/*!
+ * Finds neighbor indices and values using lb::BoundsTable built from \a values.
+ * If \a table is empty, a binary search is used. \sa findBounds()
+ */
+void findBounds(const Arrayf&       values,
+                float               value,
+                bool                equalIntervalValues,
+                const BoundsTable&  table,
+                int*                lowerIndex,
+                int*                upperIndex,
+                float*              lowerValue,
+                float*              upperValue);
+
 /*
  * Implementation
  */
@@ -124,10 +139,10 @@ ArrayT createExponentialArray(int                       numElements,
     return arr;
 }
 
-template <typename T>
+template <typename T, typename DestT>
 void catmullRomSpline(float pos0, float pos1, float pos2, float pos3,
                       const T& array0, const T& array1, const T& array2, const T& array3,
-                      float pos, T* array)
+                      float pos, DestT* array)
 {
     assert(array0.size() == array1.size() &&
            array1.size() == array2.size() &&
@@ -143,7 +158,7 @@ void catmullRomSpline(float pos0, float pos1, float pos2, float pos3,
                         Vec2(pos2, array2[i]),
                         Vec2(pos3, array3[i]));
 
-        using ScalarType = typename T::Scalar;
+        using ScalarType = typename DestT::Scalar;
         (*array)[i] = static_cast<ScalarType>(ccrs.interpolateY(pos));
     }
 }
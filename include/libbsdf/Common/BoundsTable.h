@@ -0,0 +1,86 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_BOUNDS_TABLE_H
+#define LIBBSDF_BOUNDS_TABLE_H
+
+#include <algorithm>
+#include <vector>
+
+#include <libbsdf/Common/Array.h>
+
+namespace lb {
+
+/*!
+ * \class   BoundsTable
+ * \brief   The BoundsTable class provides the lookup table to find bounds in a sorted array in constant time.
+ *
+ * The range of the array is divided into uniform buckets, and each bucket holds the index of
+ * the first element not less than the start of the bucket. A lookup computes the bucket and
+ * scans a few neighboring elements. The result is always equal to std::lower_bound(), even if
+ * the table is out of date.
+ */
+class BoundsTable
+{
+public:
+    BoundsTable();
+
+    /*! Builds the table from an array sorted in ascending order. */
+    void build(const Arrayf& values);
+
+    /*! Clears the table. */
+    void clear();
+
+    /*! Returns true if the table is not built. */
+    bool isEmpty() const;
+
+    /*! Finds the index of the first element of \a values not less than \a value. */
+    int findLowerBound(const Arrayf& values, float value) const;
+
+private:
+    float minValue_;        /*!< The minimum value of the array. */
+    float bucketScale_;     /*!< The reciprocal of the width of a bucket. */
+
+    std::vector<int> startIndices_; /*!< The first index not less than the start of each bucket. */
+};
+
+inline BoundsTable::BoundsTable() : minValue_(0.0f),
+                                    bucketScale_(0.0f) {}
+
+inline bool BoundsTable::isEmpty() const { return startIndices_.empty(); }
+
+inline int BoundsTable::findLowerBound(const Arrayf& values, float value) const
+{
+    int size = static_cast<int>(values.size());
+    int numBuckets = static_cast<int>(startIndices_.size());
+
+    float pos = (value - minValue_) * bucketScale_;
+    int bucket;
+    if (pos > 0.0f) {
+        // Clamp in floating point since the cast of a huge or infinite value is undefined.
+        bucket = (pos >= static_cast<float>(numBuckets)) ? numBuckets - 1 : static_cast<int>(pos);
+    }
+    else {
+        bucket = 0;
+    }
+    int index = std::min(startIndices_[bucket], size);
+
+    while (index < size && values[index] < value) {
+        ++index;
+    }
+
+    while (index > 0 && !(values[index - 1] < value)) {
+        --index;
+    }
+
+    return index;
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_BOUNDS_TABLE_H
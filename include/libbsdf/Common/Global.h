@@ -33,9 +33,34 @@ constexpr float EPSILON_F = std::numeric_limits<float>::epsilon();
 /*! \brief The data type of a spectrum. */
 using Spectrum = Eigen::ArrayXf;
 
+/*!
+ * \brief The data type of a spectrum with a compile-time number of wavelengths.
+ *
+ * FixedSpectrum<Eigen::Dynamic> is identical to lb::Spectrum.
+ */
+template <int NumWavelengths>
+using FixedSpectrum = Eigen::Array<float, NumWavelengths, 1>;
+
 /*! \brief The data type of spectra. */
 using SpectrumList = std::vector<Spectrum, Eigen::aligned_allocator<Spectrum>>;
 
+/*!
+ * \brief The data type of contiguous spectra.
+ *
+ * Each column is the spectrum of a sample point and the columns are stored in a single buffer.
+ */
+using SpectrumArray = Eigen::ArrayXXf;
+
+/*! \brief The view of a spectrum stored in lb::SpectrumArray. */
+using SpectrumMap = Eigen::Map<Spectrum>;
+
+/*! \brief The read-only view of a spectrum stored in lb::SpectrumArray. */
+using ConstSpectrumMap = Eigen::Map<const Spectrum>;
+
+/*! \brief The read-only view of a spectrum with a compile-time number of wavelengths. */
+template <int NumWavelengths>
+using ConstFixedSpectrumMap = Eigen::Map<const FixedSpectrum<NumWavelengths>>;
+
 /*! \brief The output format of arrays and vectors. */
 const Eigen::IOFormat LB_EIGEN_IO_FMT(Eigen::StreamPrecision, Eigen::DontAlignCols, " ", " ");
 
@@ -48,6 +73,14 @@ enum ColorModel {
     SPECTRAL_MODEL
 };
 
+/*! \brief The coordinate systems of BRDFs. */
+enum CoordinateSystemType {
+    UNKNOWN_COORDINATE_SYSTEM = 0,
+    SPHERICAL_COORDINATE_SYSTEM,
+    SPECULAR_COORDINATE_SYSTEM,
+    HALF_DIFFERENCE_COORDINATE_SYSTEM
+};
+
 /*! \brief The data type of scatter. */
 enum DataType {
     UNKNOWN_DATA = 0,
@@ -68,7 +101,8 @@ enum FileType {
     INTEGRA_SDT_FILE,
     LIGHTTOOLS_FILE,
     MERL_BINARY_FILE,
-    ZEMAX_FILE
+    ZEMAX_FILE,
+    LIBBSDF_BINARY_FILE
 };
 
 /*! \brief The data type of source. */
@@ -0,0 +1,304 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_KD_TREE_H
+#define LIBBSDF_KD_TREE_H
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace lb {
+
+/*!
+ * \class   KdTree
+ * \brief   The KdTree class provides the k-d tree of points with \a Dim dimensions.
+ *
+ * The metric of a query is given by a functor, so that non-Euclidean distances can be used.
+ * The functor must provide two member functions:
+ * - float operator()(int index) const: the distance to the point of \a index.
+ * - float operator()(const float* lower, const float* upper) const:
+ *   the lower bound of the distance to points in an axis-aligned box.
+ *
+ * Ties are resolved in favor of the smaller index, so the result of a query is equal to
+ * a linear search that keeps the first minimum.
+ */
+template <int Dim>
+class KdTree
+{
+public:
+    using Point = std::array<float, Dim>;
+
+    /*! Builds the tree from points. The index of a point is the position in \a points. */
+    void build(const std::vector<Point>& points);
+
+    /*! Clears the tree. */
+    void clear();
+
+    /*! Returns true if the tree is not built. */
+    bool isEmpty() const;
+
+    /*! Returns the number of points. */
+    int getNumPoints() const;
+
+    /*! Gets the point of \a index. */
+    const Point& getPoint(int index) const;
+
+    /*!
+     * Finds the index of the nearest point. If no point has a valid distance, -1 is returned.
+     * A node is skipped if the lower bound exceeds the minimum distance by \a tolerance,
+     * which absorbs rounding errors of the lower bound.
+     */
+    template <typename DistanceT>
+    int findNearest(const DistanceT& distance, float tolerance = 0.0f) const;
+
+    /*! Finds the indices of \a k nearest points sorted in ascending order of the distance. */
+    template <typename DistanceT>
+    std::vector<int> findNearest(const DistanceT& distance, int k, float tolerance = 0.0f) const;
+
+private:
+    /*! The node of a tree. Leaves have no children. */
+    struct Node
+    {
+        Point lower;    /*!< The lower corner of the bounding box. */
+        Point upper;    /*!< The upper corner of the bounding box. */
+        int begin;      /*!< The first position in the index list. */
+        int end;        /*!< The position after the last in the index list. */
+        int children[2];/*!< The indices of child nodes. */
+    };
+
+    /*! The pair of a distance and the index of a point. */
+    using Candidate = std::pair<float, int>;
+
+    /*! Builds a node recursively and returns the index of the node. */
+    int buildNode(int begin, int end);
+
+    /*! Searches for the nearest point in a node recursively. */
+    template <typename DistanceT>
+    void searchNearest(int nodeIndex, const DistanceT& distance, float tolerance, Candidate* nearest) const;
+
+    /*! Searches for \a k nearest points in a node recursively. */
+    template <typename DistanceT>
+    void searchNearest(int nodeIndex, const DistanceT& distance, float tolerance, size_t k,
+                       std::vector<Candidate>* heap) const;
+
+    /*! Returns true if \a lhs is nearer than \a rhs. */
+    static bool isNearer(const Candidate& lhs, const Candidate& rhs);
+
+    static const int MAX_LEAF_SIZE = 8; /*!< The maximum number of points in a leaf. */
+
+    std::vector<Point>  points_;    /*!< Points. */
+    std::vector<int>    indices_;   /*!< The indices of points sorted by nodes. */
+    std::vector<Node>   nodes_;     /*!< Nodes. The first node is the root. */
+};
+
+template <int Dim>
+inline void KdTree<Dim>::build(const std::vector<Point>& points)
+{
+    clear();
+
+    points_ = points;
+    if (points_.empty()) return;
+
+    indices_.resize(points_.size());
+    for (int i = 0; i < static_cast<int>(indices_.size()); ++i) {
+        indices_[i] = i;
+    }
+
+    nodes_.reserve(2 * points_.size() / MAX_LEAF_SIZE + 1);
+    buildNode(0, static_cast<int>(indices_.size()));
+}
+
+template <int Dim>
+inline void KdTree<Dim>::clear()
+{
+    points_.clear();
+    indices_.clear();
+    nodes_.clear();
+}
+
+template <int Dim>
+inline bool KdTree<Dim>::isEmpty() const { return nodes_.empty(); }
+
+template <int Dim>
+inline int KdTree<Dim>::getNumPoints() const { return static_cast<int>(points_.size()); }
+
+template <int Dim>
+inline const typename KdTree<Dim>::Point& KdTree<Dim>::getPoint(int index) const { return points_[index]; }
+
+template <int Dim>
+template <typename DistanceT>
+inline int KdTree<Dim>::findNearest(const DistanceT& distance, float tolerance) const
+{
+    Candidate nearest(std::numeric_limits<float>::max(), -1);
+    if (!isEmpty()) {
+        searchNearest(0, distance, tolerance, &nearest);
+    }
+
+    return nearest.second;
+}
+
+template <int Dim>
+template <typename DistanceT>
+inline std::vector<int> KdTree<Dim>::findNearest(const DistanceT& distance, int k, float tolerance) const
+{
+    std::vector<Candidate> heap;
+    if (!isEmpty() && k > 0) {
+        heap.reserve(k);
+        searchNearest(0, distance, tolerance, static_cast<size_t>(k), &heap);
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), isNearer);
+
+    std::vector<int> nearestIndices;
+    nearestIndices.reserve(heap.size());
+    for (auto it = heap.begin(); it != heap.end(); ++it) {
+        nearestIndices.push_back(it->second);
+    }
+
+    return nearestIndices;
+}
+
+template <int Dim>
+int KdTree<Dim>::buildNode(int begin, int end)
+{
+    int nodeIndex = static_cast<int>(nodes_.size());
+    nodes_.push_back(Node());
+
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    node.children[0] = node.children[1] = -1;
+    node.lower.fill(std::numeric_limits<float>::max());
+    node.upper.fill(-std::numeric_limits<float>::max());
+
+    for (int i = begin; i < end; ++i) {
+        const Point& pt = points_[indices_[i]];
+        for (int d = 0; d < Dim; ++d) {
+            node.lower[d] = std::min(node.lower[d], pt[d]);
+            node.upper[d] = std::max(node.upper[d], pt[d]);
+        }
+    }
+
+    if (end - begin > MAX_LEAF_SIZE) {
+        // Split at the median of the longest axis.
+        int splitDim = 0;
+        for (int d = 1; d < Dim; ++d) {
+            if (node.upper[d] - node.lower[d] > node.upper[splitDim] - node.lower[splitDim]) {
+                splitDim = d;
+            }
+        }
+
+        int middle = begin + (end - begin) / 2;
+        std::nth_element(indices_.begin() + begin, indices_.begin() + middle, indices_.begin() + end,
+                         [this, splitDim](int lhs, int rhs) {
+                             return points_[lhs][splitDim] < points_[rhs][splitDim];
+                         });
+
+        node.children[0] = buildNode(begin, middle);
+        node.children[1] = buildNode(middle, end);
+    }
+
+    nodes_[nodeIndex] = node;
+    return nodeIndex;
+}
+
+template <int Dim>
+template <typename DistanceT>
+void KdTree<Dim>::searchNearest(int                 nodeIndex,
+                                const DistanceT&    distance,
+                                float               tolerance,
+                                Candidate*          nearest) const
+{
+    const Node& node = nodes_[nodeIndex];
+
+    if (node.children[0] == -1) {
+        for (int i = node.begin; i < node.end; ++i) {
+            Candidate candidate(distance(indices_[i]), indices_[i]);
+            if (isNearer(candidate, *nearest)) {
+                *nearest = candidate;
+            }
+        }
+        return;
+    }
+
+    // Visit the nearer child first.
+    const Node& child0 = nodes_[node.children[0]];
+    const Node& child1 = nodes_[node.children[1]];
+    float bound0 = distance(child0.lower.data(), child0.upper.data());
+    float bound1 = distance(child1.lower.data(), child1.upper.data());
+
+    int first = (bound1 < bound0) ? 1 : 0;
+    float firstBound  = (first == 0) ? bound0 : bound1;
+    float secondBound = (first == 0) ? bound1 : bound0;
+
+    if (firstBound <= nearest->first + tolerance) {
+        searchNearest(node.children[first], distance, tolerance, nearest);
+    }
+
+    if (secondBound <= nearest->first + tolerance) {
+        searchNearest(node.children[1 - first], distance, tolerance, nearest);
+    }
+}
+
+template <int Dim>
+template <typename DistanceT>
+void KdTree<Dim>::searchNearest(int                     nodeIndex,
+                                const DistanceT&        distance,
+                                float                   tolerance,
+                                size_t                  k,
+                                std::vector<Candidate>* heap) const
+{
+    const Node& node = nodes_[nodeIndex];
+
+    if (node.children[0] == -1) {
+        for (int i = node.begin; i < node.end; ++i) {
+            Candidate candidate(distance(indices_[i]), indices_[i]);
+            if (!(candidate.first == candidate.first)) continue; // NaN
+
+            if (heap->size() < k) {
+                heap->push_back(candidate);
+                std::push_heap(heap->begin(), heap->end(), isNearer);
+            }
+            else if (isNearer(candidate, heap->front())) {
+                std::pop_heap(heap->begin(), heap->end(), isNearer);
+                heap->back() = candidate;
+                std::push_heap(heap->begin(), heap->end(), isNearer);
+            }
+        }
+        return;
+    }
+
+    const Node& child0 = nodes_[node.children[0]];
+    const Node& child1 = nodes_[node.children[1]];
+    float bound0 = distance(child0.lower.data(), child0.upper.data());
+    float bound1 = distance(child1.lower.data(), child1.upper.data());
+
+    int first = (bound1 < bound0) ? 1 : 0;
+    float bounds[2] = { (first == 0) ? bound0 : bound1,
+                        (first == 0) ? bound1 : bound0 };
+
+    for (int i = 0; i < 2; ++i) {
+        if (heap->size() < k || bounds[i] <= heap->front().first + tolerance) {
+            searchNearest(node.children[(i == 0) ? first : 1 - first], distance, tolerance, k, heap);
+        }
+    }
+}
+
+template <int Dim>
+inline bool KdTree<Dim>::isNearer(const Candidate& lhs, const Candidate& rhs)
+{
+    return (lhs.first < rhs.first ||
+            (lhs.first == rhs.first && lhs.second < rhs.second));
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_KD_TREE_H
@@ -10,6 +10,8 @@
 #define LIBBSDF_LOG_H
 
 #include <iostream>
+#include <mutex>
+#include <sstream>
 
 #define lbTrace lb::Log(lb::Log::Level::TRACE_MSG)
 #define lbDebug lb::Log(lb::Log::Level::DEBUG_MSG)
@@ -22,6 +24,8 @@ namespace lb {
 /*!
  * \class   Log
  * \brief   The Log class provides a simple logger.
+ *
+ * A message is buffered and written to std::cout at once, so messages from threads are not interleaved.
  */
 class Log
 {
@@ -50,13 +54,17 @@ public:
 
 private:
     Level level_;
+    std::ostringstream stream_; /*!< The buffer of a message. */
+
     static Level notificationLevel_;
+    static std::mutex mutex_; /*!< The mutex to serialize the output of messages. */
 };
 
 inline Log::~Log()
 {
     if (level_ >= notificationLevel_) {
-        std::cout << std::endl;
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::cout << stream_.str() << std::endl;
     }
 }
 
@@ -74,7 +82,7 @@ template <typename T>
 Log& Log::operator<<(const T& message)
 {
     if (level_ >= notificationLevel_) {
-        std::cout << message;
+        stream_ << message;
     }
     return *this;
 }
@@ -0,0 +1,222 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+/*!
+ * \file    RangeCoder.h
+ * \brief   The RangeCoder.h header file includes the binary range coder with adaptive probabilities.
+ *
+ * The coder follows the binary range coder of LZMA. A probability is a 16-bit integer that
+ * represents the probability of zero with 11-bit precision and is updated after each bit.
+ */
+
+#ifndef LIBBSDF_RANGE_CODER_H
+#define LIBBSDF_RANGE_CODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lb {
+
+/*! \brief The initial value of an adaptive probability, which represents 0.5. */
+const uint16_t RANGE_CODER_INITIAL_PROBABILITY = 1 << 10;
+
+/*!
+ * \class   RangeEncoder
+ * \brief   The RangeEncoder class provides the encoder of bits with adaptive probabilities.
+ */
+class RangeEncoder
+{
+public:
+    /*! Constructs an encoder that appends bytes to \a data. */
+    explicit RangeEncoder(std::vector<char>* data);
+
+    /*! Encodes a bit and updates the probability. */
+    void encodeBit(uint16_t* probability, int bit);
+
+    /*!
+     * Encodes the lower \a numBits bits of \a value with a binary tree of probabilities.
+     * \a probabilities must have 2^numBits elements.
+     */
+    void encodeTree(uint16_t* probabilities, int numBits, uint32_t value);
+
+    /*! Flushes the remaining state. No bit can be encoded after this call. */
+    void finish();
+
+private:
+    /*! Outputs the top byte of the low value with a carry. */
+    void shiftLow();
+
+    std::vector<char>* data_;
+
+    uint64_t    low_;
+    uint32_t    range_;
+    uint8_t     cache_;
+    uint64_t    cacheSize_;
+};
+
+/*!
+ * \class   RangeDecoder
+ * \brief   The RangeDecoder class provides the decoder of bits encoded by lb::RangeEncoder.
+ *
+ * Zeros are read beyond the end of data, so broken data do not cause invalid memory accesses.
+ */
+class RangeDecoder
+{
+public:
+    /*! Constructs a decoder of the range [\a first, \a last). */
+    RangeDecoder(const char* first, const char* last);
+
+    /*! Decodes a bit and updates the probability. */
+    int decodeBit(uint16_t* probability);
+
+    /*! Decodes \a numBits bits encoded by RangeEncoder::encodeTree(). */
+    uint32_t decodeTree(uint16_t* probabilities, int numBits);
+
+    /*! Returns true if the decoder has not read beyond the end of data. */
+    bool isValid() const;
+
+private:
+    /*! Reads the next byte. */
+    uint8_t nextByte();
+
+    const char* position_;
+    const char* last_;
+    bool        overrun_;
+
+    uint32_t range_;
+    uint32_t code_;
+};
+
+/* Constants of the coder. */
+const int       RANGE_CODER_PROBABILITY_BITS    = 11;
+const int       RANGE_CODER_ADAPTATION_SHIFT    = 5;
+const uint32_t  RANGE_CODER_TOP                 = 1 << 24;
+
+inline RangeEncoder::RangeEncoder(std::vector<char>* data)
+                                  : data_(data),
+                                    low_(0),
+                                    range_(0xFFFFFFFF),
+                                    cache_(0),
+                                    cacheSize_(1) {}
+
+inline void RangeEncoder::encodeBit(uint16_t* probability, int bit)
+{
+    uint32_t bound = (range_ >> RANGE_CODER_PROBABILITY_BITS) * (*probability);
+
+    if (bit == 0) {
+        range_ = bound;
+        *probability += ((1 << RANGE_CODER_PROBABILITY_BITS) - *probability) >> RANGE_CODER_ADAPTATION_SHIFT;
+    }
+    else {
+        low_ += bound;
+        range_ -= bound;
+        *probability -= *probability >> RANGE_CODER_ADAPTATION_SHIFT;
+    }
+
+    while (range_ < RANGE_CODER_TOP) {
+        range_ <<= 8;
+        shiftLow();
+    }
+}
+
+inline void RangeEncoder::encodeTree(uint16_t* probabilities, int numBits, uint32_t value)
+{
+    uint32_t node = 1;
+    for (int i = numBits - 1; i >= 0; --i) {
+        int bit = (value >> i) & 1;
+        encodeBit(&probabilities[node], bit);
+        node = (node << 1) | bit;
+    }
+}
+
+inline void RangeEncoder::finish()
+{
+    for (int i = 0; i < 5; ++i) {
+        shiftLow();
+    }
+}
+
+inline void RangeEncoder::shiftLow()
+{
+    if (static_cast<uint32_t>(low_) < 0xFF000000 || (low_ >> 32) != 0) {
+        uint8_t carry = static_cast<uint8_t>(low_ >> 32);
+        uint8_t temp = cache_;
+        do {
+            data_->push_back(static_cast<char>(static_cast<uint8_t>(temp + carry)));
+            temp = 0xFF;
+        } while (--cacheSize_ != 0);
+        cache_ = static_cast<uint8_t>(low_ >> 24);
+    }
+
+    ++cacheSize_;
+    low_ = (low_ & 0x00FFFFFF) << 8;
+}
+
+inline RangeDecoder::RangeDecoder(const char* first, const char* last)
+                                  : position_(first),
+                                    last_(last),
+                                    overrun_(false),
+                                    range_(0xFFFFFFFF),
+                                    code_(0)
+{
+    for (int i = 0; i < 5; ++i) {
+        code_ = (code_ << 8) | nextByte();
+    }
+}
+
+inline int RangeDecoder::decodeBit(uint16_t* probability)
+{
+    uint32_t bound = (range_ >> RANGE_CODER_PROBABILITY_BITS) * (*probability);
+
+    int bit;
+    if (code_ < bound) {
+        range_ = bound;
+        *probability += ((1 << RANGE_CODER_PROBABILITY_BITS) - *probability) >> RANGE_CODER_ADAPTATION_SHIFT;
+        bit = 0;
+    }
+    else {
+        code_ -= bound;
+        range_ -= bound;
+        *probability -= *probability >> RANGE_CODER_ADAPTATION_SHIFT;
+        bit = 1;
+    }
+
+    while (range_ < RANGE_CODER_TOP) {
+        range_ <<= 8;
+        code_ = (code_ << 8) | nextByte();
+    }
+
+    return bit;
+}
+
+inline uint32_t RangeDecoder::decodeTree(uint16_t* probabilities, int numBits)
+{
+    uint32_t node = 1;
+    for (int i = 0; i < numBits; ++i) {
+        node = (node << 1) | decodeBit(&probabilities[node]);
+    }
+
+    return node - (1u << numBits);
+}
+
+inline bool RangeDecoder::isValid() const { return !overrun_; }
+
+inline uint8_t RangeDecoder::nextByte()
+{
+    if (position_ == last_) {
+        overrun_ = true;
+        return 0;
+    }
+
+    return static_cast<uint8_t>(*position_++);
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_RANGE_CODER_H
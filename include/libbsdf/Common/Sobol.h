@@ -0,0 +1,109 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_SOBOL_H
+#define LIBBSDF_SOBOL_H
+
+#include <libbsdf/Common/Xorshift.h>
+
+namespace lb {
+
+/*!
+ * \class   Sobol
+ * \brief   The Sobol class provides the first two dimensions of the Sobol sequence with Owen scrambling.
+ *
+ * Owen scrambling is approximated with the hash-based nested uniform scramble by Laine and Karras.
+ * Sequences scrambled with different seeds are independent randomizations used to estimate errors.
+ */
+class Sobol
+{
+public:
+    /*! Generates the integer of the sequence at \a index in \a dimension (0 or 1). */
+    static uint32_t sample(uint32_t index, int dimension);
+
+    /*! Generates the scrambled integer of the sequence at \a index in \a dimension (0 or 1). */
+    static uint32_t sample(uint32_t index, int dimension, uint32_t seed);
+
+    /*! Generates the scrambled floating-point number of the sequence. Range is [0.0,1.0). */
+    template <typename T>
+    static T sample(uint32_t index, int dimension, uint32_t seed);
+
+    /*! Applies the nested uniform scramble to a 32-bit fixed-point number. */
+    static uint32_t scramble(uint32_t value, uint32_t seed);
+
+private:
+    static uint32_t reverseBits(uint32_t value);
+
+    /*! Hashes \a seed for each dimension. */
+    static uint32_t hash(uint32_t seed);
+};
+
+inline uint32_t Sobol::sample(uint32_t index, int dimension)
+{
+    if (dimension == 0) {
+        return reverseBits(index);
+    }
+
+    // The second dimension is generated by the primitive polynomial x + 1.
+    uint32_t result = 0;
+    for (uint32_t v = 1u << 31; index; index >>= 1, v ^= v >> 1) {
+        if (index & 1) {
+            result ^= v;
+        }
+    }
+
+    return result;
+}
+
+inline uint32_t Sobol::sample(uint32_t index, int dimension, uint32_t seed)
+{
+    return scramble(sample(index, dimension), hash(seed + static_cast<uint32_t>(dimension) * 0x9e3779b9));
+}
+
+template <typename T>
+inline T Sobol::sample(uint32_t index, int dimension, uint32_t seed)
+{
+    // The upper 24 bits are used to avoid rounding up to 1.0 in single precision.
+    return static_cast<T>(sample(index, dimension, seed) >> 8) / static_cast<T>(1 << 24);
+}
+
+inline uint32_t Sobol::scramble(uint32_t value, uint32_t seed)
+{
+    // The Laine-Karras permutation operates on reversed bits so that higher bits affect lower bits.
+    uint32_t x = reverseBits(value);
+    x += seed;
+    x ^= x * 0x6c50b47c;
+    x ^= x * 0xb82f1e52;
+    x ^= x * 0xc7afe638;
+    x ^= x * 0x8d22f6e6;
+    return reverseBits(x);
+}
+
+inline uint32_t Sobol::reverseBits(uint32_t value)
+{
+    value = (value << 16) | (value >> 16);
+    value = ((value & 0x00ff00ff) << 8) | ((value & 0xff00ff00) >> 8);
+    value = ((value & 0x0f0f0f0f) << 4) | ((value & 0xf0f0f0f0) >> 4);
+    value = ((value & 0x33333333) << 2) | ((value & 0xcccccccc) >> 2);
+    value = ((value & 0x55555555) << 1) | ((value & 0xaaaaaaaa) >> 1);
+    return value;
+}
+
+inline uint32_t Sobol::hash(uint32_t seed)
+{
+    seed ^= seed >> 16;
+    seed *= 0x7feb352d;
+    seed ^= seed >> 15;
+    seed *= 0x846ca68b;
+    seed ^= seed >> 16;
+    return seed;
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_SOBOL_H
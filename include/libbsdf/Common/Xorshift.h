@@ -9,7 +9,13 @@
 #ifndef LIBBSDF_XORSHIFT_H
 #define LIBBSDF_XORSHIFT_H
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <limits>
+#include <vector>
+
+#include <libbsdf/Common/Global.h>
 
 namespace lb {
 
@@ -27,6 +33,9 @@ namespace lb {
 /*!
  * \class   Xorshift
  * \brief   The Xorshift class provides a random number generator using Xorshift.
+ *
+ * An instance is not shared between threads. Independent streams for parallel loops are
+ * created with createStream() or jump(). Static functions use a generator local to each thread.
  */
 class Xorshift
 {
@@ -35,21 +44,60 @@ public:
 
     void setSeed(uint32_t seed);
 
+    /*! Sets all words of the state. At least one of them must not be zero. */
+    void setState(uint32_t x, uint32_t y, uint32_t z, uint32_t w);
+
     /*! Generates a random integer. Range is [0,std::numeric_limits<uint32_t>::max()]. */
     uint32_t next();
 
-    /*! Generates a random integer. Range is [0,std::numeric_limits<uint32_t>::max()]. */
+    /*! Generates a random floating-point number. Range is [0.0,1.0]. */
+    template <typename T>
+    T next();
+
+    /*! Generates a random point on the surface of a unit hemisphere. Z-up coordinate system is used. */
+    template <typename Vec3T>
+    Vec3T nextOnHemisphere();
+
+    /*!
+     * Fills the columns of a 3xN array with random points on the surface of a unit hemisphere.
+     * The same random numbers as nextOnHemisphere() are used, and the trigonometric functions are vectorized.
+     */
+    template <typename Array3XT>
+    void fillOnHemisphere(Array3XT* dirs);
+
+    /*! Advances the state by 2^64 steps. Sequences separated by jumps do not overlap. */
+    void jump();
+
+    /*! Advances the state by \a numSteps steps. */
+    void discard(unsigned long long numSteps);
+
+    /*!
+     * Creates the generator of the stream at \a index. Each stream is separated by 2^64 steps.
+     * The cost is proportional to \a index. Use createStreams() for many streams.
+     */
+    static Xorshift createStream(int index, uint32_t seed = 123456789);
+
+    /*! Creates the generators of the first \a numStreams streams of createStream(). */
+    static std::vector<Xorshift> createStreams(int numStreams, uint32_t seed = 123456789);
+
+    /*! Generates a random integer with the generator of the calling thread. Range is [0,std::numeric_limits<uint32_t>::max()]. */
     static uint32_t random();
 
-    /*! Generates a random floating-point number. Range is [0.0,1.0]. */
+    /*! Generates a random floating-point number with the generator of the calling thread. Range is [0.0,1.0]. */
     template <typename T>
     static T random();
 
-    /*! Generates a random point on the surface of a unit hemisphere. Z-up coordinate system is used. */
+    /*! Generates a random point on the surface of a unit hemisphere with the generator of the calling thread. */
     template <typename Vec3T>
     static Vec3T randomOnHemisphere();
 
 private:
+    /*!
+     * Gets the generator of the calling thread.
+     * The n-th thread that calls this function uses the n-th stream of createStream().
+     */
+    static Xorshift& getThreadGenerator();
+
     uint32_t x_, y_, z_, w_;
 };
 
@@ -63,6 +111,16 @@ inline void Xorshift::setSeed(uint32_t seed)
     x_ = seed;
 }
 
+inline void Xorshift::setState(uint32_t x, uint32_t y, uint32_t z, uint32_t w)
+{
+    assert(x != 0 || y != 0 || z != 0 || w != 0);
+
+    x_ = x;
+    y_ = y;
+    z_ = z;
+    w_ = w;
+}
+
 inline uint32_t Xorshift::next()
 {
     uint32_t t = x_ ^ (x_ << 11);
@@ -74,35 +132,19 @@ inline uint32_t Xorshift::next()
     return w_;
 }
 
-inline uint32_t Xorshift::random()
-{
-    static uint32_t x = 123456789;
-    static uint32_t y = 362436069;
-    static uint32_t z = 521288629;
-    static uint32_t w = 88675123;
-
-    uint32_t t = x ^ (x << 11);
-    x = y;
-    y = z;
-    z = w;
-    w = (w ^ (w >> 19)) ^ (t ^ (t >> 8));
-
-    return w;
-}
-
 template <typename T>
-inline T Xorshift::random()
+inline T Xorshift::next()
 {
-    return static_cast<T>(random()) / std::numeric_limits<uint32_t>::max();
+    return static_cast<T>(next()) / std::numeric_limits<uint32_t>::max();
 }
 
 template <typename Vec3T>
-inline Vec3T Xorshift::randomOnHemisphere()
+inline Vec3T Xorshift::nextOnHemisphere()
 {
     using Scalar = typename Vec3T::Scalar;
 
-    Scalar z = random<Scalar>();
-    Scalar phi = random<Scalar>() * TAU_F;
+    Scalar z = next<Scalar>();
+    Scalar phi = next<Scalar>() * TAU_F;
     Scalar coeff = std::sqrt(1 - z * z);
     Scalar x = coeff * std::cos(phi);
     Scalar y = coeff * std::sin(phi);
@@ -110,6 +152,106 @@ inline Vec3T Xorshift::randomOnHemisphere()
     return Vec3T(x, y, z);
 }
 
+template <typename Array3XT>
+inline void Xorshift::fillOnHemisphere(Array3XT* dirs)
+{
+    using Scalar = typename Array3XT::Scalar;
+    using ArrayT = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+
+    Eigen::Index numDirs = dirs->cols();
+
+    ArrayT z(numDirs), phi(numDirs);
+    for (Eigen::Index i = 0; i < numDirs; ++i) {
+        z[i] = next<Scalar>();
+        phi[i] = next<Scalar>() * TAU_F;
+    }
+
+    ArrayT coeff = (1 - z * z).sqrt();
+    dirs->row(0) = (coeff * phi.cos()).transpose();
+    dirs->row(1) = (coeff * phi.sin()).transpose();
+    dirs->row(2) = z.transpose();
+}
+
+inline void Xorshift::jump()
+{
+    // Coefficients of x^(2^64) modulo the characteristic polynomial of the state transition.
+    static const uint32_t JUMP[] = { 0x35aac71c, 0x821e5343, 0xf52e65c4, 0xd8cd644e };
+
+    uint32_t x = 0, y = 0, z = 0, w = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 32; ++b) {
+            if (JUMP[i] & (1u << b)) {
+                x ^= x_;
+                y ^= y_;
+                z ^= z_;
+                w ^= w_;
+            }
+            next();
+        }
+    }
+
+    x_ = x;
+    y_ = y;
+    z_ = z;
+    w_ = w;
+}
+
+inline void Xorshift::discard(unsigned long long numSteps)
+{
+    for (unsigned long long i = 0; i < numSteps; ++i) {
+        next();
+    }
+}
+
+inline Xorshift Xorshift::createStream(int index, uint32_t seed)
+{
+    Xorshift generator(seed);
+    for (int i = 0; i < index; ++i) {
+        generator.jump();
+    }
+
+    return generator;
+}
+
+inline std::vector<Xorshift> Xorshift::createStreams(int numStreams, uint32_t seed)
+{
+    std::vector<Xorshift> generators;
+    generators.reserve(std::max(numStreams, 0));
+
+    // Each stream is derived from the previous one with a single jump.
+    Xorshift generator(seed);
+    for (int i = 0; i < numStreams; ++i) {
+        generators.push_back(generator);
+        generator.jump();
+    }
+
+    return generators;
+}
+
+inline uint32_t Xorshift::random()
+{
+    return getThreadGenerator().next();
+}
+
+template <typename T>
+inline T Xorshift::random()
+{
+    return getThreadGenerator().next<T>();
+}
+
+template <typename Vec3T>
+inline Vec3T Xorshift::randomOnHemisphere()
+{
+    return getThreadGenerator().nextOnHemisphere<Vec3T>();
+}
+
+inline Xorshift& Xorshift::getThreadGenerator()
+{
+    static std::atomic<int> numThreads(0);
+    thread_local Xorshift generator = createStream(numThreads++);
+    return generator;
+}
+
 } // namespace lb
 
 #endif // LIBBSDF_XORSHIFT_H
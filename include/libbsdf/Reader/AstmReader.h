@@ -9,9 +9,12 @@
 #ifndef LIBBSDF_ASTM_READER_H
 #define LIBBSDF_ASTM_READER_H
 
+#include <istream>
 #include <string>
+#include <vector>
 
 #include <libbsdf/Brdf/SphericalCoordinatesBrdf.h>
+#include <libbsdf/Reader/FileInfo.h>
 
 namespace lb {
 
@@ -29,6 +32,19 @@ class AstmReader
 public:
     /*! Reads an ASTM file and creates the BRDF of a spherical coordinate system. */
     static SphericalCoordinatesBrdf* read(const std::string& fileName);
+
+    /*!
+     * Reads the header of an ASTM file without samples.
+     * Angles are not determined because sample points are listed in the data.
+     */
+    static bool readInfo(const std::string& fileName, FileInfo* info);
+
+private:
+    /*!
+     * Reads the header until the line of variables. The position of \a stream is set to the data.
+     * Returns false if the header is invalid.
+     */
+    static bool readHeader(std::istream& stream, ColorModel* colorModel, std::vector<float>* wavelengths);
 };
 
 } // namespace lb
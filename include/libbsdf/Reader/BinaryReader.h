@@ -0,0 +1,53 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_BINARY_READER_H
+#define LIBBSDF_BINARY_READER_H
+
+#include <string>
+#include <vector>
+
+#include <libbsdf/Brdf/Brdf.h>
+#include <libbsdf/Reader/BinaryUtility.h>
+#include <libbsdf/Reader/FileInfo.h>
+
+namespace lb {
+
+/*!
+ * \class BinaryReader
+ * \brief The BinaryReader class provides the reader of a libbsdf binary file (".lbb").
+ *
+ * Raw spectra are read into lb::SampleSet at once without parsing.
+ * Compressed spectra are decoded in parallel for each incoming direction. \sa BinaryUtility.h
+ */
+class BinaryReader
+{
+public:
+    /*!
+     * Reads a libbsdf binary file and creates the BRDF of the stored coordinate system.
+     * The data type of the file is assigned to \a dataType.
+     */
+    static Brdf* read(const std::string& fileName, DataType* dataType = 0);
+
+    /*! Reads the header and metadata of a libbsdf binary file without spectra. */
+    static bool readInfo(const std::string& fileName, FileInfo* info);
+
+    /*! Reads the header of a libbsdf binary file. Returns false if the header is invalid. */
+    static bool readHeader(std::istream& stream, binary_utility::Header* header);
+
+private:
+    /*! Decodes the spectra block of lb::binary_utility::PREDICTIVE_ENCODING into a sample set. */
+    static bool decodeSpectra(const std::vector<char>& data, SampleSet* samples);
+
+    /*! Creates an empty BRDF from the attributes in a header. */
+    static Brdf* createBrdf(const binary_utility::Header& header);
+};
+
+} // namespace lb
+
+#endif // LIBBSDF_BINARY_READER_H
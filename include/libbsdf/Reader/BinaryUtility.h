@@ -0,0 +1,129 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+/*!
+ * \file    BinaryUtility.h
+ * \brief   The definitions of the libbsdf binary format (".lbb") shared by the reader and writer.
+ *
+ * A file consists of the following blocks:
+ *   - lb::binary_utility::Header
+ *   - Metadata: angles0, angles1, angles2, angles3, wavelengths, and specular offsets
+ *     as 32-bit floats, followed by the name of a BRDF
+ *   - Zero padding to align the spectra block to lb::binary_utility::SPECTRA_ALIGNMENT bytes
+ *   - Spectra: 32-bit floats in the layout of lb::SampleSet::getSpectra()
+ *
+ * All values are little-endian. The checksum is computed from the header with a zero checksum,
+ * the metadata with the padding, and the spectra in this order.
+ *
+ * With lb::binary_utility::PREDICTIVE_ENCODING, the spectra block is divided into chunks for each
+ * incoming direction, i.e. a pair of angle0 and angle1 indices in the order of lb::SampleSet::getIndex().
+ * The block begins with the sizes of chunks as 64-bit integers, followed by the chunks.
+ * The bit pattern of each spectrum value is predicted from neighboring samples of angle2 and angle3,
+ * and the residual is coded by lb::RangeEncoder. See encodeSpectra().
+ */
+
+#ifndef LIBBSDF_BINARY_UTILITY_H
+#define LIBBSDF_BINARY_UTILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <libbsdf/Brdf/SampleSet.h>
+#include <libbsdf/Reader/FileInfo.h>
+
+namespace lb {
+namespace binary_utility {
+
+/*! The signature at the beginning of a file. */
+const char MAGIC[8] = { 'L', 'I', 'B', 'B', 'S', 'D', 'F', '\0' };
+
+/*! The version of the format. */
+const uint32_t VERSION = 1;
+
+/*! The mark to detect the byte order. */
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/*! The alignment of the spectra block in bytes. */
+const uint64_t SPECTRA_ALIGNMENT = 64;
+
+/*! The encodings of the spectra block. */
+enum EncodingType {
+    RAW_ENCODING = 0,   /*!< Spectra are stored without compression. */
+    PREDICTIVE_ENCODING /*!< Spectra are compressed losslessly with predictive coding. */
+};
+
+/*! The header of a file. */
+struct Header
+{
+    char        magic[8];           /*!< The signature. */
+    uint32_t    version;            /*!< The version of the format. */
+    uint32_t    byteOrder;          /*!< lb::binary_utility::BYTE_ORDER_MARK. */
+    uint32_t    coordinateSystem;   /*!< lb::CoordinateSystemType. */
+    uint32_t    colorModel;         /*!< lb::ColorModel. */
+    uint32_t    sourceType;         /*!< lb::SourceType. */
+    uint32_t    dataType;           /*!< lb::DataType. */
+    uint32_t    encoding;           /*!< lb::binary_utility::EncodingType. */
+    int32_t     numAngles[4];       /*!< The numbers of angles0, angles1, angles2, and angles3. */
+    int32_t     numWavelengths;     /*!< The number of wavelengths. */
+    int32_t     numSpecularOffsets; /*!< The number of specular offsets. */
+    uint32_t    nameSize;           /*!< The length of the name in bytes. */
+    uint64_t    spectraOffset;      /*!< The offset of the spectra block from the beginning of a file. */
+    uint64_t    spectraSize;        /*!< The size of the spectra block in bytes. */
+    uint64_t    checksum;           /*!< The checksum of a file. */
+};
+
+static_assert(sizeof(Header) == 88, "The size of the header must be 88 bytes.");
+
+/*! \brief Computes the checksum of data. A checksum of the preceding data is passed as \a seed. */
+uint64_t computeChecksum(const void* data, size_t size, uint64_t seed = 0);
+
+/*!
+ * \brief Computes the checksum of \a size bytes read from \a stream.
+ * The result equals the checksum of the same data in memory. Zero is returned if reading fails.
+ */
+uint64_t computeChecksum(std::istream& stream, uint64_t size, uint64_t seed = 0);
+
+/*!
+ * \brief Creates the header and metadata block of a file from the attributes of a BRDF.
+ *
+ * The metadata block is padded to lb::binary_utility::SPECTRA_ALIGNMENT bytes.
+ * The sizes of spectra and the checksum are not set. Returns false if the coordinate system is unknown.
+ */
+bool createHeader(const FileInfo&       info,
+                  EncodingType          encoding,
+                  const std::string&    name,
+                  Header*               header,
+                  std::vector<char>*    metadata);
+
+/*!
+ * \brief Encodes the spectra of an incoming direction and appends them to \a data.
+ *
+ * The bit pattern of a float is mapped to an integer in the same order as values.
+ * For each wavelength, the integer at (angle2, angle3) is predicted from the samples at
+ * (angle2 - 1, angle3), (angle2, angle3 - 1), and (angle2 - 1, angle3 - 1).
+ * The number of significant bits of the residual is coded with the range coder,
+ * and the remaining bits are packed after the range-coded data.
+ */
+void encodeSpectra(const SampleSet& samples, int index0, int index1, std::vector<char>* data);
+
+/*!
+ * \brief Decodes the spectra of an incoming direction encoded by encodeSpectra().
+ * Returns false if data are broken.
+ */
+bool decodeSpectra(const char* data, size_t size, int index0, int index1, SampleSet* samples);
+
+/*! \brief Returns true if the byte order of the system is little-endian. */
+bool isLittleEndian();
+
+} // namespace binary_utility
+} // namespace lb
+
+#endif // LIBBSDF_BINARY_UTILITY_H
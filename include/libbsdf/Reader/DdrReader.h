@@ -10,11 +10,16 @@
 #define LIBBSDF_DDR_READER_H
 
 #include <string>
+#include <vector>
 
 #include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
+#include <libbsdf/Reader/DdrSdrUtility.h>
+#include <libbsdf/Reader/FileInfo.h>
 
 namespace lb {
 
+class Tokenizer;
+
 /*!
  * \class DdrReader
  * \brief The DdrReader class provides the reader for a DDR and DDT file.
@@ -22,12 +27,85 @@ namespace lb {
  * A DDR (Diffuse Distribution Reflection) file includes a BRDF,
  * and a DDT (Diffuse Distribution Transparent) file includes a BTDF.
  * lb::SpecularCoordinatesBrdf is created from loaded data.
+ * The whole file is loaded into memory and scanned by lb::Tokenizer.
+ * Blocks of wavelengths are parsed in parallel.
+ * readInfo() reads the beginning of a file until the header ends.
  */
 class DdrReader
 {
 public:
     /*! Reads a DDR or DDT file and creates the BRDF of a specular coordinate system. */
     static SpecularCoordinatesBrdf* read(const std::string& fileName);
+
+    /*! Reads the header of a DDR or DDT file without spectra. */
+    static bool readInfo(const std::string& fileName, FileInfo* info);
+
+private:
+    friend class DdrSlabReader;
+
+    /*! The values of a wavelength in spectra. The stride is the number of wavelengths. */
+    using ValueMap = Eigen::Map<Arrayf, 0, Eigen::InnerStride<>>;
+
+    /*! The attributes in the header of a file. */
+    struct Header
+    {
+        Header();
+
+        SourceType                      sourceType;
+        ddr_sdr_utility::SymmetryType   symmetryType;
+        ddr_sdr_utility::UnitType       unitType;
+        ColorModel                      colorModel;
+        int                             numWavelengths;
+
+        std::vector<float> inThetaDegrees;
+        std::vector<float> inPhiDegrees;
+        std::vector<float> spThetaDegrees;
+        std::vector<float> spPhiDegrees;
+        std::vector<float> spThetaOffsetDegrees;
+    };
+
+    /*!
+     * Reads the header until the first wavelength block. The position of \a tokenizer is set to the block.
+     * Returns false if the header is invalid.
+     */
+    static bool readHeader(Tokenizer* tokenizer, Header* header);
+
+    /*!
+     * Reads the header from the beginning of a file. \a headerSize is set to the offset of the first wavelength block.
+     * Returns false if the file cannot be opened or the header is invalid.
+     */
+    static bool readHeader(const std::string& fileName, Header* header, size_t* headerSize);
+
+    /*!
+     * Reads a block of "wl", "bw", "red", "gre", or "blu" after the keyword.
+     * Values are stored in \a values at the indices of samples.
+     */
+    static bool readWavelengthBlock(Tokenizer*                      tokenizer,
+                                    const SpecularCoordinatesBrdf&  brdf,
+                                    ColorModel                      colorModel,
+                                    ddr_sdr_utility::UnitType       unitType,
+                                    ddr_sdr_utility::SymmetryType   symmetryType,
+                                    int                             numSpecPhiDegrees,
+                                    float*                          wavelength,
+                                    std::vector<float>*             kbdfs,
+                                    ValueMap*                       values);
+
+    /*!
+     * Reads the values of an incoming direction in a wavelength block.
+     * Values are converted to BRDF with \a kbdf and stored in \a values at the indices of samples.
+     */
+    static bool readValues(Tokenizer*                       tokenizer,
+                           const SpecularCoordinatesBrdf&   brdf,
+                           int                              inThIndex,
+                           int                              inPhIndex,
+                           ddr_sdr_utility::UnitType        unitType,
+                           ddr_sdr_utility::SymmetryType    symmetryType,
+                           int                              numSpecPhiDegrees,
+                           float                            kbdf,
+                           ValueMap*                        values);
+
+    /*! Returns true if the current token is the keyword of a wavelength block. */
+    static bool isWavelengthKeyword(const Tokenizer& tokenizer);
 };
 
 } // namespace lb
@@ -0,0 +1,125 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_DDR_SLAB_READER_H
+#define LIBBSDF_DDR_SLAB_READER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
+#include <libbsdf/Reader/DdrReader.h>
+#include <libbsdf/Reader/FileInfo.h>
+
+namespace lb {
+
+/*!
+ * \class DdrSlabReader
+ * \brief The DdrSlabReader class provides the streaming reader for a DDR and DDT file.
+ *
+ * A BRDF is read as slabs of incoming directions, so the whole file is not held in memory.
+ * A slab is lb::SpecularCoordinatesBrdf with one incoming polar angle and one incoming azimuthal angle.
+ * open() scans the file once and records the position of the values of each incoming direction
+ * in each wavelength block. readSlab() parses only these values.
+ * The samples of a slab are equal to those of the BRDF read by lb::DdrReader.
+ * Relative values are equalized to "kbdf"s with the reflectance of the slab itself,
+ * so they can differ from lb::DdrReader by rounding errors of interpolation.
+ */
+class DdrSlabReader
+{
+public:
+    DdrSlabReader();
+
+    /*! Opens a DDR or DDT file and scans the positions of values. */
+    bool open(const std::string& fileName);
+
+    /*!
+     * Gets the attributes of the whole BRDF. Angles and wavelengths are equal to those of
+     * the BRDF read by lb::DdrReader.
+     */
+    const FileInfo& getInfo() const;
+
+    /*! Gets the number of incoming polar angles. */
+    int getNumInTheta() const;
+
+    /*! Gets the number of incoming azimuthal angles. */
+    int getNumInPhi() const;
+
+    /*! Reads the slab of an incoming direction. Returns 0 if values are invalid. */
+    SpecularCoordinatesBrdf* readSlab(int inThIndex, int inPhIndex);
+
+private:
+    /*! Processes a token of the data section while the positions of values are scanned. */
+    bool scanToken(const Tokenizer& tokenizer, uint64_t tokenOffset, uint64_t tokenEndOffset);
+
+    /*! Finishes the wavelength block in scanning. Returns false if values are not enough. */
+    bool finishBlock();
+
+    /*! Gets the index of a segment of values in all blocks. */
+    size_t getSegmentIndex(int wlIndex, int inDirIndex) const;
+
+    /*! The states of scanning a wavelength block. */
+    enum ScanState {
+        EXPECT_KEYWORD,     /*!< Tokens are skipped until a wavelength keyword. */
+        EXPECT_WAVELENGTH,  /*!< A wavelength of a spectral block is expected. */
+        EXPECT_KBDF,        /*!< "kbdf" or "def" is expected. */
+        READ_KBDF,          /*!< Values of "kbdf" are read. */
+        SKIP_DEF,           /*!< "def" after "kbdf"s is skipped. */
+        READ_VALUES         /*!< Values are counted. */
+    };
+
+    std::ifstream stream_; /*!< The stream of the file. */
+
+    DdrReader::Header   header_;    /*!< The attributes in the header. */
+    FileInfo            info_;      /*!< The attributes of the whole BRDF. */
+
+    Arrayf inThetaAngles_;      /*!< The incoming polar angles before clamped. */
+    Arrayf inPhiAngles_;        /*!< The incoming azimuthal angles before clamped. */
+    Arrayf specThetaAngles_;    /*!< The specular polar angles before clamped. */
+    Arrayf specularOffsets_;    /*!< The offsets of specular directions. */
+
+    int numBlocks_;     /*!< The number of loaded wavelength blocks. */
+    int numInDirs_;     /*!< The number of incoming directions. */
+    int numSegValues_;  /*!< The number of values of an incoming direction in a block. */
+
+    /*!
+     * The offsets of the values of incoming directions in blocks. Each block has
+     * (the number of incoming directions + 1) offsets and the last one is the end of values.
+     */
+    std::vector<uint64_t> segmentOffsets_;
+
+    std::vector<std::vector<float>> blockKbdfs_;    /*!< The "kbdf"s of blocks. */
+    std::vector<float>              kbdfs_;         /*!< The "kbdf"s of all blocks. */
+
+    ScanState   scanState_;         /*!< The state of scanning. */
+    uint64_t    numValues_;         /*!< The number of values counted in the current block. */
+    int         numFoundBlocks_;    /*!< The number of found wavelength blocks including ignored ones. */
+};
+
+inline DdrSlabReader::DdrSlabReader() : numBlocks_(0),
+                                        numInDirs_(0),
+                                        numSegValues_(0),
+                                        scanState_(EXPECT_KEYWORD),
+                                        numValues_(0),
+                                        numFoundBlocks_(0) {}
+
+inline const FileInfo& DdrSlabReader::getInfo() const { return info_; }
+
+inline int DdrSlabReader::getNumInTheta() const { return static_cast<int>(info_.angles0.size()); }
+inline int DdrSlabReader::getNumInPhi()   const { return static_cast<int>(info_.angles1.size()); }
+
+inline size_t DdrSlabReader::getSegmentIndex(int wlIndex, int inDirIndex) const
+{
+    return static_cast<size_t>(numInDirs_ + 1) * wlIndex + inDirIndex;
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_DDR_SLAB_READER_H
@@ -0,0 +1,52 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_FILE_INFO_H
+#define LIBBSDF_FILE_INFO_H
+
+#include <libbsdf/Common/Array.h>
+#include <libbsdf/Common/Global.h>
+
+namespace lb {
+
+/*!
+ * \struct  FileInfo
+ * \brief   The FileInfo struct provides the attributes of a file read from the header without spectra.
+ *
+ * Angles are in radians and equal to the angles of the BRDF created by a reader.
+ * An array is empty if the values are not determined by the header, e.g. angles listed in data blocks.
+ */
+struct FileInfo
+{
+    FileInfo();
+
+    FileType                fileType;           /*!< The type of the file. */
+    DataType                dataType;           /*!< The data type of scatter. */
+    SourceType              sourceType;         /*!< The data type of source. */
+    CoordinateSystemType    coordinateSystem;   /*!< The coordinate system of the BRDF. */
+    ColorModel              colorModel;         /*!< The color model of spectra. */
+    int                     numWavelengths;     /*!< The number of wavelengths. Zero if unknown. */
+
+    Arrayf wavelengths;     /*!< The wavelengths of spectra. */
+    Arrayf angles0;         /*!< The angles of the first parameter. */
+    Arrayf angles1;         /*!< The angles of the second parameter. */
+    Arrayf angles2;         /*!< The angles of the third parameter. */
+    Arrayf angles3;         /*!< The angles of the fourth parameter. */
+    Arrayf specularOffsets; /*!< The offsets of specular directions of lb::SpecularCoordinatesBrdf. */
+};
+
+inline FileInfo::FileInfo() : fileType(UNKNOWN_FILE),
+                              dataType(UNKNOWN_DATA),
+                              sourceType(UNKNOWN_SOURCE),
+                              coordinateSystem(UNKNOWN_COORDINATE_SYSTEM),
+                              colorModel(UNKNOWN_MODEL),
+                              numWavelengths(0) {}
+
+} // namespace lb
+
+#endif // LIBBSDF_FILE_INFO_H
@@ -13,16 +13,21 @@
 
 #include <libbsdf/Brdf/SphericalCoordinatesBrdf.h>
 #include <libbsdf/Brdf/TwoSidedMaterial.h>
+#include <libbsdf/Reader/FileInfo.h>
 #include <libbsdf/Reader/ReaderUtility.h>
 
 namespace lb {
 
+class Tokenizer;
+
 /*!
  * \class LightToolsBsdfReader
  * \brief The LightToolsBsdfReader class provides the reader for a LightTools BSDF file.
  *
  * A LightTools BSDF file can contain BRDFs and BTDFs of front and back.
  * lb::TwoSidedMaterial is created from loaded data.
+ * The whole file is loaded into memory and scanned by lb::Tokenizer.
+ * Data blocks record the positions of values, which are parsed in parallel into BRDFs.
  */
 class LightToolsBsdfReader
 {
@@ -30,6 +35,13 @@ public:
     /*! Reads a LightTools BSDF file and creates the two-sided material of a spherical coordinate system. */
     static TwoSidedMaterial* read(const std::string& fileName);
 
+    /*!
+     * Reads the header of a LightTools BSDF file and the attributes of the first data block without samples.
+     * The data type is the scatter type of the first data block. Incoming angles are not determined
+     * because they are listed in data blocks.
+     */
+    static bool readInfo(const std::string& fileName, FileInfo* info);
+
 private:
     enum SymmetryType {
         UNKNOWN_SYMMETRY = 0,
@@ -48,7 +60,7 @@ private:
         TRIS_Z = 2
     };
 
-    /*! The data structure of a LightTools BRDF. */
+    /*! The attributes of a LightTools BRDF block. Values are parsed from [values, valuesEnd). */
     struct DataBlock
     {
         DataBlock();
@@ -62,26 +74,48 @@ private:
         DataType                dataType;
         TristimulusValueType    tristimulusValueType;
 
-        Arrayf samples;
+        const char* values;     /*!< The first character of values. */
+        const char* valuesEnd;  /*!< The position after the last value. */
 
-        static bool cmp(DataBlock* lhs, DataBlock* rhs);
+        static bool cmp(const DataBlock& lhs, const DataBlock& rhs);
     };
 
-    /*! Skips comment lines. */
-    static void ignoreCommentLines(std::istream& stream);
+    /*! The attributes in the header of a file. */
+    struct Header
+    {
+        Header();
+
+        SymmetryType    symmetryType;
+        ColorModel      colorModel;
 
-    /*! Creates a BRDF from LightTools BRDF data. */
-    static SphericalCoordinatesBrdf* createBrdf(std::vector<DataBlock*>&    brdfData,
+        std::vector<float> outThetaDegrees;
+        std::vector<float> outPhiDegrees;
+    };
+
+    /*!
+     * Reads the header until "DataBegin". The position of \a tokenizer is set to the data.
+     * Returns false if the header is invalid.
+     */
+    static bool readHeader(Tokenizer* tokenizer, Header* header);
+
+    /*!
+     * Reads the attributes of data blocks and skips values. Blocks are appended to the list of
+     * the side and scatter type.
+     */
+    static bool readDataBlocks(Tokenizer*               tokenizer,
+                               size_t                   numValues,
+                               std::vector<DataBlock>*  frontBrdfData,
+                               std::vector<DataBlock>*  frontBtdfData,
+                               std::vector<DataBlock>*  backBrdfData,
+                               std::vector<DataBlock>*  backBtdfData);
+
+    /*! Creates a BRDF from LightTools BRDF data. Values of blocks are parsed into the BRDF. */
+    static SphericalCoordinatesBrdf* createBrdf(std::vector<DataBlock>&     brdfData,
                                                 const std::vector<float>&   outThetaDegrees,
                                                 const std::vector<float>&   outPhiDegrees,
                                                 ColorModel                  colorModel);
 };
 
-inline void LightToolsBsdfReader::ignoreCommentLines(std::istream& stream)
-{
-    reader_utility::ignoreCommentLines(stream, "#");
-}
-
 } // namespace lb
 
 #endif // LIBBSDF_LIGHTTOOLS_BSDF_READER_H
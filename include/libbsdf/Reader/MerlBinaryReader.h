@@ -12,6 +12,7 @@
 #include <string>
 
 #include <libbsdf/Brdf/HalfDifferenceCoordinatesBrdf.h>
+#include <libbsdf/Reader/FileInfo.h>
 
 namespace lb {
 
@@ -32,6 +33,20 @@ class MerlBinaryReader
 public:
     /*! Reads a MERL binary file and creates the BRDF of a half difference coordinate system. */
     static HalfDifferenceCoordinatesBrdf* read(const std::string& fileName);
+
+    /*! Reads the dimensions of a MERL binary file and creates the fixed angles without samples. */
+    static bool readInfo(const std::string& fileName, FileInfo* info);
+
+private:
+    static const int NUM_HALF_THETA = 90;  /*!< The number of half polar angles in a file. */
+    static const int NUM_DIFF_THETA = 90;  /*!< The number of difference polar angles in a file. */
+    static const int NUM_DIFF_PHI   = 360; /*!< The number of difference azimuthal angles of a full circle. */
+
+    /*! Reads the dimensions in the header. Returns false if they do not match the format. */
+    static bool readDimensions(std::istream& stream);
+
+    /*! Computes the half polar angle of a non-linear mapping. */
+    static float computeHalfTheta(int index);
 };
 
 } // namespace lb
@@ -15,16 +15,22 @@
 #define LIBBSDF_READER_UTILITY_H
 
 #include <algorithm>
+#include <functional>
 #include <istream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <libbsdf/Brdf/Brdf.h>
 #include <libbsdf/Common/Global.h>
 #include <libbsdf/Common/Log.h>
+#include <libbsdf/Reader/FileInfo.h>
 
 namespace lb {
+
+class Tokenizer;
+
 namespace reader_utility {
 
 /*! \brief Outputs an unsupported keyword. */
@@ -42,6 +48,37 @@ void ignoreCommentLines(std::istream& stream, const std::string& lineHead);
 */
 std::istream& safeGetline(std::istream& stream, std::string& token);
 
+/*!
+ * \brief Reads the whole file into \a buffer. The buffer is terminated by '\0', which is not included in the content.
+ * Returns false if the file could not be read.
+ */
+bool readFile(const std::string& fileName, std::vector<char>* buffer);
+
+/*!
+ * \brief Reads at most \a maxSize bytes from the beginning of a file into \a buffer.
+ * The buffer is terminated by '\0'. \a truncated is set to true if the file is longer than \a maxSize.
+ * Returns false if the file could not be read.
+ */
+bool readFile(const std::string& fileName, std::vector<char>* buffer, size_t maxSize, bool* truncated);
+
+/*!
+ * \brief Reads the beginning of a file until a line whose first token satisfies \a isEndLine.
+ * Tokens beginning with \a commentHead are skipped. The size of the loaded part is doubled until the line is found.
+ * \a headerSize is set to the offset of the line, or the size of the file if the line is not found.
+ * Returns false if the file could not be read.
+ */
+bool readFileHead(const std::string&                            fileName,
+                  const char*                                   commentHead,
+                  const std::function<bool(const Tokenizer&)>&  isEndLine,
+                  std::vector<char>*                            buffer,
+                  size_t*                                       headerSize);
+
+/*!
+ * \brief Reads the number of angles and angles following the current token.
+ * Returns false if a value is not a number.
+ */
+bool readAngles(Tokenizer* tokenizer, std::vector<float>* angles);
+
 /*! \brief Converts a string to lower-case. */
 std::string toLower(const std::string& str);
 
@@ -51,12 +88,45 @@ bool isEqual(const std::string& lhs, const std::string& rhs);
 /*! \brief Returns true if the string ends with \a suffix. */
 bool hasSuffix(const std::string &fileName, const std::string &suffix);
 
+/*!
+ * \brief Converts the azimuthal angles of specular directions from degrees to clamped radians.
+ * If \a planeSymmetrical is true, the angles mirrored across the plane of incidence are appended.
+ */
+Arrayf computeSpecPhiAngles(const std::vector<float>& degrees, bool planeSymmetrical);
+
 /*! \brief Classifies the type of a file. */
 FileType classifyFile(const std::string& fileName);
 
 /*! \brief Reads a BRDF/BTDF/BSDF/Material file and returns a lb::Brdf, file type, and data type. */
 std::shared_ptr<Brdf> read(const std::string& fileName, FileType* fileType, DataType* dataType);
 
+/*! \brief The result of loading a file with readAll(). */
+struct ReadResult
+{
+    ReadResult();
+
+    std::shared_ptr<Brdf>   brdf;           /*!< The loaded BRDF. Null if loading failed. */
+    FileType                fileType;       /*!< The type of the file. */
+    DataType                dataType;       /*!< The data type of the file. */
+    std::string             errorMessage;   /*!< The reason of failure. Empty if loading succeeded. */
+};
+
+/*!
+ * \brief Reads BRDF/BTDF/BSDF/Material files concurrently and returns the results in the order of \a fileNames.
+ *
+ * Files are taken from a shared queue by \a numThreads workers. Each worker reads and parses a file,
+ * so the disk reads of some files overlap the parsing of others. At most \a numThreads files are in flight.
+ * If \a numThreads is zero or less, the default number of threads of OpenMP is used.
+ * A failure of a file does not stop the others.
+ */
+std::vector<ReadResult> readAll(const std::vector<std::string>& fileNames, int numThreads = 0);
+
+/*!
+ * \brief Reads the header of a BRDF/BTDF/BSDF/Material file without spectra.
+ * Returns false if the file could not be identified.
+ */
+bool readInfo(const std::string& fileName, FileInfo* info);
+
 } // namespace reader_utility
 
 /*
@@ -73,6 +143,9 @@ inline void reader_utility::ignoreLine(std::istream& stream)
     stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
+inline reader_utility::ReadResult::ReadResult() : fileType(UNKNOWN_FILE),
+                                                   dataType(UNKNOWN_DATA) {}
+
 inline std::string reader_utility::toLower(const std::string& str)
 {
     std::string lowerStr(str);
@@ -9,9 +9,12 @@
 #ifndef LIBBSDF_SDR_READER_H
 #define LIBBSDF_SDR_READER_H
 
+#include <istream>
 #include <string>
+#include <vector>
 
 #include <libbsdf/Brdf/SampleSet2D.h>
+#include <libbsdf/Reader/FileInfo.h>
 
 namespace lb {
 
@@ -28,6 +31,28 @@ class SdrReader
 public:
     /*! Reads a SDR or SDT file and creates sample points. */
     static SampleSet2D* read(const std::string& fileName);
+
+    /*! Reads the header of a SDR or SDT file without reflectances. */
+    static bool readInfo(const std::string& fileName, FileInfo* info);
+
+private:
+    /*! The attributes in the header of a file. */
+    struct Header
+    {
+        Header();
+
+        SourceType  sourceType;
+        ColorModel  colorModel;
+        int         numWavelengths;
+
+        std::vector<float> inThetaDegrees;
+    };
+
+    /*!
+     * Reads the header until the first wavelength block. The position of \a stream is set to the block.
+     * Returns false if the header is invalid.
+     */
+    static bool readHeader(std::istream& stream, Header* header);
 };
 
 } // namespace lb
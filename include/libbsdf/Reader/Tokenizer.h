@@ -0,0 +1,194 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_TOKENIZER_H
+#define LIBBSDF_TOKENIZER_H
+
+#include <cstring>
+#include <string>
+
+namespace lb {
+
+/*!
+ * \class   Tokenizer
+ * \brief   The Tokenizer class provides the scanner of whitespace-separated tokens in a text buffer.
+ *
+ * Tokens are views of the buffer, so scanning does not allocate memory.
+ * Lines beginning with a comment head are skipped.
+ * Numbers are parsed with an exact fast path, and std::strtod() or std::strtof() is used for
+ * other inputs. Parsed values are equal to the results of these functions.
+ * The buffer must be followed by a character that cannot be a part of a number, such as '\0'.
+ */
+class Tokenizer
+{
+public:
+    /*!
+     * Constructs a tokenizer of the range [\a first, \a last).
+     * Tokens beginning with \a commentHead are skipped with the rest of the line.
+     */
+    Tokenizer(const char* first, const char* last, const char* commentHead = 0);
+
+    /*! Moves to the next token. Returns false if no token is found. */
+    bool next();
+
+    /*! Returns true if the current token equals \a str ignoring case. */
+    bool isToken(const char* str) const;
+
+    /*! Returns true if the current token begins with \a str. */
+    bool hasPrefix(const char* str) const;
+
+    /*! Gets the current token as a string. */
+    std::string getToken() const;
+
+    /*! Gets the first character of the current token. */
+    const char* getTokenBegin() const;
+
+    /*! Gets the position after the last character of the current token. */
+    const char* getTokenEnd() const;
+
+    /*! Reads the next token as an integer. Returns false if the token is not an integer. */
+    bool readInt(int* value);
+
+    /*! Reads the next token as a float. Returns false if the token is not a number. */
+    bool readFloat(float* value);
+
+    /*! Reads the next token as a double. Returns false if the token is not a number. */
+    bool readDouble(double* value);
+
+    /*! Skips the rest of the current line. */
+    void skipLine();
+
+    /*! Gets the position of scanning. */
+    const char* getPosition() const;
+
+    /*! Sets the position of scanning. The current token is cleared. */
+    void setPosition(const char* position);
+
+    /*! Parses a number in the range [\a first, \a last) as a float. */
+    static bool parseFloat(const char* first, const char* last, float* value);
+
+    /*! Parses a number in the range [\a first, \a last) as a double. */
+    static bool parseDouble(const char* first, const char* last, double* value);
+
+    /*! Returns true if \a c is a whitespace character. */
+    static bool isSpace(char c);
+
+private:
+    /*!
+     * Parses the mantissa and exponent of a decimal number.
+     * Returns false if the number is not handled by the fast path.
+     */
+    static bool parseDecimal(const char*            first,
+                             const char*            last,
+                             bool*                  negative,
+                             unsigned long long*    mantissa,
+                             int*                   exponent);
+
+    const char* last_;          /*!< The position after the last character of the buffer. */
+    const char* position_;      /*!< The current position of scanning. */
+    const char* tokenBegin_;    /*!< The first character of the current token. */
+    const char* tokenEnd_;      /*!< The position after the last character of the current token. */
+
+    const char* commentHead_;   /*!< The head of comment lines. */
+    size_t      commentSize_;   /*!< The length of the comment head. */
+};
+
+inline Tokenizer::Tokenizer(const char* first,
+                            const char* last,
+                            const char* commentHead)
+                            : last_(last),
+                              position_(first),
+                              tokenBegin_(first),
+                              tokenEnd_(first),
+                              commentHead_(commentHead),
+                              commentSize_(commentHead ? std::strlen(commentHead) : 0) {}
+
+inline bool Tokenizer::next()
+{
+    for (;;) {
+        while (position_ != last_ && isSpace(*position_)) {
+            ++position_;
+        }
+
+        tokenBegin_ = position_;
+        while (position_ != last_ && !isSpace(*position_)) {
+            ++position_;
+        }
+        tokenEnd_ = position_;
+
+        if (tokenBegin_ == tokenEnd_) return false;
+
+        if (commentSize_ != 0 && hasPrefix(commentHead_)) {
+            skipLine();
+            continue;
+        }
+
+        return true;
+    }
+}
+
+inline bool Tokenizer::isToken(const char* str) const
+{
+    const char* c = tokenBegin_;
+    for (; c != tokenEnd_ && *str != '\0'; ++c, ++str) {
+        char lhs = (*c   >= 'A' && *c   <= 'Z') ? *c   - 'A' + 'a' : *c;
+        char rhs = (*str >= 'A' && *str <= 'Z') ? *str - 'A' + 'a' : *str;
+        if (lhs != rhs) return false;
+    }
+
+    return (c == tokenEnd_ && *str == '\0');
+}
+
+inline bool Tokenizer::hasPrefix(const char* str) const
+{
+    size_t size = std::strlen(str);
+    return (static_cast<size_t>(tokenEnd_ - tokenBegin_) >= size &&
+            std::strncmp(tokenBegin_, str, size) == 0);
+}
+
+inline std::string Tokenizer::getToken() const { return std::string(tokenBegin_, tokenEnd_); }
+
+inline const char* Tokenizer::getTokenBegin() const { return tokenBegin_; }
+inline const char* Tokenizer::getTokenEnd()   const { return tokenEnd_; }
+
+inline bool Tokenizer::readFloat(float* value)
+{
+    return (next() && parseFloat(tokenBegin_, tokenEnd_, value));
+}
+
+inline bool Tokenizer::readDouble(double* value)
+{
+    return (next() && parseDouble(tokenBegin_, tokenEnd_, value));
+}
+
+inline void Tokenizer::skipLine()
+{
+    while (position_ != last_ && *position_ != '\n') {
+        ++position_;
+    }
+
+    if (position_ != last_) {
+        ++position_;
+    }
+}
+
+inline const char* Tokenizer::getPosition() const { return position_; }
+
+inline void Tokenizer::setPosition(const char* position)
+{
+    position_ = tokenBegin_ = tokenEnd_ = position;
+}
+
+inline bool Tokenizer::isSpace(char c)
+{
+    return (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f');
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_TOKENIZER_H
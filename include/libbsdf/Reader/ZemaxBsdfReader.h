@@ -12,15 +12,20 @@
 #include <string>
 
 #include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
+#include <libbsdf/Reader/FileInfo.h>
 #include <libbsdf/Reader/ReaderUtility.h>
 
 namespace lb {
 
+class Tokenizer;
+
 /*!
  * \class ZemaxBsdfReader
  * \brief The ZemaxBsdfReader class provides the reader for a Zemax BSDF file.
  *
  * A Zemax BSDF file can contain a BRDF or BTDF.
+ * The whole file is loaded into memory and scanned by lb::Tokenizer.
+ * Data blocks of incoming directions are parsed in parallel into the samples of a BRDF.
  *
  * File format:
  * https://www.zemax.com/support/knowledgebase/bsdf-data-interchange-file-format-specification
@@ -34,6 +39,9 @@ public:
      */
     static SpecularCoordinatesBrdf* read(const std::string& fileName, DataType* dataType);
 
+    /*! Reads the header of a Zemax BSDF file without samples. */
+    static bool readInfo(const std::string& fileName, FileInfo* info);
+
 private:
     enum SymmetryType {
         UNKNOWN_SYMMETRY = 0,
@@ -42,14 +50,42 @@ private:
         ASYMMETRICAL_4D
     };
 
-    /*! Skips comment lines. */
-    static void ignoreCommentLines(std::istream& stream);
-};
+    /*! The attributes in the header of a file. */
+    struct Header
+    {
+        Header();
 
-inline void ZemaxBsdfReader::ignoreCommentLines(std::istream& stream)
-{
-    reader_utility::ignoreCommentLines(stream, "#");
-}
+        SymmetryType    symmetryType;
+        ColorModel      colorModel;
+        DataType        dataType;
+
+        std::vector<float> inThetaDegrees;
+        std::vector<float> inPhiDegrees;
+        std::vector<float> spThetaDegrees;
+        std::vector<float> spPhiDegrees;
+    };
+
+    /*!
+     * Reads the header until the first data block. The position of \a tokenizer is set to the block.
+     * Returns false if the header is invalid.
+     */
+    static bool readHeader(Tokenizer* tokenizer, Header* header);
+
+    /*!
+     * Reads the values of a data block after "TIS" into the samples of an incoming direction.
+     * Values of plane symmetrical data are copied to mirrored samples.
+     */
+    static bool readValues(Tokenizer*                       tokenizer,
+                           SpecularCoordinatesBrdf*         brdf,
+                           int                              inThIndex,
+                           int                              inPhIndex,
+                           int                              wlIndex,
+                           SymmetryType                     symmetryType,
+                           int                              numSpecPhiDegrees);
+
+    /*! Returns true if the current token is the keyword of a color channel. */
+    static bool isChannelKeyword(const Tokenizer& tokenizer);
+};
 
 } // namespace lb
 
@@ -11,6 +11,7 @@
 
 #include <libbsdf/Common/Global.h>
 #include <libbsdf/ReflectanceModel/ReflectanceModel.h>
+#include <libbsdf/ReflectanceModel/SoaVec3.h>
 
 namespace lb {
 
@@ -35,12 +36,33 @@ public:
                         const Vec3& color,
                         float       shininess);
 
+    /*! Computes values of a block of directions. The normal is the Z-axis. */
+    template <typename ScalarT>
+    static void compute(const SoaVec3<ScalarT>& L,
+                        const SoaVec3<ScalarT>& V,
+                        const Vec3&             color,
+                        float                   shininess,
+                        SoaVec3<ScalarT>*       values);
+
     Vec3 getValue(const Vec3& inDir, const Vec3& outDir) const
     {
         const Vec3 N = Vec3(0.0, 0.0, 1.0);
         return compute(inDir, outDir, N, color_, shininess_);
     }
 
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values) const
+    {
+        using Scalar = Vec3::Scalar;
+
+        evaluateSoa<Scalar>(inDirs, outDirs, numDirs, values,
+                            [this](const SoaVec3<Scalar>& L, const SoaVec3<Scalar>& V, SoaVec3<Scalar>* values) {
+                                compute(L, V, color_, shininess_, values);
+                            });
+    }
+
     Vec3 getBrdfValue(const Vec3& inDir, const Vec3& outDir) const
     {
         using std::max;
@@ -50,6 +72,19 @@ public:
         return getValue(inDir, outDir) / max(dotLN, EPSILON_F);
     }
 
+    void getBrdfValues(const Vec3*  inDirs,
+                       const Vec3*  outDirs,
+                       size_t       numDirs,
+                       Vec3*        values) const
+    {
+        using std::max;
+
+        BlinnPhong::getValues(inDirs, outDirs, numDirs, values);
+        for (size_t i = 0; i < numDirs; ++i) {
+            values[i] /= max(inDirs[i].z(), EPSILON_F);
+        }
+    }
+
     bool isIsotropic() const { return true; }
 
     std::string getName() const { return "Blinn-Phong"; }
@@ -83,6 +118,27 @@ inline Vec3 BlinnPhong::compute(const Vec3& L,
     return color * pow(max(dotHN, 0.0f), shininess);
 }
 
+template <typename ScalarT>
+void BlinnPhong::compute(const SoaVec3<ScalarT>&    L,
+                         const SoaVec3<ScalarT>&    V,
+                         const Vec3&                color,
+                         float                      shininess,
+                         SoaVec3<ScalarT>*          values)
+{
+    using Array = typename SoaVec3<ScalarT>::Array;
+
+    SoaVec3<ScalarT> H;
+    H.x = L.x + V.x;
+    H.y = L.y + V.y;
+    H.z = L.z + V.z;
+    H.normalize();
+
+    Array cosine = H.z.max(ScalarT(0)).pow(ScalarT(shininess));
+    values->x = ScalarT(color[0]) * cosine;
+    values->y = ScalarT(color[1]) * cosine;
+    values->z = ScalarT(color[2]) * cosine;
+}
+
 } // namespace lb
 
 #endif // LIBBSDF_BLINN_PHONG_H
@@ -41,6 +41,11 @@ public:
 #endif
     }
 
+    /*!
+     * Computes a value. Intermediate values are computed in \a ScalarT.
+     * getValue() uses double as the reference, and getValues() uses float for speed.
+     */
+    template <typename ScalarT = double>
     static Vec3 compute(const Vec3& L,
                         const Vec3& V,
                         const Vec3& N,
@@ -55,6 +60,28 @@ public:
         return compute(inDir, outDir, N, color_, roughness_, refractiveIndex_, extinctionCoefficient_);
     }
 
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values) const
+    {
+        using Scalar = Vec3::Scalar;
+
+        const Vec3 N = Vec3(0.0, 0.0, 1.0);
+
+        for (size_t i = 0; i < numDirs; ++i) {
+            values[i] = compute<Scalar>(inDirs[i], outDirs[i], N, color_, roughness_, refractiveIndex_, extinctionCoefficient_);
+        }
+    }
+
+    void getBrdfValues(const Vec3*  inDirs,
+                       const Vec3*  outDirs,
+                       size_t       numDirs,
+                       Vec3*        values) const
+    {
+        CookTorrance::getValues(inDirs, outDirs, numDirs, values);
+    }
+
     bool isIsotropic() const { return true; }
 
     std::string getName() const { return "Cook-Torrance"; }
@@ -76,26 +103,27 @@ private:
  * Implementation
  */
 
-inline Vec3 CookTorrance::compute(const Vec3&   L,
-                                  const Vec3&   V,
-                                  const Vec3&   N,
-                                  const Vec3&   color,
-                                  float         roughness,
-                                  float         refractiveIndex,
-                                  float         extinctionCoefficient)
+template <typename ScalarT>
+Vec3 CookTorrance::compute(const Vec3&   L,
+                           const Vec3&   V,
+                           const Vec3&   N,
+                           const Vec3&   color,
+                           float         roughness,
+                           float         refractiveIndex,
+                           float         extinctionCoefficient)
 {
     using std::acos;
     using std::exp;
     using std::min;
 
-    double alpha = roughness * roughness;
+    ScalarT alpha = roughness * roughness;
 
-    double dotLN = L.dot(N);
-    double dotVN = V.dot(N);
+    ScalarT dotLN = L.dot(N);
+    ScalarT dotVN = V.dot(N);
 
     Vec3 H = (L + V).normalized();
-    double dotHN = H.dot(N);
-    double dotVH = min(V.dot(H), Vec3::Scalar(1));
+    ScalarT dotHN = H.dot(N);
+    ScalarT dotVH = min(V.dot(H), Vec3::Scalar(1));
 
 #if defined(LIBBSDF_USE_COLOR_INSTEAD_OF_REFRACTIVE_INDEX)
     Vec3 F = fresnelSchlick(dotVH, color);
@@ -104,16 +132,16 @@ inline Vec3 CookTorrance::compute(const Vec3&   L,
     Vec3 F = color * fresnelComplex(inTheta, refractiveIndex, extinctionCoefficient);
 #endif
 
-    double G = min(dotHN * dotVN / dotVH,
+    ScalarT G = min(dotHN * dotVN / dotVH,
                    dotHN * dotLN / dotVH);
-    G = min(1.0, 2.0 * G);
+    G = min(ScalarT(1), ScalarT(2) * G);
 
-    double sqDotHN = dotHN * dotHN;
-    double sqAlpha = alpha * alpha;
-    double sqTanHN = (1.0 - sqDotHN) / (sqAlpha * sqDotHN);
-    double D = exp(-sqTanHN) / (PI_D * sqAlpha * sqDotHN * sqDotHN);
+    ScalarT sqDotHN = dotHN * dotHN;
+    ScalarT sqAlpha = alpha * alpha;
+    ScalarT sqTanHN = (ScalarT(1) - sqDotHN) / (sqAlpha * sqDotHN);
+    ScalarT D = exp(-sqTanHN) / (ScalarT(PI_D) * sqAlpha * sqDotHN * sqDotHN);
 
-    return F * G * D / (4.0 * dotLN * dotVN);
+    return F * G * D / (ScalarT(4) * dotLN * dotVN);
 }
 
 } // namespace lb
@@ -36,6 +36,11 @@ public:
         parameters_.push_back(Parameter("Diffuse color",    &diffuseColor_));
     }
 
+    /*!
+     * Computes a value. Intermediate values are computed in \a ScalarT.
+     * getValue() uses double as the reference, and getValues() uses float for speed.
+     */
+    template <typename ScalarT = double>
     static Vec3 compute(const Vec3& L,
                         const Vec3& V,
                         const Vec3& N,
@@ -56,6 +61,31 @@ public:
                        specularColor_, diffuseColor_, roughnessX_, roughnessY_);
     }
 
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values) const
+    {
+        using Scalar = Vec3::Scalar;
+
+        const Vec3 N = Vec3(0.0, 0.0, 1.0);
+        const Vec3 T = Vec3(1.0, 0.0, 0.0);
+        const Vec3 B = Vec3(0.0, -1.0, 0.0);
+
+        for (size_t i = 0; i < numDirs; ++i) {
+            values[i] = compute<Scalar>(inDirs[i], outDirs[i], N, T, B,
+                                        specularColor_, diffuseColor_, roughnessX_, roughnessY_);
+        }
+    }
+
+    void getBrdfValues(const Vec3*  inDirs,
+                       const Vec3*  outDirs,
+                       size_t       numDirs,
+                       Vec3*        values) const
+    {
+        Disney::getValues(inDirs, outDirs, numDirs, values);
+    }
+
     bool isIsotropic() const { return false; }
 
     std::string getName() const { return "Disney"; }
@@ -77,57 +107,58 @@ private:
  * Implementation
  */
 
-inline Vec3 Disney::compute(const Vec3& L,
-                            const Vec3& V,
-                            const Vec3& N,
-                            const Vec3& T,
-                            const Vec3& B,
-                            const Vec3& specularColor,
-                            const Vec3& diffuseColor,
-                            float       roughnessX,
-                            float       roughnessY)
+template <typename ScalarT>
+Vec3 Disney::compute(const Vec3& L,
+                     const Vec3& V,
+                     const Vec3& N,
+                     const Vec3& T,
+                     const Vec3& B,
+                     const Vec3& specularColor,
+                     const Vec3& diffuseColor,
+                     float       roughnessX,
+                     float       roughnessY)
 {
     using std::min;
     using std::pow;
 
-    double alphaX = roughnessX * roughnessX;
-    double alphaY = roughnessY * roughnessY;
-    double sqAlpha = alphaX * alphaY;
+    ScalarT alphaX = roughnessX * roughnessX;
+    ScalarT alphaY = roughnessY * roughnessY;
+    ScalarT sqAlpha = alphaX * alphaY;
 
-    double dotLN = L.dot(N);
-    double dotVN = V.dot(N);
+    ScalarT dotLN = L.dot(N);
+    ScalarT dotVN = V.dot(N);
 
     Vec3 H = (L + V).normalized();
 
-    double dotHN = H.dot(N);
-    double dotHT = H.dot(T);
-    double dotHB = H.dot(B);
-    double dotVH = min(V.dot(H), Vec3::Scalar(1));
+    ScalarT dotHN = H.dot(N);
+    ScalarT dotHT = H.dot(T);
+    ScalarT dotHB = H.dot(B);
+    ScalarT dotVH = min(V.dot(H), Vec3::Scalar(1));
 
     Vec3 F = fresnelSchlick(dotVH, specularColor);
 
     // Remap roughness.
-    double roughnessXG = 0.5 + roughnessX * 0.5;
-    double roughnessYG = 0.5 + roughnessY * 0.5;
-    double alphaXG = roughnessXG * roughnessXG;
-    double alphaYG = roughnessYG * roughnessYG;
-    double sqAlphaG = alphaXG * alphaYG;
-    double G = Ggx::computeG1(dotVN, sqAlphaG) * Ggx::computeG1(dotLN, sqAlphaG);
-
-    double denominatorD = dotHT * dotHT / (alphaX * alphaX)
+    ScalarT roughnessXG = ScalarT(0.5) + roughnessX * ScalarT(0.5);
+    ScalarT roughnessYG = ScalarT(0.5) + roughnessY * ScalarT(0.5);
+    ScalarT alphaXG = roughnessXG * roughnessXG;
+    ScalarT alphaYG = roughnessYG * roughnessYG;
+    ScalarT sqAlphaG = alphaXG * alphaYG;
+    ScalarT G = Ggx::computeG1(dotVN, sqAlphaG) * Ggx::computeG1(dotLN, sqAlphaG);
+
+    ScalarT denominatorD = dotHT * dotHT / (alphaX * alphaX)
                         + dotHB * dotHB / (alphaY * alphaY)
                         + dotHN * dotHN;
-    double D = 1.0 / (PI_D * sqAlpha * denominatorD * denominatorD);
+    ScalarT D = ScalarT(1) / (ScalarT(PI_D) * sqAlpha * denominatorD * denominatorD);
 
     // specular component
-    Vec3 sBrdf = F * G * D / (4.0 * dotLN * dotVN);
+    Vec3 sBrdf = F * G * D / (ScalarT(4) * dotLN * dotVN);
 
-    double Fd90 = 0.5 + 2.0 * (roughnessX + roughnessY) / 2.0 * dotVH * dotVH;
+    ScalarT Fd90 = ScalarT(0.5) + ScalarT(2) * (roughnessX + roughnessY) / ScalarT(2) * dotVH * dotVH;
 
     // diffuse component
-    Vec3 dBrdf = diffuseColor / PI_D
-               * (1.0 + (Fd90 - 1.0) * pow(1.0 - dotLN, 5.0))
-               * (1.0 + (Fd90 - 1.0) * pow(1.0 - dotVN, 5.0));
+    Vec3 dBrdf = diffuseColor / ScalarT(PI_D)
+               * (ScalarT(1) + (Fd90 - ScalarT(1)) * pow(ScalarT(1) - dotLN, ScalarT(5)))
+               * (ScalarT(1) + (Fd90 - ScalarT(1)) * pow(ScalarT(1) - dotVN, ScalarT(5)));
 
     return sBrdf + dBrdf;
 }
@@ -25,6 +25,13 @@ float fresnel(float inTheta, float n);
 /*! Fresnel reflection with a complex refractive index. */
 float fresnelComplex(float inTheta, float n, float k);
 
+/*!
+ * Fresnel reflection with a complex refractive index for an Eigen array of
+ * the cosines of incoming angles.
+ */
+template <typename ArrayT>
+ArrayT fresnelComplexCos(const ArrayT& cosI, float n, float k);
+
 /*! Schlick's approximation of Fresnel reflection. */
 float fresnelSchlick(float inTheta, float n1, float n2 = 1.0f);
 
@@ -99,6 +106,52 @@ inline float fresnelComplex(float inTheta, float n, float k)
     return (Rs + Rp) / 2.0f;
 }
 
+template <typename ArrayT>
+ArrayT fresnelComplexCos(const ArrayT& cosI, float n, float k)
+{
+    using Scalar = typename ArrayT::Scalar;
+
+    const Scalar one = Scalar(1);
+
+    ArrayT sqCosI = cosI.square();
+    ArrayT sqSinI = (one - sqCosI).max(Scalar(0));
+    ArrayT sinI = sqSinI.sqrt();
+
+    if (k == 0.0f) {
+        ArrayT sinT = sinI / Scalar(n);
+        ArrayT cosT = (one - sinT.square()).max(Scalar(0)).sqrt();
+
+        ArrayT Rs = ((cosI - Scalar(n) * cosT) / (cosI + Scalar(n) * cosT)).square();
+        ArrayT Rp = ((cosT - Scalar(n) * cosI) / (cosT + Scalar(n) * cosI)).square();
+
+        // total internal reflection
+        return (sinT >= one).select(ArrayT::Ones(), (Rs + Rp) / Scalar(2));
+    }
+
+    Scalar sqN = Scalar(n) * Scalar(n);
+    Scalar sqK = Scalar(k) * Scalar(k);
+
+    ArrayT nks = sqN - sqK - sqSinI;
+    ArrayT root = (nks.square() + Scalar(4) * sqN * sqK).sqrt();
+    ArrayT sqA = (root + nks) / Scalar(2);
+    ArrayT sqB = (root - nks) / Scalar(2);
+
+    ArrayT a = sqA.sqrt();
+
+    ArrayT Rs = (sqA + sqB - Scalar(2) * a * cosI + sqCosI)
+              / (sqA + sqB + Scalar(2) * a * cosI + sqCosI);
+
+    // sinI * tanI and the square of it.
+    ArrayT sinTanI = sqSinI / cosI;
+    ArrayT sqSinTanI = sinTanI.square();
+
+    ArrayT Rp = Rs
+              * (sqA + sqB - Scalar(2) * a * sinTanI + sqSinTanI)
+              / (sqA + sqB + Scalar(2) * a * sinTanI + sqSinTanI);
+
+    return (Rs + Rp) / Scalar(2);
+}
+
 inline float fresnelSchlick(float inTheta, float n1, float n2)
 {
     assert(inTheta >= 0.0f && inTheta <= PI_2_F);
@@ -9,9 +9,12 @@
 #ifndef LIBBSDF_GGX_H
 #define LIBBSDF_GGX_H
 
+#include <algorithm>
+
 #include <libbsdf/Common/Global.h>
 #include <libbsdf/ReflectanceModel/Fresnel.h>
 #include <libbsdf/ReflectanceModel/ReflectanceModel.h>
+#include <libbsdf/ReflectanceModel/SoaVec3.h>
 
 namespace lb {
 
@@ -38,6 +41,11 @@ public:
 #endif
     }
 
+    /*!
+     * Computes a value. Intermediate values are computed in \a ScalarT.
+     * getValue() uses double as the reference, and getValues() uses float for speed.
+     */
+    template <typename ScalarT = double>
     static Vec3 compute(const Vec3& L,
                         const Vec3& V,
                         const Vec3& N,
@@ -46,12 +54,38 @@ public:
                         float       refractiveIndex = 1.5f,
                         float       extinctionCoefficient = 0.0f);
 
+    /*!
+     * Computes reflected values of a block of directions. The normal is the Z-axis.
+     * Values of transmitted directions are invalid.
+     */
+    template <typename ScalarT>
+    static void computeReflection(const SoaVec3<ScalarT>&   L,
+                                  const SoaVec3<ScalarT>&   V,
+                                  const Vec3&               color,
+                                  float                     roughness,
+                                  float                     refractiveIndex,
+                                  float                     extinctionCoefficient,
+                                  SoaVec3<ScalarT>*         values);
+
     Vec3 getValue(const Vec3& inDir, const Vec3& outDir) const
     {
         const Vec3 N = Vec3(0.0, 0.0, 1.0);
         return compute(inDir, outDir, N, color_, roughness_, refractiveIndex_, extinctionCoefficient_);
     }
 
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values) const;
+
+    void getBrdfValues(const Vec3*  inDirs,
+                       const Vec3*  outDirs,
+                       size_t       numDirs,
+                       Vec3*        values) const
+    {
+        Ggx::getValues(inDirs, outDirs, numDirs, values);
+    }
+
     bool isIsotropic() const { return true; }
 
     std::string getName() const { return "GGX (isotropic)"; }
@@ -66,7 +100,8 @@ public:
         return "Reference: " + getReference();
     }
 
-    static double computeG1(double dotN, double sqAlpha);
+    template <typename ScalarT>
+    static ScalarT computeG1(ScalarT dotN, ScalarT sqAlpha);
 
 private:
     Vec3    color_;
@@ -79,27 +114,28 @@ private:
  * Implementation
  */
 
-inline Vec3 Ggx::compute(const Vec3&    L,
-                         const Vec3&    V,
-                         const Vec3&    N,
-                         const Vec3&    color,
-                         float          roughness,
-                         float          refractiveIndex,
-                         float          extinctionCoefficient)
+template <typename ScalarT>
+Vec3 Ggx::compute(const Vec3&    L,
+                  const Vec3&    V,
+                  const Vec3&    N,
+                  const Vec3&    color,
+                  float          roughness,
+                  float          refractiveIndex,
+                  float          extinctionCoefficient)
 {
     using std::abs;
     using std::acos;
     using std::min;
 
-    double dotLN = L.dot(N);
-    double dotVN = V.dot(N);
+    ScalarT dotLN = L.dot(N);
+    ScalarT dotVN = V.dot(N);
 
 #if defined(LIBBSDF_USE_COLOR_INSTEAD_OF_REFRACTIVE_INDEX)
     Vec3 H = (L + V).normalized();
 
-    double dotHN = H.dot(N);
-    double dotLH = min(L.dot(H), Vec3::Scalar(1));
-    double dotVH = min(V.dot(H), Vec3::Scalar(1));
+    ScalarT dotHN = H.dot(N);
+    ScalarT dotLH = min(L.dot(H), Vec3::Scalar(1));
+    ScalarT dotVH = min(V.dot(H), Vec3::Scalar(1));
 
     Vec3 F = fresnelSchlick(dotVH, color);
 #else
@@ -122,9 +158,9 @@ inline Vec3 Ggx::compute(const Vec3&    L,
         H = -H;
     }
 
-    double dotHN = H.dot(N);
-    double dotLH = clamp(static_cast<double>(L.dot(H)), -1.0, 1.0);
-    double dotVH = clamp(static_cast<double>(V.dot(H)), -1.0, 1.0);
+    ScalarT dotHN = H.dot(N);
+    ScalarT dotLH = clamp(static_cast<ScalarT>(L.dot(H)), ScalarT(-1), ScalarT(1));
+    ScalarT dotVH = clamp(static_cast<ScalarT>(V.dot(H)), ScalarT(-1), ScalarT(1));
 
     if (!reflected && (dotLH < 0.0 || // F
                        dotLH * dotLN < 0.0 || // G
@@ -138,23 +174,23 @@ inline Vec3 Ggx::compute(const Vec3&    L,
     Vec3 F = color * fresnelComplex(inTheta, refractiveIndex, extinctionCoefficient);
 #endif
 
-    double alpha = roughness * roughness;
-    double sqAlpha = alpha * alpha;
+    ScalarT alpha = roughness * roughness;
+    ScalarT sqAlpha = alpha * alpha;
 
-    double G = computeG1(dotLN, sqAlpha) * computeG1(dotVN, sqAlpha);
+    ScalarT G = computeG1(dotLN, sqAlpha) * computeG1(dotVN, sqAlpha);
 
-    double sqDotHN = dotHN * dotHN;
-    double tanHN = sqDotHN * (sqAlpha - 1.0) + 1.0;
-    double D = sqAlpha / (PI_D * (tanHN * tanHN));
+    ScalarT sqDotHN = dotHN * dotHN;
+    ScalarT tanHN = sqDotHN * (sqAlpha - ScalarT(1)) + ScalarT(1);
+    ScalarT D = sqAlpha / (ScalarT(PI_D) * (tanHN * tanHN));
 
 #if defined(LIBBSDF_USE_COLOR_INSTEAD_OF_REFRACTIVE_INDEX)
     return F * G * D / (4.0f * dotLN * dotVN);
 #else
     if (reflected) {
-        return F * G * D / (4.0 * abs(dotLN) * abs(dotVN));
+        return F * G * D / (ScalarT(4) * abs(dotLN) * abs(dotVN));
     }
     else {
-        double denominator = dotLH + refractiveIndex * dotVH;
+        ScalarT denominator = dotLH + refractiveIndex * dotVH;
         return (abs(dotLH) * abs(dotVH)) / (abs(dotLN) * abs(dotVN)) *
                refractiveIndex * refractiveIndex *
                (Vec3::Ones() - F) * G * D / (denominator * denominator);
@@ -162,14 +198,90 @@ inline Vec3 Ggx::compute(const Vec3&    L,
 #endif
 }
 
-inline double Ggx::computeG1(double dotN, double sqAlpha)
+inline void Ggx::getValues(const Vec3*  inDirs,
+                           const Vec3*  outDirs,
+                           size_t       numDirs,
+                           Vec3*        values) const
+{
+#if defined(LIBBSDF_USE_COLOR_INSTEAD_OF_REFRACTIVE_INDEX)
+    ReflectanceModel::getValues(inDirs, outDirs, numDirs, values);
+#else
+    // If the refractive index of dielectric is 1.0, 0.0 is returned.
+    if (refractiveIndex_ == 1.0f && extinctionCoefficient_ < 0.00001f) {
+        std::fill(values, values + numDirs, Vec3(Vec3::Zero()));
+        return;
+    }
+
+    using Scalar = Vec3::Scalar;
+
+    evaluateSoa<Scalar>(inDirs, outDirs, numDirs, values,
+                        [this](const SoaVec3<Scalar>& L, const SoaVec3<Scalar>& V, SoaVec3<Scalar>* values) {
+                            computeReflection(L, V, color_, roughness_, refractiveIndex_, extinctionCoefficient_, values);
+                        });
+
+    // Transmitted values are computed for each pair.
+    const Vec3 N = Vec3(0.0, 0.0, 1.0);
+    for (size_t i = 0; i < numDirs; ++i) {
+        if (outDirs[i].z() < 0.0f) {
+            values[i] = compute<Scalar>(inDirs[i], outDirs[i], N, color_, roughness_, refractiveIndex_, extinctionCoefficient_);
+        }
+    }
+#endif
+}
+
+template <typename ScalarT>
+void Ggx::computeReflection(const SoaVec3<ScalarT>& L,
+                            const SoaVec3<ScalarT>& V,
+                            const Vec3&             color,
+                            float                   roughness,
+                            float                   refractiveIndex,
+                            float                   extinctionCoefficient,
+                            SoaVec3<ScalarT>*       values)
+{
+    using Array = typename SoaVec3<ScalarT>::Array;
+
+    const ScalarT one = ScalarT(1);
+
+    const Array& dotLN = L.z;
+    const Array& dotVN = V.z;
+
+    SoaVec3<ScalarT> H;
+    H.x = L.x + V.x;
+    H.y = L.y + V.y;
+    H.z = L.z + V.z;
+    H.normalize();
+
+    const Array& dotHN = H.z;
+    Array dotLH = L.dot(H).max(-one).min(one);
+
+    Array F = fresnelComplexCos(dotLH, refractiveIndex, extinctionCoefficient);
+
+    ScalarT alpha = roughness * roughness;
+    ScalarT sqAlpha = alpha * alpha;
+
+    // G1 of incoming and outgoing directions.
+    Array G = ScalarT(2) / (one + (one + sqAlpha * (one / dotLN.square() - one)).sqrt())
+            * ScalarT(2) / (one + (one + sqAlpha * (one / dotVN.square() - one)).sqrt());
+
+    Array tanHN = dotHN.square() * (sqAlpha - one) + one;
+    Array D = sqAlpha / (ScalarT(PI_D) * tanHN.square());
+
+    Array FGD = F * G * D / (ScalarT(4) * dotLN.abs() * dotVN.abs());
+
+    values->x = ScalarT(color[0]) * FGD;
+    values->y = ScalarT(color[1]) * FGD;
+    values->z = ScalarT(color[2]) * FGD;
+}
+
+template <typename ScalarT>
+ScalarT Ggx::computeG1(ScalarT dotN, ScalarT sqAlpha)
 {
-    assert(sqAlpha > 0.0);
+    assert(sqAlpha > ScalarT(0));
 
     using std::sqrt;
 
-    double sqTanN = 1.0 / (dotN * dotN) - 1.0;
-    return 2.0 / (1.0 + sqrt(1.0 + sqAlpha * sqTanN));
+    ScalarT sqTanN = ScalarT(1) / (dotN * dotN) - ScalarT(1);
+    return ScalarT(2) / (ScalarT(1) + sqrt(ScalarT(1) + sqAlpha * sqTanN));
 }
 
 } // namespace lb
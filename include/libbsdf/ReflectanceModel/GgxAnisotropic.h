@@ -44,6 +44,11 @@ public:
 #endif
     }
 
+    /*!
+     * Computes a value. Intermediate values are computed in \a ScalarT.
+     * getValue() uses double as the reference, and getValues() uses float for speed.
+     */
+    template <typename ScalarT = double>
     static Vec3 compute(const Vec3& L,
                         const Vec3& V,
                         const Vec3& N,
@@ -66,6 +71,32 @@ public:
                        refractiveIndex_, extinctionCoefficient_);
     }
 
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values) const
+    {
+        using Scalar = Vec3::Scalar;
+
+        const Vec3 N = Vec3(0.0, 0.0, 1.0);
+        const Vec3 T = Vec3(1.0, 0.0, 0.0);
+        const Vec3 B = Vec3(0.0, -1.0, 0.0);
+
+        for (size_t i = 0; i < numDirs; ++i) {
+            values[i] = compute<Scalar>(inDirs[i], outDirs[i], N, T, B,
+                                        color_, roughnessX_, roughnessY_,
+                                        refractiveIndex_, extinctionCoefficient_);
+        }
+    }
+
+    void getBrdfValues(const Vec3*  inDirs,
+                       const Vec3*  outDirs,
+                       size_t       numDirs,
+                       Vec3*        values) const
+    {
+        GgxAnisotropic::getValues(inDirs, outDirs, numDirs, values);
+    }
+
     bool isIsotropic() const { return false; }
 
     std::string getName() const { return "GGX (anisotropic)"; }
@@ -88,32 +119,33 @@ private:
  * Implementation
  */
 
-inline Vec3 GgxAnisotropic::compute(const Vec3& L,
-                                    const Vec3& V,
-                                    const Vec3& N,
-                                    const Vec3& T,
-                                    const Vec3& B,
-                                    const Vec3& color,
-                                    float       roughnessX,
-                                    float       roughnessY,
-                                    float       refractiveIndex,
-                                    float       extinctionCoefficient)
+template <typename ScalarT>
+Vec3 GgxAnisotropic::compute(const Vec3& L,
+                             const Vec3& V,
+                             const Vec3& N,
+                             const Vec3& T,
+                             const Vec3& B,
+                             const Vec3& color,
+                             float       roughnessX,
+                             float       roughnessY,
+                             float       refractiveIndex,
+                             float       extinctionCoefficient)
 {
     using std::abs;
     using std::acos;
     using std::min;
 
-    double dotLN = L.dot(N);
-    double dotVN = V.dot(N);
+    ScalarT dotLN = L.dot(N);
+    ScalarT dotVN = V.dot(N);
 
 #if defined(LIBBSDF_USE_COLOR_INSTEAD_OF_REFRACTIVE_INDEX)
     Vec3 H = (L + V).normalized();
 
-    double dotHN = H.dot(N);
-    double dotHT = H.dot(T);
-    double dotHB = H.dot(B);
-    double dotLH = min(L.dot(H), Vec3::Scalar(1));
-    double dotVH = min(V.dot(H), Vec3::Scalar(1));
+    ScalarT dotHN = H.dot(N);
+    ScalarT dotHT = H.dot(T);
+    ScalarT dotHB = H.dot(B);
+    ScalarT dotLH = min(L.dot(H), Vec3::Scalar(1));
+    ScalarT dotVH = min(V.dot(H), Vec3::Scalar(1));
 
     Vec3 F = fresnelSchlick(dotVH, color);
 #else
@@ -136,11 +168,11 @@ inline Vec3 GgxAnisotropic::compute(const Vec3& L,
         H = -H;
     }
 
-    double dotHN = H.dot(N);
-    double dotHT = H.dot(T);
-    double dotHB = H.dot(B);
-    double dotLH = clamp(static_cast<double>(L.dot(H)), -1.0, 1.0);
-    double dotVH = clamp(static_cast<double>(V.dot(H)), -1.0, 1.0);
+    ScalarT dotHN = H.dot(N);
+    ScalarT dotHT = H.dot(T);
+    ScalarT dotHB = H.dot(B);
+    ScalarT dotLH = clamp(static_cast<ScalarT>(L.dot(H)), ScalarT(-1), ScalarT(1));
+    ScalarT dotVH = clamp(static_cast<ScalarT>(V.dot(H)), ScalarT(-1), ScalarT(1));
 
     if (!reflected && (dotLH < 0.0 || // F
                        dotLH * dotLN < 0.0 || // G
@@ -153,27 +185,27 @@ inline Vec3 GgxAnisotropic::compute(const Vec3& L,
     Vec3 F = color * fresnelComplex(acos(dotLH), refractiveIndex, extinctionCoefficient);
 #endif
 
-    double alphaX = roughnessX * roughnessX;
-    double alphaY = roughnessY * roughnessY;
-    double sqAlpha = alphaX * alphaY;
+    ScalarT alphaX = roughnessX * roughnessX;
+    ScalarT alphaY = roughnessY * roughnessY;
+    ScalarT sqAlpha = alphaX * alphaY;
 
-    double G = Ggx::computeG1(dotLN, sqAlpha) * Ggx::computeG1(dotVN, sqAlpha);
+    ScalarT G = Ggx::computeG1(dotLN, sqAlpha) * Ggx::computeG1(dotVN, sqAlpha);
 
     // GTR (Generalized-Trowbridge-Reitz) distribution function is implemented here.
     // This function with gamma = 2 is equivalent to GGX.
-    double denominatorD = dotHT * dotHT / (alphaX * alphaX)
+    ScalarT denominatorD = dotHT * dotHT / (alphaX * alphaX)
                         + dotHB * dotHB / (alphaY * alphaY)
                         + dotHN * dotHN;
-    double D = 1.0 / (PI_D * sqAlpha * denominatorD * denominatorD);
+    ScalarT D = ScalarT(1) / (ScalarT(PI_D) * sqAlpha * denominatorD * denominatorD);
 
 #if defined(LIBBSDF_USE_COLOR_INSTEAD_OF_REFRACTIVE_INDEX)
-    return F * G * D / (4.0 * dotLN * dotVN);
+    return F * G * D / (ScalarT(4) * dotLN * dotVN);
 #else
     if (reflected) {
-        return F * G * D / (4.0 * abs(dotLN) * abs(dotVN));
+        return F * G * D / (ScalarT(4) * abs(dotLN) * abs(dotVN));
     }
     else {
-        double denominator = dotLH + refractiveIndex * dotVH;
+        ScalarT denominator = dotLH + refractiveIndex * dotVH;
         return (abs(dotLH) * abs(dotVH)) / (abs(dotLN) * abs(dotVN)) *
                refractiveIndex * refractiveIndex *
                (Vec3::Ones() - F) * G * D / (denominator * denominator);
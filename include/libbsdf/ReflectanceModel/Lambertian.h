@@ -9,6 +9,8 @@
 #ifndef LIBBSDF_LAMBERTIAN_H
 #define LIBBSDF_LAMBERTIAN_H
 
+#include <algorithm>
+
 #include <libbsdf/Common/Global.h>
 #include <libbsdf/ReflectanceModel/ReflectanceModel.h>
 
@@ -35,11 +37,30 @@ public:
         return compute(inDir, N, color_);
     }
 
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*,
+                   size_t       numDirs,
+                   Vec3*        values) const
+    {
+        const Vec3 N = Vec3(0.0, 0.0, 1.0);
+        for (size_t i = 0; i < numDirs; ++i) {
+            values[i] = compute(inDirs[i], N, color_);
+        }
+    }
+
     Vec3 getBrdfValue(const Vec3&, const Vec3&) const
     {
         return color_ / PI_F;
     }
 
+    void getBrdfValues(const Vec3*,
+                       const Vec3*,
+                       size_t       numDirs,
+                       Vec3*        values) const
+    {
+        std::fill(values, values + numDirs, Vec3(color_ / PI_F));
+    }
+
     bool isIsotropic() const { return true; }
 
     std::string getName() const { return "Lambertian"; }
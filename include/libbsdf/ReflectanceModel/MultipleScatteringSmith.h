@@ -9,12 +9,30 @@
 #ifndef LIBBSDF_MULTIPLE_SCATTERING_SMITH_H
 #define LIBBSDF_MULTIPLE_SCATTERING_SMITH_H
 
+#include <memory>
+#include <mutex>
+
 #include <libbsdf/Common/Global.h>
 #include <libbsdf/ReflectanceModel/ReflectanceModel.h>
 
 namespace lb {
 
-/*! Multiple scattering Smith reflectance model. */
+class Microsurface;
+
+/*!
+ * Multiple scattering Smith reflectance model.
+ *
+ * The microsurface is built once and rebuilt only if parameters are changed.
+ * A built microsurface is looked up without locking the mutex, so concurrent evaluations are not serialized.
+ * Random walks of each pair of directions use a random number stream seeded with the directions,
+ * so values are deterministic and independent of threads. The walks of a pair run one after another
+ * and are not batched across iterations or pairs.
+ *
+ * If the target error is positive, iterations are adaptive. Random walks are repeated in units of
+ * the number of iterations until the relative standard error of the mean falls below the target error
+ * or the maximum number of iterations is reached. Pairs whose samples are all zero are regarded as converged
+ * only after 3 / (target error) random walks, since non-zero walks can be rare.
+ */
 class MultipleScatteringSmith : public ReflectanceModel
 {
 public:
@@ -46,7 +64,9 @@ public:
                             int         materialType,
                             int         heightType,
                             int         slopeType,
-                            int         numIterations)
+                            int         numIterations,
+                            float       targetError = 0.0f,
+                            int         maxNumIterations = 1000)
                             : color_            (color),
                               roughnessX_       (roughnessX),
                               roughnessY_       (roughnessY),
@@ -54,7 +74,9 @@ public:
                               materialType_     (static_cast<MaterialType>(materialType)),
                               heightType_       (static_cast<HeightType>(heightType)),
                               slopeType_        (static_cast<SlopeType>(slopeType)),
-                              numIterations_    (numIterations)
+                              numIterations_    (numIterations),
+                              targetError_      (targetError),
+                              maxNumIterations_ (maxNumIterations)
     {
         parameters_.push_back(Parameter("Color",                &color_));
         parameters_.push_back(Parameter("Roughness X",          &roughnessX_, 0.01f, 100.0f));
@@ -68,6 +90,10 @@ public:
         parameters_.push_back(Parameter("Slope type",           &slopeType_,
                                         0, 1, "0: Beckmann\n1: GGX"));
         parameters_.push_back(Parameter("Number of iterations", &numIterations_));
+        parameters_.push_back(Parameter("Target error",         &targetError_,
+                                        0.0f, 1.0f, "Relative standard error of adaptive iterations\n0: Disabled"));
+        parameters_.push_back(Parameter("Maximum number of iterations", &maxNumIterations_,
+                                        1, 100000, "Only valid for adaptive iterations"));
     }
 
     /*! Evaluates a BSDF value with iterations. */
@@ -82,14 +108,31 @@ public:
                         SlopeType       slopeType,
                         int             numIterations);
 
-    Vec3 getValue(const Vec3& inDir, const Vec3& outDir) const
+    Vec3 getValue(const Vec3& inDir, const Vec3& outDir) const;
+
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values) const;
+
+    /*!
+     * Gets reflected values and the relative standard errors of the means of random walks.
+     * An error is infinity if it is unknown, i.e. with one iteration or if all samples are zero.
+     * The numbers of used iterations are stored in \a numUsedIterations if it is not 0.
+     */
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values,
+                   float*       relativeErrors,
+                   int*         numUsedIterations = 0) const;
+
+    void getBrdfValues(const Vec3*  inDirs,
+                       const Vec3*  outDirs,
+                       size_t       numDirs,
+                       Vec3*        values) const
     {
-        return compute(inDir, outDir,
-                       color_, roughnessX_, roughnessY_, refractiveIndex_,
-                       static_cast<MaterialType>(materialType_),
-                       static_cast<HeightType>(heightType_),
-                       static_cast<SlopeType>(slopeType_),
-                       numIterations_);
+        MultipleScatteringSmith::getValues(inDirs, outDirs, numDirs, values);
     }
 
     bool isIsotropic() const { return false; }
@@ -107,6 +150,33 @@ public:
     }
 
 private:
+    /*! The parameters used to build a microsurface. */
+    struct MicrosurfaceParameters
+    {
+        float   roughnessX;
+        float   roughnessY;
+        float   refractiveIndex;
+        int     materialType;
+        int     heightType;
+        int     slopeType;
+
+        bool operator==(const MicrosurfaceParameters& params) const;
+    };
+
+    /*! The microsurface built with parameters. */
+    struct MicrosurfaceCache
+    {
+        MicrosurfaceParameters              params;
+        std::shared_ptr<const Microsurface> microsurface;
+    };
+
+    /*!
+     * Gets the microsurface of the current parameters. Returns 0 if the material type is invalid.
+     * The mutex is locked only if the parameters are changed since the last call.
+     * The returned microsurface is kept alive while it is used, even if parameters are changed.
+     */
+    std::shared_ptr<const Microsurface> getMicrosurface() const;
+
     Vec3    color_;
     float   roughnessX_;
     float   roughnessY_;
@@ -115,8 +185,28 @@ private:
     int     materialType_;
     int     heightType_;
     int     slopeType_;
+    float   targetError_;
+    int     maxNumIterations_;
+
+    /*!
+     * The microsurface of the current parameters, accessed with std::atomic_load() and std::atomic_store().
+     * A replaced microsurface is released when the last evaluation using it finishes.
+     */
+    mutable std::shared_ptr<const MicrosurfaceCache> microsurfaceCache_;
+
+    mutable std::mutex microsurfaceMutex_; /*!< The mutex to build a microsurface. */
 };
 
+inline bool MultipleScatteringSmith::MicrosurfaceParameters::operator==(const MicrosurfaceParameters& params) const
+{
+    return (roughnessX      == params.roughnessX &&
+            roughnessY      == params.roughnessY &&
+            refractiveIndex == params.refractiveIndex &&
+            materialType    == params.materialType &&
+            heightType      == params.heightType &&
+            slopeType       == params.slopeType);
+}
+
 } // namespace lb
 
 #endif // LIBBSDF_MULTIPLE_SCATTERING_SMITH_H
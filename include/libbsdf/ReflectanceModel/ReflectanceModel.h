@@ -105,12 +105,30 @@ public:
     /*! Gets a reflected value with incoming and outgoing directions in tangent space. */
     virtual Vec3 getValue(const Vec3& inDir, const Vec3& outDir) const = 0;
 
+    /*!
+     * Gets reflected values of \a numDirs pairs of incoming and outgoing directions.
+     * The default implementation calls getValue() for each pair.
+     */
+    virtual void getValues(const Vec3*  inDirs,
+                           const Vec3*  outDirs,
+                           size_t       numDirs,
+                           Vec3*        values) const;
+
     /*!
      * Gets a BRDF value. If a reflectance model is not an analytical BRDF, it
      * should be converted to a BRDF value.
      */
     virtual Vec3 getBrdfValue(const Vec3& inDir, const Vec3& outDir) const;
 
+    /*!
+     * Gets BRDF values of \a numDirs pairs of incoming and outgoing directions.
+     * The default implementation calls getBrdfValue() for each pair.
+     */
+    virtual void getBrdfValues(const Vec3*  inDirs,
+                               const Vec3*  outDirs,
+                               size_t       numDirs,
+                               Vec3*        values) const;
+
     /*! Returns ture if this reflectance model is isotropic. */
     virtual bool isIsotropic() const = 0;
 
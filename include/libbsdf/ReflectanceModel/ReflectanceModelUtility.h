@@ -20,7 +20,10 @@
 namespace lb {
 namespace reflectance_model_utility {
 
-/*! Sets up a lb::Brdf using an analytic reflectance or transmittance model. */
+/*!
+ * Sets up a lb::Brdf using an analytic reflectance or transmittance model.
+ * Samples are evaluated in parallel by blocks with ReflectanceModel::getBrdfValues().
+ */
 bool setupTabularBrdf(const ReflectanceModel&   model,
                       Brdf*                     brdf,
                       DataType                  dataType = BRDF_DATA,
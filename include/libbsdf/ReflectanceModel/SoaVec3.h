@@ -0,0 +1,133 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_SOA_VEC3_H
+#define LIBBSDF_SOA_VEC3_H
+
+#include <algorithm>
+
+#include <libbsdf/Common/Vector.h>
+
+namespace lb {
+
+/*! The number of vectors in a block of lb::SoaVec3. */
+const int SOA_BLOCK_SIZE = 64;
+
+/*!
+ * \struct  SoaVec3
+ * \brief   The SoaVec3 struct provides a block of 3D vectors in the structure-of-arrays layout.
+ *
+ * Each component is a fixed-size Eigen array, so array expressions are vectorized over the block.
+ */
+template <typename ScalarT>
+struct SoaVec3
+{
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    using Scalar = ScalarT;
+    using Array = Eigen::Array<ScalarT, SOA_BLOCK_SIZE, 1>;
+
+    /*! Loads \a numVecs vectors. Remaining vectors are set to (0, 0, 1). */
+    void load(const Vec3* vecs, int numVecs);
+
+    /*! Stores the first \a numVecs vectors. */
+    void store(int numVecs, Vec3* vecs) const;
+
+    /*! Normalizes vectors. Zero vectors are not changed. */
+    void normalize();
+
+    /*! Computes the dot products of vectors. */
+    Array dot(const SoaVec3& v) const;
+
+    Array x; /*!< The X components. */
+    Array y; /*!< The Y components. */
+    Array z; /*!< The Z components. */
+};
+
+/*!
+ * Evaluates a reflectance model for arrays of incoming and outgoing directions in blocks of lb::SoaVec3.
+ * \a kernel is called as kernel(L, V, &values) for each block.
+ */
+template <typename ScalarT, typename KernelT>
+void evaluateSoa(const Vec3*    inDirs,
+                 const Vec3*    outDirs,
+                 size_t         numDirs,
+                 Vec3*          values,
+                 KernelT        kernel);
+
+/*
+ * Implementation
+ */
+
+template <typename ScalarT>
+void SoaVec3<ScalarT>::load(const Vec3* vecs, int numVecs)
+{
+    for (int i = 0; i < numVecs; ++i) {
+        x[i] = static_cast<ScalarT>(vecs[i][0]);
+        y[i] = static_cast<ScalarT>(vecs[i][1]);
+        z[i] = static_cast<ScalarT>(vecs[i][2]);
+    }
+
+    for (int i = numVecs; i < SOA_BLOCK_SIZE; ++i) {
+        x[i] = ScalarT(0);
+        y[i] = ScalarT(0);
+        z[i] = ScalarT(1);
+    }
+}
+
+template <typename ScalarT>
+void SoaVec3<ScalarT>::store(int numVecs, Vec3* vecs) const
+{
+    using VecScalar = Vec3::Scalar;
+
+    for (int i = 0; i < numVecs; ++i) {
+        vecs[i] = Vec3(static_cast<VecScalar>(x[i]),
+                       static_cast<VecScalar>(y[i]),
+                       static_cast<VecScalar>(z[i]));
+    }
+}
+
+template <typename ScalarT>
+void SoaVec3<ScalarT>::normalize()
+{
+    Array sqLength = x * x + y * y + z * z;
+    Array length = (sqLength > ScalarT(0)).select(sqLength.sqrt(), Array::Ones());
+
+    x /= length;
+    y /= length;
+    z /= length;
+}
+
+template <typename ScalarT>
+typename SoaVec3<ScalarT>::Array SoaVec3<ScalarT>::dot(const SoaVec3& v) const
+{
+    return x * v.x + y * v.y + z * v.z;
+}
+
+template <typename ScalarT, typename KernelT>
+void evaluateSoa(const Vec3*    inDirs,
+                 const Vec3*    outDirs,
+                 size_t         numDirs,
+                 Vec3*          values,
+                 KernelT        kernel)
+{
+    SoaVec3<ScalarT> L, V, blockValues;
+
+    for (size_t first = 0; first < numDirs; first += SOA_BLOCK_SIZE) {
+        int numBlockDirs = static_cast<int>(std::min(numDirs - first, static_cast<size_t>(SOA_BLOCK_SIZE)));
+
+        L.load(inDirs + first, numBlockDirs);
+        V.load(outDirs + first, numBlockDirs);
+        kernel(L, V, &blockValues);
+        blockValues.store(numBlockDirs, values + first);
+    }
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_SOA_VEC3_H
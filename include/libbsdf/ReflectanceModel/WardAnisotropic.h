@@ -11,6 +11,7 @@
 
 #include <libbsdf/Common/Global.h>
 #include <libbsdf/ReflectanceModel/ReflectanceModel.h>
+#include <libbsdf/ReflectanceModel/SoaVec3.h>
 
 namespace lb {
 
@@ -41,6 +42,18 @@ public:
                         float       roughnessX,
                         float       roughnessY);
 
+    /*!
+     * Computes values of a block of directions. The normal, tangent, and binormal are
+     * the Z-axis, X-axis, and negative Y-axis.
+     */
+    template <typename ScalarT>
+    static void compute(const SoaVec3<ScalarT>& L,
+                        const SoaVec3<ScalarT>& V,
+                        const Vec3&             color,
+                        float                   roughnessX,
+                        float                   roughnessY,
+                        SoaVec3<ScalarT>*       values);
+
     Vec3 getValue(const Vec3& inDir, const Vec3& outDir) const
     {
         const Vec3 N = Vec3(0.0, 0.0, 1.0);
@@ -50,6 +63,27 @@ public:
         return compute(inDir, outDir, N, T, B, color_, roughnessX_, roughnessY_);
     }
 
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values) const
+    {
+        using Scalar = Vec3::Scalar;
+
+        evaluateSoa<Scalar>(inDirs, outDirs, numDirs, values,
+                            [this](const SoaVec3<Scalar>& L, const SoaVec3<Scalar>& V, SoaVec3<Scalar>* values) {
+                                compute(L, V, color_, roughnessX_, roughnessY_, values);
+                            });
+    }
+
+    void getBrdfValues(const Vec3*  inDirs,
+                       const Vec3*  outDirs,
+                       size_t       numDirs,
+                       Vec3*        values) const
+    {
+        WardAnisotropic::getValues(inDirs, outDirs, numDirs, values);
+    }
+
     bool isIsotropic() const { return false; }
 
     std::string getName() const { return "Ward (anisotropic)"; }
@@ -103,6 +137,38 @@ inline Vec3 WardAnisotropic::compute(const Vec3&    L,
     return color * brdf;
 }
 
+template <typename ScalarT>
+void WardAnisotropic::compute(const SoaVec3<ScalarT>&   L,
+                              const SoaVec3<ScalarT>&   V,
+                              const Vec3&               color,
+                              float                     roughnessX,
+                              float                     roughnessY,
+                              SoaVec3<ScalarT>*         values)
+{
+    using Array = typename SoaVec3<ScalarT>::Array;
+
+    const Array& dotLN = L.z;
+    const Array& dotVN = V.z;
+
+    SoaVec3<ScalarT> H;
+    H.x = L.x + V.x;
+    H.y = L.y + V.y;
+    H.z = L.z + V.z;
+    H.normalize();
+    const Array& dotHN = H.z;
+
+    Array sqDotHT = (H.x / ScalarT(roughnessX)).square();
+    Array sqDotHB = (H.y / ScalarT(roughnessY)).square();
+
+    Array brdf = ScalarT(1) / (dotLN * dotVN).max(ScalarT(EPSILON_F)).sqrt()
+               * (ScalarT(-2) * (sqDotHT + sqDotHB) / (ScalarT(1) + dotHN)).exp()
+               / (ScalarT(4) * ScalarT(PI_D) * ScalarT(roughnessX) * ScalarT(roughnessY));
+
+    values->x = ScalarT(color[0]) * brdf;
+    values->y = ScalarT(color[1]) * brdf;
+    values->z = ScalarT(color[2]) * brdf;
+}
+
 } // namespace lb
 
 #endif // LIBBSDF_WARD_ANISOTROPIC_H
@@ -11,6 +11,7 @@
 
 #include <libbsdf/Common/Global.h>
 #include <libbsdf/ReflectanceModel/ReflectanceModel.h>
+#include <libbsdf/ReflectanceModel/SoaVec3.h>
 
 namespace lb {
 
@@ -35,12 +36,41 @@ public:
                         const Vec3& color,
                         float       roughness);
 
+    /*! Computes values of a block of directions. The normal is the Z-axis. */
+    template <typename ScalarT>
+    static void compute(const SoaVec3<ScalarT>& L,
+                        const SoaVec3<ScalarT>& V,
+                        const Vec3&             color,
+                        float                   roughness,
+                        SoaVec3<ScalarT>*       values);
+
     Vec3 getValue(const Vec3& inDir, const Vec3& outDir) const
     {
         const Vec3 N = Vec3(0.0, 0.0, 1.0);
         return compute(inDir, outDir, N, color_, roughness_);
     }
 
+    void getValues(const Vec3*  inDirs,
+                   const Vec3*  outDirs,
+                   size_t       numDirs,
+                   Vec3*        values) const
+    {
+        using Scalar = Vec3::Scalar;
+
+        evaluateSoa<Scalar>(inDirs, outDirs, numDirs, values,
+                            [this](const SoaVec3<Scalar>& L, const SoaVec3<Scalar>& V, SoaVec3<Scalar>* values) {
+                                compute(L, V, color_, roughness_, values);
+                            });
+    }
+
+    void getBrdfValues(const Vec3*  inDirs,
+                       const Vec3*  outDirs,
+                       size_t       numDirs,
+                       Vec3*        values) const
+    {
+        WardIsotropic::getValues(inDirs, outDirs, numDirs, values);
+    }
+
     bool isIsotropic() const { return true; }
 
     std::string getName() const { return "Ward (isotropic)"; }
@@ -86,6 +116,40 @@ inline Vec3 WardIsotropic::compute(const Vec3&  L,
     return color * brdf;
 }
 
+template <typename ScalarT>
+void WardIsotropic::compute(const SoaVec3<ScalarT>& L,
+                            const SoaVec3<ScalarT>& V,
+                            const Vec3&             color,
+                            float                   roughness,
+                            SoaVec3<ScalarT>*       values)
+{
+    using Array = typename SoaVec3<ScalarT>::Array;
+
+    const Array& dotLN = L.z;
+    const Array& dotVN = V.z;
+
+    SoaVec3<ScalarT> H;
+    H.x = L.x + V.x;
+    H.y = L.y + V.y;
+    H.z = L.z + V.z;
+    H.normalize();
+    const Array& dotHN = H.z;
+
+    ScalarT sqRoughness = roughness * roughness;
+
+    // The square of tan(acos(dotHN)).
+    Array sqDotHN = dotHN * dotHN;
+    Array sqTanHN = (ScalarT(1) - sqDotHN) / sqDotHN;
+
+    Array brdf = ScalarT(1) / (dotLN * dotVN).sqrt()
+               * (-(sqTanHN / sqRoughness)).exp()
+               / (ScalarT(4) * ScalarT(PI_D) * sqRoughness);
+
+    values->x = ScalarT(color[0]) * brdf;
+    values->y = ScalarT(color[1]) * brdf;
+    values->z = ScalarT(color[2]) * brdf;
+}
+
 } // namespace lb
 
 #endif // LIBBSDF_WARD_ISOTROPIC_H
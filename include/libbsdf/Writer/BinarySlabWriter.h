@@ -0,0 +1,82 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_BINARY_SLAB_WRITER_H
+#define LIBBSDF_BINARY_SLAB_WRITER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <libbsdf/Brdf/Brdf.h>
+#include <libbsdf/Reader/BinaryUtility.h>
+#include <libbsdf/Reader/FileInfo.h>
+
+namespace lb {
+
+/*!
+ * \class BinarySlabWriter
+ * \brief The BinarySlabWriter class provides the streaming writer of a libbsdf binary file (".lbb").
+ *
+ * A BRDF is written as slabs of incoming directions, so the whole BRDF is not held in memory.
+ * A slab is a BRDF with one angle0 and one angle1. Slabs are written in the order of
+ * lb::SampleSet::getIndex(), i.e. angle0 varies fastest.
+ * The file is equal to the output of lb::BinaryWriter for the same BRDF.
+ * With lb::binary_utility::PREDICTIVE_ENCODING, chunks are appended sequentially.
+ * With lb::binary_utility::RAW_ENCODING, spectra of a slab are scattered over the spectra block.
+ */
+class BinarySlabWriter
+{
+public:
+    BinarySlabWriter();
+
+    /*!
+     * Creates a file and writes the header. \a info provides the attributes and angles of the whole BRDF.
+     * Spectra are filled with zeros until slabs are written.
+     */
+    bool open(const std::string&            fileName,
+              const FileInfo&               info,
+              binary_utility::EncodingType  encoding = binary_utility::RAW_ENCODING,
+              const std::string&            name = "");
+
+    /*! Writes the next slab. Returns false if the size of \a slab is not matched. */
+    bool writeSlab(const Brdf& slab);
+
+    /*! Finishes the file with the sizes of chunks and the checksum. All slabs must be written. */
+    bool close();
+
+    /*! Returns true if a file is open. */
+    bool isOpen() const;
+
+    /*! Gets the number of slabs written to the file. */
+    int getNumWrittenSlabs() const;
+
+private:
+    /*! Writes zeros to the stream. */
+    void writeZeros(uint64_t size);
+
+    std::fstream stream_; /*!< The stream of the file. */
+
+    binary_utility::Header header_; /*!< The header of the file. */
+    std::vector<char> metadata_;    /*!< The metadata block with the padding. */
+
+    std::vector<uint64_t> chunkSizes_; /*!< The sizes of chunks for lb::binary_utility::PREDICTIVE_ENCODING. */
+
+    int numSlabs_;          /*!< The number of slabs in the file. */
+    int numWrittenSlabs_;   /*!< The number of written slabs. */
+};
+
+inline BinarySlabWriter::BinarySlabWriter() : numSlabs_(0), numWrittenSlabs_(0) {}
+
+inline bool BinarySlabWriter::isOpen() const { return stream_.is_open(); }
+
+inline int BinarySlabWriter::getNumWrittenSlabs() const { return numWrittenSlabs_; }
+
+} // namespace lb
+
+#endif // LIBBSDF_BINARY_SLAB_WRITER_H
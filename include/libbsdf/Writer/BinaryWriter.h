@@ -0,0 +1,51 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_BINARY_WRITER_H
+#define LIBBSDF_BINARY_WRITER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <libbsdf/Brdf/Brdf.h>
+#include <libbsdf/Reader/BinaryUtility.h>
+
+namespace lb {
+
+/*!
+ * \class BinaryWriter
+ * \brief The BinaryWriter class provides the writer of a libbsdf binary file (".lbb").
+ *
+ * The BRDFs of spherical, specular, and half difference coordinate systems are supported.
+ * Data are stored without loss. Spectra are compressed with
+ * lb::binary_utility::PREDICTIVE_ENCODING if it is specified. \sa BinaryUtility.h
+ */
+class BinaryWriter
+{
+public:
+    /*! Writes a BRDF in a libbsdf binary file. */
+    static bool write(const std::string&            fileName,
+                      const Brdf&                   brdf,
+                      DataType                      dataType = UNKNOWN_DATA,
+                      binary_utility::EncodingType  encoding = binary_utility::RAW_ENCODING);
+
+    /*! Outputs binary data of a libbsdf binary file to a stream. */
+    static bool output(const Brdf&                  brdf,
+                       std::ostream&                stream,
+                       DataType                     dataType = UNKNOWN_DATA,
+                       binary_utility::EncodingType encoding = binary_utility::RAW_ENCODING);
+
+private:
+    /*! Encodes spectra with lb::binary_utility::PREDICTIVE_ENCODING. */
+    static void encodeSpectra(const SampleSet& samples, std::vector<char>* data);
+};
+
+} // namespace lb
+
+#endif // LIBBSDF_BINARY_WRITER_H
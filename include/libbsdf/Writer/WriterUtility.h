@@ -0,0 +1,48 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+/*!
+ * \file    WriterUtility.h
+ * \brief   The WriterUtility.h header file includes the utility functions for file writers.
+ */
+
+#ifndef LIBBSDF_WRITER_UTILITY_H
+#define LIBBSDF_WRITER_UTILITY_H
+
+#include <string>
+
+namespace lb {
+namespace writer_utility {
+
+/*! \brief The size of a buffer large enough for lb::writer_utility::formatFloat(). */
+const int FORMAT_BUFFER_SIZE = 64;
+
+/*!
+ * \brief Formats a float in the same way as std::ostream with default flags, i.e. "%.*g" of printf.
+ *
+ * Values are formatted by an exact fast path, and std::snprintf() is used if the fast path
+ * cannot round correctly. \a buffer must have lb::writer_utility::FORMAT_BUFFER_SIZE characters.
+ * Returns the number of characters written without a null terminator.
+ */
+int formatFloat(float value, int precision, char* buffer);
+
+/*! \brief Appends a float formatted by lb::writer_utility::formatFloat() to a string. */
+void appendFloat(float value, int precision, std::string* str);
+
+} // namespace writer_utility
+
+inline void writer_utility::appendFloat(float value, int precision, std::string* str)
+{
+    char buffer[FORMAT_BUFFER_SIZE];
+    int size = formatFloat(value, precision, buffer);
+    str->append(buffer, size);
+}
+
+} // namespace lb
+
+#endif // LIBBSDF_WRITER_UTILITY_H
@@ -240,7 +240,7 @@ SampleSet2D* lb::computeSpecularReflectances(const SpecularCoordinatesBrdf& brdf
             }
 
             for (int spPhIndex = 0; spPhIndex < brdf.getNumSpecPhi(); ++spPhIndex) {
-                const Spectrum& sp = brdf.getSpectrum(thIndex, phIndex, spThIndex, spPhIndex);
+                ConstSpectrumMap sp = brdf.getSpectrum(thIndex, phIndex, spThIndex, spPhIndex);
 
                 if (brdfSp.sum() < sp.sum()) {
                     brdfSp = sp;
@@ -52,6 +52,29 @@ void Brdf::initializeSpectra(const Brdf& brdf)
     lb::initializeSpectra<LinearInterpolator>(brdf, this);
 }
 
+void Brdf::getSpectra(const Vec3*   inDirs,
+                      const Vec3*   outDirs,
+                      size_t        numDirs,
+                      float*        spectra) const
+{
+    int numWavelengths = samples_->getNumWavelengths();
+
+    for (size_t i = 0; i < numDirs; ++i) {
+        SpectrumMap(spectra + numWavelengths * i, numWavelengths) = getSpectrum(inDirs[i], outDirs[i]);
+    }
+}
+
+void Brdf::getValues(const Vec3*    inDirs,
+                     const Vec3*    outDirs,
+                     size_t         numDirs,
+                     int            wavelengthIndex,
+                     float*         values) const
+{
+    for (size_t i = 0; i < numDirs; ++i) {
+        values[i] = getValue(inDirs[i], outDirs[i], wavelengthIndex);
+    }
+}
+
 void Brdf::setName(const std::string& name)
 {
     lbTrace << "[Brdf::setName] " << name;
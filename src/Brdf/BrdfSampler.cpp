@@ -0,0 +1,217 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Brdf/BrdfSampler.h>
+
+#include <algorithm>
+
+#include <libbsdf/Common/Log.h>
+#include <libbsdf/Common/SolidAngle.h>
+
+using namespace lb;
+
+BrdfSampler::BrdfSampler(const SpecularCoordinatesBrdf& brdf)
+                         : brdf_(brdf),
+                           numSpecThetaIntervals_(brdf.getNumSpecTheta() - 1),
+                           numSpecPhiIntervals_(brdf.getNumSpecPhi() - 1)
+{
+    if (numSpecThetaIntervals_ < 1 || numSpecPhiIntervals_ < 1) {
+        lbError << "[BrdfSampler::BrdfSampler] The numbers of specular angles must be greater than 1.";
+        numSpecThetaIntervals_ = 0;
+        numSpecPhiIntervals_ = 0;
+        return;
+    }
+
+    int numInTheta = brdf.getNumInTheta();
+    int numInPhi = brdf.getNumInPhi();
+    int numInDirs = numInTheta * numInPhi;
+
+    marginalCdfs_.resize(numInDirs * (numSpecThetaIntervals_ + 1));
+    conditionalCdfs_.resize(numInDirs * numSpecThetaIntervals_ * (numSpecPhiIntervals_ + 1));
+
+    #pragma omp parallel for
+    for (int inIndex = 0; inIndex < numInDirs; ++inIndex) {
+        buildCdfs(inIndex % numInTheta, inIndex / numInTheta);
+    }
+}
+
+bool BrdfSampler::sample(const Vec3& inDir, float u1, float u2, Vec3* outDir, float* pdf) const
+{
+    *pdf = 0.0f;
+
+    if (marginalCdfs_.empty()) return false;
+
+    float inTheta, inPhi;
+    SphericalCoordinateSystem::fromXyz(inDir, &inTheta, &inPhi);
+    inTheta = std::min(inTheta, SpecularCoordinateSystem::MAX_ANGLE0);
+
+    int inIndex = findInIndex(inTheta, inPhi);
+
+    float thetaProbability;
+    const float* marginalCdf = &marginalCdfs_[inIndex * (numSpecThetaIntervals_ + 1)];
+    int thIndex = sampleCdf(marginalCdf, numSpecThetaIntervals_, &u1, &thetaProbability);
+
+    float phiProbability;
+    const float* conditionalCdf = &conditionalCdfs_[(inIndex * numSpecThetaIntervals_ + thIndex) * (numSpecPhiIntervals_ + 1)];
+    int phIndex = sampleCdf(conditionalCdf, numSpecPhiIntervals_, &u2, &phiProbability);
+
+    float solidAngle = computeCellSolidAngle(thIndex, phIndex);
+    if (thetaProbability <= 0.0f || phiProbability <= 0.0f || solidAngle <= 0.0f) return false;
+
+    // Sample uniformly by solid angle in the cell.
+    float cosTheta0 = std::cos(brdf_.getSpecTheta(thIndex));
+    float cosTheta1 = std::cos(brdf_.getSpecTheta(thIndex + 1));
+    float specTheta = std::acos(clamp(lerp(cosTheta0, cosTheta1, u1), -1.0f, 1.0f));
+    float specPhi = lerp(brdf_.getSpecPhi(phIndex), brdf_.getSpecPhi(phIndex + 1), u2);
+
+    Vec3 dummyInDir;
+    brdf_.toXyz(inTheta, inPhi, specTheta, specPhi, &dummyInDir, outDir);
+
+    if (outDir->z() <= 0.0) return false;
+
+    *pdf = thetaProbability * phiProbability / solidAngle;
+    return true;
+}
+
+float BrdfSampler::getPdf(const Vec3& inDir, const Vec3& outDir) const
+{
+    if (marginalCdfs_.empty() || outDir.z() <= 0.0) return 0.0f;
+
+    float inTheta, inPhi, specTheta, specPhi;
+    brdf_.fromXyz(inDir, outDir, &inTheta, &inPhi, &specTheta, &specPhi);
+
+    const SampleSet* ss = brdf_.getSampleSet();
+    const Arrayf& specThetas = ss->getAngles2();
+    const Arrayf& specPhis = ss->getAngles3();
+
+    if (specTheta < specThetas[0] || specTheta > specThetas[numSpecThetaIntervals_] ||
+        specPhi   < specPhis[0]   || specPhi   > specPhis[numSpecPhiIntervals_]) {
+        return 0.0f;
+    }
+
+    int thIndex, phIndex, upperIndex;
+    float lowerAngle, upperAngle;
+    findBounds(specThetas, specTheta, ss->isEqualIntervalAngles2(), ss->getBoundsTable2(),
+               &thIndex, &upperIndex, &lowerAngle, &upperAngle);
+    findBounds(specPhis, specPhi, ss->isEqualIntervalAngles3(), ss->getBoundsTable3(),
+               &phIndex, &upperIndex, &lowerAngle, &upperAngle);
+
+    float solidAngle = computeCellSolidAngle(thIndex, phIndex);
+    if (solidAngle <= 0.0f) return 0.0f;
+
+    int inIndex = findInIndex(std::min(inTheta, SpecularCoordinateSystem::MAX_ANGLE0), inPhi);
+
+    const float* marginalCdf = &marginalCdfs_[inIndex * (numSpecThetaIntervals_ + 1)];
+    const float* conditionalCdf = &conditionalCdfs_[(inIndex * numSpecThetaIntervals_ + thIndex) * (numSpecPhiIntervals_ + 1)];
+
+    float thetaProbability = marginalCdf[thIndex + 1] - marginalCdf[thIndex];
+    float phiProbability = conditionalCdf[phIndex + 1] - conditionalCdf[phIndex];
+
+    return thetaProbability * phiProbability / solidAngle;
+}
+
+void BrdfSampler::buildCdfs(int inThIndex, int inPhIndex)
+{
+    int inIndex = inThIndex + brdf_.getNumInTheta() * inPhIndex;
+
+    // Weights of cells: the mean of the BRDF * cosine * solid angle above the surface.
+    Eigen::ArrayXXf weights = Eigen::ArrayXXf::Zero(numSpecThetaIntervals_, numSpecPhiIntervals_);
+    Eigen::ArrayXXf solidAngles = Eigen::ArrayXXf::Zero(numSpecThetaIntervals_, numSpecPhiIntervals_);
+    for (int thIndex = 0; thIndex < numSpecThetaIntervals_; ++thIndex) {
+    for (int phIndex = 0; phIndex < numSpecPhiIntervals_;   ++phIndex) {
+        Vec3 outDir0 = brdf_.getOutDirection(inThIndex, inPhIndex, thIndex,     phIndex);
+        Vec3 outDir1 = brdf_.getOutDirection(inThIndex, inPhIndex, thIndex,     phIndex + 1);
+        Vec3 outDir2 = brdf_.getOutDirection(inThIndex, inPhIndex, thIndex + 1, phIndex + 1);
+        Vec3 outDir3 = brdf_.getOutDirection(inThIndex, inPhIndex, thIndex + 1, phIndex);
+
+        if (outDir0.z() <= 0.0 && outDir1.z() <= 0.0 && outDir2.z() <= 0.0 && outDir3.z() <= 0.0) continue;
+
+        Vec3 centroid;
+        double solidAngle = SolidAngle::fromRectangleOnHemisphere(outDir0, outDir1, outDir2, outDir3, &centroid);
+        if (solidAngle <= 0.0) continue;
+
+        float value = (brdf_.getSpectrum(inThIndex, inPhIndex, thIndex,     phIndex).mean()
+                     + brdf_.getSpectrum(inThIndex, inPhIndex, thIndex,     phIndex + 1).mean()
+                     + brdf_.getSpectrum(inThIndex, inPhIndex, thIndex + 1, phIndex + 1).mean()
+                     + brdf_.getSpectrum(inThIndex, inPhIndex, thIndex + 1, phIndex).mean()) / 4.0f;
+
+        solidAngles(thIndex, phIndex) = static_cast<float>(solidAngle);
+        weights(thIndex, phIndex) = std::max(value, 0.0f) * static_cast<float>(std::max(centroid.z(), Vec3::Scalar(0)) * solidAngle);
+    }}
+
+    // Directions are sampled by solid angle if the BRDF is zero.
+    if (weights.sum() <= 0.0f) {
+        weights = solidAngles;
+    }
+
+    float* marginalCdf = &marginalCdfs_[inIndex * (numSpecThetaIntervals_ + 1)];
+    Arrayf rowSums = weights.rowwise().sum();
+    float sum = rowSums.sum();
+
+    marginalCdf[0] = 0.0f;
+    for (int thIndex = 0; thIndex < numSpecThetaIntervals_; ++thIndex) {
+        marginalCdf[thIndex + 1] = marginalCdf[thIndex] + rowSums[thIndex] / sum;
+
+        float* conditionalCdf = &conditionalCdfs_[(inIndex * numSpecThetaIntervals_ + thIndex) * (numSpecPhiIntervals_ + 1)];
+        conditionalCdf[0] = 0.0f;
+        for (int phIndex = 0; phIndex < numSpecPhiIntervals_; ++phIndex) {
+            float weight = (rowSums[thIndex] > 0.0f) ? weights(thIndex, phIndex) / rowSums[thIndex]
+                                                     : 1.0f / numSpecPhiIntervals_;
+            conditionalCdf[phIndex + 1] = conditionalCdf[phIndex] + weight;
+        }
+        conditionalCdf[numSpecPhiIntervals_] = 1.0f;
+    }
+    marginalCdf[numSpecThetaIntervals_] = 1.0f;
+}
+
+int BrdfSampler::findInIndex(float inTheta, float inPhi) const
+{
+    const SampleSet* ss = brdf_.getSampleSet();
+
+    int lowerIndex, upperIndex;
+    float lowerAngle, upperAngle;
+
+    findBounds(ss->getAngles0(), inTheta, ss->isEqualIntervalAngles0(), ss->getBoundsTable0(),
+               &lowerIndex, &upperIndex, &lowerAngle, &upperAngle);
+    int thIndex = (inTheta - lowerAngle < upperAngle - inTheta) ? lowerIndex : upperIndex;
+
+    int phIndex = 0;
+    if (!ss->isIsotropic()) {
+        findBounds(ss->getAngles1(), inPhi, ss->isEqualIntervalAngles1(), ss->getBoundsTable1(),
+                   &lowerIndex, &upperIndex, &lowerAngle, &upperAngle);
+        phIndex = (inPhi - lowerAngle < upperAngle - inPhi) ? lowerIndex : upperIndex;
+    }
+
+    return thIndex + brdf_.getNumInTheta() * phIndex;
+}
+
+int BrdfSampler::sampleCdf(const float* cdf, int numIntervals, float* u, float* probability)
+{
+    const float* upper = std::upper_bound(cdf, cdf + numIntervals + 1, *u);
+    int index = clamp(static_cast<int>(upper - cdf) - 1, 0, numIntervals - 1);
+
+    // Skip intervals of zero probability at the end of the CDF.
+    while (index > 0 && cdf[index + 1] - cdf[index] <= 0.0f) {
+        --index;
+    }
+
+    *probability = cdf[index + 1] - cdf[index];
+    if (*probability > 0.0f) {
+        *u = clamp((*u - cdf[index]) / *probability, 0.0f, 1.0f);
+    }
+
+    return index;
+}
+
+float BrdfSampler::computeCellSolidAngle(int specThIndex, int specPhIndex) const
+{
+    return SolidAngle::fromRectangle(brdf_.getSpecTheta(specThIndex),
+                                     brdf_.getSpecTheta(specThIndex + 1),
+                                     brdf_.getSpecPhi(specPhIndex),
+                                     brdf_.getSpecPhi(specPhIndex + 1));
+}
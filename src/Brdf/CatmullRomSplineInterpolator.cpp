@@ -17,6 +17,64 @@ void CatmullRomSplineInterpolator::getSpectrum(const SampleSet& samples,
                                                float            angle3,
                                                Spectrum*        spectrum)
 {
+    switch (samples.getNumWavelengths()) {
+        case 1: {
+            FixedSpectrum<1> sp;
+            getSpectrum<1>(samples, angle0, angle1, angle2, angle3, &sp);
+            spectrum->resize(1);
+            Eigen::Map<FixedSpectrum<1>>(spectrum->data()) = sp;
+            break;
+        }
+        case 3: {
+            FixedSpectrum<3> sp;
+            getSpectrum<3>(samples, angle0, angle1, angle2, angle3, &sp);
+            spectrum->resize(3);
+            Eigen::Map<FixedSpectrum<3>>(spectrum->data()) = sp;
+            break;
+        }
+        default:
+            getSpectrum<Eigen::Dynamic>(samples, angle0, angle1, angle2, angle3, spectrum);
+            break;
+    }
+}
+
+void CatmullRomSplineInterpolator::getSpectrum(const SampleSet& samples,
+                                               float            angle0,
+                                               float            angle2,
+                                               float            angle3,
+                                               Spectrum*        spectrum)
+{
+    switch (samples.getNumWavelengths()) {
+        case 1: {
+            FixedSpectrum<1> sp;
+            getSpectrum<1>(samples, angle0, angle2, angle3, &sp);
+            spectrum->resize(1);
+            Eigen::Map<FixedSpectrum<1>>(spectrum->data()) = sp;
+            break;
+        }
+        case 3: {
+            FixedSpectrum<3> sp;
+            getSpectrum<3>(samples, angle0, angle2, angle3, &sp);
+            spectrum->resize(3);
+            Eigen::Map<FixedSpectrum<3>>(spectrum->data()) = sp;
+            break;
+        }
+        default:
+            getSpectrum<Eigen::Dynamic>(samples, angle0, angle2, angle3, spectrum);
+            break;
+    }
+}
+
+template <int NumWavelengths>
+void CatmullRomSplineInterpolator::getSpectrum(const SampleSet&                samples,
+                                               float                           angle0,
+                                               float                           angle1,
+                                               float                           angle2,
+                                               float                           angle3,
+                                               FixedSpectrum<NumWavelengths>*  spectrum)
+{
+    using SpectrumT = FixedSpectrum<NumWavelengths>;
+
     const Arrayf& angles0 = samples.getAngles0();
     const Arrayf& angles1 = samples.getAngles1();
     const Arrayf& angles2 = samples.getAngles2();
@@ -32,135 +90,135 @@ void CatmullRomSplineInterpolator::getSpectrum(const SampleSet& samples,
     float pos2Angle0, pos2Angle1, pos2Angle2, pos2Angle3;
     float pos3Angle0, pos3Angle1, pos3Angle2, pos3Angle3;
 
-    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), false,
+    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), false,
                &pos0Idx0, &pos1Idx0, &pos2Idx0, &pos3Idx0,
                &pos0Angle0, &pos1Angle0, &pos2Angle0, &pos3Angle0);
 
-    findBounds(angles1, angle1, samples.isEqualIntervalAngles1(), true,
+    findBounds(angles1, angle1, samples.isEqualIntervalAngles1(), samples.getBoundsTable1(), true,
                &pos0Idx1, &pos1Idx1, &pos2Idx1, &pos3Idx1,
                &pos0Angle1, &pos1Angle1, &pos2Angle1, &pos3Angle1);
 
-    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), false,
+    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), false,
                &pos0Idx2, &pos1Idx2, &pos2Idx2, &pos3Idx2,
                &pos0Angle2, &pos1Angle2, &pos2Angle2, &pos3Angle2);
 
-    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), true,
+    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), true,
                &pos0Idx3, &pos1Idx3, &pos2Idx3, &pos3Idx3,
                &pos0Angle3, &pos1Angle3, &pos2Angle3, &pos3Angle3);
 
-    Spectrum sp00 = interpolate2D(samples, pos0Idx0, pos0Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp01 = interpolate2D(samples, pos0Idx0, pos1Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp02 = interpolate2D(samples, pos0Idx0, pos2Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp03 = interpolate2D(samples, pos0Idx0, pos3Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp10 = interpolate2D(samples, pos1Idx0, pos0Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp11 = interpolate2D(samples, pos1Idx0, pos1Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp12 = interpolate2D(samples, pos1Idx0, pos2Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp13 = interpolate2D(samples, pos1Idx0, pos3Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp20 = interpolate2D(samples, pos2Idx0, pos0Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp21 = interpolate2D(samples, pos2Idx0, pos1Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp22 = interpolate2D(samples, pos2Idx0, pos2Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp23 = interpolate2D(samples, pos2Idx0, pos3Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp30 = interpolate2D(samples, pos3Idx0, pos0Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp31 = interpolate2D(samples, pos3Idx0, pos1Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp32 = interpolate2D(samples, pos3Idx0, pos2Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp33 = interpolate2D(samples, pos3Idx0, pos3Idx1,
-                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                  angle2, angle3);
-
-    Spectrum sp0, sp1, sp2, sp3;
+    SpectrumT sp00 = interpolate2D<NumWavelengths>(samples, pos0Idx0, pos0Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp01 = interpolate2D<NumWavelengths>(samples, pos0Idx0, pos1Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp02 = interpolate2D<NumWavelengths>(samples, pos0Idx0, pos2Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp03 = interpolate2D<NumWavelengths>(samples, pos0Idx0, pos3Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp10 = interpolate2D<NumWavelengths>(samples, pos1Idx0, pos0Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp11 = interpolate2D<NumWavelengths>(samples, pos1Idx0, pos1Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp12 = interpolate2D<NumWavelengths>(samples, pos1Idx0, pos2Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp13 = interpolate2D<NumWavelengths>(samples, pos1Idx0, pos3Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp20 = interpolate2D<NumWavelengths>(samples, pos2Idx0, pos0Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp21 = interpolate2D<NumWavelengths>(samples, pos2Idx0, pos1Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp22 = interpolate2D<NumWavelengths>(samples, pos2Idx0, pos2Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp23 = interpolate2D<NumWavelengths>(samples, pos2Idx0, pos3Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp30 = interpolate2D<NumWavelengths>(samples, pos3Idx0, pos0Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp31 = interpolate2D<NumWavelengths>(samples, pos3Idx0, pos1Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp32 = interpolate2D<NumWavelengths>(samples, pos3Idx0, pos2Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp33 = interpolate2D<NumWavelengths>(samples, pos3Idx0, pos3Idx1,
+                                                   pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                   pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                   pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                   pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                   angle2, angle3);
+
+    SpectrumT sp0, sp1, sp2, sp3;
     catmullRomSpline(pos0Angle1, pos1Angle1, pos2Angle1, pos3Angle1, sp00, sp01, sp02, sp03, angle1, &sp0);
     catmullRomSpline(pos0Angle1, pos1Angle1, pos2Angle1, pos3Angle1, sp10, sp11, sp12, sp13, angle1, &sp1);
     catmullRomSpline(pos0Angle1, pos1Angle1, pos2Angle1, pos3Angle1, sp20, sp21, sp22, sp23, angle1, &sp2);
@@ -171,12 +229,15 @@ void CatmullRomSplineInterpolator::getSpectrum(const SampleSet& samples,
     assert(spectrum->allFinite());
 }
 
-void CatmullRomSplineInterpolator::getSpectrum(const SampleSet& samples,
-                                               float            angle0,
-                                               float            angle2,
-                                               float            angle3,
-                                               Spectrum*        spectrum)
+template <int NumWavelengths>
+void CatmullRomSplineInterpolator::getSpectrum(const SampleSet&                samples,
+                                               float                           angle0,
+                                               float                           angle2,
+                                               float                           angle3,
+                                               FixedSpectrum<NumWavelengths>*  spectrum)
 {
+    using SpectrumT = FixedSpectrum<NumWavelengths>;
+
     const Arrayf& angles0 = samples.getAngles0();
     const Arrayf& angles2 = samples.getAngles2();
     const Arrayf& angles3 = samples.getAngles3();
@@ -191,45 +252,45 @@ void CatmullRomSplineInterpolator::getSpectrum(const SampleSet& samples,
     float pos2Angle0, pos2Angle2, pos2Angle3;
     float pos3Angle0, pos3Angle2, pos3Angle3;
 
-    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), false,
+    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), false,
                &pos0Idx0, &pos1Idx0, &pos2Idx0, &pos3Idx0,
                &pos0Angle0, &pos1Angle0, &pos2Angle0, &pos3Angle0);
 
-    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), false,
+    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), false,
                &pos0Idx2, &pos1Idx2, &pos2Idx2, &pos3Idx2,
                &pos0Angle2, &pos1Angle2, &pos2Angle2, &pos3Angle2);
 
-    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), true,
+    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), true,
                &pos0Idx3, &pos1Idx3, &pos2Idx3, &pos3Idx3,
                &pos0Angle3, &pos1Angle3, &pos2Angle3, &pos3Angle3);
 
-    Spectrum sp0 = interpolate2D(samples, pos0Idx0, 0,
-                                 pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                 pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                 pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                 pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                 angle2, angle3);
-
-    Spectrum sp1 = interpolate2D(samples, pos1Idx0, 0,
-                                 pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                 pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                 pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                 pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                 angle2, angle3);
-
-    Spectrum sp2 = interpolate2D(samples, pos2Idx0, 0,
-                                 pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                 pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                 pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                 pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                 angle2, angle3);
-
-    Spectrum sp3 = interpolate2D(samples, pos3Idx0, 0,
-                                 pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
-                                 pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
-                                 pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
-                                 pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
-                                 angle2, angle3);
+    SpectrumT sp0 = interpolate2D<NumWavelengths>(samples, pos0Idx0, 0,
+                                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                  angle2, angle3);
+
+    SpectrumT sp1 = interpolate2D<NumWavelengths>(samples, pos1Idx0, 0,
+                                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                  angle2, angle3);
+
+    SpectrumT sp2 = interpolate2D<NumWavelengths>(samples, pos2Idx0, 0,
+                                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                  angle2, angle3);
+
+    SpectrumT sp3 = interpolate2D<NumWavelengths>(samples, pos3Idx0, 0,
+                                                  pos0Idx2, pos1Idx2, pos2Idx2, pos3Idx2,
+                                                  pos0Idx3, pos1Idx3, pos2Idx3, pos3Idx3,
+                                                  pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2,
+                                                  pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3,
+                                                  angle2, angle3);
 
     catmullRomSpline(pos0Angle0, pos1Angle0, pos2Angle0, pos3Angle0, sp0, sp1, sp2, sp3, angle0, spectrum);
 
@@ -258,19 +319,19 @@ float CatmullRomSplineInterpolator::getValue(const SampleSet&   samples,
     float pos2Angle0, pos2Angle1, pos2Angle2, pos2Angle3;
     float pos3Angle0, pos3Angle1, pos3Angle2, pos3Angle3;
 
-    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), false,
+    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), false,
                &pos0Idx0, &pos1Idx0, &pos2Idx0, &pos3Idx0,
                &pos0Angle0, &pos1Angle0, &pos2Angle0, &pos3Angle0);
 
-    findBounds(angles1, angle1, samples.isEqualIntervalAngles1(), true,
+    findBounds(angles1, angle1, samples.isEqualIntervalAngles1(), samples.getBoundsTable1(), true,
                &pos0Idx1, &pos1Idx1, &pos2Idx1, &pos3Idx1,
                &pos0Angle1, &pos1Angle1, &pos2Angle1, &pos3Angle1);
 
-    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), false,
+    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), false,
                &pos0Idx2, &pos1Idx2, &pos2Idx2, &pos3Idx2,
                &pos0Angle2, &pos1Angle2, &pos2Angle2, &pos3Angle2);
 
-    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), true,
+    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), true,
                &pos0Idx3, &pos1Idx3, &pos2Idx3, &pos3Idx3,
                &pos0Angle3, &pos1Angle3, &pos2Angle3, &pos3Angle3);
 
@@ -417,15 +478,15 @@ float CatmullRomSplineInterpolator::getValue(const SampleSet&   samples,
     float pos2Angle0, pos2Angle2, pos2Angle3;
     float pos3Angle0, pos3Angle2, pos3Angle3;
 
-    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), false,
+    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), false,
                &pos0Idx0, &pos1Idx0, &pos2Idx0, &pos3Idx0,
                &pos0Angle0, &pos1Angle0, &pos2Angle0, &pos3Angle0);
 
-    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), false,
+    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), false,
                &pos0Idx2, &pos1Idx2, &pos2Idx2, &pos3Idx2,
                &pos0Angle2, &pos1Angle2, &pos2Angle2, &pos3Angle2);
 
-    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), true,
+    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), true,
                &pos0Idx3, &pos1Idx3, &pos2Idx3, &pos3Idx3,
                &pos0Angle3, &pos1Angle3, &pos2Angle3, &pos3Angle3);
 
@@ -481,11 +542,11 @@ void CatmullRomSplineInterpolator::getSpectrum(const SampleSet2D&   ss2,
     float pos2Angle0, pos2Angle1;
     float pos3Angle0, pos3Angle1;
 
-    findBounds(thetaArray, theta, ss2.isEqualIntervalTheta(), false,
+    findBounds(thetaArray, theta, ss2.isEqualIntervalTheta(), BoundsTable(), false,
                &pos0Idx0, &pos1Idx0, &pos2Idx0, &pos3Idx0,
                &pos0Angle0, &pos1Angle0, &pos2Angle0, &pos3Angle0);
 
-    findBounds(phiArray, phi, ss2.isEqualIntervalPhi(), true,
+    findBounds(phiArray, phi, ss2.isEqualIntervalPhi(), BoundsTable(), true,
                &pos0Idx1, &pos1Idx1, &pos2Idx1, &pos3Idx1,
                &pos0Angle1, &pos1Angle1, &pos2Angle1, &pos3Angle1);
 
@@ -536,7 +597,7 @@ void CatmullRomSplineInterpolator::getSpectrum(const SampleSet2D&   ss2,
     float pos2Angle0;
     float pos3Angle0;
 
-    findBounds(thetaArray, theta, ss2.isEqualIntervalTheta(), false,
+    findBounds(thetaArray, theta, ss2.isEqualIntervalTheta(), BoundsTable(), false,
                &pos0Idx0, &pos1Idx0, &pos2Idx0, &pos3Idx0,
                &pos0Angle0, &pos1Angle0, &pos2Angle0, &pos3Angle0);
 
@@ -550,18 +611,19 @@ void CatmullRomSplineInterpolator::getSpectrum(const SampleSet2D&   ss2,
     assert(spectrum->allFinite());
 }
 
-void CatmullRomSplineInterpolator::findBounds(const Arrayf& positions,
-                                              float         posAngle,
-                                              bool          equalIntervalPositions,
-                                              bool          repeatBounds,
-                                              int*          pos0Index,
-                                              int*          pos1Index,
-                                              int*          pos2Index,
-                                              int*          pos3Index,
-                                              float*        pos0Angle,
-                                              float*        pos1Angle,
-                                              float*        pos2Angle,
-                                              float*        pos3Angle)
+void CatmullRomSplineInterpolator::findBounds(const Arrayf&       positions,
+                                              float               posAngle,
+                                              bool                equalIntervalPositions,
+                                              const BoundsTable&  table,
+                                              bool                repeatBounds,
+                                              int*                pos0Index,
+                                              int*                pos1Index,
+                                              int*                pos2Index,
+                                              int*                pos3Index,
+                                              float*              pos0Angle,
+                                              float*              pos1Angle,
+                                              float*              pos2Angle,
+                                              float*              pos3Angle)
 {
     using std::min;
     using std::max;
@@ -579,7 +641,7 @@ void CatmullRomSplineInterpolator::findBounds(const Arrayf& positions,
         return;
     }
 
-    lb::findBounds(positions, posAngle, equalIntervalPositions, pos1Index, pos2Index, pos1Angle, pos2Angle);
+    lb::findBounds(positions, posAngle, equalIntervalPositions, table, pos1Index, pos2Index, pos1Angle, pos2Angle);
 
     int backIndex = static_cast<int>(positions.size() - 1);
     if (repeatBounds) {
@@ -610,55 +672,59 @@ void CatmullRomSplineInterpolator::findBounds(const Arrayf& positions,
     }
 }
 
-Spectrum CatmullRomSplineInterpolator::interpolate2D(const SampleSet&   samples,
-                                                     int                index0,
-                                                     int                index1,
-                                                     int                pos0Index2,
-                                                     int                pos1Index2,
-                                                     int                pos2Index2,
-                                                     int                pos3Index2,
-                                                     int                pos0Index3,
-                                                     int                pos1Index3,
-                                                     int                pos2Index3,
-                                                     int                pos3Index3,
-                                                     float              pos0Angle2,
-                                                     float              pos1Angle2,
-                                                     float              pos2Angle2,
-                                                     float              pos3Angle2,
-                                                     float              pos0Angle3,
-                                                     float              pos1Angle3,
-                                                     float              pos2Angle3,
-                                                     float              pos3Angle3,
-                                                     float              angle2,
-                                                     float              angle3)
+template <int NumWavelengths>
+FixedSpectrum<NumWavelengths> CatmullRomSplineInterpolator::interpolate2D(const SampleSet&   samples,
+                                                                          int                index0,
+                                                                          int                index1,
+                                                                          int                pos0Index2,
+                                                                          int                pos1Index2,
+                                                                          int                pos2Index2,
+                                                                          int                pos3Index2,
+                                                                          int                pos0Index3,
+                                                                          int                pos1Index3,
+                                                                          int                pos2Index3,
+                                                                          int                pos3Index3,
+                                                                          float              pos0Angle2,
+                                                                          float              pos1Angle2,
+                                                                          float              pos2Angle2,
+                                                                          float              pos3Angle2,
+                                                                          float              pos0Angle3,
+                                                                          float              pos1Angle3,
+                                                                          float              pos2Angle3,
+                                                                          float              pos3Angle3,
+                                                                          float              angle2,
+                                                                          float              angle3)
 {
-    const Spectrum& sp00 = samples.getSpectrum(index0, index1, pos0Index2, pos0Index3);
-    const Spectrum& sp01 = samples.getSpectrum(index0, index1, pos0Index2, pos1Index3);
-    const Spectrum& sp02 = samples.getSpectrum(index0, index1, pos0Index2, pos2Index3);
-    const Spectrum& sp03 = samples.getSpectrum(index0, index1, pos0Index2, pos3Index3);
-
-    const Spectrum& sp10 = samples.getSpectrum(index0, index1, pos1Index2, pos0Index3);
-    const Spectrum& sp11 = samples.getSpectrum(index0, index1, pos1Index2, pos1Index3);
-    const Spectrum& sp12 = samples.getSpectrum(index0, index1, pos1Index2, pos2Index3);
-    const Spectrum& sp13 = samples.getSpectrum(index0, index1, pos1Index2, pos3Index3);
-
-    const Spectrum& sp20 = samples.getSpectrum(index0, index1, pos2Index2, pos0Index3);
-    const Spectrum& sp21 = samples.getSpectrum(index0, index1, pos2Index2, pos1Index3);
-    const Spectrum& sp22 = samples.getSpectrum(index0, index1, pos2Index2, pos2Index3);
-    const Spectrum& sp23 = samples.getSpectrum(index0, index1, pos2Index2, pos3Index3);
-
-    const Spectrum& sp30 = samples.getSpectrum(index0, index1, pos3Index2, pos0Index3);
-    const Spectrum& sp31 = samples.getSpectrum(index0, index1, pos3Index2, pos1Index3);
-    const Spectrum& sp32 = samples.getSpectrum(index0, index1, pos3Index2, pos2Index3);
-    const Spectrum& sp33 = samples.getSpectrum(index0, index1, pos3Index2, pos3Index3);
-
-    Spectrum sp0, sp1, sp2, sp3;
+    using SpectrumT = FixedSpectrum<NumWavelengths>;
+    using MapT = ConstFixedSpectrumMap<NumWavelengths>;
+
+    MapT sp00 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos0Index2, pos0Index3);
+    MapT sp01 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos0Index2, pos1Index3);
+    MapT sp02 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos0Index2, pos2Index3);
+    MapT sp03 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos0Index2, pos3Index3);
+
+    MapT sp10 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos1Index2, pos0Index3);
+    MapT sp11 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos1Index2, pos1Index3);
+    MapT sp12 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos1Index2, pos2Index3);
+    MapT sp13 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos1Index2, pos3Index3);
+
+    MapT sp20 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos2Index2, pos0Index3);
+    MapT sp21 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos2Index2, pos1Index3);
+    MapT sp22 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos2Index2, pos2Index3);
+    MapT sp23 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos2Index2, pos3Index3);
+
+    MapT sp30 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos3Index2, pos0Index3);
+    MapT sp31 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos3Index2, pos1Index3);
+    MapT sp32 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos3Index2, pos2Index3);
+    MapT sp33 = samples.getFixedSpectrum<NumWavelengths>(index0, index1, pos3Index2, pos3Index3);
+
+    SpectrumT sp0, sp1, sp2, sp3;
     catmullRomSpline(pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3, sp00, sp01, sp02, sp03, angle3, &sp0);
     catmullRomSpline(pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3, sp10, sp11, sp12, sp13, angle3, &sp1);
     catmullRomSpline(pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3, sp20, sp21, sp22, sp23, angle3, &sp2);
     catmullRomSpline(pos0Angle3, pos1Angle3, pos2Angle3, pos3Angle3, sp30, sp31, sp32, sp33, angle3, &sp3);
 
-    Spectrum sp;
+    SpectrumT sp;
     catmullRomSpline(pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2, sp0, sp1, sp2, sp3, angle2, &sp);
     return sp;
 }
@@ -713,3 +779,17 @@ float CatmullRomSplineInterpolator::interpolate2D(const SampleSet&  samples,
 
     return catmullRomSpline(pos0Angle2, pos1Angle2, pos2Angle2, pos3Angle2, v0, v1, v2, v3, angle2);
 }
+
+#define LB_INSTANTIATE_CATMULL_ROM_SPLINE_INTERPOLATOR(NumWavelengths)                           \
+    template void CatmullRomSplineInterpolator::getSpectrum<NumWavelengths>(                      \
+        const SampleSet&, float, float, float, float, FixedSpectrum<NumWavelengths>*);            \
+    template void CatmullRomSplineInterpolator::getSpectrum<NumWavelengths>(                      \
+        const SampleSet&, float, float, float, FixedSpectrum<NumWavelengths>*);
+
+namespace lb {
+
+LB_INSTANTIATE_CATMULL_ROM_SPLINE_INTERPOLATOR(1)
+LB_INSTANTIATE_CATMULL_ROM_SPLINE_INTERPOLATOR(3)
+LB_INSTANTIATE_CATMULL_ROM_SPLINE_INTERPOLATOR(Eigen::Dynamic)
+
+} // namespace lb
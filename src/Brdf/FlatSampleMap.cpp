@@ -0,0 +1,157 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Brdf/FlatSampleMap.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <libbsdf/Common/Log.h>
+
+using namespace lb;
+
+void FlatSampleMap::setNumWavelengths(int numWavelengths)
+{
+    clear();
+    numWavelengths_ = numWavelengths;
+}
+
+void FlatSampleMap::reserve(int numSamples)
+{
+    if (numSamples > spectra_.cols()) {
+        spectra_.conservativeResize(numWavelengths_, numSamples);
+    }
+
+    angleList_.reserve(numSamples);
+    growTable(numSamples);
+}
+
+void FlatSampleMap::clear()
+{
+    angleList_.clear();
+    spectra_.resize(numWavelengths_, 0);
+    slots_.clear();
+}
+
+int FlatSampleMap::insert(const Key& angles, const Spectrum& spectrum)
+{
+    if (numWavelengths_ == 0 && empty()) {
+        numWavelengths_ = static_cast<int>(spectrum.size());
+    }
+
+    if (spectrum.size() != numWavelengths_) {
+        lbError
+            << "[FlatSampleMap::insert] The number of wavelengths is not matched: "
+            << spectrum.size() << ", " << numWavelengths_;
+        return -1;
+    }
+
+    growTable(angleList_.size() + 1);
+
+    size_t slot = findSlot(angles);
+    int index = slots_[slot];
+    if (index == -1) {
+        index = append(angles, slot);
+    }
+
+    getSpectrum(index) = spectrum;
+
+    return index;
+}
+
+bool FlatSampleMap::insert(const std::vector<Key>& angleList, const SpectrumArray& spectra)
+{
+    if (numWavelengths_ == 0 && empty()) {
+        numWavelengths_ = static_cast<int>(spectra.rows());
+    }
+
+    if (spectra.rows() != numWavelengths_ ||
+        spectra.cols() != static_cast<SpectrumArray::Index>(angleList.size())) {
+        lbError
+            << "[FlatSampleMap::insert] The size of spectra is not matched: "
+            << spectra.rows() << "x" << spectra.cols();
+        return false;
+    }
+
+    reserve(size() + static_cast<int>(angleList.size()));
+
+    for (size_t i = 0; i < angleList.size(); ++i) {
+        size_t slot = findSlot(angleList[i]);
+        int index = slots_[slot];
+        if (index == -1) {
+            index = append(angleList[i], slot);
+        }
+
+        getSpectrum(index) = spectra.col(i);
+    }
+
+    return true;
+}
+
+size_t FlatSampleMap::hash(const Key& angles)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < angles.size(); ++i) {
+        // Negative zero must have the same hash value as positive zero.
+        float angle = (angles[i] == 0.0f) ? 0.0f : angles[i];
+
+        uint32_t bits;
+        std::memcpy(&bits, &angle, sizeof(bits));
+
+        // The finalizer of splitmix64.
+        h ^= bits;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+    }
+
+    return static_cast<size_t>(h);
+}
+
+int FlatSampleMap::append(const Key& angles, size_t slot)
+{
+    int index = size();
+
+    // Rows are missing if columns were reserved before the number of wavelengths was set.
+    if (index >= spectra_.cols() || spectra_.rows() != numWavelengths_) {
+        SpectrumArray::Index numCols = spectra_.cols();
+        if (index >= numCols) {
+            numCols = std::max<SpectrumArray::Index>(16, numCols * 2);
+        }
+
+        spectra_.conservativeResize(numWavelengths_, numCols);
+    }
+
+    angleList_.push_back(angles);
+    slots_[slot] = index;
+
+    return index;
+}
+
+void FlatSampleMap::rehash(size_t numSlots)
+{
+    slots_.assign(numSlots, -1);
+
+    for (int i = 0; i < size(); ++i) {
+        slots_[findSlot(angleList_[i])] = i;
+    }
+}
+
+void FlatSampleMap::growTable(size_t numSamples)
+{
+    // Keep the load factor at most 0.5.
+    size_t numSlots = std::max<size_t>(slots_.size(), 16);
+    while (numSlots < numSamples * 2) {
+        numSlots *= 2;
+    }
+
+    if (numSlots != slots_.size()) {
+        rehash(numSlots);
+    }
+}
@@ -8,63 +8,195 @@
 
 #include <libbsdf/Brdf/Integrator.h>
 
+#include <algorithm>
+
+#include <libbsdf/Common/Sobol.h>
 #include <libbsdf/Common/Xorshift.h>
 
 using namespace lb;
 
-Integrator::Integrator(int numSampling) : numSampling_(numSampling)
+Integrator::Integrator(int numSampling, uint32_t seed) : numSampling_(numSampling)
 {
-    initializeOutDirs();
+    initializeOutDirs(seed);
 }
 
 Spectrum Integrator::computeReflectance(const Brdf& brdf, const Vec3& inDir)
 {
-    Arrayd sumSpectrum;
-    sumSpectrum.resize(brdf.getSampleSet()->getNumWavelengths());
-    sumSpectrum.setZero();
-
-    Vec3 outDir;
-    Spectrum sp;
-    #pragma omp parallel for private(outDir, sp)
-    for (int i = 0; i < numSampling_; ++i) {
-        outDir = outDirs_.col(i).cast<Vec3::Scalar>();
-        sp = brdf.getSpectrum(inDir, outDir);
-        sp *= static_cast<Spectrum::Scalar>(outDir.z());
-
-        #pragma omp critical
-        sumSpectrum += sp.cast<Arrayd::Scalar>();
+    if (numSampling_ <= 0) {
+        return Spectrum::Zero(brdf.getSampleSet()->getNumWavelengths());
+    }
+
+    int numBlocks = (numSampling_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::vector<Arrayd> blockSums(numBlocks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex) {
+        int blockBegin = blockIndex * BLOCK_SIZE;
+        int blockEnd = std::min(numSampling_, blockBegin + BLOCK_SIZE);
+
+        std::vector<Vec3> outDirs(blockEnd - blockBegin);
+        for (int i = blockBegin; i < blockEnd; ++i) {
+            outDirs[i - blockBegin] = outDirs_.col(i).cast<Vec3::Scalar>();
+        }
+
+        blockSums[blockIndex] = sumBlock(brdf, inDir, outDirs);
     }
 
+    Arrayd sumSpectrum = reduceBlockSums(&blockSums);
     sumSpectrum *= TAU_D / numSampling_;
     return sumSpectrum.cast<Spectrum::Scalar>();
 }
 
-Spectrum Integrator::computeReflectance(const Brdf& brdf, const Vec3& inDir, int numSampling)
+Spectrum Integrator::computeReflectance(const Brdf&    brdf,
+                                        const Vec3&    inDir,
+                                        int            numSampling,
+                                        uint32_t       seed)
 {
-    Arrayd sumSpectrum;
-    sumSpectrum.resize(brdf.getSampleSet()->getNumWavelengths());
-    sumSpectrum.setZero();
-
-    Vec3 outDir;
-    Spectrum sp;
-    #pragma omp parallel for private(outDir, sp)
-    for (int i = 0; i < numSampling; ++i) {
-        outDir = Xorshift::randomOnHemisphere<Vec3>();
-        sp = brdf.getSpectrum(inDir, outDir);
-        sp *= static_cast<Spectrum::Scalar>(outDir.z());
-
-        #pragma omp critical
-        sumSpectrum += sp.cast<Arrayd::Scalar>();
+    if (numSampling <= 0) {
+        return Spectrum::Zero(brdf.getSampleSet()->getNumWavelengths());
+    }
+
+    int numBlocks = (numSampling + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::vector<Arrayd> blockSums(numBlocks);
+
+    // Each block of samples uses its own random number stream independent of the thread.
+    std::vector<Xorshift> rngs = Xorshift::createStreams(numBlocks, seed);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex) {
+        int blockBegin = blockIndex * BLOCK_SIZE;
+        int blockEnd = std::min(numSampling, blockBegin + BLOCK_SIZE);
+
+        Xorshift& rng = rngs[blockIndex];
+
+        std::vector<Vec3> outDirs(blockEnd - blockBegin);
+        for (auto& outDir : outDirs) {
+            outDir = rng.nextOnHemisphere<Vec3>();
+        }
+
+        blockSums[blockIndex] = sumBlock(brdf, inDir, outDirs);
     }
 
+    Arrayd sumSpectrum = reduceBlockSums(&blockSums);
     sumSpectrum *= TAU_D / numSampling;
     return sumSpectrum.cast<Spectrum::Scalar>();
 }
 
-void Integrator::initializeOutDirs()
+Spectrum Integrator::computeReflectanceAdaptively(const Brdf&    brdf,
+                                                  const Vec3&    inDir,
+                                                  double         tolerance,
+                                                  int            maxNumSampling,
+                                                  double*        error,
+                                                  int*           numSampling)
 {
-    outDirs_.resize(Eigen::NoChange, numSampling_);
-    for (int i = 0; i < numSampling_; ++i) {
-        outDirs_.col(i) = Xorshift::randomOnHemisphere<Vec3f>();
+    const int numSequences = 8;
+    const int initialNumSampling = 64;
+
+    int numWavelengths = brdf.getSampleSet()->getNumWavelengths();
+
+    std::vector<Arrayd> sums(numSequences, Arrayd::Zero(numWavelengths));
+    Arrayd mean, stdError;
+
+    int begin = 0;
+    int end = std::max(std::min(initialNumSampling, maxNumSampling / numSequences), 1);
+    while (true) {
+        #pragma omp parallel for schedule(dynamic)
+        for (int seqIndex = 0; seqIndex < numSequences; ++seqIndex) {
+            uint32_t seed = static_cast<uint32_t>(seqIndex);
+
+            std::vector<Vec3> outDirs(end - begin);
+            for (int i = begin; i < end; ++i) {
+                uint32_t index = static_cast<uint32_t>(i);
+                double u0 = Sobol::sample<double>(index, 0, seed);
+                double u1 = Sobol::sample<double>(index, 1, seed);
+
+                // Cosine-weighted direction on the hemisphere.
+                double r = std::sqrt(u0);
+                double phi = TAU_D * u1;
+                outDirs[i - begin] = Vec3(r * std::cos(phi), r * std::sin(phi), std::sqrt(1.0 - u0));
+            }
+
+            int numDirs = static_cast<int>(outDirs.size());
+            std::vector<Vec3> inDirs(numDirs, inDir);
+            std::vector<float> spectra(numDirs * numWavelengths);
+            brdf.getSpectra(inDirs.data(), outDirs.data(), numDirs, spectra.data());
+
+            for (int i = 0; i < numDirs; ++i) {
+                sums[seqIndex] += ConstSpectrumMap(&spectra[numWavelengths * i], numWavelengths).cast<Arrayd::Scalar>();
+            }
+        }
+
+        // The estimate of each sequence is PI * (the mean of the BRDF), since the PDF is cos(theta) / PI.
+        Arrayd sumEstimates = Arrayd::Zero(numWavelengths);
+        Arrayd sumSquaredEstimates = Arrayd::Zero(numWavelengths);
+        for (int seqIndex = 0; seqIndex < numSequences; ++seqIndex) {
+            Arrayd estimate = sums[seqIndex] * (PI_D / end);
+            sumEstimates += estimate;
+            sumSquaredEstimates += estimate.square();
+        }
+
+        mean = sumEstimates / numSequences;
+        Arrayd variance = ((sumSquaredEstimates - numSequences * mean.square()) / (numSequences - 1)).max(0.0);
+        stdError = (variance / numSequences).sqrt();
+
+        if (stdError.maxCoeff() <= tolerance ||
+            static_cast<long long>(end) * 2 * numSequences > maxNumSampling) {
+            break;
+        }
+
+        begin = end;
+        end *= 2;
+    }
+
+    if (error) {
+        *error = stdError.maxCoeff();
+    }
+
+    if (numSampling) {
+        *numSampling = end * numSequences;
+    }
+
+    return mean.cast<Spectrum::Scalar>();
+}
+
+Arrayd Integrator::sumBlock(const Brdf& brdf, const Vec3& inDir, const std::vector<Vec3>& outDirs)
+{
+    int numWavelengths = brdf.getSampleSet()->getNumWavelengths();
+    size_t numDirs = outDirs.size();
+
+    std::vector<Vec3> inDirs(numDirs, inDir);
+    std::vector<float> spectra(numDirs * numWavelengths);
+    brdf.getSpectra(inDirs.data(), outDirs.data(), numDirs, spectra.data());
+
+    Arrayd sumSpectrum = Arrayd::Zero(numWavelengths);
+    for (size_t i = 0; i < numDirs; ++i) {
+        ConstSpectrumMap sp(&spectra[numWavelengths * i], numWavelengths);
+        sumSpectrum += (sp * static_cast<Spectrum::Scalar>(outDirs[i].z())).cast<Arrayd::Scalar>();
     }
+
+    return sumSpectrum;
+}
+
+Arrayd Integrator::reduceBlockSums(std::vector<Arrayd>* blockSums)
+{
+    std::vector<Arrayd>& sums = *blockSums;
+    size_t numSums = sums.size();
+    if (numSums == 0) return Arrayd();
+
+    // Pairwise reduction in a fixed order for reproducible results.
+    for (size_t stride = 1; stride < numSums; stride *= 2) {
+        for (size_t i = 0; i + stride < numSums; i += stride * 2) {
+            sums[i] += sums[i + stride];
+        }
+    }
+
+    return sums.front();
+}
+
+void Integrator::initializeOutDirs(uint32_t seed)
+{
+    outDirs_.resize(Eigen::NoChange, numSampling_);
+
+    Xorshift rng(seed);
+    rng.fillOnHemisphere(&outDirs_);
 }
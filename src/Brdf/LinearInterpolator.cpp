@@ -21,64 +21,25 @@ void LinearInterpolator::getSpectrum(const SampleSet&   samples,
                                      float              angle3,
                                      Spectrum*          spectrum)
 {
-    const Arrayf& angles0 = samples.getAngles0();
-    const Arrayf& angles1 = samples.getAngles1();
-    const Arrayf& angles2 = samples.getAngles2();
-    const Arrayf& angles3 = samples.getAngles3();
-
-    int lIdx0, lIdx1, lIdx2, lIdx3; // index of the lower bound sample point
-    int uIdx0, uIdx1, uIdx2, uIdx3; // index of the upper bound sample point
-    Vec4f lowerAngles, upperAngles;
-
-    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), &lIdx0, &uIdx0, &lowerAngles[0], &upperAngles[0]);
-    findBounds(angles1, angle1, samples.isEqualIntervalAngles1(), &lIdx1, &uIdx1, &lowerAngles[1], &upperAngles[1]);
-    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), &lIdx2, &uIdx2, &lowerAngles[2], &upperAngles[2]);
-    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), &lIdx3, &uIdx3, &lowerAngles[3], &upperAngles[3]);
-
-    Vec4f angles(angle0, angle1, angle2, angle3);
-    Vec4f intervals = (upperAngles - lowerAngles).cwiseMax(EPSILON_F);
-    Vec4f weights = (angles - lowerAngles).cwiseQuotient(intervals);
-
-    const Spectrum& sp0000 = samples.getSpectrum(lIdx0, lIdx1, lIdx2, lIdx3);
-    const Spectrum& sp0001 = samples.getSpectrum(lIdx0, lIdx1, lIdx2, uIdx3);
-    const Spectrum& sp0010 = samples.getSpectrum(lIdx0, lIdx1, uIdx2, lIdx3);
-    const Spectrum& sp0011 = samples.getSpectrum(lIdx0, lIdx1, uIdx2, uIdx3);
-
-    const Spectrum& sp0100 = samples.getSpectrum(lIdx0, uIdx1, lIdx2, lIdx3);
-    const Spectrum& sp0101 = samples.getSpectrum(lIdx0, uIdx1, lIdx2, uIdx3);
-    const Spectrum& sp0110 = samples.getSpectrum(lIdx0, uIdx1, uIdx2, lIdx3);
-    const Spectrum& sp0111 = samples.getSpectrum(lIdx0, uIdx1, uIdx2, uIdx3);
-
-    const Spectrum& sp1000 = samples.getSpectrum(uIdx0, lIdx1, lIdx2, lIdx3);
-    const Spectrum& sp1001 = samples.getSpectrum(uIdx0, lIdx1, lIdx2, uIdx3);
-    const Spectrum& sp1010 = samples.getSpectrum(uIdx0, lIdx1, uIdx2, lIdx3);
-    const Spectrum& sp1011 = samples.getSpectrum(uIdx0, lIdx1, uIdx2, uIdx3);
-
-    const Spectrum& sp1100 = samples.getSpectrum(uIdx0, uIdx1, lIdx2, lIdx3);
-    const Spectrum& sp1101 = samples.getSpectrum(uIdx0, uIdx1, lIdx2, uIdx3);
-    const Spectrum& sp1110 = samples.getSpectrum(uIdx0, uIdx1, uIdx2, lIdx3);
-    const Spectrum& sp1111 = samples.getSpectrum(uIdx0, uIdx1, uIdx2, uIdx3);
-
-    Spectrum sp000 = lerp(sp0000, sp0001, weights[3]);
-    Spectrum sp001 = lerp(sp0010, sp0011, weights[3]);
-    Spectrum sp010 = lerp(sp0100, sp0101, weights[3]);
-    Spectrum sp011 = lerp(sp0110, sp0111, weights[3]);
-    Spectrum sp100 = lerp(sp1000, sp1001, weights[3]);
-    Spectrum sp101 = lerp(sp1010, sp1011, weights[3]);
-    Spectrum sp110 = lerp(sp1100, sp1101, weights[3]);
-    Spectrum sp111 = lerp(sp1110, sp1111, weights[3]);
-
-    Spectrum sp00 = lerp(sp000, sp001, weights[2]);
-    Spectrum sp01 = lerp(sp010, sp011, weights[2]);
-    Spectrum sp10 = lerp(sp100, sp101, weights[2]);
-    Spectrum sp11 = lerp(sp110, sp111, weights[2]);
-
-    Spectrum sp0 = lerp(sp00, sp01, weights[1]);
-    Spectrum sp1 = lerp(sp10, sp11, weights[1]);
-
-    *spectrum = lerp(sp0, sp1, weights[0]);
-
-    assert(spectrum->allFinite());
+    switch (samples.getNumWavelengths()) {
+        case 1: {
+            FixedSpectrum<1> sp;
+            getSpectrum<1>(samples, angle0, angle1, angle2, angle3, &sp);
+            spectrum->resize(1);
+            Eigen::Map<FixedSpectrum<1>>(spectrum->data()) = sp;
+            break;
+        }
+        case 3: {
+            FixedSpectrum<3> sp;
+            getSpectrum<3>(samples, angle0, angle1, angle2, angle3, &sp);
+            spectrum->resize(3);
+            Eigen::Map<FixedSpectrum<3>>(spectrum->data()) = sp;
+            break;
+        }
+        default:
+            getSpectrum<Eigen::Dynamic>(samples, angle0, angle1, angle2, angle3, spectrum);
+            break;
+    }
 }
 
 void LinearInterpolator::getSpectrum(const SampleSet&   samples,
@@ -87,43 +48,25 @@ void LinearInterpolator::getSpectrum(const SampleSet&   samples,
                                      float              angle3,
                                      Spectrum*          spectrum)
 {
-    const Arrayf& angles0 = samples.getAngles0();
-    const Arrayf& angles2 = samples.getAngles2();
-    const Arrayf& angles3 = samples.getAngles3();
-
-    int lIdx0, lIdx2, lIdx3; // index of the lower bound sample point
-    int uIdx0, uIdx2, uIdx3; // index of the upper bound sample point
-    Vec4f lowerAngles, upperAngles;
-
-    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), &lIdx0, &uIdx0, &lowerAngles[0], &upperAngles[0]);
-    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), &lIdx2, &uIdx2, &lowerAngles[2], &upperAngles[2]);
-    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), &lIdx3, &uIdx3, &lowerAngles[3], &upperAngles[3]);
-
-    Vec4f angles(angle0, 0.0, angle2, angle3);
-    Vec4f intervals = (upperAngles - lowerAngles).cwiseMax(EPSILON_F);
-    Vec4f weights = (angles - lowerAngles).cwiseQuotient(intervals);
-
-    const Spectrum& sp0000 = samples.getSpectrum(lIdx0, lIdx2, lIdx3);
-    const Spectrum& sp0001 = samples.getSpectrum(lIdx0, lIdx2, uIdx3);
-    const Spectrum& sp0010 = samples.getSpectrum(lIdx0, uIdx2, lIdx3);
-    const Spectrum& sp0011 = samples.getSpectrum(lIdx0, uIdx2, uIdx3);
-
-    const Spectrum& sp1000 = samples.getSpectrum(uIdx0, lIdx2, lIdx3);
-    const Spectrum& sp1001 = samples.getSpectrum(uIdx0, lIdx2, uIdx3);
-    const Spectrum& sp1010 = samples.getSpectrum(uIdx0, uIdx2, lIdx3);
-    const Spectrum& sp1011 = samples.getSpectrum(uIdx0, uIdx2, uIdx3);
-
-    Spectrum sp000 = lerp(sp0000, sp0001, weights[3]);
-    Spectrum sp001 = lerp(sp0010, sp0011, weights[3]);
-    Spectrum sp100 = lerp(sp1000, sp1001, weights[3]);
-    Spectrum sp101 = lerp(sp1010, sp1011, weights[3]);
-
-    Spectrum sp00 = lerp(sp000, sp001, weights[2]);
-    Spectrum sp10 = lerp(sp100, sp101, weights[2]);
-
-    *spectrum = lerp(sp00, sp10, weights[0]);
-
-    assert(spectrum->allFinite());
+    switch (samples.getNumWavelengths()) {
+        case 1: {
+            FixedSpectrum<1> sp;
+            getSpectrum<1>(samples, angle0, angle2, angle3, &sp);
+            spectrum->resize(1);
+            Eigen::Map<FixedSpectrum<1>>(spectrum->data()) = sp;
+            break;
+        }
+        case 3: {
+            FixedSpectrum<3> sp;
+            getSpectrum<3>(samples, angle0, angle2, angle3, &sp);
+            spectrum->resize(3);
+            Eigen::Map<FixedSpectrum<3>>(spectrum->data()) = sp;
+            break;
+        }
+        default:
+            getSpectrum<Eigen::Dynamic>(samples, angle0, angle2, angle3, spectrum);
+            break;
+    }
 }
 
 float LinearInterpolator::getValue(const SampleSet& samples,
@@ -142,10 +85,10 @@ float LinearInterpolator::getValue(const SampleSet& samples,
     int uIdx0, uIdx1, uIdx2, uIdx3; // index of the upper bound sample point
     Vec4f lowerAngles, upperAngles;
 
-    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), &lIdx0, &uIdx0, &lowerAngles[0], &upperAngles[0]);
-    findBounds(angles1, angle1, samples.isEqualIntervalAngles1(), &lIdx1, &uIdx1, &lowerAngles[1], &upperAngles[1]);
-    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), &lIdx2, &uIdx2, &lowerAngles[2], &upperAngles[2]);
-    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), &lIdx3, &uIdx3, &lowerAngles[3], &upperAngles[3]);
+    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), &lIdx0, &uIdx0, &lowerAngles[0], &upperAngles[0]);
+    findBounds(angles1, angle1, samples.isEqualIntervalAngles1(), samples.getBoundsTable1(), &lIdx1, &uIdx1, &lowerAngles[1], &upperAngles[1]);
+    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), &lIdx2, &uIdx2, &lowerAngles[2], &upperAngles[2]);
+    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), &lIdx3, &uIdx3, &lowerAngles[3], &upperAngles[3]);
 
     Vec4f angles(angle0, angle1, angle2, angle3);
     Vec4f intervals = (upperAngles - lowerAngles).cwiseMax(EPSILON_F);
@@ -208,9 +151,9 @@ float LinearInterpolator::getValue(const SampleSet& samples,
     int uIdx0, uIdx2, uIdx3; // index of the upper bound sample point
     Vec4f lowerAngles, upperAngles;
 
-    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), &lIdx0, &uIdx0, &lowerAngles[0], &upperAngles[0]);
-    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), &lIdx2, &uIdx2, &lowerAngles[2], &upperAngles[2]);
-    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), &lIdx3, &uIdx3, &lowerAngles[3], &upperAngles[3]);
+    findBounds(angles0, angle0, samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), &lIdx0, &uIdx0, &lowerAngles[0], &upperAngles[0]);
+    findBounds(angles2, angle2, samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), &lIdx2, &uIdx2, &lowerAngles[2], &upperAngles[2]);
+    findBounds(angles3, angle3, samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), &lIdx3, &uIdx3, &lowerAngles[3], &upperAngles[3]);
 
     Vec4f angles(angle0, 0.0, angle2, angle3);
     Vec4f intervals = (upperAngles - lowerAngles).cwiseMax(EPSILON_F);
@@ -240,6 +183,140 @@ float LinearInterpolator::getValue(const SampleSet& samples,
     return val;
 }
 
+void LinearInterpolator::getValues(const SampleSet&   samples,
+                                   const float*       angles0,
+                                   const float*       angles1,
+                                   const float*       angles2,
+                                   const float*       angles3,
+                                   size_t             numAngles,
+                                   int                wavelengthIndex,
+                                   float*             values)
+{
+    interpolateLanes(samples, angles0, angles1, angles2, angles3, numAngles, wavelengthIndex, 1, values);
+}
+
+void LinearInterpolator::getSpectra(const SampleSet&    samples,
+                                    const float*        angles0,
+                                    const float*        angles1,
+                                    const float*        angles2,
+                                    const float*        angles3,
+                                    size_t              numAngles,
+                                    float*              spectra)
+{
+    interpolateLanes(samples, angles0, angles1, angles2, angles3, numAngles,
+                     0, samples.getNumWavelengths(), spectra);
+}
+
+void LinearInterpolator::interpolateLanes(const SampleSet&  samples,
+                                          const float*      angles0,
+                                          const float*      angles1,
+                                          const float*      angles2,
+                                          const float*      angles3,
+                                          size_t            numAngles,
+                                          int               firstWavelength,
+                                          int               numWavelengths,
+                                          float*            values)
+{
+    using Lanes = Eigen::Array4f;
+
+    const Arrayf& sampleAngles0 = samples.getAngles0();
+    const Arrayf& sampleAngles1 = samples.getAngles1();
+    const Arrayf& sampleAngles2 = samples.getAngles2();
+    const Arrayf& sampleAngles3 = samples.getAngles3();
+
+    const bool isotropic = samples.isIsotropic();
+
+    for (size_t base = 0; base < numAngles; base += 4) {
+        int numLanes = static_cast<int>(std::min<size_t>(4, numAngles - base));
+
+        // Lane l of cornerSpectra[c] points to the sample point selected by the bits of c (angle0 is the highest bit).
+        // Unused lanes point to the sample point of the first lane.
+        const float* cornerSpectra[16][4];
+        Lanes weights0, weights1, weights2, weights3;
+        weights0.setZero();
+        weights1.setZero();
+        weights2.setZero();
+        weights3.setZero();
+
+        for (int l = 0; l < numLanes; ++l) {
+            size_t i = base + l;
+
+            int lIdx[4], uIdx[4];
+            Vec4f lowerAngles, upperAngles;
+
+            findBounds(sampleAngles0, angles0[i], samples.isEqualIntervalAngles0(), samples.getBoundsTable0(), &lIdx[0], &uIdx[0], &lowerAngles[0], &upperAngles[0]);
+            findBounds(sampleAngles2, angles2[i], samples.isEqualIntervalAngles2(), samples.getBoundsTable2(), &lIdx[2], &uIdx[2], &lowerAngles[2], &upperAngles[2]);
+            findBounds(sampleAngles3, angles3[i], samples.isEqualIntervalAngles3(), samples.getBoundsTable3(), &lIdx[3], &uIdx[3], &lowerAngles[3], &upperAngles[3]);
+
+            Vec4f angles(angles0[i], 0.0, angles2[i], angles3[i]);
+            if (isotropic) {
+                lIdx[1] = uIdx[1] = 0;
+                lowerAngles[1] = upperAngles[1] = 0.0f;
+            }
+            else {
+                findBounds(sampleAngles1, angles1[i], samples.isEqualIntervalAngles1(), samples.getBoundsTable1(), &lIdx[1], &uIdx[1], &lowerAngles[1], &upperAngles[1]);
+                angles[1] = angles1[i];
+            }
+
+            Vec4f intervals = (upperAngles - lowerAngles).cwiseMax(EPSILON_F);
+            Vec4f weights = (angles - lowerAngles).cwiseQuotient(intervals);
+
+            weights0[l] = weights[0];
+            weights1[l] = isotropic ? 0.0f : weights[1];
+            weights2[l] = weights[2];
+            weights3[l] = weights[3];
+
+            for (int c = 0; c < 16; ++c) {
+                cornerSpectra[c][l] = samples.getSpectrum((c & 8) ? uIdx[0] : lIdx[0],
+                                                          (c & 4) ? uIdx[1] : lIdx[1],
+                                                          (c & 2) ? uIdx[2] : lIdx[2],
+                                                          (c & 1) ? uIdx[3] : lIdx[3]).data();
+            }
+        }
+
+        for (int l = numLanes; l < 4; ++l) {
+            for (int c = 0; c < 16; ++c) {
+                cornerSpectra[c][l] = cornerSpectra[c][0];
+            }
+        }
+
+        for (int w = 0; w < numWavelengths; ++w) {
+            const int wavelengthIndex = firstWavelength + w;
+
+            Lanes corners[16];
+            for (int c = 0; c < 16; ++c) {
+                corners[c] = Lanes(cornerSpectra[c][0][wavelengthIndex],
+                                   cornerSpectra[c][1][wavelengthIndex],
+                                   cornerSpectra[c][2][wavelengthIndex],
+                                   cornerSpectra[c][3][wavelengthIndex]);
+            }
+
+            Lanes vals3[8];
+            for (int c = 0; c < 8; ++c) {
+                vals3[c] = corners[2 * c] + (corners[2 * c + 1] - corners[2 * c]) * weights3;
+            }
+
+            Lanes vals2[4];
+            for (int c = 0; c < 4; ++c) {
+                vals2[c] = vals3[2 * c] + (vals3[2 * c + 1] - vals3[2 * c]) * weights2;
+            }
+
+            Lanes vals1[2];
+            for (int c = 0; c < 2; ++c) {
+                vals1[c] = vals2[2 * c] + (vals2[2 * c + 1] - vals2[2 * c]) * weights1;
+            }
+
+            Lanes vals = vals1[0] + (vals1[1] - vals1[0]) * weights0;
+
+            for (int l = 0; l < numLanes; ++l) {
+                float& value = values[numWavelengths * (base + l) + w];
+                value = vals[l];
+                assert(!std::isnan(value) && !std::isinf(value));
+            }
+        }
+    }
+}
+
 void LinearInterpolator::getSpectrum(const SampleSet2D& ss2,
                                      float              theta,
                                      float              phi,
@@ -105,7 +105,7 @@ void lb::divideByCosineOutTheta(Brdf* brdf)
         brdf->getInOutDirection(i0, i1, i2, i3, &inDir, &outDir);
         Vec3::Scalar cosOutTheta = outDir.dot(Vec3(0.0, 0.0, 1.0));
 
-        Spectrum& sp = ss->getSpectrum(i0, i1, i2, i3);
+        SpectrumMap sp = ss->getSpectrum(i0, i1, i2, i3);
 
         // Copy the spectrum if the Z-component of the outgoing direction is zero or negative.
         if (cosOutTheta <= 0.0 && i2 > 0) {
@@ -121,7 +121,7 @@ void lb::divideByCosineOutTheta(Brdf* brdf)
 
 SphericalCoordinatesBrdf* lb::fillSymmetricBrdf(SphericalCoordinatesBrdf* brdf)
 {
-    RandomSampleSet<SphericalCoordinateSystem>::AngleList filledAngles;
+    std::vector<float> filledAngles;
 
     for (int i = 0; i < brdf->getNumOutPhi(); ++i) {
         float outPhi = brdf->getOutPhi(i);
@@ -180,7 +180,7 @@ SphericalCoordinatesBrdf* lb::fillSymmetricBrdf(SphericalCoordinatesBrdf* brdf)
             if (outPhiEqual) break;
         }
 
-        Spectrum& sp = brdf->getSpectrum(inThIndex, inPhIndex, outThIndex, origIndex);
+        SpectrumMap sp = brdf->getSpectrum(inThIndex, inPhIndex, outThIndex, origIndex);
         filledBrdf->setSpectrum(inThIndex, inPhIndex, outThIndex, outPhIndex, sp);
     }}}}
 
@@ -285,7 +285,7 @@ void lb::fixEnergyConservation(SpecularCoordinatesBrdf* brdf)
         if (maxReflectance > 1.0f) {
             for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
             for (int i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
-                Spectrum& fixedSp = ss->getSpectrum(inThIndex, inPhIndex, i2, i3);
+                SpectrumMap fixedSp = ss->getSpectrum(inThIndex, inPhIndex, i2, i3);
                 fixedSp /= maxReflectance;
             }}
         }
@@ -306,7 +306,7 @@ void lb::fixEnergyConservation(SpecularCoordinatesBrdf* brdf,
         if (maxReflectance > 1.0f) {
             for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
             for (int i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
-                Spectrum& fixedSp = ss->getSpectrum(inThIndex, inPhIndex, i2, i3);
+                SpectrumMap fixedSp = ss->getSpectrum(inThIndex, inPhIndex, i2, i3);
                 fixedSp /= maxReflectance;
             }}
         }
@@ -328,7 +328,7 @@ void lb::fixEnergyConservation(SpecularCoordinatesBrdf* brdf,
         if (maxReflectance > 1.0f) {
             for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
             for (int i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
-                Spectrum& fixedSp = ss->getSpectrum(inThIndex, inPhIndex, i2, i3);
+                SpectrumMap fixedSp = ss->getSpectrum(inThIndex, inPhIndex, i2, i3);
                 fixedSp *= 1.0f - specRefSp[maxIndex];
             }}
         }
@@ -355,7 +355,7 @@ void lb::fixEnergyConservation(SpecularCoordinatesBrdf* brdf,
         if (maxReflectance > 1.0f) {
             for (int spThIndex = 0; spThIndex < brdf->getNumSpecTheta(); ++spThIndex) {
             for (int spPhIndex = 0; spPhIndex < brdf->getNumSpecPhi();   ++spPhIndex) {
-                Spectrum& fixedSp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
+                SpectrumMap fixedSp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
                 fixedSp /= maxReflectance;
             }}
         }
@@ -372,7 +372,7 @@ void lb::fixEnergyConservation(SpecularCoordinatesBrdf* brdf,
         if (maxReflectance > 1.0f) {
             for (int spThIndex = 0; spThIndex < btdf->getNumSpecTheta(); ++spThIndex) {
             for (int spPhIndex = 0; spPhIndex < btdf->getNumSpecPhi();   ++spPhIndex) {
-                Spectrum& fixedSp = btdf->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
+                SpectrumMap fixedSp = btdf->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
                 fixedSp /= maxReflectance;
             }}
         }
@@ -538,8 +538,8 @@ void lb::equalizeOverlappingSamples(SpecularCoordinatesBrdf* brdf)
             for (int inThIndex = 0; inThIndex < brdf->getNumInTheta();   ++inThIndex) {
             for (int spThIndex = 0; spThIndex < brdf->getNumSpecTheta(); ++spThIndex) {
             for (int spPhIndex = 0; spPhIndex < brdf->getNumSpecPhi();   ++spPhIndex) {
-                const Spectrum& minSp = brdf->getSpectrum(inThIndex, minInPhiIndex, spThIndex, spPhIndex);
-                const Spectrum& maxSp = brdf->getSpectrum(inThIndex, maxInPhiIndex, spThIndex, spPhIndex);
+                const SpectrumMap minSp = brdf->getSpectrum(inThIndex, minInPhiIndex, spThIndex, spPhIndex);
+                const SpectrumMap maxSp = brdf->getSpectrum(inThIndex, maxInPhiIndex, spThIndex, spPhIndex);
                 Spectrum sp = (minSp + maxSp) / 2.0;
 
                 brdf->setSpectrum(inThIndex, minInPhiIndex, spThIndex, spPhIndex, sp);
@@ -589,8 +589,8 @@ void lb::equalizeOverlappingSamples(SpecularCoordinatesBrdf* brdf)
             for (int inThIndex = 0; inThIndex < brdf->getNumInTheta();   ++inThIndex) {
             for (int inPhIndex = 0; inPhIndex < brdf->getNumInPhi();     ++inPhIndex) {
             for (int spThIndex = 0; spThIndex < brdf->getNumSpecTheta(); ++spThIndex) {
-                const Spectrum& minSp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, minSpPhiIndex);
-                const Spectrum& maxSp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, maxSpPhiIndex);
+                const SpectrumMap minSp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, minSpPhiIndex);
+                const SpectrumMap maxSp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, maxSpPhiIndex);
                 Spectrum sp = (minSp + maxSp) / 2.0;
 
                 brdf->setSpectrum(inThIndex, inPhIndex, spThIndex, minSpPhiIndex, sp);
@@ -883,7 +883,7 @@ void lb::copySpectraFromPhiOf0To360(SampleSet* samples)
         for (int i0 = 0; i0 < samples->getNumAngles0(); ++i0) {
         for (int i2 = 0; i2 < samples->getNumAngles2(); ++i2) {
         for (int i3 = 0; i3 < samples->getNumAngles3(); ++i3) {
-            const Spectrum& sp = samples->getSpectrum(i0, 0, i2, i3);
+            const SpectrumMap sp = samples->getSpectrum(i0, 0, i2, i3);
             samples->setSpectrum(i0, samples->getNumAngles1() - 1, i2, i3, sp);
         }}}
     }
@@ -894,7 +894,7 @@ void lb::copySpectraFromPhiOf0To360(SampleSet* samples)
         for (int i0 = 0; i0 < samples->getNumAngles0(); ++i0) {
         for (int i1 = 0; i1 < samples->getNumAngles1(); ++i1) {
         for (int i2 = 0; i2 < samples->getNumAngles2(); ++i2) {
-            const Spectrum& sp = samples->getSpectrum(i0, i1, i2, 0);
+            const SpectrumMap sp = samples->getSpectrum(i0, i1, i2, 0);
             samples->setSpectrum(i0, i1, i2, samples->getNumAngles3() - 1, sp);
         }}}
     }
@@ -918,7 +918,7 @@ bool lb::fillSpectraAtInThetaOf90(Brdf* brdf, Spectrum::Scalar value)
     for (int i1 = 0; i1 < ss->getNumAngles1(); ++i1) {
     for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
     for (int i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
-        Spectrum& sp = ss->getSpectrum(endIndex0, i1, i2, i3);
+        SpectrumMap sp = ss->getSpectrum(endIndex0, i1, i2, i3);
         sp.fill(value);
     }}}
 
@@ -937,7 +937,7 @@ void lb::xyzToSrgb(SampleSet* samples)
     for (int i1 = 0; i1 < samples->getNumAngles1(); ++i1) {
     for (int i2 = 0; i2 < samples->getNumAngles2(); ++i2) {
     for (int i3 = 0; i3 < samples->getNumAngles3(); ++i3) {
-        const Spectrum& xyz = samples->getSpectrum(i0, i1, i2, i3);
+        const SpectrumMap xyz = samples->getSpectrum(i0, i1, i2, i3);
         Spectrum rgb = xyzToSrgb<Vec3f>(xyz);
         samples->setSpectrum(i0, i1, i2, i3, rgb);
     }}}}
@@ -957,6 +957,11 @@ void lb::fillSpectra(SpectrumList& spectra, Spectrum::Scalar value)
     }
 }
 
+void lb::fillSpectra(SpectrumArray& spectra, Spectrum::Scalar value)
+{
+    spectra.fill(value);
+}
+
 bool lb::compute(const Brdf& src0, const Brdf& src1, Brdf* dest,
                  std::function<Spectrum(const Spectrum&, const Spectrum&)> manipulator)
 {
@@ -991,9 +996,7 @@ bool lb::subtract(const Brdf& src0, const Brdf& src1, Brdf* dest)
 
 void lb::multiplySpectra(SampleSet* samples, Spectrum::Scalar value)
 {
-    for (auto& sp : samples->getSpectra()) {
-        sp *= value;
-    }
+    samples->getSpectra() *= value;
 }
 
 void lb::fixNegativeSpectra(Brdf* brdf)
@@ -1009,7 +1012,7 @@ void lb::fixNegativeSpectra(Brdf* brdf)
 
         if (isDownwardDir(outDir)) continue;
 
-        Spectrum& sp = ss->getSpectrum(i0, i1, i2, i3);
+        SpectrumMap sp = ss->getSpectrum(i0, i1, i2, i3);
         sp = sp.cwiseMax(0);
     }}}}
 }
@@ -1025,3 +1028,8 @@ void lb::fixNegativeSpectra(SpectrumList& spectra)
         sp = sp.cwiseMax(0);
     }
 }
+
+void lb::fixNegativeSpectra(SpectrumArray& spectra)
+{
+    spectra = spectra.cwiseMax(0);
+}
@@ -54,7 +54,7 @@ bool SampleSet::validate(bool verbose) const
     for (int i2 = 0; i2 < angles2_.size(); ++i2) {
         if (!spectraValid && !verbose) break;
     for (int i3 = 0; i3 < angles3_.size(); ++i3) {
-        const Spectrum& sp = getSpectrum(i0, i1, i2, i3);
+        ConstSpectrumMap sp = getSpectrum(i0, i1, i2, i3);
 
         if (!sp.allFinite()) {
             spectraValid = false;
@@ -167,6 +167,7 @@ bool SampleSet::validate(bool verbose) const
 void SampleSet::updateAngleAttributes()
 {
     updateEqualIntervalAngles();
+    updateBoundsTables();
     updateOneSide();
 }
 
@@ -182,8 +183,8 @@ void SampleSet::resizeAngles(int numAngles0,
     angles2_.resize(numAngles2);
     angles3_.resize(numAngles3);
 
-    size_t numSamples = numAngles0 * numAngles1 * numAngles2 * numAngles3;
-    spectra_.resize(numSamples);
+    size_t numSamples = static_cast<size_t>(numAngles0) * numAngles1 * numAngles2 * numAngles3;
+    spectra_.resize(spectra_.rows(), numSamples);
 }
 
 void SampleSet::resizeWavelengths(int numWavelengths)
@@ -191,10 +192,7 @@ void SampleSet::resizeWavelengths(int numWavelengths)
     assert(numWavelengths > 0);
 
     size_t numSamples = angles0_.size() * angles1_.size() * angles2_.size() * angles3_.size();
-
-    for (size_t i = 0; i < numSamples; ++i) {
-        spectra_.at(i) = Spectrum::Zero(numWavelengths);
-    }
+    spectra_ = SpectrumArray::Zero(numWavelengths, numSamples);
 
     wavelengths_.resize(numWavelengths);
 }
@@ -212,6 +210,14 @@ void SampleSet::updateEqualIntervalAngles()
     lbInfo << "[SampleSet::updateEqualIntervalAngles] Angle3: " << equalIntervalAngles3_;
 }
 
+void SampleSet::updateBoundsTables()
+{
+    boundsTable0_.build(angles0_);
+    boundsTable1_.build(angles1_);
+    boundsTable2_.build(angles2_);
+    boundsTable3_.build(angles3_);
+}
+
 bool SampleSet::distinguishOneSide() const
 {
     bool containing_0_PI = false;
@@ -16,6 +16,8 @@ void SpecularCoordinatesRandomSampleSet::setupBrdf(SpecularCoordinatesBrdf* brdf
                                                    float                    weight2,
                                                    float                    weight3)
 {
+    updateIndex<SpecularCoordinateSystem>();
+
     for (int inThIndex = 0; inThIndex < brdf->getNumInTheta();   ++inThIndex) {
     for (int inPhIndex = 0; inPhIndex < brdf->getNumInPhi();     ++inPhIndex) {
     for (int spThIndex = 0; spThIndex < brdf->getNumSpecTheta(); ++spThIndex) {
@@ -28,27 +30,26 @@ void SpecularCoordinatesRandomSampleSet::setupBrdf(SpecularCoordinatesBrdf* brdf
             coeff3 = 1.0f;
         }
 
-        RandomSampleSet::AngleList angles;
-        SampleMap::iterator it;
+        AngleList angles;
+        int index;
         float w3;
-        Spectrum sp;
-        #pragma omp parallel for private(angles, it, w3, sp)
+        #pragma omp parallel for private(angles, index, w3)
         for (int spPhIndex = 0; spPhIndex < brdf->getNumSpecPhi(); ++spPhIndex) {
-            angles.resize(4);
-            angles.at(0) = brdf->getInTheta(inThIndex);
-            angles.at(1) = brdf->getInPhi(inPhIndex);
-            angles.at(2) = brdf->getSpecTheta(spThIndex);
-            angles.at(3) = brdf->getSpecPhi(spPhIndex);
-
-            it = sampleMap_.find(angles);
-            if (it != sampleMap_.end()) {
-                brdf->setSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex, it->second);
+            angles[0] = brdf->getInTheta(inThIndex);
+            angles[1] = brdf->getInPhi(inPhIndex);
+            angles[2] = brdf->getSpecTheta(spThIndex);
+            angles[3] = brdf->getSpecPhi(spPhIndex);
+
+            SpectrumMap sp = brdf->getSampleSet()->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
+
+            index = sampleMap_.find(angles);
+            if (index != -1) {
+                sp = sampleMap_.getSpectrum(index);
             }
             else {
                 // Modify a weight coefficient for specular azimuthal angles.
                 w3 = hermiteInterpolation3(0.0f, weight3, coeff3);
                 sp = estimateSpectrum<SpecularCoordinateSystem>(angles, weight0, weight1, weight2, w3);
-                brdf->setSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex, sp);
             }
         }
     }}}
@@ -12,29 +12,29 @@ using namespace lb;
 
 void SphericalCoordinatesRandomSampleSet::setupBrdf(SphericalCoordinatesBrdf* brdf)
 {
+    updateIndex();
+
     for (int inThIndex = 0;  inThIndex < brdf->getNumInTheta();   ++inThIndex)  {
     for (int inPhIndex = 0;  inPhIndex < brdf->getNumInPhi();     ++inPhIndex)  {
     for (int outThIndex = 0; outThIndex < brdf->getNumOutTheta(); ++outThIndex) {
-        RandomSampleSet::AngleList angles;
-        SampleMap::iterator it;
-        #pragma omp parallel for private(angles, it)
+        AngleList angles;
+        int index;
+        #pragma omp parallel for private(angles, index)
         for (int outPhIndex = 0; outPhIndex < brdf->getNumOutPhi(); ++outPhIndex) {
-            angles.resize(4);
-            angles.at(0) = brdf->getInTheta(inThIndex);
-            angles.at(1) = brdf->getInPhi(inPhIndex);
-            angles.at(2) = brdf->getOutTheta(outThIndex);
-            angles.at(3) = brdf->getOutPhi(outPhIndex);
+            angles[0] = brdf->getInTheta(inThIndex);
+            angles[1] = brdf->getInPhi(inPhIndex);
+            angles[2] = brdf->getOutTheta(outThIndex);
+            angles[3] = brdf->getOutPhi(outPhIndex);
+
+            SpectrumMap sp = brdf->getSampleSet()->getSpectrum(inThIndex, inPhIndex, outThIndex, outPhIndex);
 
-            it = sampleMap_.find(angles);
-            if (it != sampleMap_.end()) {
-                brdf->setSpectrum(inThIndex, inPhIndex, outThIndex, outPhIndex,
-                                  it->second);
+            index = sampleMap_.find(angles);
+            if (index != -1) {
+                sp = sampleMap_.getSpectrum(index);
             }
             else {
-                brdf->setSpectrum(inThIndex, inPhIndex, outThIndex, outPhIndex,
-                                  findSpectrumOfNearestSample(angles, false));
-                //brdf->setSpectrum(inThIndex, inPhIndex, outThIndex, outPhIndex,
-                //                  estimateSpectrum<CoordSysT>(angles));
+                sp = findSpectrumOfNearestSample(angles, false);
+                //sp = estimateSpectrum<CoordSysT>(angles);
             }
         }
     }}}
@@ -8,6 +8,7 @@
 
 #include <libbsdf/Common/Array.h>
 
+#include <libbsdf/Common/BoundsTable.h>
 #include <libbsdf/Common/Utility.h>
 
 using namespace lb;
@@ -46,3 +47,25 @@ void lb::findBounds(const Arrayf&   values,
     *lowerValue = values[*lowerIndex];
     *upperValue = values[*upperIndex];
 }
+
+void lb::findBounds(const Arrayf&       values,
+                    float               value,
+                    bool                equalIntervalValues,
+                    const BoundsTable&  table,
+                    int*                lowerIndex,
+                    int*                upperIndex,
+                    float*              lowerValue,
+                    float*              upperValue)
+{
+    if (equalIntervalValues || table.isEmpty() || values.size() == 1) {
+        findBounds(values, value, equalIntervalValues, lowerIndex, upperIndex, lowerValue, upperValue);
+        return;
+    }
+
+    int backIndex = static_cast<int>(values.size() - 1);
+    *upperIndex = clamp(table.findLowerBound(values, value), 1, backIndex);
+    *lowerIndex = *upperIndex - 1;
+
+    *lowerValue = values[*lowerIndex];
+    *upperValue = values[*upperIndex];
+}
@@ -0,0 +1,46 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Common/BoundsTable.h>
+
+using namespace lb;
+
+void BoundsTable::build(const Arrayf& values)
+{
+    clear();
+
+    int size = static_cast<int>(values.size());
+    if (size < 2) return;
+
+    float range = values[size - 1] - values[0];
+    if (!(range > 0.0f)) return;
+
+    // Several buckets per interval keep scans short for strongly non-uniform arrays.
+    int numBuckets = size * 4;
+
+    minValue_ = values[0];
+    bucketScale_ = numBuckets / range;
+    startIndices_.resize(numBuckets);
+
+    int index = 0;
+    for (int i = 0; i < numBuckets; ++i) {
+        float bucketStart = minValue_ + i / bucketScale_;
+        while (index < size && values[index] < bucketStart) {
+            ++index;
+        }
+
+        startIndices_[i] = index;
+    }
+}
+
+void BoundsTable::clear()
+{
+    minValue_ = 0.0f;
+    bucketScale_ = 0.0f;
+    startIndices_.clear();
+}
@@ -11,3 +11,5 @@
 using namespace lb;
 
 Log::Level Log::notificationLevel_ = Level::TRACE_MSG;
+
+std::mutex Log::mutex_;
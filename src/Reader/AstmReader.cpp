@@ -29,94 +29,9 @@ SphericalCoordinatesBrdf* AstmReader::read(const std::string& fileName)
 
     std::ios_base::sync_with_stdio(false);
 
-    ColorModel colorModel = SPECTRAL_MODEL;
+    ColorModel colorModel;
     std::vector<float> wavelengths;
-
-    // Read a header.
-    std::string headStr;
-    while (ifs >> headStr) {
-        if (headStr.empty()) {
-            continue;
-        }
-        else if (headStr == "NUM_POINTS") {
-            int numPoints;
-            ifs >> numPoints;
-            lbInfo << "[AstmReader::read] NUM_POINTS: " << numPoints;
-        }
-        else if (headStr == "VARS") {
-            ifs.ignore(1);
-
-            std::string varStr;
-            std::getline(ifs, varStr);
-            std::stringstream stream(varStr);
-            std::string token;
-            std::vector<std::string> varNames;
-            while (getline(stream, token, ',')) {
-                if (token.at(token.size() - 1) == '\r') {
-                    token.erase(token.size() - 1);
-                }
-
-                varNames.push_back(token);
-            }
-
-            // Read the names of color components.
-            if (varNames.size() < 5) {
-                // No color components.
-                return 0;
-            }
-            else if (varNames.size() == 7 &&
-                     varNames.at(4) == "R" &&
-                     varNames.at(5) == "G" &&
-                     varNames.at(6) == "B") {
-                wavelengths.push_back(0.0f);
-                wavelengths.push_back(0.0f);
-                wavelengths.push_back(0.0f);
-                colorModel = RGB_MODEL;
-            }
-            else if (varNames.size() == 7 &&
-                     varNames.at(4) == "X" &&
-                     varNames.at(5) == "Y" &&
-                     varNames.at(6) == "Z") {
-                wavelengths.push_back(0.0f);
-                wavelengths.push_back(0.0f);
-                wavelengths.push_back(0.0f);
-                colorModel = XYZ_MODEL;
-            }
-            else {
-                for (int i = 4; i < static_cast<int>(varNames.size()); ++i) {
-                    std::string name = varNames.at(i);
-                    bool spectral = (name.size() >= 3 &&
-                                     name.substr(name.size() - 2, 2) == "nm");
-                    if (spectral) {
-                        std::stringstream nameStream(name.substr(0, name.size() - 2));
-                        float wl;
-                        nameStream >> wl;
-
-                        if (nameStream.fail()) {
-                            wavelengths.push_back(0.0f);
-                        }
-                        else {
-                            wavelengths.push_back(wl);
-                        }
-                    }
-                    else {
-                        wavelengths.push_back(0.0f);
-                    }
-                }
-            }
-
-            break;
-        }
-    }
-
-    if (colorModel == SPECTRAL_MODEL) {
-        if (wavelengths.size() == 1 && wavelengths.at(0) == 0.0f) {
-            colorModel = MONOCHROMATIC_MODEL;
-        }
-        else if (wavelengths.size() == 3 && wavelengths.at(0) == 0.0f) {
-            colorModel = RGB_MODEL;
-        }
-    }
+    if (!readHeader(ifs, &colorModel, &wavelengths)) return 0;
 
     std::set<float> inThetaAngles;
     std::set<float> inPhiAngles;
@@ -125,13 +40,14 @@ SphericalCoordinatesBrdf* AstmReader::read(const std::string& fileName)
 
     SphericalCoordinatesRandomSampleSet rss;
     SphericalCoordinatesRandomSampleSet::SampleMap& samples = rss.getSampleMap();
+    samples.setNumWavelengths(static_cast<int>(wavelengths.size()));
 
     // Read data.
     std::string dataStr;
     while (std::getline(ifs, dataStr)) {
         if (dataStr.empty() || dataStr.at(0) == '\r') continue;
 
-        SphericalCoordinatesRandomSampleSet::AngleList angles;
+        SphericalCoordinatesRandomSampleSet::AngleList angles = {{ 0.0f, 0.0f, 0.0f, 0.0f }};
         Spectrum values(wavelengths.size());
 
         std::stringstream stream(dataStr);
@@ -150,7 +66,7 @@ SphericalCoordinatesBrdf* AstmReader::read(const std::string& fileName)
                 }
 
                 val = std::min(val, SphericalCoordinateSystem::MAX_ANGLE3);
-                angles.push_back(val);
+                angles.at(count) = val;
             }
             else {
                 values[count - 4] = std::max(val, 0.0f);
@@ -164,21 +80,20 @@ SphericalCoordinatesBrdf* AstmReader::read(const std::string& fileName)
         outThetaAngles.insert(angles.at(2));
         outPhiAngles.insert(angles.at(3));
 
-        auto it = samples.find(angles);
-        if (it != samples.end()) {
+        if (samples.contains(angles)) {
             lbWarn
                 << "[AstmReader::read] Already defined: "
                 << angles.at(0) << ", " << angles.at(1) << ", " << angles.at(2) << ", " << angles.at(3);
             continue;
         }
 
-        samples[angles] = values;
+        samples.insert(angles, values);
     }
 
     // Modify data for the isotropic BRDF with the incoming azimuthal angle of non-zero radian.
     if (inPhiAngles.size() == 1 && *inPhiAngles.begin() != 0.0f) {
         // Rotate outgoing azimuthal angles using the incoming azimuthal angle.
-        SphericalCoordinatesRandomSampleSet::AngleList rotatedAngles;
+        std::vector<float> rotatedAngles;
         for (auto it = outPhiAngles.begin(); it != outPhiAngles.end(); ++it) {
             float outPhi = *it - *inPhiAngles.begin();
             if (outPhi < 0.0f) {
@@ -191,9 +106,10 @@ SphericalCoordinatesBrdf* AstmReader::read(const std::string& fileName)
         std::copy(rotatedAngles.begin(), rotatedAngles.end(), std::inserter(outPhiAngles, outPhiAngles.begin()));
 
         // Rotate sample points using the incoming azimuthal angle.
-        SphericalCoordinatesRandomSampleSet::SampleMap modifiedSamples;
-        for (auto it = samples.begin(); it != samples.end(); ++it) {
-            SphericalCoordinatesRandomSampleSet::AngleList angles = it->first;
+        SphericalCoordinatesRandomSampleSet::SampleMap modifiedSamples(samples.getNumWavelengths());
+        modifiedSamples.reserve(samples.size());
+        for (int i = 0; i < samples.size(); ++i) {
+            SphericalCoordinatesRandomSampleSet::AngleList angles = samples.getAngles(i);
             float outPhi = angles.at(3) - *inPhiAngles.begin();
             if (outPhi < 0.0f) {
                 outPhi += TAU_F;
@@ -201,10 +117,9 @@ SphericalCoordinatesBrdf* AstmReader::read(const std::string& fileName)
             angles.at(1) = 0.0f;
             angles.at(3) = outPhi;
 
-            modifiedSamples[angles] = it->second;
+            modifiedSamples.insert(angles, samples.getSpectrum(i));
         }
-        samples.clear();
-        std::copy(modifiedSamples.begin(), modifiedSamples.end(), std::inserter(samples, samples.begin()));
+        samples = modifiedSamples;
 
         inPhiAngles.clear();
         inPhiAngles.insert(0.0f);
@@ -249,3 +164,123 @@ SphericalCoordinatesBrdf* AstmReader::read(const std::string& fileName)
 
     return brdf;
 }
+
+bool AstmReader::readInfo(const std::string& fileName, FileInfo* info)
+{
+    // std::ios_base::binary is used to read line endings of CR+LF and LF.
+    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
+    if (ifs.fail()) {
+        lbError << "[AstmReader::readInfo] Could not open: " << fileName;
+        return false;
+    }
+
+    ColorModel colorModel;
+    std::vector<float> wavelengths;
+    if (!readHeader(ifs, &colorModel, &wavelengths)) return false;
+
+    *info = FileInfo();
+    info->sourceType = MEASURED_SOURCE;
+    info->coordinateSystem = SPHERICAL_COORDINATE_SYSTEM;
+    info->colorModel = colorModel;
+    info->numWavelengths = static_cast<int>(wavelengths.size());
+
+    info->wavelengths.resize(wavelengths.size());
+    copyArray(wavelengths, &info->wavelengths);
+
+    return true;
+}
+
+bool AstmReader::readHeader(std::istream&       stream,
+                            ColorModel*         colorModel,
+                            std::vector<float>* wavelengths)
+{
+    *colorModel = SPECTRAL_MODEL;
+
+    // Read a header.
+    std::string headStr;
+    while (stream >> headStr) {
+        if (headStr.empty()) {
+            continue;
+        }
+        else if (headStr == "NUM_POINTS") {
+            int numPoints;
+            stream >> numPoints;
+            lbInfo << "[AstmReader::readHeader] NUM_POINTS: " << numPoints;
+        }
+        else if (headStr == "VARS") {
+            stream.ignore(1);
+
+            std::string varStr;
+            std::getline(stream, varStr);
+            std::stringstream varStream(varStr);
+            std::string token;
+            std::vector<std::string> varNames;
+            while (getline(varStream, token, ',')) {
+                if (token.at(token.size() - 1) == '\r') {
+                    token.erase(token.size() - 1);
+                }
+
+                varNames.push_back(token);
+            }
+
+            // Read the names of color components.
+            if (varNames.size() < 5) {
+                // No color components.
+                return false;
+            }
+            else if (varNames.size() == 7 &&
+                     varNames.at(4) == "R" &&
+                     varNames.at(5) == "G" &&
+                     varNames.at(6) == "B") {
+                wavelengths->push_back(0.0f);
+                wavelengths->push_back(0.0f);
+                wavelengths->push_back(0.0f);
+                *colorModel = RGB_MODEL;
+            }
+            else if (varNames.size() == 7 &&
+                     varNames.at(4) == "X" &&
+                     varNames.at(5) == "Y" &&
+                     varNames.at(6) == "Z") {
+                wavelengths->push_back(0.0f);
+                wavelengths->push_back(0.0f);
+                wavelengths->push_back(0.0f);
+                *colorModel = XYZ_MODEL;
+            }
+            else {
+                for (int i = 4; i < static_cast<int>(varNames.size()); ++i) {
+                    std::string name = varNames.at(i);
+                    bool spectral = (name.size() >= 3 &&
+                                     name.substr(name.size() - 2, 2) == "nm");
+                    if (spectral) {
+                        std::stringstream nameStream(name.substr(0, name.size() - 2));
+                        float wl;
+                        nameStream >> wl;
+
+                        if (nameStream.fail()) {
+                            wavelengths->push_back(0.0f);
+                        }
+                        else {
+                            wavelengths->push_back(wl);
+                        }
+                    }
+                    else {
+                        wavelengths->push_back(0.0f);
+                    }
+                }
+            }
+
+            break;
+        }
+    }
+
+    if (*colorModel == SPECTRAL_MODEL) {
+        if (wavelengths->size() == 1 && wavelengths->at(0) == 0.0f) {
+            *colorModel = MONOCHROMATIC_MODEL;
+        }
+        else if (wavelengths->size() == 3 && wavelengths->at(0) == 0.0f) {
+            *colorModel = RGB_MODEL;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,354 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Reader/BinaryReader.h>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <libbsdf/Brdf/HalfDifferenceCoordinatesBrdf.h>
+#include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
+#include <libbsdf/Brdf/SphericalCoordinatesBrdf.h>
+
+using namespace lb;
+using namespace lb::binary_utility;
+
+namespace {
+
+/*! Copies floats from a buffer to an array and advances the position of the buffer. */
+void copyFromBuffer(const char** position, Arrayf* array)
+{
+    size_t size = sizeof(float) * array->size();
+    std::memcpy(array->data(), *position, size);
+    *position += size;
+}
+
+} // namespace
+
+Brdf* BinaryReader::read(const std::string& fileName, DataType* dataType)
+{
+    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
+    if (ifs.fail()) {
+        lbError << "[BinaryReader::read] Could not open: " << fileName;
+        return 0;
+    }
+
+    Header header;
+    if (!readHeader(ifs, &header)) {
+        lbError << "[BinaryReader::read] Invalid header: " << fileName;
+        return 0;
+    }
+
+    ifs.seekg(0, std::ios_base::end);
+    uint64_t fileSize = static_cast<uint64_t>(ifs.tellg());
+    ifs.seekg(sizeof(Header), std::ios_base::beg);
+
+    // Validate the size of spectra before allocation.
+    double numValues = static_cast<double>(header.numAngles[0]) * header.numAngles[1]
+                     * header.numAngles[2] * header.numAngles[3] * header.numWavelengths;
+    uint64_t numChunks = static_cast<uint64_t>(header.numAngles[0]) * header.numAngles[1];
+
+    bool spectraSizeValid;
+    switch (header.encoding) {
+        case RAW_ENCODING:
+            spectraSizeValid = (numValues * sizeof(float) == static_cast<double>(header.spectraSize));
+            break;
+        case PREDICTIVE_ENCODING:
+            spectraSizeValid = (header.spectraSize >= sizeof(uint64_t) * numChunks);
+            break;
+        default:
+            lbError << "[BinaryReader::read] Unsupported encoding: " << header.encoding;
+            return 0;
+    }
+
+    if (!spectraSizeValid ||
+        header.spectraOffset > fileSize ||
+        header.spectraSize > fileSize - header.spectraOffset) {
+        lbError << "[BinaryReader::read] The size of spectra is not matched: " << header.spectraSize;
+        return 0;
+    }
+
+    // Read the metadata and padding.
+    uint64_t numFloats = static_cast<uint64_t>(header.numAngles[0]) + header.numAngles[1]
+                       + header.numAngles[2] + header.numAngles[3]
+                       + header.numWavelengths + header.numSpecularOffsets;
+    uint64_t metadataEnd = sizeof(Header) + sizeof(float) * numFloats + header.nameSize;
+    if (header.spectraOffset < metadataEnd ||
+        header.spectraOffset - metadataEnd >= SPECTRA_ALIGNMENT) {
+        lbError << "[BinaryReader::read] Invalid offset of spectra: " << header.spectraOffset;
+        return 0;
+    }
+
+    std::vector<char> metadata(static_cast<size_t>(header.spectraOffset - sizeof(Header)));
+    ifs.read(metadata.data(), metadata.size());
+
+    Header zeroChecksumHeader = header;
+    zeroChecksumHeader.checksum = 0;
+    uint64_t checksum = computeChecksum(&zeroChecksumHeader, sizeof(zeroChecksumHeader));
+    checksum = computeChecksum(metadata.data(), metadata.size(), checksum);
+
+    // Encoded spectra are verified before the sample set is allocated with the sizes in the header.
+    std::vector<char> encodedSpectra;
+    if (header.encoding == PREDICTIVE_ENCODING) {
+        encodedSpectra.resize(static_cast<size_t>(header.spectraSize));
+        ifs.read(encodedSpectra.data(), static_cast<std::streamsize>(header.spectraSize));
+
+        if (ifs.fail()) {
+            lbError << "[BinaryReader::read] Unexpected end of file: " << fileName;
+            return 0;
+        }
+
+        checksum = computeChecksum(encodedSpectra.data(), encodedSpectra.size(), checksum);
+        if (checksum != header.checksum) {
+            lbError << "[BinaryReader::read] Checksum mismatch: " << fileName;
+            return 0;
+        }
+    }
+
+    std::unique_ptr<Brdf> brdf(createBrdf(header));
+    if (!brdf) {
+        lbError << "[BinaryReader::read] Unsupported coordinate system: " << header.coordinateSystem;
+        return 0;
+    }
+
+    SampleSet* ss = brdf->getSampleSet();
+
+    if (header.encoding == RAW_ENCODING) {
+        // Raw spectra are read into the sample set at once. The size is equal to the payload.
+        char* spectra = reinterpret_cast<char*>(ss->getSpectra().data());
+        ifs.read(spectra, static_cast<std::streamsize>(header.spectraSize));
+
+        if (ifs.fail()) {
+            lbError << "[BinaryReader::read] Unexpected end of file: " << fileName;
+            return 0;
+        }
+
+        checksum = computeChecksum(spectra, static_cast<size_t>(header.spectraSize), checksum);
+        if (checksum != header.checksum) {
+            lbError << "[BinaryReader::read] Checksum mismatch: " << fileName;
+            return 0;
+        }
+    }
+    else if (!decodeSpectra(encodedSpectra, ss)) {
+        lbError << "[BinaryReader::read] Failed to decode spectra: " << fileName;
+        return 0;
+    }
+
+    const char* position = metadata.data();
+    copyFromBuffer(&position, &ss->getAngles0());
+    copyFromBuffer(&position, &ss->getAngles1());
+    copyFromBuffer(&position, &ss->getAngles2());
+    copyFromBuffer(&position, &ss->getAngles3());
+    copyFromBuffer(&position, &ss->getWavelengths());
+
+    if (auto specBrdf = dynamic_cast<SpecularCoordinatesBrdf*>(brdf.get())) {
+        specBrdf->getSpecularOffsets().resize(header.numSpecularOffsets);
+        copyFromBuffer(&position, &specBrdf->getSpecularOffsets());
+    }
+
+    brdf->setName(std::string(position, position + header.nameSize));
+    brdf->setSourceType(static_cast<SourceType>(header.sourceType));
+
+    ss->updateAngleAttributes();
+
+    if (dataType) {
+        *dataType = static_cast<DataType>(header.dataType);
+    }
+
+    return brdf.release();
+}
+
+bool BinaryReader::readInfo(const std::string& fileName, FileInfo* info)
+{
+    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
+    if (ifs.fail()) {
+        lbError << "[BinaryReader::readInfo] Could not open: " << fileName;
+        return false;
+    }
+
+    Header header;
+    if (!readHeader(ifs, &header)) {
+        lbError << "[BinaryReader::readInfo] Invalid header: " << fileName;
+        return false;
+    }
+
+    ifs.seekg(0, std::ios_base::end);
+    uint64_t fileSize = static_cast<uint64_t>(ifs.tellg());
+    ifs.seekg(sizeof(Header), std::ios_base::beg);
+
+    // Validate the size of metadata before allocation.
+    uint64_t numFloats = static_cast<uint64_t>(header.numAngles[0]) + header.numAngles[1]
+                       + header.numAngles[2] + header.numAngles[3]
+                       + header.numWavelengths + header.numSpecularOffsets;
+    if (sizeof(Header) + sizeof(float) * numFloats > header.spectraOffset ||
+        header.spectraOffset > fileSize) {
+        lbError << "[BinaryReader::readInfo] Invalid offset of spectra: " << header.spectraOffset;
+        return false;
+    }
+
+    *info = FileInfo();
+    info->dataType = static_cast<DataType>(header.dataType);
+    info->sourceType = static_cast<SourceType>(header.sourceType);
+    info->coordinateSystem = static_cast<CoordinateSystemType>(header.coordinateSystem);
+    info->colorModel = static_cast<ColorModel>(header.colorModel);
+    info->numWavelengths = header.numWavelengths;
+
+    info->angles0.resize(header.numAngles[0]);
+    info->angles1.resize(header.numAngles[1]);
+    info->angles2.resize(header.numAngles[2]);
+    info->angles3.resize(header.numAngles[3]);
+    info->wavelengths.resize(header.numWavelengths);
+    info->specularOffsets.resize(header.numSpecularOffsets);
+
+    // The metadata follows the header. Spectra are not read.
+    ifs.read(reinterpret_cast<char*>(info->angles0.data()),         sizeof(float) * info->angles0.size());
+    ifs.read(reinterpret_cast<char*>(info->angles1.data()),         sizeof(float) * info->angles1.size());
+    ifs.read(reinterpret_cast<char*>(info->angles2.data()),         sizeof(float) * info->angles2.size());
+    ifs.read(reinterpret_cast<char*>(info->angles3.data()),         sizeof(float) * info->angles3.size());
+    ifs.read(reinterpret_cast<char*>(info->wavelengths.data()),     sizeof(float) * info->wavelengths.size());
+    ifs.read(reinterpret_cast<char*>(info->specularOffsets.data()), sizeof(float) * info->specularOffsets.size());
+
+    if (ifs.fail()) {
+        lbError << "[BinaryReader::readInfo] Unexpected end of file: " << fileName;
+        return false;
+    }
+
+    return true;
+}
+
+bool BinaryReader::readHeader(std::istream& stream, Header* header)
+{
+    stream.read(reinterpret_cast<char*>(header), sizeof(Header));
+    if (stream.fail()) return false;
+
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        lbError << "[BinaryReader::readHeader] Invalid signature.";
+        return false;
+    }
+
+    if (header->byteOrder != BYTE_ORDER_MARK) {
+        lbError << "[BinaryReader::readHeader] Unsupported byte order.";
+        return false;
+    }
+
+    if (header->version > VERSION) {
+        lbError << "[BinaryReader::readHeader] Unsupported version: " << header->version;
+        return false;
+    }
+
+    if (header->coordinateSystem < SPHERICAL_COORDINATE_SYSTEM ||
+        header->coordinateSystem > HALF_DIFFERENCE_COORDINATE_SYSTEM) {
+        lbError << "[BinaryReader::readHeader] Unsupported coordinate system: " << header->coordinateSystem;
+        return false;
+    }
+
+    if (header->colorModel < MONOCHROMATIC_MODEL || header->colorModel > SPECTRAL_MODEL) {
+        lbError << "[BinaryReader::readHeader] Unsupported color model: " << header->colorModel;
+        return false;
+    }
+
+    if (header->sourceType > GENERATED_SOURCE) {
+        lbError << "[BinaryReader::readHeader] Unsupported source type: " << header->sourceType;
+        return false;
+    }
+
+    if (header->dataType > SPECULAR_TRANSMITTANCE_DATA) {
+        lbError << "[BinaryReader::readHeader] Unsupported data type: " << header->dataType;
+        return false;
+    }
+
+    bool numAnglesValid = (header->numAngles[0] > 0 && header->numAngles[1] > 0 &&
+                           header->numAngles[2] > 0 && header->numAngles[3] > 0);
+    if (!numAnglesValid || header->numWavelengths <= 0 || header->numSpecularOffsets < 0) {
+        lbError << "[BinaryReader::readHeader] Invalid number of angles or wavelengths.";
+        return false;
+    }
+
+    // lb::SampleSet fixes the number of wavelengths except for lb::SPECTRAL_MODEL.
+    if ((header->colorModel == MONOCHROMATIC_MODEL && header->numWavelengths != 1) ||
+        ((header->colorModel == RGB_MODEL || header->colorModel == XYZ_MODEL) && header->numWavelengths != 3)) {
+        lbError << "[BinaryReader::readHeader] The number of wavelengths is not matched with the color model: "
+                << header->numWavelengths;
+        return false;
+    }
+
+    // The numbers of samples and values of lb::SampleSet are int.
+    const uint64_t maxNumValues = static_cast<uint64_t>(std::numeric_limits<int>::max());
+    uint64_t numValues = header->numWavelengths;
+    for (int i = 0; i < 4; ++i) {
+        numValues *= static_cast<uint64_t>(header->numAngles[i]);
+        if (numValues > maxNumValues) {
+            lbError << "[BinaryReader::readHeader] Too many samples.";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BinaryReader::decodeSpectra(const std::vector<char>& data, SampleSet* samples)
+{
+    const int numAngles0 = samples->getNumAngles0();
+    const int numChunks = numAngles0 * samples->getNumAngles1();
+
+    // Compute the offsets of chunks from the table of sizes.
+    std::vector<uint64_t> offsets(numChunks + 1);
+    offsets[0] = sizeof(uint64_t) * numChunks;
+    for (int i = 0; i < numChunks; ++i) {
+        uint64_t chunkSize;
+        std::memcpy(&chunkSize, data.data() + sizeof(uint64_t) * i, sizeof(chunkSize));
+        if (chunkSize > data.size() - offsets[i]) return false;
+
+        offsets[i + 1] = offsets[i] + chunkSize;
+    }
+
+    // Chunks of incoming directions are decoded independently.
+    int numFailedChunks = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:numFailedChunks)
+    for (int i = 0; i < numChunks; ++i) {
+        const char* chunk = data.data() + offsets[i];
+        size_t chunkSize = static_cast<size_t>(offsets[i + 1] - offsets[i]);
+        if (!binary_utility::decodeSpectra(chunk, chunkSize, i % numAngles0, i / numAngles0, samples)) {
+            ++numFailedChunks;
+        }
+    }
+
+    return (numFailedChunks == 0);
+}
+
+Brdf* BinaryReader::createBrdf(const Header& header)
+{
+    ColorModel colorModel = static_cast<ColorModel>(header.colorModel);
+
+    switch (header.coordinateSystem) {
+        case SPHERICAL_COORDINATE_SYSTEM:
+            if (header.numSpecularOffsets != 0) return 0;
+
+            return new SphericalCoordinatesBrdf(header.numAngles[0], header.numAngles[1],
+                                                header.numAngles[2], header.numAngles[3],
+                                                colorModel, header.numWavelengths);
+        case SPECULAR_COORDINATE_SYSTEM:
+            if (header.numSpecularOffsets != 0 &&
+                header.numSpecularOffsets != header.numAngles[0]) return 0;
+
+            return new SpecularCoordinatesBrdf(header.numAngles[0], header.numAngles[1],
+                                               header.numAngles[2], header.numAngles[3],
+                                               colorModel, header.numWavelengths);
+        case HALF_DIFFERENCE_COORDINATE_SYSTEM:
+            if (header.numSpecularOffsets != 0) return 0;
+
+            return new HalfDifferenceCoordinatesBrdf(header.numAngles[0], header.numAngles[1],
+                                                     header.numAngles[2], header.numAngles[3],
+                                                     colorModel, header.numWavelengths);
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,372 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Reader/BinaryUtility.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <libbsdf/Common/Log.h>
+#include <libbsdf/Common/RangeCoder.h>
+
+using namespace lb;
+
+namespace {
+
+const int NUM_BUCKET_BITS       = 6;    /*!< The number of bits to code a bucket of 0 to 32. */
+const int NUM_BUCKET_CONTEXTS   = 33;   /*!< The number of contexts, which are previous buckets. */
+
+/*! Appends the bytes of an array to a buffer. */
+void appendArray(const Arrayf& array, std::vector<char>* buffer)
+{
+    const char* data = reinterpret_cast<const char*>(array.data());
+    buffer->insert(buffer->end(), data, data + sizeof(float) * array.size());
+}
+
+/*! Maps the bit pattern of a float to an integer in the same order as values. */
+inline uint32_t toOrderedInt(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/*! Inverts toOrderedInt(). */
+inline float fromOrderedInt(uint32_t orderedInt)
+{
+    uint32_t bits = (orderedInt & 0x80000000u) ? (orderedInt & 0x7FFFFFFFu) : ~orderedInt;
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/*! Predicts an integer from neighboring samples in a grid of angle2 and angle3. */
+inline uint32_t predict(const uint32_t* previousRow, const uint32_t* currentRow, int index2, int index3)
+{
+    if (index2 > 0 && index3 > 0) {
+        return currentRow[index2 - 1] + previousRow[index2] - previousRow[index2 - 1];
+    }
+    else if (index2 > 0) {
+        return currentRow[index2 - 1];
+    }
+    else if (index3 > 0) {
+        return previousRow[index2];
+    }
+    else {
+        return 0x80000000u; // zero
+    }
+}
+
+/*! Returns the number of significant bits. */
+inline int countBits(uint32_t value)
+{
+    int numBits = 0;
+    while (value != 0) {
+        value >>= 1;
+        ++numBits;
+    }
+    return numBits;
+}
+
+/*! Writes bits in the order from least significant bit. */
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<char>* data) : data_(data), buffer_(0), numBits_(0) {}
+
+    void write(uint32_t value, int numBits)
+    {
+        buffer_ |= static_cast<uint64_t>(value) << numBits_;
+        numBits_ += numBits;
+
+        while (numBits_ >= 8) {
+            data_->push_back(static_cast<char>(buffer_ & 0xFF));
+            buffer_ >>= 8;
+            numBits_ -= 8;
+        }
+    }
+
+    void finish()
+    {
+        if (numBits_ > 0) {
+            data_->push_back(static_cast<char>(buffer_ & 0xFF));
+        }
+        buffer_ = 0;
+        numBits_ = 0;
+    }
+
+private:
+    std::vector<char>*  data_;
+    uint64_t            buffer_;
+    int                 numBits_;
+};
+
+/*! Reads bits written by BitWriter. Zeros are read beyond the end of data. */
+class BitReader
+{
+public:
+    BitReader(const char* first, const char* last) : position_(first), last_(last), buffer_(0), numBits_(0) {}
+
+    uint32_t read(int numBits)
+    {
+        while (numBits_ < numBits) {
+            uint64_t byte = (position_ != last_) ? static_cast<uint8_t>(*position_++) : 0;
+            buffer_ |= byte << numBits_;
+            numBits_ += 8;
+        }
+
+        uint32_t value = static_cast<uint32_t>(buffer_ & ((uint64_t(1) << numBits) - 1));
+        buffer_ >>= numBits;
+        numBits_ -= numBits;
+        return value;
+    }
+
+private:
+    const char* position_;
+    const char* last_;
+    uint64_t    buffer_;
+    int         numBits_;
+};
+
+const uint64_t CHECKSUM_PRIME0 = 0x9e3779b97f4a7c15ULL;
+const uint64_t CHECKSUM_PRIME1 = 0xff51afd7ed558ccdULL;
+
+/*! Mixes 8-byte words into the state of a checksum. \a size must be a multiple of 8. */
+inline uint64_t mixChecksumWords(const unsigned char* bytes, size_t size, uint64_t h)
+{
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+
+        word *= CHECKSUM_PRIME1;
+        word ^= word >> 32;
+        h = (h ^ word) * CHECKSUM_PRIME0;
+        h ^= h >> 29;
+    }
+
+    return h;
+}
+
+/*! Mixes the remaining bytes of less than 8 bytes and finalizes a checksum. */
+inline uint64_t finalizeChecksum(const unsigned char* bytes, size_t size, uint64_t h)
+{
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ bytes[i]) * CHECKSUM_PRIME0;
+        h ^= h >> 29;
+    }
+
+    // The finalizer of MurmurHash3.
+    h ^= h >> 33;
+    h *= CHECKSUM_PRIME1;
+    h ^= h >> 33;
+
+    return h;
+}
+
+} // namespace
+
+uint64_t binary_utility::computeChecksum(const void* data, size_t size, uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    uint64_t h = seed ^ (static_cast<uint64_t>(size) * CHECKSUM_PRIME0);
+
+    size_t numWordBytes = size / 8 * 8;
+    h = mixChecksumWords(bytes, numWordBytes, h);
+
+    return finalizeChecksum(bytes + numWordBytes, size - numWordBytes, h);
+}
+
+uint64_t binary_utility::computeChecksum(std::istream& stream, uint64_t size, uint64_t seed)
+{
+    uint64_t h = seed ^ (size * CHECKSUM_PRIME0);
+
+    // Data are read in pieces of a multiple of 8 bytes to mix the same words as the other overload.
+    const uint64_t pieceSize = 1 << 20;
+    std::vector<char> piece;
+
+    uint64_t numWordBytes = size / 8 * 8;
+    for (uint64_t pos = 0; pos < numWordBytes; pos += pieceSize) {
+        size_t readSize = static_cast<size_t>(std::min(pieceSize, numWordBytes - pos));
+        piece.resize(readSize);
+        if (!stream.read(piece.data(), readSize)) return 0;
+
+        h = mixChecksumWords(reinterpret_cast<const unsigned char*>(piece.data()), readSize, h);
+    }
+
+    size_t tailSize = static_cast<size_t>(size - numWordBytes);
+    piece.resize(tailSize);
+    if (tailSize > 0 && !stream.read(piece.data(), tailSize)) return 0;
+
+    return finalizeChecksum(reinterpret_cast<const unsigned char*>(piece.data()), tailSize, h);
+}
+
+bool binary_utility::createHeader(const FileInfo&        info,
+                                  EncodingType           encoding,
+                                  const std::string&     name,
+                                  Header*                header,
+                                  std::vector<char>*     metadata)
+{
+    if (info.coordinateSystem == UNKNOWN_COORDINATE_SYSTEM) {
+        lbError << "[binary_utility::createHeader] Unsupported coordinate system.";
+        return false;
+    }
+
+    std::memset(header, 0, sizeof(*header));
+    std::memcpy(header->magic, MAGIC, sizeof(header->magic));
+    header->version             = VERSION;
+    header->byteOrder           = BYTE_ORDER_MARK;
+    header->coordinateSystem    = info.coordinateSystem;
+    header->colorModel          = info.colorModel;
+    header->sourceType          = info.sourceType;
+    header->dataType            = info.dataType;
+    header->encoding            = encoding;
+
+    header->numAngles[0]        = static_cast<int32_t>(info.angles0.size());
+    header->numAngles[1]        = static_cast<int32_t>(info.angles1.size());
+    header->numAngles[2]        = static_cast<int32_t>(info.angles2.size());
+    header->numAngles[3]        = static_cast<int32_t>(info.angles3.size());
+    header->numWavelengths      = static_cast<int32_t>(info.wavelengths.size());
+    header->numSpecularOffsets  = static_cast<int32_t>(info.specularOffsets.size());
+    header->nameSize            = static_cast<uint32_t>(name.size());
+
+    metadata->clear();
+    appendArray(info.angles0, metadata);
+    appendArray(info.angles1, metadata);
+    appendArray(info.angles2, metadata);
+    appendArray(info.angles3, metadata);
+    appendArray(info.wavelengths, metadata);
+    appendArray(info.specularOffsets, metadata);
+    metadata->insert(metadata->end(), name.begin(), name.end());
+
+    uint64_t metadataEnd = sizeof(Header) + metadata->size();
+    uint64_t spectraOffset = (metadataEnd + SPECTRA_ALIGNMENT - 1) / SPECTRA_ALIGNMENT * SPECTRA_ALIGNMENT;
+    metadata->resize(metadata->size() + static_cast<size_t>(spectraOffset - metadataEnd), '\0');
+
+    header->spectraOffset = spectraOffset;
+
+    return true;
+}
+
+bool binary_utility::isLittleEndian()
+{
+    uint32_t value = BYTE_ORDER_MARK;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &value, 1);
+
+    return (firstByte == 0x04);
+}
+
+void binary_utility::encodeSpectra(const SampleSet&     samples,
+                                   int                  index0,
+                                   int                  index1,
+                                   std::vector<char>*   data)
+{
+    const int numAngles2 = samples.getNumAngles2();
+    const int numAngles3 = samples.getNumAngles3();
+    const int numWavelengths = samples.getNumWavelengths();
+    const SpectrumArray& spectra = samples.getSpectra();
+
+    std::vector<uint16_t> probabilities(NUM_BUCKET_CONTEXTS << NUM_BUCKET_BITS, RANGE_CODER_INITIAL_PROBABILITY);
+    std::vector<uint32_t> previousRow(numAngles2), currentRow(numAngles2);
+
+    std::vector<char> rangeData, bitData;
+    RangeEncoder encoder(&rangeData);
+    BitWriter bitWriter(&bitData);
+
+    int context = 0;
+    for (int wlIndex = 0; wlIndex < numWavelengths; ++wlIndex) {
+        for (int i3 = 0; i3 < numAngles3; ++i3) {
+            for (int i2 = 0; i2 < numAngles2; ++i2) {
+                size_t index = samples.getIndex(index0, index1, i2, i3);
+                uint32_t value = toOrderedInt(spectra(wlIndex, index));
+                currentRow[i2] = value;
+
+                // The zigzag encoding of a residual.
+                int32_t residual = static_cast<int32_t>(value - predict(previousRow.data(), currentRow.data(), i2, i3));
+                uint32_t code = (static_cast<uint32_t>(residual) << 1) ^ static_cast<uint32_t>(residual >> 31);
+
+                int bucket = countBits(code);
+                encoder.encodeTree(&probabilities[context << NUM_BUCKET_BITS], NUM_BUCKET_BITS, bucket);
+                if (bucket > 1) {
+                    bitWriter.write(code & ((1u << (bucket - 1)) - 1), bucket - 1);
+                }
+
+                context = bucket;
+            }
+
+            previousRow.swap(currentRow);
+        }
+    }
+
+    encoder.finish();
+    bitWriter.finish();
+
+    uint32_t rangeSize = static_cast<uint32_t>(rangeData.size());
+    const char* rangeSizeBytes = reinterpret_cast<const char*>(&rangeSize);
+    data->insert(data->end(), rangeSizeBytes, rangeSizeBytes + sizeof(rangeSize));
+    data->insert(data->end(), rangeData.begin(), rangeData.end());
+    data->insert(data->end(), bitData.begin(), bitData.end());
+}
+
+bool binary_utility::decodeSpectra(const char*  data,
+                                   size_t       size,
+                                   int          index0,
+                                   int          index1,
+                                   SampleSet*   samples)
+{
+    uint32_t rangeSize;
+    if (size < sizeof(rangeSize)) return false;
+
+    std::memcpy(&rangeSize, data, sizeof(rangeSize));
+    if (rangeSize > size - sizeof(rangeSize)) return false;
+
+    const char* rangeFirst = data + sizeof(rangeSize);
+    const char* rangeLast  = rangeFirst + rangeSize;
+
+    const int numAngles2 = samples->getNumAngles2();
+    const int numAngles3 = samples->getNumAngles3();
+    const int numWavelengths = samples->getNumWavelengths();
+    SpectrumArray& spectra = samples->getSpectra();
+
+    std::vector<uint16_t> probabilities(NUM_BUCKET_CONTEXTS << NUM_BUCKET_BITS, RANGE_CODER_INITIAL_PROBABILITY);
+    std::vector<uint32_t> previousRow(numAngles2), currentRow(numAngles2);
+
+    RangeDecoder decoder(rangeFirst, rangeLast);
+    BitReader bitReader(rangeLast, data + size);
+
+    int context = 0;
+    for (int wlIndex = 0; wlIndex < numWavelengths; ++wlIndex) {
+        for (int i3 = 0; i3 < numAngles3; ++i3) {
+            for (int i2 = 0; i2 < numAngles2; ++i2) {
+                int bucket = decoder.decodeTree(&probabilities[context << NUM_BUCKET_BITS], NUM_BUCKET_BITS);
+                if (bucket > 32) return false;
+
+                uint32_t code = 0;
+                if (bucket > 0) {
+                    code = (bucket > 1) ? bitReader.read(bucket - 1) : 0;
+                    code |= 1u << (bucket - 1);
+                }
+
+                uint32_t residual = (code >> 1) ^ (0u - (code & 1));
+                uint32_t value = predict(previousRow.data(), currentRow.data(), i2, i3) + residual;
+                currentRow[i2] = value;
+
+                size_t index = samples->getIndex(index0, index1, i2, i3);
+                spectra(wlIndex, index) = fromOrderedInt(value);
+
+                context = bucket;
+            }
+
+            previousRow.swap(currentRow);
+        }
+    }
+
+    return decoder.isValid();
+}
@@ -8,419 +8,486 @@
 
 #include <libbsdf/Reader/DdrReader.h>
 
-#include <fstream>
+#include <algorithm>
 
 #include <libbsdf/Brdf/Analyzer.h>
 #include <libbsdf/Reader/DdrSdrUtility.h>
+#include <libbsdf/Reader/Tokenizer.h>
 
 using namespace lb;
 
 SpecularCoordinatesBrdf* DdrReader::read(const std::string& fileName)
 {
-    // std::ios_base::binary is used to read line endings of CR+LF and LF.
-    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
-    if (ifs.fail()) {
+    std::vector<char> buffer;
+    if (!reader_utility::readFile(fileName, &buffer)) {
         lbError << "[DdrReader::read] Could not open: " << fileName;
         return 0;
     }
 
-    std::ios_base::sync_with_stdio(false);
+    // The terminating '\0' is excluded.
+    Tokenizer tokenizer(buffer.data(), buffer.data() + buffer.size() - 1, ";;");
 
-    SourceType sourceType = UNKNOWN_SOURCE;
+    Header header;
+    if (!readHeader(&tokenizer, &header)) return 0;
 
-    ddr_sdr_utility::SymmetryType symmetryType  = ddr_sdr_utility::PLANE_SYMMETRICAL;
-    ddr_sdr_utility::UnitType     unitType      = ddr_sdr_utility::LUMINANCE_ABSOLUTE;
+    const std::vector<float>& inThetaDegrees  = header.inThetaDegrees;
+    const std::vector<float>& inPhiDegrees    = header.inPhiDegrees;
+    const std::vector<float>& spThetaDegrees  = header.spThetaDegrees;
+    const std::vector<float>& spPhiDegrees    = header.spPhiDegrees;
 
-    ColorModel colorModel = RGB_MODEL;
+    ColorModel colorModel = header.colorModel;
+    int numWavelengths = header.numWavelengths;
 
-    int numWavelengths = 1;
+    ddr_sdr_utility::SymmetryType symmetryType  = header.symmetryType;
+    ddr_sdr_utility::UnitType     unitType      = header.unitType;
 
-    std::vector<float> inThetaDegrees;
-    std::vector<float> inPhiDegrees;
-    std::vector<float> spThetaDegrees;
-    std::vector<float> spPhiDegrees;
-    std::vector<float> spThetaOffsetDegrees;
+    bool planeSymmetrical = (symmetryType == ddr_sdr_utility::PLANE_SYMMETRICAL);
+    Arrayf specPhiAngles = reader_utility::computeSpecPhiAngles(spPhiDegrees, planeSymmetrical);
 
-    ddr_sdr_utility::ignoreCommentLines(ifs);
-    std::ifstream::pos_type pos = ifs.tellg();
+    // Initialize BRDF.
+    SpecularCoordinatesBrdf* brdf = new SpecularCoordinatesBrdf(static_cast<int>(inThetaDegrees.size()),
+                                                                static_cast<int>(inPhiDegrees.size()),
+                                                                static_cast<int>(spThetaDegrees.size()),
+                                                                static_cast<int>(specPhiAngles.size()),
+                                                                colorModel,
+                                                                numWavelengths);
+    brdf->setSourceType(header.sourceType);
 
-    using reader_utility::isEqual;
+    SampleSet* ss = brdf->getSampleSet();
 
-    // Read a header.
-    std::string headStr;
-    while (ifs >> headStr) {
-        ddr_sdr_utility::ignoreCommentLines(ifs);
+    copyArray(inThetaDegrees, &ss->getAngles0());
+    copyArray(inPhiDegrees,   &ss->getAngles1());
+    copyArray(spThetaDegrees, &ss->getAngles2());
 
-        if (headStr.empty()) {
-            continue;
+    ss->getAngles0() = toRadians(ss->getAngles0());
+    ss->getAngles1() = toRadians(ss->getAngles1());
+    ss->getAngles2() = toRadians(ss->getAngles2());
+
+    for (int i = 0; i < specPhiAngles.size(); ++i) {
+        brdf->setSpecPhi(i, specPhiAngles[i]);
+    }
+
+    if (!header.spThetaOffsetDegrees.empty()) {
+        brdf->getSpecularOffsets().resize(header.spThetaOffsetDegrees.size());
+        copyArray(header.spThetaOffsetDegrees, &brdf->getSpecularOffsets());
+        brdf->getSpecularOffsets() = toRadians(brdf->getSpecularOffsets());
+    }
+
+    // Find wavelength blocks. Blocks are independent and parsed concurrently.
+    std::vector<const char*> blockPositions;
+    while (tokenizer.next()) {
+        if (isWavelengthKeyword(tokenizer)) {
+            blockPositions.push_back(tokenizer.getTokenBegin());
         }
-        else if (isEqual(headStr, "Source")) {
-            std::string typeStr;
-            ifs >> typeStr;
+    }
+    blockPositions.push_back(tokenizer.getPosition());
+
+    int numBlocks = static_cast<int>(blockPositions.size()) - 1;
+    if (numBlocks > numWavelengths) {
+        lbWarn
+            << "[DdrReader::read] The number of wavelength blocks exceeds the number of wavelengths: "
+            << numBlocks << ", " << numWavelengths;
+        numBlocks = numWavelengths;
+    }
+
+    // Each block fills its own row of spectra, so threads write disjoint values.
+    SpectrumArray& spectra = ss->getSpectra();
+    std::vector<float> wavelengths(numBlocks);
+    std::vector<std::vector<float>> blockKbdfs(numBlocks);
+    int numFailedBlocks = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:numFailedBlocks)
+    for (int wlIndex = 0; wlIndex < numBlocks; ++wlIndex) {
+        Tokenizer blockTokenizer(blockPositions[wlIndex], blockPositions[wlIndex + 1], ";;");
+
+        // Skip the keyword.
+        blockTokenizer.next();
+
+        ValueMap values(spectra.data() + wlIndex, spectra.cols(), Eigen::InnerStride<>(numWavelengths));
+        bool succeeded = readWavelengthBlock(&blockTokenizer, *brdf,
+                                             colorModel, unitType, symmetryType,
+                                             static_cast<int>(spPhiDegrees.size()),
+                                             &wavelengths[wlIndex], &blockKbdfs[wlIndex],
+                                             &values);
+        if (!succeeded) {
+            ++numFailedBlocks;
+        }
+    }
+
+    if (numFailedBlocks > 0) {
+        delete brdf;
+        return 0;
+    }
+
+    if (colorModel == SPECTRAL_MODEL) {
+        for (int wlIndex = 0; wlIndex < numBlocks; ++wlIndex) {
+            ss->setWavelength(wlIndex, wavelengths[wlIndex]);
+        }
+    }
 
-            if (isEqual(typeStr, "Measured")) {
-                sourceType = MEASURED_SOURCE;
+    // "kbdf"s of relative values are used after all blocks are read.
+    std::vector<float> kbdfs;
+    for (auto it = blockKbdfs.begin(); it != blockKbdfs.end(); ++it) {
+        kbdfs.insert(kbdfs.end(), it->begin(), it->end());
+    }
+
+    brdf->clampAngles();
+
+    // Equalize reflectances to "kbdf"s.
+    if (unitType == ddr_sdr_utility::LUMINANCE_RELATIVE ||
+        unitType == ddr_sdr_utility::INTENSITY_RELATIVE) {
+        if (!kbdfs.empty()) {
+            int numWl = brdf->getSampleSet()->getNumWavelengths();
+            int numInTh = brdf->getNumInTheta();
+            int numInPh = brdf->getNumInPhi();
+
+            for (int wlIndex = 0; wlIndex < numWl; ++wlIndex) {
+                for (int inThIndex = 0; inThIndex < numInTh; ++inThIndex) {
+                for (int inPhIndex = 0; inPhIndex < numInPh; ++inPhIndex) {
+                    Spectrum refSp = computeReflectance(*brdf, inThIndex, inPhIndex);
+
+                    // Edit samples with "kbdf".
+                    float maxReflectance = refSp.maxCoeff();
+                    for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
+                    for (int i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
+                        SpectrumMap sp = ss->getSpectrum(inThIndex, inPhIndex, i2, i3);
+                        sp /= maxReflectance;
+
+                        // A reflectance equals "kbdf".
+                        float kbdf = kbdfs.at(inThIndex +
+                                              numInTh * inPhIndex +
+                                              numInTh * numInPh * wlIndex);
+                        sp *= kbdf;
+                    }}
+                }}
             }
-            else if (isEqual(typeStr, "Generated")) {
-                sourceType = GENERATED_SOURCE;
+        }
+    }
+
+    return brdf;
+}
+
+bool DdrReader::readInfo(const std::string& fileName, FileInfo* info)
+{
+    Header header;
+    size_t headerSize;
+    if (!readHeader(fileName, &header, &headerSize)) return false;
+
+    *info = FileInfo();
+    info->sourceType = header.sourceType;
+    info->coordinateSystem = SPECULAR_COORDINATE_SYSTEM;
+    info->colorModel = header.colorModel;
+    info->numWavelengths = header.numWavelengths;
+
+    info->angles0.resize(header.inThetaDegrees.size());
+    info->angles1.resize(header.inPhiDegrees.size());
+    info->angles2.resize(header.spThetaDegrees.size());
+    info->specularOffsets.resize(header.spThetaOffsetDegrees.size());
+
+    copyArray(header.inThetaDegrees,        &info->angles0);
+    copyArray(header.inPhiDegrees,          &info->angles1);
+    copyArray(header.spThetaDegrees,        &info->angles2);
+    copyArray(header.spThetaOffsetDegrees,  &info->specularOffsets);
+
+    info->angles0 = toRadians(info->angles0).cwiseMax(SpecularCoordinateSystem::MIN_ANGLE0)
+                                            .cwiseMin(SpecularCoordinateSystem::MAX_ANGLE0);
+    info->angles1 = toRadians(info->angles1).cwiseMax(SpecularCoordinateSystem::MIN_ANGLE1)
+                                            .cwiseMin(SpecularCoordinateSystem::MAX_ANGLE1);
+    info->angles2 = toRadians(info->angles2).cwiseMax(SpecularCoordinateSystem::MIN_ANGLE2)
+                                            .cwiseMin(SpecularCoordinateSystem::MAX_ANGLE2);
+    info->angles3 = reader_utility::computeSpecPhiAngles(header.spPhiDegrees,
+                                                         header.symmetryType == ddr_sdr_utility::PLANE_SYMMETRICAL);
+    info->specularOffsets = toRadians(info->specularOffsets);
+
+    return true;
+}
+
+DdrReader::Header::Header() : sourceType(UNKNOWN_SOURCE),
+                              symmetryType(ddr_sdr_utility::PLANE_SYMMETRICAL),
+                              unitType(ddr_sdr_utility::LUMINANCE_ABSOLUTE),
+                              colorModel(RGB_MODEL),
+                              numWavelengths(1) {}
+
+bool DdrReader::readHeader(const std::string& fileName, Header* header, size_t* headerSize)
+{
+    // The header ends at the first line beginning with a wavelength keyword.
+    std::vector<char> buffer;
+    if (!reader_utility::readFileHead(fileName, ";;", isWavelengthKeyword, &buffer, headerSize)) {
+        lbError << "[DdrReader::readHeader] Could not open: " << fileName;
+        return false;
+    }
+
+    Tokenizer tokenizer(buffer.data(), buffer.data() + *headerSize, ";;");
+    return readHeader(&tokenizer, header);
+}
+
+bool DdrReader::readHeader(Tokenizer* tokenizer, Header* header)
+{
+    // Read a header.
+    while (tokenizer->next()) {
+        if (tokenizer->isToken("Source")) {
+            tokenizer->next();
+
+            if (tokenizer->isToken("Measured")) {
+                header->sourceType = MEASURED_SOURCE;
             }
-            else if (isEqual(typeStr, "Edited")) {
-                sourceType = EDITED_SOURCE;
+            else if (tokenizer->isToken("Generated")) {
+                header->sourceType = GENERATED_SOURCE;
             }
-            else if (isEqual(typeStr, "Morphed")) {
-                sourceType = UNKNOWN_SOURCE;
+            else if (tokenizer->isToken("Edited")) {
+                header->sourceType = EDITED_SOURCE;
+            }
+            else if (tokenizer->isToken("Morphed")) {
+                header->sourceType = UNKNOWN_SOURCE;
             }
             else {
-                reader_utility::logNotImplementedKeyword(typeStr);
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
             }
         }
-        else if (isEqual(headStr, "TypeSym")) {
-            std::string typeStr;
-            ifs >> typeStr;
+        else if (tokenizer->isToken("TypeSym")) {
+            tokenizer->next();
 
-            if (isEqual(typeStr, "AxiSymmetrical")) {
-                symmetryType = ddr_sdr_utility::AXI_SYMMETRICAL;
+            if (tokenizer->isToken("AxiSymmetrical")) {
+                header->symmetryType = ddr_sdr_utility::AXI_SYMMETRICAL;
             }
-            else if (isEqual(typeStr, "DirSymmetrical")) {
-                symmetryType = ddr_sdr_utility::DIR_SYMMETRICAL;
+            else if (tokenizer->isToken("DirSymmetrical")) {
+                header->symmetryType = ddr_sdr_utility::DIR_SYMMETRICAL;
             }
-            else if (isEqual(typeStr, "PlaneSymmetrical")) {
-                symmetryType = ddr_sdr_utility::PLANE_SYMMETRICAL;
+            else if (tokenizer->isToken("PlaneSymmetrical")) {
+                header->symmetryType = ddr_sdr_utility::PLANE_SYMMETRICAL;
             }
-            else if (isEqual(typeStr, "ASymmetrical")) {
-                std::ifstream::pos_type asymmetricalPos = ifs.tellg();
-                ifs >> typeStr;
+            else if (tokenizer->isToken("ASymmetrical")) {
+                const char* asymmetricalPos = tokenizer->getPosition();
+                tokenizer->next();
 
-                if (isEqual(typeStr, "4D")) {
-                    symmetryType = ddr_sdr_utility::ASYMMETRICAL_4D;
+                if (tokenizer->isToken("4D")) {
+                    header->symmetryType = ddr_sdr_utility::ASYMMETRICAL_4D;
                 }
                 else {
-                    symmetryType = ddr_sdr_utility::ASYMMETRICAL;
-                    ifs.seekg(asymmetricalPos, std::ios_base::beg);
+                    header->symmetryType = ddr_sdr_utility::ASYMMETRICAL;
+                    tokenizer->setPosition(asymmetricalPos);
                 }
             }
             else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-                return 0;
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
             }
         }
-        else if (isEqual(headStr, "TypeColorModel")) {
-            std::string typeStr;
-            ifs >> typeStr;
+        else if (tokenizer->isToken("TypeColorModel")) {
+            tokenizer->next();
 
-            if (isEqual(typeStr, "rgb")) {
-                colorModel = RGB_MODEL;
-                numWavelengths = 3;
+            if (tokenizer->isToken("rgb")) {
+                header->colorModel = RGB_MODEL;
+                header->numWavelengths = 3;
             }
-            else if (isEqual(typeStr, "spectral")) {
-                colorModel = SPECTRAL_MODEL;
-                ifs >> numWavelengths;
+            else if (tokenizer->isToken("spectral")) {
+                header->colorModel = SPECTRAL_MODEL;
+                if (!tokenizer->readInt(&header->numWavelengths)) {
+                    lbError << "[DdrReader::readHeader] Invalid number of wavelengths: " << tokenizer->getToken();
+                    return false;
+                }
             }
-            else if (isEqual(typeStr, "bw")) {
-                colorModel = MONOCHROMATIC_MODEL;
-                numWavelengths = 1;
+            else if (tokenizer->isToken("bw")) {
+                header->colorModel = MONOCHROMATIC_MODEL;
+                header->numWavelengths = 1;
             }
             else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-                return 0;
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
             }
         }
-        else if (isEqual(headStr, "TypeData")) {
-            std::string typeStr;
-            ifs >> typeStr;
+        else if (tokenizer->isToken("TypeData")) {
+            tokenizer->next();
 
-            if (isEqual(typeStr, "Luminance")) {
-                ifs >> typeStr;
+            if (tokenizer->isToken("Luminance")) {
+                tokenizer->next();
 
-                if (isEqual(typeStr, "Absolute")) {
-                    unitType = ddr_sdr_utility::LUMINANCE_ABSOLUTE;
+                if (tokenizer->isToken("Absolute")) {
+                    header->unitType = ddr_sdr_utility::LUMINANCE_ABSOLUTE;
                 }
-                else if (isEqual(typeStr, "Relative")) {
-                    unitType = ddr_sdr_utility::LUMINANCE_RELATIVE;
+                else if (tokenizer->isToken("Relative")) {
+                    header->unitType = ddr_sdr_utility::LUMINANCE_RELATIVE;
                 }
                 else {
-                    reader_utility::ignoreLine(ifs);
+                    tokenizer->skipLine();
                 }
             }
-            else if (isEqual(typeStr, "Intensity")) {
-                ifs >> typeStr;
+            else if (tokenizer->isToken("Intensity")) {
+                tokenizer->next();
 
-                if (isEqual(typeStr, "Absolute")) {
-                    unitType = ddr_sdr_utility::INTENSITY_ABSOLUTE;
+                if (tokenizer->isToken("Absolute")) {
+                    header->unitType = ddr_sdr_utility::INTENSITY_ABSOLUTE;
                 }
-                else if (isEqual(typeStr, "Relative")) {
-                    unitType = ddr_sdr_utility::INTENSITY_RELATIVE;
+                else if (tokenizer->isToken("Relative")) {
+                    header->unitType = ddr_sdr_utility::INTENSITY_RELATIVE;
                 }
                 else {
-                    reader_utility::ignoreLine(ifs);
+                    tokenizer->skipLine();
                 }
-                reader_utility::ignoreLine(ifs);
+                tokenizer->skipLine();
             }
             else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-                return 0;
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
             }
         }
-        else if (isEqual(headStr, "psi")) {
-            int numInPhi;
-            ifs >> numInPhi;
-            for (int i = 0; i < numInPhi; ++i) {
-                float angle;
-                ifs >> angle;
-                inPhiDegrees.push_back(angle);
-            }
+        else if (tokenizer->isToken("psi")) {
+            if (!reader_utility::readAngles(tokenizer, &header->inPhiDegrees)) return false;
         }
-        else if (isEqual(headStr, "sigma")) {
-            int numInTheta;
-            ifs >> numInTheta;
-            for (int i = 0; i < numInTheta; ++i) {
-                float angle;
-                ifs >> angle;
-                inThetaDegrees.push_back(angle);
-            }
+        else if (tokenizer->isToken("sigma")) {
+            if (!reader_utility::readAngles(tokenizer, &header->inThetaDegrees)) return false;
         }
-        else if (isEqual(headStr, "sigmaT")) {
-            size_t numSpecThetaOffsets = inThetaDegrees.size();
+        else if (tokenizer->isToken("sigmaT")) {
+            size_t numSpecThetaOffsets = header->inThetaDegrees.size();
             for (size_t i = 0; i < numSpecThetaOffsets; ++i) {
                 float angle;
-                ifs >> angle;
-                spThetaOffsetDegrees.push_back(angle - inThetaDegrees[i]);
+                if (!tokenizer->readFloat(&angle)) {
+                    lbError << "[DdrReader::readHeader] Invalid angle: " << tokenizer->getToken();
+                    return false;
+                }
+                header->spThetaOffsetDegrees.push_back(angle - header->inThetaDegrees[i]);
             }
         }
-        else if (isEqual(headStr, "phi")) {
-            int numSpecPhi;
-            ifs >> numSpecPhi;
-            for (int i = 0; i < numSpecPhi; ++i) {
-                float angle;
-                ifs >> angle;
-                spPhiDegrees.push_back(angle);
-            }
+        else if (tokenizer->isToken("phi")) {
+            if (!reader_utility::readAngles(tokenizer, &header->spPhiDegrees)) return false;
         }
-        else if (isEqual(headStr, "theta")) {
-            int numSpecTheta;
-            ifs >> numSpecTheta;
-            for (int i = 0; i < numSpecTheta; ++i) {
-                float angle;
-                ifs >> angle;
-                spThetaDegrees.push_back(angle);
-            }
+        else if (tokenizer->isToken("theta")) {
+            if (!reader_utility::readAngles(tokenizer, &header->spThetaDegrees)) return false;
         }
-        else if (isEqual(headStr, "wl") ||
-                 isEqual(headStr, "bw") ||
-                 isEqual(headStr, "red") ||
-                 isEqual(headStr, "gre") ||
-                 isEqual(headStr, "blu") ||
-                 isEqual(headStr, "green") ||   // Not correct keyword in the specification
-                 isEqual(headStr, "blue")) {    // Not correct keyword in the specification
-            ifs.seekg(pos, std::ios_base::beg);
+        else if (isWavelengthKeyword(*tokenizer)) {
+            tokenizer->setPosition(tokenizer->getTokenBegin());
             break;
         }
-
-        pos = ifs.tellg();
     }
 
-    if (inThetaDegrees.empty() ||
-        spThetaDegrees.empty() ||
-        spPhiDegrees.empty()) {
-        lbError << "[DdrReader::read] Invalid format.";
-        return 0;
-    }
-
-    if (inPhiDegrees.empty()) {
-        inPhiDegrees.push_back(0.0f);
+    if (header->inThetaDegrees.empty() ||
+        header->spThetaDegrees.empty() ||
+        header->spPhiDegrees.empty()) {
+        lbError << "[DdrReader::readHeader] Invalid format.";
+        return false;
     }
 
-    size_t numSpecPhi = spPhiDegrees.size();
-    if (symmetryType == ddr_sdr_utility::PLANE_SYMMETRICAL) {
-        numSpecPhi = spPhiDegrees.size() + (spPhiDegrees.size() - 1);
+    if (header->inPhiDegrees.empty()) {
+        header->inPhiDegrees.push_back(0.0f);
     }
 
-    // Initialize BRDF.
-    SpecularCoordinatesBrdf* brdf = new SpecularCoordinatesBrdf(static_cast<int>(inThetaDegrees.size()),
-                                                                static_cast<int>(inPhiDegrees.size()),
-                                                                static_cast<int>(spThetaDegrees.size()),
-                                                                static_cast<int>(numSpecPhi),
-                                                                colorModel,
-                                                                numWavelengths);
-    brdf->setSourceType(sourceType);
-
-    SampleSet* ss = brdf->getSampleSet();
-
-    copyArray(inThetaDegrees, &ss->getAngles0());
-    copyArray(inPhiDegrees,   &ss->getAngles1());
-    copyArray(spThetaDegrees, &ss->getAngles2());
-
-    ss->getAngles0() = toRadians(ss->getAngles0());
-    ss->getAngles1() = toRadians(ss->getAngles1());
-    ss->getAngles2() = toRadians(ss->getAngles2());
+    return true;
+}
 
-    for (int i = 0; i < static_cast<int>(spPhiDegrees.size()); ++i) {
-        brdf->setSpecPhi(i, toRadian(spPhiDegrees.at(i)));
+bool DdrReader::readWavelengthBlock(Tokenizer*                      tokenizer,
+                                    const SpecularCoordinatesBrdf&  brdf,
+                                    ColorModel                      colorModel,
+                                    ddr_sdr_utility::UnitType       unitType,
+                                    ddr_sdr_utility::SymmetryType   symmetryType,
+                                    int                             numSpecPhiDegrees,
+                                    float*                          wavelength,
+                                    std::vector<float>*             kbdfs,
+                                    ValueMap*                       values)
+{
+    if (colorModel == SPECTRAL_MODEL) {
+        if (!tokenizer->readFloat(wavelength)) {
+            lbError << "[DdrReader::read] Invalid wavelength: " << tokenizer->getToken();
+            return false;
+        }
     }
 
-    // Copy symmetrical angles.
-    if (symmetryType == ddr_sdr_utility::PLANE_SYMMETRICAL) {
-        int numSpecPhiDegrees = static_cast<int>(spPhiDegrees.size());
-        for (int i = numSpecPhiDegrees, reverseIndex = numSpecPhiDegrees - 2;
-             i < brdf->getNumSpecPhi();
-             ++i, --reverseIndex) {
-            brdf->setSpecPhi(i, PI_F + (PI_F - brdf->getSpecPhi(reverseIndex)));
+    int numInTheta  = brdf.getNumInTheta();
+    int numInPhi    = brdf.getNumInPhi();
+
+    // Read "kbdf" and "def" or skip "def".
+    tokenizer->next();
+    if (tokenizer->isToken("kbdf")) {
+        for (int i = 0; i < numInTheta * numInPhi; ++i) {
+            float kbdf;
+            if (!tokenizer->readFloat(&kbdf)) {
+                lbError << "[DdrReader::read] Invalid kbdf: " << tokenizer->getToken();
+                return false;
+            }
+            kbdfs->push_back(kbdf);
         }
-    }
 
-    if (!spThetaOffsetDegrees.empty()) {
-        brdf->getSpecularOffsets().resize(spThetaOffsetDegrees.size());
-        copyArray(spThetaOffsetDegrees, &brdf->getSpecularOffsets());
-        brdf->getSpecularOffsets() = toRadians(brdf->getSpecularOffsets());
+        // Skip "def".
+        tokenizer->next();
     }
 
-    std::vector<float> kbdfs;
-
-    // Read data.
-    int wlIndex = 0;
-    std::string dataStr;
-    while (ifs >> dataStr) {
-        ddr_sdr_utility::ignoreCommentLines(ifs);
-
-        if (dataStr.empty()) {
-            continue;
-        }
-        else if (isEqual(dataStr, "wl") ||
-                 isEqual(dataStr, "bw") ||
-                 isEqual(dataStr, "red") ||
-                 isEqual(dataStr, "gre") ||
-                 isEqual(dataStr, "blu") ||
-                 isEqual(dataStr, "green") ||   // Not correct specification
-                 isEqual(dataStr, "blue")) {    // Not correct specification
-            if (colorModel == SPECTRAL_MODEL) {
-                float wavelength;
-                ifs >> wavelength;
-                brdf->getSampleSet()->setWavelength(wlIndex, wavelength);
+    for (int inPhIndex = 0; inPhIndex < numInPhi;   ++inPhIndex) {
+    for (int inThIndex = 0; inThIndex < numInTheta; ++inThIndex) {
+        float kbdf = 1.0f;
+        if (unitType == ddr_sdr_utility::LUMINANCE_ABSOLUTE ||
+            unitType == ddr_sdr_utility::INTENSITY_ABSOLUTE) {
+            if (!kbdfs->empty()) {
+                kbdf = kbdfs->at(inThIndex + numInTheta * inPhIndex);
             }
+        }
 
-            ddr_sdr_utility::ignoreCommentLines(ifs);
-            // Read "kbdf" and "def" or skip "def".
-            std::string kbdfStr;
-            ifs >> kbdfStr;
-            if (isEqual(kbdfStr, "kbdf")) {
-                for (size_t i = 0; i < inThetaDegrees.size() * inPhiDegrees.size(); ++i) {
-                    float kbdf;
-                    ifs >> kbdf;
-                    kbdfs.push_back(kbdf);
-                }
-
-                ddr_sdr_utility::ignoreCommentLines(ifs);
-                // Skip "def".
-                std::string defStr;
-                ifs >> defStr;
-            }
+        if (!readValues(tokenizer, brdf, inThIndex, inPhIndex,
+                        unitType, symmetryType, numSpecPhiDegrees, kbdf, values)) {
+            return false;
+        }
+    }}
 
-            int numInTheta  = static_cast<int>(inThetaDegrees.size());
-            int numInPhi    = static_cast<int>(inPhiDegrees.size());
-            int numSpTheta  = static_cast<int>(spThetaDegrees.size());
-            int numSpPhi    = static_cast<int>(spPhiDegrees.size());
-
-            for (int inPhIndex = 0; inPhIndex < numInPhi;   ++inPhIndex) {
-            for (int inThIndex = 0; inThIndex < numInTheta; ++inThIndex) {
-                float kbdf = 1.0f;
-                if (unitType == ddr_sdr_utility::LUMINANCE_ABSOLUTE ||
-                    unitType == ddr_sdr_utility::INTENSITY_ABSOLUTE) {
-                    if (!kbdfs.empty()) {
-                        kbdf = kbdfs.at(inThIndex + numInTheta * inPhIndex);
-                    }
-                }
+    return true;
+}
 
-                for (int spPhIndex = 0; spPhIndex < numSpPhi;   ++spPhIndex) {
-                    ddr_sdr_utility::ignoreCommentLines(ifs);
-                for (int spThIndex = 0; spThIndex < numSpTheta; ++spThIndex) {
-                    std::string brdfValueStr;
-                    ifs >> brdfValueStr;
-
-                    char* end;
-                    double brdfValue = std::strtod(brdfValueStr.c_str(), &end);
-                    if (*end != '\0') {
-                        lbError << "[DdrReader::read] Invalid value: " << brdfValueStr;
-                        delete brdf;
-                        return 0;
-                    }
-
-                    // Convert intensity to radiance.
-                    if (unitType == ddr_sdr_utility::INTENSITY_ABSOLUTE ||
-                        unitType == ddr_sdr_utility::INTENSITY_RELATIVE) {
-                        Vec3 inDir, outDir;
-                        brdf->getInOutDirection(inThIndex, inPhIndex, spThIndex, spPhIndex, &inDir, &outDir);
-
-                        brdfValue /= std::max(outDir[2], Vec3::Scalar(EPSILON_F));
-                        brdfValue *= PI_D;
-                    }
-
-                    brdfValue *= kbdf;
-                    brdfValue /= PI_D;
-
-                    Spectrum& sp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
-                    sp[wlIndex] = static_cast<Spectrum::Scalar>(brdfValue);
-
-                    if (symmetryType == ddr_sdr_utility::PLANE_SYMMETRICAL) {
-                        int symmetryIndex = (brdf->getNumSpecPhi() - 1) - spPhIndex;
-                        Spectrum& symmetrySp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, symmetryIndex);
-                        symmetrySp[wlIndex] = static_cast<Spectrum::Scalar>(brdfValue);
-                    }
-
-                    if (ifs.fail()) {
-                        lbError << "[DdrReader::read] Invalid format: " << brdfValue;
-                        delete brdf;
-                        return 0;
-                    }
-                }}
-            }}
+bool DdrReader::readValues(Tokenizer*                       tokenizer,
+                           const SpecularCoordinatesBrdf&   brdf,
+                           int                              inThIndex,
+                           int                              inPhIndex,
+                           ddr_sdr_utility::UnitType        unitType,
+                           ddr_sdr_utility::SymmetryType    symmetryType,
+                           int                              numSpecPhiDegrees,
+                           float                            kbdf,
+                           ValueMap*                        values)
+{
+    const SampleSet* ss = brdf.getSampleSet();
 
-            if (unitType == ddr_sdr_utility::LUMINANCE_ABSOLUTE ||
-                unitType == ddr_sdr_utility::INTENSITY_ABSOLUTE) {
-                kbdfs.clear();
-            }
+    int numSpTheta  = brdf.getNumSpecTheta();
+    int numSpPhi    = numSpecPhiDegrees;
 
-            ++wlIndex;
+    for (int spPhIndex = 0; spPhIndex < numSpPhi;   ++spPhIndex) {
+    for (int spThIndex = 0; spThIndex < numSpTheta; ++spThIndex) {
+        if (!tokenizer->next()) {
+            lbError << "[DdrReader::read] Invalid format. Values are not enough.";
+            return false;
         }
 
-        if (ifs.fail()) {
-            lbError << "[DdrReader::read] Invalid format. Head of line: " << dataStr;
-            delete brdf;
-            return 0;
+        double brdfValue;
+        if (!Tokenizer::parseDouble(tokenizer->getTokenBegin(), tokenizer->getTokenEnd(), &brdfValue)) {
+            lbError << "[DdrReader::read] Invalid value: " << tokenizer->getToken();
+            return false;
         }
-    }
 
-    brdf->clampAngles();
+        // Convert intensity to radiance.
+        if (unitType == ddr_sdr_utility::INTENSITY_ABSOLUTE ||
+            unitType == ddr_sdr_utility::INTENSITY_RELATIVE) {
+            Vec3 inDir, outDir;
+            brdf.getInOutDirection(inThIndex, inPhIndex, spThIndex, spPhIndex, &inDir, &outDir);
 
-    // Equalize reflectances to "kbdf"s.
-    if (unitType == ddr_sdr_utility::LUMINANCE_RELATIVE ||
-        unitType == ddr_sdr_utility::INTENSITY_RELATIVE) {
-        if (!kbdfs.empty()) {
-            int numWl = brdf->getSampleSet()->getNumWavelengths();
-            int numInTh = brdf->getNumInTheta();
-            int numInPh = brdf->getNumInPhi();
+            brdfValue /= std::max(outDir[2], Vec3::Scalar(EPSILON_F));
+            brdfValue *= PI_D;
+        }
 
-            for (wlIndex = 0; wlIndex < numWl; ++wlIndex) {
-                for (int inThIndex = 0; inThIndex < numInTh; ++inThIndex) {
-                for (int inPhIndex = 0; inPhIndex < numInPh; ++inPhIndex) {
-                    Spectrum refSp = computeReflectance(*brdf, inThIndex, inPhIndex);
+        brdfValue *= kbdf;
+        brdfValue /= PI_D;
 
-                    // Edit samples with "kbdf".
-                    float maxReflectance = refSp.maxCoeff();
-                    for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
-                    for (int i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
-                        Spectrum& sp = ss->getSpectrum(inThIndex, inPhIndex, i2, i3);
-                        sp /= maxReflectance;
+        (*values)[ss->getIndex(inThIndex, inPhIndex, spThIndex, spPhIndex)] = static_cast<float>(brdfValue);
 
-                        // A reflectance equals "kbdf".
-                        float kbdf = kbdfs.at(inThIndex +
-                                              numInTh * inPhIndex +
-                                              numInTh * numInPh * wlIndex);
-                        sp *= kbdf;
-                    }}
-                }}
-            }
+        if (symmetryType == ddr_sdr_utility::PLANE_SYMMETRICAL) {
+            int symmetryIndex = (brdf.getNumSpecPhi() - 1) - spPhIndex;
+            (*values)[ss->getIndex(inThIndex, inPhIndex, spThIndex, symmetryIndex)] = static_cast<float>(brdfValue);
         }
-    }
+    }}
 
-    return brdf;
+    return true;
+}
+
+bool DdrReader::isWavelengthKeyword(const Tokenizer& tokenizer)
+{
+    return (tokenizer.isToken("wl") ||
+            tokenizer.isToken("bw") ||
+            tokenizer.isToken("red") ||
+            tokenizer.isToken("gre") ||
+            tokenizer.isToken("blu") ||
+            tokenizer.isToken("green") ||   // Not correct keyword in the specification
+            tokenizer.isToken("blue"));     // Not correct keyword in the specification
 }
@@ -0,0 +1,329 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Reader/DdrSlabReader.h>
+
+#include <cstring>
+#include <memory>
+
+#include <libbsdf/Brdf/Analyzer.h>
+#include <libbsdf/Reader/Tokenizer.h>
+
+using namespace lb;
+
+bool DdrSlabReader::open(const std::string& fileName)
+{
+    if (stream_.is_open()) {
+        stream_.close();
+    }
+
+    size_t headerSize;
+    if (!DdrReader::readInfo(fileName, &info_) ||
+        !DdrReader::readHeader(fileName, &header_, &headerSize)) {
+        return false;
+    }
+
+    stream_.clear();
+    stream_.open(fileName.c_str(), std::ios_base::binary);
+    if (stream_.fail()) {
+        lbError << "[DdrSlabReader::open] Could not open: " << fileName;
+        return false;
+    }
+
+    info_.wavelengths = Arrayf::Zero(header_.numWavelengths);
+
+    numBlocks_ = 0;
+    numInDirs_ = static_cast<int>(header_.inThetaDegrees.size() * header_.inPhiDegrees.size());
+    numSegValues_ = static_cast<int>(header_.spThetaDegrees.size() * header_.spPhiDegrees.size());
+    segmentOffsets_.clear();
+    blockKbdfs_.clear();
+    kbdfs_.clear();
+    scanState_ = EXPECT_KEYWORD;
+    numValues_ = 0;
+    numFoundBlocks_ = 0;
+
+    // Scan the data section in pieces of complete lines. Comments end at the end of a line.
+    const size_t pieceSize = 16 << 20;
+    std::vector<char> buffer;
+    size_t numCarriedBytes = 0;
+    uint64_t bufferOffset = headerSize;
+    stream_.seekg(static_cast<std::streamoff>(headerSize));
+
+    bool endOfFile = false;
+    while (!endOfFile) {
+        buffer.resize(numCarriedBytes + pieceSize + 1);
+        stream_.read(buffer.data() + numCarriedBytes, pieceSize);
+
+        size_t numReadBytes = static_cast<size_t>(stream_.gcount());
+        size_t size = numCarriedBytes + numReadBytes;
+        endOfFile = (numReadBytes < pieceSize);
+
+        size_t end = size;
+        if (!endOfFile) {
+            while (end > 0 && buffer[end - 1] != '\n') {
+                --end;
+            }
+
+            // A line longer than a piece is continued.
+            if (end == 0) {
+                numCarriedBytes = size;
+                continue;
+            }
+        }
+
+        // A number at the end of the file must be followed by a character that is not a part of it.
+        buffer[size] = '\0';
+
+        Tokenizer tokenizer(buffer.data(), buffer.data() + end, ";;");
+        while (tokenizer.next()) {
+            uint64_t tokenOffset    = bufferOffset + (tokenizer.getTokenBegin() - buffer.data());
+            uint64_t tokenEndOffset = bufferOffset + (tokenizer.getTokenEnd()   - buffer.data());
+            if (!scanToken(tokenizer, tokenOffset, tokenEndOffset)) {
+                stream_.close();
+                return false;
+            }
+        }
+
+        numCarriedBytes = size - end;
+        std::memmove(buffer.data(), buffer.data() + end, numCarriedBytes);
+        bufferOffset += end;
+    }
+
+    if (!finishBlock()) {
+        stream_.close();
+        return false;
+    }
+
+    if (numFoundBlocks_ > header_.numWavelengths) {
+        lbWarn
+            << "[DdrSlabReader::open] The number of wavelength blocks exceeds the number of wavelengths: "
+            << numFoundBlocks_ << ", " << header_.numWavelengths;
+    }
+
+    // The stream is reused to read slabs.
+    stream_.clear();
+
+    if (header_.colorModel != SPECTRAL_MODEL) {
+        info_.wavelengths.setZero();
+    }
+
+    for (auto it = blockKbdfs_.begin(); it != blockKbdfs_.end(); ++it) {
+        kbdfs_.insert(kbdfs_.end(), it->begin(), it->end());
+    }
+
+    // Angles are converted in the same way as lb::DdrReader before clamped.
+    inThetaAngles_.resize(header_.inThetaDegrees.size());
+    inPhiAngles_.resize(header_.inPhiDegrees.size());
+    specThetaAngles_.resize(header_.spThetaDegrees.size());
+    specularOffsets_.resize(header_.spThetaOffsetDegrees.size());
+
+    copyArray(header_.inThetaDegrees,       &inThetaAngles_);
+    copyArray(header_.inPhiDegrees,         &inPhiAngles_);
+    copyArray(header_.spThetaDegrees,       &specThetaAngles_);
+    copyArray(header_.spThetaOffsetDegrees, &specularOffsets_);
+
+    inThetaAngles_      = toRadians(inThetaAngles_);
+    inPhiAngles_        = toRadians(inPhiAngles_);
+    specThetaAngles_    = toRadians(specThetaAngles_);
+    specularOffsets_    = toRadians(specularOffsets_);
+
+    return true;
+}
+
+SpecularCoordinatesBrdf* DdrSlabReader::readSlab(int inThIndex, int inPhIndex)
+{
+    if (!stream_.is_open()) {
+        lbError << "[DdrSlabReader::readSlab] A file is not open.";
+        return 0;
+    }
+
+    int numInTheta = getNumInTheta();
+    if (inThIndex < 0 || inThIndex >= numInTheta ||
+        inPhIndex < 0 || inPhIndex >= getNumInPhi()) {
+        lbError << "[DdrSlabReader::readSlab] Invalid index: " << inThIndex << ", " << inPhIndex;
+        return 0;
+    }
+
+    int numWavelengths = header_.numWavelengths;
+    const Arrayf& specPhiAngles = info_.angles3;
+
+    std::unique_ptr<SpecularCoordinatesBrdf> slab(new SpecularCoordinatesBrdf(1, 1,
+                                                                              static_cast<int>(specThetaAngles_.size()),
+                                                                              static_cast<int>(specPhiAngles.size()),
+                                                                              header_.colorModel,
+                                                                              numWavelengths));
+    slab->setSourceType(header_.sourceType);
+
+    SampleSet* ss = slab->getSampleSet();
+
+    ss->getAngles0()[0] = inThetaAngles_[inThIndex];
+    ss->getAngles1()[0] = inPhiAngles_[inPhIndex];
+    ss->getAngles2() = specThetaAngles_;
+
+    for (int i = 0; i < specPhiAngles.size(); ++i) {
+        slab->setSpecPhi(i, specPhiAngles[i]);
+    }
+
+    if (specularOffsets_.size() > 0) {
+        slab->getSpecularOffsets().resize(1);
+        slab->getSpecularOffsets()[0] = specularOffsets_[inThIndex];
+    }
+
+    int inDirIndex = inThIndex + numInTheta * inPhIndex;
+
+    SpectrumArray& spectra = ss->getSpectra();
+    std::vector<char> buffer;
+    for (int wlIndex = 0; wlIndex < numBlocks_; ++wlIndex) {
+        uint64_t segmentBegin = segmentOffsets_[getSegmentIndex(wlIndex, inDirIndex)];
+        uint64_t segmentEnd   = segmentOffsets_[getSegmentIndex(wlIndex, inDirIndex + 1)];
+
+        buffer.resize(static_cast<size_t>(segmentEnd - segmentBegin) + 1);
+        stream_.seekg(static_cast<std::streamoff>(segmentBegin));
+        stream_.read(buffer.data(), static_cast<std::streamsize>(segmentEnd - segmentBegin));
+        if (stream_.fail()) {
+            lbError << "[DdrSlabReader::readSlab] Failed to read data.";
+            stream_.clear();
+            return 0;
+        }
+        buffer.back() = '\0';
+
+        float kbdf = 1.0f;
+        if (header_.unitType == ddr_sdr_utility::LUMINANCE_ABSOLUTE ||
+            header_.unitType == ddr_sdr_utility::INTENSITY_ABSOLUTE) {
+            if (!blockKbdfs_[wlIndex].empty()) {
+                kbdf = blockKbdfs_[wlIndex].at(inDirIndex);
+            }
+        }
+
+        Tokenizer tokenizer(buffer.data(), buffer.data() + buffer.size() - 1, ";;");
+        DdrReader::ValueMap values(spectra.data() + wlIndex, spectra.cols(), Eigen::InnerStride<>(numWavelengths));
+        if (!DdrReader::readValues(&tokenizer, *slab, 0, 0,
+                                   header_.unitType, header_.symmetryType,
+                                   static_cast<int>(header_.spPhiDegrees.size()),
+                                   kbdf, &values)) {
+            return 0;
+        }
+    }
+
+    if (header_.colorModel == SPECTRAL_MODEL) {
+        for (int wlIndex = 0; wlIndex < numBlocks_; ++wlIndex) {
+            ss->setWavelength(wlIndex, info_.wavelengths[wlIndex]);
+        }
+    }
+
+    slab->clampAngles();
+
+    // Equalize reflectances to "kbdf"s.
+    if (header_.unitType == ddr_sdr_utility::LUMINANCE_RELATIVE ||
+        header_.unitType == ddr_sdr_utility::INTENSITY_RELATIVE) {
+        if (!kbdfs_.empty()) {
+            for (int wlIndex = 0; wlIndex < numWavelengths; ++wlIndex) {
+                Spectrum refSp = computeReflectance(*slab, 0, 0);
+
+                // Edit samples with "kbdf".
+                float maxReflectance = refSp.maxCoeff();
+                float kbdf = kbdfs_.at(inDirIndex + numInDirs_ * wlIndex);
+                for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
+                for (int i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
+                    SpectrumMap sp = ss->getSpectrum(0, 0, i2, i3);
+                    sp /= maxReflectance;
+
+                    // A reflectance equals "kbdf".
+                    sp *= kbdf;
+                }}
+            }
+        }
+    }
+
+    return slab.release();
+}
+
+bool DdrSlabReader::scanToken(const Tokenizer& tokenizer, uint64_t tokenOffset, uint64_t tokenEndOffset)
+{
+    if (DdrReader::isWavelengthKeyword(tokenizer)) {
+        if (!finishBlock()) return false;
+
+        // Blocks beyond the number of wavelengths are ignored.
+        ++numFoundBlocks_;
+        if (numFoundBlocks_ > header_.numWavelengths) return true;
+
+        ++numBlocks_;
+        segmentOffsets_.resize(getSegmentIndex(numBlocks_, 0), 0);
+        blockKbdfs_.push_back(std::vector<float>());
+        numValues_ = 0;
+
+        scanState_ = (header_.colorModel == SPECTRAL_MODEL) ? EXPECT_WAVELENGTH : EXPECT_KBDF;
+        return true;
+    }
+
+    switch (scanState_) {
+        case EXPECT_KEYWORD:
+            break;
+        case EXPECT_WAVELENGTH:
+            if (!Tokenizer::parseFloat(tokenizer.getTokenBegin(),
+                                       tokenizer.getTokenEnd(),
+                                       &info_.wavelengths[numBlocks_ - 1])) {
+                lbError << "[DdrSlabReader::open] Invalid wavelength: " << tokenizer.getToken();
+                return false;
+            }
+            scanState_ = EXPECT_KBDF;
+            break;
+        case EXPECT_KBDF:
+            // "def" is skipped.
+            scanState_ = tokenizer.isToken("kbdf") ? READ_KBDF : READ_VALUES;
+            break;
+        case READ_KBDF: {
+            float kbdf;
+            if (!Tokenizer::parseFloat(tokenizer.getTokenBegin(), tokenizer.getTokenEnd(), &kbdf)) {
+                lbError << "[DdrSlabReader::open] Invalid kbdf: " << tokenizer.getToken();
+                return false;
+            }
+
+            std::vector<float>& kbdfs = blockKbdfs_.back();
+            kbdfs.push_back(kbdf);
+            if (static_cast<int>(kbdfs.size()) == numInDirs_) {
+                scanState_ = SKIP_DEF;
+            }
+            break;
+        }
+        case SKIP_DEF:
+            scanState_ = READ_VALUES;
+            break;
+        case READ_VALUES:
+            if (numValues_ % numSegValues_ == 0) {
+                int inDirIndex = static_cast<int>(numValues_ / numSegValues_);
+                segmentOffsets_[getSegmentIndex(numBlocks_ - 1, inDirIndex)] = tokenOffset;
+            }
+
+            ++numValues_;
+            if (numValues_ == static_cast<uint64_t>(numInDirs_) * numSegValues_) {
+                segmentOffsets_[getSegmentIndex(numBlocks_ - 1, numInDirs_)] = tokenEndOffset;
+                scanState_ = EXPECT_KEYWORD;
+            }
+            break;
+    }
+
+    return true;
+}
+
+bool DdrSlabReader::finishBlock()
+{
+    if (scanState_ == EXPECT_KEYWORD) return true;
+
+    if (scanState_ == EXPECT_WAVELENGTH) {
+        lbError << "[DdrSlabReader::open] Invalid wavelength.";
+    }
+    else if (scanState_ == READ_KBDF) {
+        lbError << "[DdrSlabReader::open] Invalid kbdf.";
+    }
+    else {
+        lbError << "[DdrSlabReader::open] Invalid format. Values are not enough.";
+    }
+
+    return false;
+}
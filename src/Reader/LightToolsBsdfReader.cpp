@@ -8,247 +8,291 @@
 
 #include <libbsdf/Reader/LightToolsBsdfReader.h>
 
-#include <fstream>
+#include <algorithm>
 #include <set>
 
 #include <libbsdf/Brdf/Processor.h>
+#include <libbsdf/Reader/Tokenizer.h>
 
 using namespace lb;
 
 TwoSidedMaterial* LightToolsBsdfReader::read(const std::string& fileName)
 {
-    // std::ios_base::binary is used to read line endings of CR+LF and LF.
-    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
-    if (ifs.fail()) {
+    std::vector<char> buffer;
+    if (!reader_utility::readFile(fileName, &buffer)) {
         lbError << "[LightToolsBsdfReader::read] Could not open: " << fileName;
         return 0;
     }
 
-    std::ios_base::sync_with_stdio(false);
+    // The terminating '\0' is excluded.
+    Tokenizer tokenizer(buffer.data(), buffer.data() + buffer.size() - 1, "#");
 
-    SymmetryType symmetryType = UNKNOWN_SYMMETRY;
-    ColorModel colorModel = UNKNOWN_MODEL;
+    Header header;
+    if (!readHeader(&tokenizer, &header)) return 0;
 
-    std::vector<float> outThetaDegrees;
-    std::vector<float> outPhiDegrees;
+    const std::vector<float>& outThetaDegrees = header.outThetaDegrees;
+    const std::vector<float>& outPhiDegrees   = header.outPhiDegrees;
+    ColorModel colorModel = header.colorModel;
 
-    int numChannels = 1;
+    std::vector<DataBlock> frontBrdfData;
+    std::vector<DataBlock> frontBtdfData;
+    std::vector<DataBlock> backBrdfData;
+    std::vector<DataBlock> backBtdfData;
 
-    ignoreCommentLines(ifs);
+    size_t numOutDirSamples = outThetaDegrees.size() * outPhiDegrees.size();
 
-    // Read a header.
-    std::string headStr;
-    while (ifs >> headStr) {
-        ignoreCommentLines(ifs);
+    if (!readDataBlocks(&tokenizer, numOutDirSamples,
+                        &frontBrdfData, &frontBtdfData, &backBrdfData, &backBtdfData)) {
+        return 0;
+    }
+
+    std::shared_ptr<Brdf> frontBrdf(createBrdf(frontBrdfData, outThetaDegrees, outPhiDegrees, colorModel));
+    std::shared_ptr<Brdf> frontBtdf(createBrdf(frontBtdfData, outThetaDegrees, outPhiDegrees, colorModel));
+    std::shared_ptr<Brdf> backBrdf (createBrdf(backBrdfData,  outThetaDegrees, outPhiDegrees, colorModel));
+    std::shared_ptr<Brdf> backBtdf (createBrdf(backBtdfData,  outThetaDegrees, outPhiDegrees, colorModel));
+
+    if (!frontBrdf && !frontBtdf && !backBrdf && !backBtdf) return 0;
+
+    std::shared_ptr<Btdf> fBtdf = frontBtdf ? std::make_shared<Btdf>(frontBtdf) : 0;
+    std::shared_ptr<Btdf> bBtdf = backBtdf  ? std::make_shared<Btdf>(backBtdf)  : 0;
+
+    std::shared_ptr<Bsdf> frontBsdf = std::make_shared<Bsdf>(frontBrdf, fBtdf);
+    std::shared_ptr<Bsdf> backBsdf  = std::make_shared<Bsdf>(backBrdf,  bBtdf);
+
+    std::shared_ptr<Material> frontMaterial = std::make_shared<Material>(frontBsdf, nullptr, nullptr);
+    std::shared_ptr<Material> backMaterial  = std::make_shared<Material>(backBsdf, nullptr, nullptr);
+
+    TwoSidedMaterial* material = new TwoSidedMaterial(frontMaterial, backMaterial);
+
+    return material;
+}
+
+bool LightToolsBsdfReader::readInfo(const std::string& fileName, FileInfo* info)
+{
+    // The header and the attributes of the first data block end at "TIS" or "DataEnd".
+    auto isEndLine = [](const Tokenizer& tokenizer) {
+        return (tokenizer.isToken("TIS") || tokenizer.isToken("DataEnd"));
+    };
+
+    std::vector<char> buffer;
+    size_t headerSize;
+    if (!reader_utility::readFileHead(fileName, "#", isEndLine, &buffer, &headerSize)) {
+        lbError << "[LightToolsBsdfReader::readInfo] Could not open: " << fileName;
+        return false;
+    }
+
+    Tokenizer tokenizer(buffer.data(), buffer.data() + headerSize, "#");
+
+    Header header;
+    if (!readHeader(&tokenizer, &header)) return false;
 
-        if (headStr.empty()) {
-            continue;
+    *info = FileInfo();
+    info->coordinateSystem = SPHERICAL_COORDINATE_SYSTEM;
+    info->colorModel = header.colorModel;
+
+    if (header.colorModel == MONOCHROMATIC_MODEL) {
+        info->numWavelengths = 1;
+    }
+    else if (header.colorModel == XYZ_MODEL) {
+        info->numWavelengths = 3;
+    }
+
+    // Outgoing azimuthal angles are rotated and filled with symmetrical angles while reading data.
+    info->angles1 = Arrayf::Zero(1);
+    info->angles2.resize(header.outThetaDegrees.size());
+    copyArray(header.outThetaDegrees, &info->angles2);
+    info->angles2 = toRadians(info->angles2).cwiseMax(SphericalCoordinateSystem::MIN_ANGLE2)
+                                            .cwiseMin(SphericalCoordinateSystem::MAX_ANGLE2);
+
+    // Read the scatter type of the first data block.
+    info->dataType = BRDF_DATA;
+    while (tokenizer.next()) {
+        if (tokenizer.isToken("ScatterType")) {
+            tokenizer.next();
+
+            if (tokenizer.isToken("BTDF")) {
+                info->dataType = BTDF_DATA;
+            }
         }
-        else if (headStr == "Symmetry") {
-            std::string typeStr;
-            ifs >> typeStr;
+    }
 
-            if (typeStr == "PlaneSymmetrical") {
-                symmetryType = PLANE_SYMMETRICAL;
+    return true;
+}
+
+LightToolsBsdfReader::Header::Header() : symmetryType(UNKNOWN_SYMMETRY),
+                                         colorModel(UNKNOWN_MODEL) {}
+
+bool LightToolsBsdfReader::readHeader(Tokenizer* tokenizer, Header* header)
+{
+    // Read a header.
+    while (tokenizer->next()) {
+        if (tokenizer->isToken("Symmetry")) {
+            tokenizer->next();
+
+            if (tokenizer->isToken("PlaneSymmetrical")) {
+                header->symmetryType = PLANE_SYMMETRICAL;
             }
-            else if (typeStr == "Asymmetric") {
-                symmetryType = ASYMMETRICAL;
+            else if (tokenizer->isToken("Asymmetric")) {
+                header->symmetryType = ASYMMETRICAL;
             }
             else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-                return 0;
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
             }
         }
-        else if (headStr == "SpectralContent") {
-            std::string typeStr;
-            ifs >> typeStr;
+        else if (tokenizer->isToken("SpectralContent")) {
+            tokenizer->next();
 
-            if (typeStr == "Monochrome") {
-                colorModel = MONOCHROMATIC_MODEL;
-                numChannels = 1;
+            if (tokenizer->isToken("Monochrome")) {
+                header->colorModel = MONOCHROMATIC_MODEL;
             }
-            else if (typeStr == "XYZ") {
-                colorModel = XYZ_MODEL;
-                numChannels = 3;
+            else if (tokenizer->isToken("XYZ")) {
+                header->colorModel = XYZ_MODEL;
             }
             else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-                return 0;
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
             }
         }
-        else if (headStr == "ScatterAzimuth") {
-            int numOutPhi;
-            ifs >> numOutPhi;
-            for (int i = 0; i < numOutPhi; ++i) {
-                float angle;
-                ifs >> angle;
-                outPhiDegrees.push_back(angle);
-            }
+        else if (tokenizer->isToken("ScatterAzimuth")) {
+            if (!reader_utility::readAngles(tokenizer, &header->outPhiDegrees)) return false;
         }
-        else if (headStr == "ScatterRadial") {
-            int numOutTheta;
-            ifs >> numOutTheta;
-            for (int i = 0; i < numOutTheta; ++i) {
-                float angle;
-                ifs >> angle;
-                outThetaDegrees.push_back(angle);
-            }
+        else if (tokenizer->isToken("ScatterRadial")) {
+            if (!reader_utility::readAngles(tokenizer, &header->outThetaDegrees)) return false;
         }
-        else if (headStr == "DataBegin") {
+        else if (tokenizer->isToken("DataBegin")) {
             break;
         }
     }
 
-    std::vector<DataBlock*> frontBrdfData;
-    std::vector<DataBlock*> frontBtdfData;
-    std::vector<DataBlock*> backBrdfData;
-    std::vector<DataBlock*> backBtdfData;
-
-    if (outThetaDegrees.empty() ||
-        outPhiDegrees.empty()) {
-        lbError << "[LightToolsBsdfReader::read] Invalid format.";
-        return 0;
+    if (header->outThetaDegrees.empty() ||
+        header->outPhiDegrees.empty()) {
+        lbError << "[LightToolsBsdfReader::readHeader] Invalid format.";
+        return false;
     }
 
-    size_t numOutDirSamples = outThetaDegrees.size() * outPhiDegrees.size();
-
-    ignoreCommentLines(ifs);
-
-    // Read data.
-    DataBlock* data = 0;
-    std::string dataStr;
-    while (ifs >> dataStr) {
-        ignoreCommentLines(ifs);
-
-        if (!data) {
-            data = new DataBlock;
-        }
+    return true;
+}
 
-        if (dataStr.empty()) {
-            continue;
-        }
-        else if (dataStr == "AOI") {
+bool LightToolsBsdfReader::readDataBlocks(Tokenizer*                tokenizer,
+                                          size_t                    numValues,
+                                          std::vector<DataBlock>*   frontBrdfData,
+                                          std::vector<DataBlock>*   frontBtdfData,
+                                          std::vector<DataBlock>*   backBrdfData,
+                                          std::vector<DataBlock>*   backBtdfData)
+{
+    DataBlock data;
+    while (tokenizer->next()) {
+        if (tokenizer->isToken("AOI")) {
             float aoi;
-            ifs >> aoi;
+            if (!tokenizer->readFloat(&aoi)) {
+                lbError << "[LightToolsBsdfReader::read] Invalid AOI: " << tokenizer->getToken();
+                return false;
+            }
+
             if (aoi > 90.0f) {
                 aoi = 0;
             }
-            data->aoi = aoi;
+            data.aoi = aoi;
         }
-        else if (dataStr == "POI") {
-            ifs >> data->poi;
+        else if (tokenizer->isToken("POI")) {
+            if (!tokenizer->readFloat(&data.poi)) {
+                lbError << "[LightToolsBsdfReader::read] Invalid POI: " << tokenizer->getToken();
+                return false;
+            }
         }
-        else if (dataStr == "Side") {
-            std::string sideStr;
-            ifs >> sideStr;
+        else if (tokenizer->isToken("Side")) {
+            tokenizer->next();
 
-            if (sideStr == "Front") {
-                data->sideType = FRONT_SIDE;
+            if (tokenizer->isToken("Front")) {
+                data.sideType = FRONT_SIDE;
             }
-            else if (sideStr == "Back") {
-                data->sideType = BACK_SIDE;
+            else if (tokenizer->isToken("Back")) {
+                data.sideType = BACK_SIDE;
             }
             else {
-                reader_utility::logNotImplementedKeyword(sideStr);
-                return 0;
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
             }
         }
-        else if (dataStr == "Wavelength") {
-            ifs >> data->wavelength;
+        else if (tokenizer->isToken("Wavelength")) {
+            if (!tokenizer->readFloat(&data.wavelength)) {
+                lbError << "[LightToolsBsdfReader::read] Invalid wavelength: " << tokenizer->getToken();
+                return false;
+            }
         }
-        else if (dataStr == "ScatterType") {
-            std::string scatterStr;
-            ifs >> scatterStr;
+        else if (tokenizer->isToken("ScatterType")) {
+            tokenizer->next();
 
-            if (scatterStr == "BRDF") {
-                data->dataType = BRDF_DATA;
+            if (tokenizer->isToken("BRDF")) {
+                data.dataType = BRDF_DATA;
             }
-            else if (scatterStr == "BTDF") {
-                data->dataType = BTDF_DATA;
+            else if (tokenizer->isToken("BTDF")) {
+                data.dataType = BTDF_DATA;
             }
             else {
-                reader_utility::logNotImplementedKeyword(scatterStr);
-                return 0;
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
             }
         }
-        else if (dataStr == "TristimulusValue") {
-            std::string trisStr;
-            ifs >> trisStr;
+        else if (tokenizer->isToken("TristimulusValue")) {
+            tokenizer->next();
 
-            if (trisStr == "TrisX") {
-                data->tristimulusValueType = TRIS_X;
+            if (tokenizer->isToken("TrisX")) {
+                data.tristimulusValueType = TRIS_X;
             }
-            else if (trisStr == "TrisY") {
-                data->tristimulusValueType = TRIS_Y;
+            else if (tokenizer->isToken("TrisY")) {
+                data.tristimulusValueType = TRIS_Y;
             }
-            else if (trisStr == "TrisZ") {
-                data->tristimulusValueType = TRIS_Z;
+            else if (tokenizer->isToken("TrisZ")) {
+                data.tristimulusValueType = TRIS_Z;
             }
             else {
-                reader_utility::logNotImplementedKeyword(trisStr);
-                return 0;
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
             }
         }
-        else if (dataStr == "TIS") {
-            ifs >> data->tis;
-
-            ignoreCommentLines(ifs);
+        else if (tokenizer->isToken("TIS")) {
+            if (!tokenizer->readFloat(&data.tis)) {
+                lbError << "[LightToolsBsdfReader::read] Invalid TIS: " << tokenizer->getToken();
+                return false;
+            }
 
-            data->samples.resize(numOutDirSamples);
-            for (size_t i = 0; i < numOutDirSamples; ++i) {
-                std::string valueStr;
-                ifs >> valueStr;
-                data->samples[i] = static_cast<Arrayf::Scalar>(std::atof(valueStr.c_str()));
+            // Values are skipped and parsed by createBrdf().
+            data.values = tokenizer->getPosition();
+            for (size_t i = 0; i < numValues; ++i) {
+                if (!tokenizer->next()) {
+                    lbError << "[LightToolsBsdfReader::read] Invalid format. Values are not enough.";
+                    return false;
+                }
             }
+            data.valuesEnd = tokenizer->getPosition();
 
-            if (data->sideType == FRONT_SIDE) {
-                if (data->dataType == BRDF_DATA) {
-                    frontBrdfData.push_back(data);
+            if (data.sideType == FRONT_SIDE) {
+                if (data.dataType == BRDF_DATA) {
+                    frontBrdfData->push_back(data);
                 }
                 else {
-                    frontBtdfData.push_back(data);
+                    frontBtdfData->push_back(data);
                 }
             }
             else {
-                if (data->dataType == BRDF_DATA) {
-                    backBrdfData.push_back(data);
+                if (data.dataType == BRDF_DATA) {
+                    backBrdfData->push_back(data);
                 }
                 else {
-                    backBtdfData.push_back(data);
+                    backBtdfData->push_back(data);
                 }
             }
 
-            data = 0;
+            data = DataBlock();
         }
-        else if (dataStr == "DataEnd") {
+        else if (tokenizer->isToken("DataEnd")) {
             break;
         }
     }
 
-    std::shared_ptr<Brdf> frontBrdf(createBrdf(frontBrdfData, outThetaDegrees, outPhiDegrees, colorModel));
-    std::shared_ptr<Brdf> frontBtdf(createBrdf(frontBtdfData, outThetaDegrees, outPhiDegrees, colorModel));
-    std::shared_ptr<Brdf> backBrdf (createBrdf(backBrdfData,  outThetaDegrees, outPhiDegrees, colorModel));
-    std::shared_ptr<Brdf> backBtdf (createBrdf(backBtdfData,  outThetaDegrees, outPhiDegrees, colorModel));
-
-    for (auto it = frontBrdfData.begin(); it != frontBrdfData.end(); ++it) { delete *it; }
-    for (auto it = frontBtdfData.begin(); it != frontBtdfData.end(); ++it) { delete *it; }
-    for (auto it = backBrdfData.begin();  it != backBrdfData.end();  ++it) { delete *it; }
-    for (auto it = backBtdfData.begin();  it != backBtdfData.end();  ++it) { delete *it; }
-
-    if (!frontBrdf && !frontBtdf && !backBrdf && !backBtdf) return 0;
-
-    std::shared_ptr<Btdf> fBtdf = frontBtdf ? std::make_shared<Btdf>(frontBtdf) : 0;
-    std::shared_ptr<Btdf> bBtdf = backBtdf  ? std::make_shared<Btdf>(backBtdf)  : 0;
-
-    std::shared_ptr<Bsdf> frontBsdf = std::make_shared<Bsdf>(frontBrdf, fBtdf);
-    std::shared_ptr<Bsdf> backBsdf  = std::make_shared<Bsdf>(backBrdf,  bBtdf);
-
-    std::shared_ptr<Material> frontMaterial = std::make_shared<Material>(frontBsdf, nullptr, nullptr);
-    std::shared_ptr<Material> backMaterial  = std::make_shared<Material>(backBsdf, nullptr, nullptr);
-
-    TwoSidedMaterial* material = new TwoSidedMaterial(frontMaterial, backMaterial);
-
-    return material;
+    return true;
 }
 
 LightToolsBsdfReader::DataBlock::DataBlock() : aoi(0.0f),
@@ -256,19 +300,22 @@ LightToolsBsdfReader::DataBlock::DataBlock() : aoi(0.0f),
                                                wavelength(0.0f),
                                                tis(0.0f),
                                                sideType(FRONT_SIDE),
-                                               dataType(BRDF_DATA) {}
+                                               dataType(BRDF_DATA),
+                                               tristimulusValueType(TRIS_X),
+                                               values(0),
+                                               valuesEnd(0) {}
 
-bool LightToolsBsdfReader::DataBlock::cmp(DataBlock* lhs, DataBlock* rhs)
+bool LightToolsBsdfReader::DataBlock::cmp(const DataBlock& lhs, const DataBlock& rhs)
 {
-    if (lhs->aoi == rhs->aoi) {
-        return lhs->tristimulusValueType < rhs->tristimulusValueType;
+    if (lhs.aoi == rhs.aoi) {
+        return lhs.tristimulusValueType < rhs.tristimulusValueType;
     }
     else {
-        return lhs->aoi < rhs->aoi;
+        return lhs.aoi < rhs.aoi;
     }
 }
 
-SphericalCoordinatesBrdf* LightToolsBsdfReader::createBrdf(std::vector<DataBlock*>&     brdfData,
+SphericalCoordinatesBrdf* LightToolsBsdfReader::createBrdf(std::vector<DataBlock>&      brdfData,
                                                            const std::vector<float>&    outThetaDegrees,
                                                            const std::vector<float>&    outPhiDegrees,
                                                            ColorModel                   colorModel)
@@ -290,7 +337,7 @@ SphericalCoordinatesBrdf* LightToolsBsdfReader::createBrdf(std::vector<DataBlock
 
     std::set<float> inThetaDegrees;
     for (auto it = brdfData.begin(); it != brdfData.end(); ++it) {
-        inThetaDegrees.insert((*it)->aoi);
+        inThetaDegrees.insert(it->aoi);
     }
 
     if (brdfData.size() != inThetaDegrees.size() * numChannels) {
@@ -315,31 +362,50 @@ SphericalCoordinatesBrdf* LightToolsBsdfReader::createBrdf(std::vector<DataBlock
     ss->getAngles2() = toRadians(ss->getAngles2());
     ss->getAngles3() = toRadians(ss->getAngles3());
 
-    for (int i = 0; i < static_cast<int>(brdfData.size()); ++i) {
-        DataBlock* data = brdfData.at(i);
+    int numBlocks = static_cast<int>(brdfData.size());
+    for (int i = 0; i < numBlocks; ++i) {
+        const DataBlock& data = brdfData.at(i);
 
-        int channelIndex;
-        if (colorModel == MONOCHROMATIC_MODEL) {
-            channelIndex = 0;
-        }
-        else if (colorModel == XYZ_MODEL) {
-            channelIndex = data->tristimulusValueType;
-        }
-        else {
-            return 0;
-        }
+        int channelIndex = (colorModel == XYZ_MODEL) ? data.tristimulusValueType : 0;
+        ss->setWavelength(channelIndex, data.wavelength);
 
-        ss->setWavelength(channelIndex, data->wavelength);
+        lbInfo << "[LightToolsBsdfReader::read] TIS(inThIndex: " << i / numChannels << "): " << data.tis;
+    }
+
+    // Values of blocks are parsed concurrently into the samples of the BRDF.
+    int numFailedBlocks = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:numFailedBlocks)
+    for (int i = 0; i < numBlocks; ++i) {
+        const DataBlock& data = brdfData[i];
 
+        int channelIndex = (colorModel == XYZ_MODEL) ? data.tristimulusValueType : 0;
         int inThIndex = i / numChannels;
-        int index = 0;
-        for (int outPhIndex = 0; outPhIndex < brdf->getNumOutPhi();   ++outPhIndex)          {
-        for (int outThIndex = 0; outThIndex < brdf->getNumOutTheta(); ++outThIndex, ++index) {
-            Spectrum& sp = brdf->getSpectrum(inThIndex, 0, outThIndex, outPhIndex);
-            sp[channelIndex] = data->samples[index];
+
+        Tokenizer tokenizer(data.values, data.valuesEnd, "#");
+        bool succeeded = true;
+        for (int outPhIndex = 0; outPhIndex < brdf->getNumOutPhi()   && succeeded; ++outPhIndex) {
+        for (int outThIndex = 0; outThIndex < brdf->getNumOutTheta() && succeeded; ++outThIndex) {
+            tokenizer.next();
+
+            double value;
+            if (Tokenizer::parseDouble(tokenizer.getTokenBegin(), tokenizer.getTokenEnd(), &value)) {
+                SpectrumMap sp = brdf->getSpectrum(inThIndex, 0, outThIndex, outPhIndex);
+                sp[channelIndex] = static_cast<float>(value);
+            }
+            else {
+                lbError << "[LightToolsBsdfReader::read] Invalid value: " << tokenizer.getToken();
+                succeeded = false;
+            }
         }}
 
-        lbInfo << "[LightToolsBsdfReader::read] TIS(inThIndex: " << inThIndex << "): " << data->tis;
+        if (!succeeded) {
+            ++numFailedBlocks;
+        }
+    }
+
+    if (numFailedBlocks > 0) {
+        delete brdf;
+        return 0;
     }
 
     // An incoming azimuthal angle of an isotropic LightTools BSDF is 90 degrees.
@@ -8,7 +8,9 @@
 
 #include <libbsdf/Reader/MerlBinaryReader.h>
 
+#include <algorithm>
 #include <fstream>
+#include <vector>
 
 using namespace lb;
 
@@ -22,28 +24,11 @@ HalfDifferenceCoordinatesBrdf* MerlBinaryReader::read(const std::string& fileNam
 
     std::ios_base::sync_with_stdio(false);
 
-    const int numHalfTheta = 90;
-    const int numDiffTheta = 90;
-    const int numDiffPhi = 360;
-    const int numSamples = numHalfTheta * numDiffTheta * numDiffPhi / 2;
+    const int numHalfTheta = NUM_HALF_THETA;
+    const int numDiffTheta = NUM_DIFF_THETA;
+    const int numDiffPhi = NUM_DIFF_PHI;
 
-    // Read a header.
-    int dims[3];
-    ifs.read(reinterpret_cast<char*>(dims), sizeof(int) * 3);
-
-    int numSamplesInFile = dims[0] * dims[1] * dims[2];
-    if (numSamplesInFile != numSamples) {
-        lbError << "[MerlBinaryReader::read] Dimensions do not match: " << numSamplesInFile << ", " << numSamples;
-        return 0;
-    }
-
-    // Read data.
-    double* samples = new double[numSamples * 3];
-    ifs.read(reinterpret_cast<char*>(samples), sizeof(double) * numSamples * 3);
-    if (ifs.fail()) {
-        lbError << "[MerlBinaryReader::read] Invalid format.";
-        delete[] samples;
-    }
+    if (!readDimensions(ifs)) return 0;
 
     HalfDifferenceCoordinatesBrdf* brdf = new HalfDifferenceCoordinatesBrdf(numHalfTheta + 1, 1,
                                                                             numDiffTheta + 1, numDiffPhi + 1,
@@ -51,37 +36,111 @@ HalfDifferenceCoordinatesBrdf* MerlBinaryReader::read(const std::string& fileNam
 
     // Set the angles of a non-linear mapping.
     for (int i = 0; i < brdf->getNumHalfTheta(); ++i) {
-        float halfThetaDegree = static_cast<float>(i * i) / numHalfTheta;
-        brdf->setHalfTheta(i, toRadian(halfThetaDegree));
+        brdf->setHalfTheta(i, computeHalfTheta(i));
+    }
+
+    const float rgbScaleCoeffs[3] = { 1.0f / 1500.0f, 1.15f / 1500.0f, 1.66f / 1500.0f };
+
+    SampleSet* ss = brdf->getSampleSet();
+    SpectrumArray& spectra = ss->getSpectra();
+
+    // Read the plane of each channel in slices of a half polar angle without buffering the whole file.
+    const int numSliceSamples = numDiffTheta * numDiffPhi / 2;
+    std::vector<double> slice(numSliceSamples);
+    std::vector<float> values(numSliceSamples);
+
+    for (int channel = 0; channel < 3; ++channel) {
+        for (int sampleHalfThIndex = 0; sampleHalfThIndex < numHalfTheta; ++sampleHalfThIndex) {
+            ifs.read(reinterpret_cast<char*>(slice.data()), sizeof(double) * numSliceSamples);
+            if (ifs.fail()) {
+                lbError << "[MerlBinaryReader::read] Invalid format.";
+                delete brdf;
+                return 0;
+            }
+
+            for (int i = 0; i < numSliceSamples; ++i) {
+                values[i] = std::max(static_cast<float>(slice[i]), 0.0f) * rgbScaleCoeffs[channel];
+            }
+
+            // The last half polar angle and the boundaries of difference angles are undefined in the file,
+            // so they are filled with the nearest samples.
+            int lastHalfThIndex = (sampleHalfThIndex == numHalfTheta - 1) ? numHalfTheta : sampleHalfThIndex;
+
+            for (int halfThIndex = sampleHalfThIndex; halfThIndex <= lastHalfThIndex; ++halfThIndex) {
+            for (int diffPhIndex = 0; diffPhIndex < brdf->getNumDiffPhi();   ++diffPhIndex) {
+            for (int diffThIndex = 0; diffThIndex < brdf->getNumDiffTheta(); ++diffThIndex) {
+                int sampleDiffThIndex = std::min(diffThIndex, numDiffTheta - 1);
+                int sampleDiffPhIndex = diffPhIndex % (numDiffPhi / 2);
+                int sampleIndex = sampleDiffPhIndex + numDiffPhi / 2 * sampleDiffThIndex;
+
+                spectra(channel, ss->getIndex(halfThIndex, 0, diffThIndex, diffPhIndex)) = values[sampleIndex];
+            }}}
+        }
+    }
+
+    brdf->clampAngles();
+    brdf->setSourceType(MEASURED_SOURCE);
+
+    return brdf;
+}
+
+bool MerlBinaryReader::readInfo(const std::string& fileName, FileInfo* info)
+{
+    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
+    if (ifs.fail()) {
+        lbError << "[MerlBinaryReader::readInfo] Could not open: " << fileName;
+        return false;
     }
 
-    const Vec3f rgbScaleCoeff(1.0f / 1500.0f, 1.15f / 1500.0f, 1.66f / 1500.0f);
+    if (!readDimensions(ifs)) return false;
 
-    for (int halfThIndex = 0; halfThIndex < brdf->getNumHalfTheta(); ++halfThIndex) {
-    for (int diffThIndex = 0; diffThIndex < brdf->getNumDiffTheta(); ++diffThIndex) {
-    for (int diffPhIndex = 0; diffPhIndex < brdf->getNumDiffPhi();   ++diffPhIndex) {
-        // Compute the sample index including undefined samples.
-        int sampleHalfThIndex = std::min(halfThIndex, numHalfTheta - 1);
-        int sampleDiffThIndex = std::min(diffThIndex, numDiffTheta - 1);
-        int sampleDiffPhIndex = diffPhIndex % (numDiffPhi / 2);
+    *info = FileInfo();
+    info->dataType = BRDF_DATA;
+    info->sourceType = MEASURED_SOURCE;
+    info->coordinateSystem = HALF_DIFFERENCE_COORDINATE_SYSTEM;
+    info->colorModel = RGB_MODEL;
+    info->numWavelengths = 3;
+    info->wavelengths = Arrayf::Zero(3);
 
-        int sampleIndex = sampleDiffPhIndex
-                        + numDiffPhi / 2 * sampleDiffThIndex
-                        + numDiffPhi / 2 * numDiffTheta * sampleHalfThIndex;
+    // The angles are equal to the BRDF created by read().
+    info->angles0.resize(NUM_HALF_THETA + 1);
+    for (int i = 0; i < info->angles0.size(); ++i) {
+        info->angles0[i] = computeHalfTheta(i);
+    }
 
-        Vec3f rgb(static_cast<float>(samples[sampleIndex]),
-                  static_cast<float>(samples[sampleIndex + numSamples]),
-                  static_cast<float>(samples[sampleIndex + numSamples * 2]));
-        rgb = rgb.cwiseMax(0.0f);
+    info->angles1 = Arrayf::Zero(1);
+    info->angles2 = Arrayf::LinSpaced(NUM_DIFF_THETA + 1,
+                                      HalfDifferenceCoordinateSystem::MIN_ANGLE2,
+                                      HalfDifferenceCoordinateSystem::MAX_ANGLE2);
+    info->angles3 = Arrayf::LinSpaced(NUM_DIFF_PHI + 1,
+                                      HalfDifferenceCoordinateSystem::MIN_ANGLE3,
+                                      HalfDifferenceCoordinateSystem::MAX_ANGLE3);
 
-        rgb = rgb.cwiseProduct(rgbScaleCoeff);
-        brdf->setSpectrum(halfThIndex, 0, diffThIndex, diffPhIndex, rgb);
-    }}}
+    return true;
+}
 
-    delete[] samples;
+bool MerlBinaryReader::readDimensions(std::istream& stream)
+{
+    const int numSamples = NUM_HALF_THETA * NUM_DIFF_THETA * NUM_DIFF_PHI / 2;
 
-    brdf->clampAngles();
-    brdf->setSourceType(MEASURED_SOURCE);
+    int dims[3] = { 0, 0, 0 };
+    stream.read(reinterpret_cast<char*>(dims), sizeof(int) * 3);
 
-    return brdf;
+    int numSamplesInFile = dims[0] * dims[1] * dims[2];
+    if (numSamplesInFile != numSamples) {
+        lbError
+            << "[MerlBinaryReader::readDimensions] Dimensions do not match: "
+            << numSamplesInFile << ", " << numSamples;
+        return false;
+    }
+
+    return true;
+}
+
+float MerlBinaryReader::computeHalfTheta(int index)
+{
+    float halfThetaDegree = static_cast<float>(index * index) / NUM_HALF_THETA;
+    return clamp(toRadian(halfThetaDegree),
+                 HalfDifferenceCoordinateSystem::MIN_ANGLE0,
+                 HalfDifferenceCoordinateSystem::MAX_ANGLE0);
 }
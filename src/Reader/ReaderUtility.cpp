@@ -8,12 +8,21 @@
 
 #include <libbsdf/Reader/ReaderUtility.h>
 
+#include <algorithm>
 #include <fstream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <libbsdf/Common/SpecularCoordinateSystem.h>
 #include <libbsdf/Reader/AstmReader.h>
+#include <libbsdf/Reader/BinaryReader.h>
 #include <libbsdf/Reader/DdrReader.h>
 #include <libbsdf/Reader/LightToolsBsdfReader.h>
 #include <libbsdf/Reader/MerlBinaryReader.h>
+#include <libbsdf/Reader/SdrReader.h>
+#include <libbsdf/Reader/Tokenizer.h>
 #include <libbsdf/Reader/ZemaxBsdfReader.h>
 
 using namespace lb;
@@ -71,6 +80,103 @@ std::istream& reader_utility::safeGetline(std::istream& stream, std::string& tok
     }
 }
 
+bool reader_utility::readFile(const std::string& fileName, std::vector<char>* buffer)
+{
+    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
+    if (ifs.fail()) return false;
+
+    ifs.seekg(0, std::ios_base::end);
+    std::streamoff fileSize = ifs.tellg();
+    ifs.seekg(0, std::ios_base::beg);
+    if (fileSize < 0) return false;
+
+    buffer->resize(static_cast<size_t>(fileSize) + 1);
+    ifs.read(buffer->data(), fileSize);
+    buffer->back() = '\0';
+
+    return (ifs.gcount() == fileSize);
+}
+
+bool reader_utility::readFile(const std::string&  fileName,
+                              std::vector<char>*  buffer,
+                              size_t              maxSize,
+                              bool*               truncated)
+{
+    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
+    if (ifs.fail()) return false;
+
+    ifs.seekg(0, std::ios_base::end);
+    std::streamoff fileSize = ifs.tellg();
+    ifs.seekg(0, std::ios_base::beg);
+    if (fileSize < 0) return false;
+
+    *truncated = (static_cast<size_t>(fileSize) > maxSize);
+    std::streamoff readSize = *truncated ? static_cast<std::streamoff>(maxSize) : fileSize;
+
+    buffer->resize(static_cast<size_t>(readSize) + 1);
+    ifs.read(buffer->data(), readSize);
+    buffer->back() = '\0';
+
+    return (ifs.gcount() == readSize);
+}
+
+bool reader_utility::readFileHead(const std::string&                            fileName,
+                                  const char*                                   commentHead,
+                                  const std::function<bool(const Tokenizer&)>&  isEndLine,
+                                  std::vector<char>*                            buffer,
+                                  size_t*                                       headerSize)
+{
+    const char* headerEnd = 0;
+    for (size_t maxSize = 64 * 1024; !headerEnd; maxSize *= 2) {
+        bool truncated;
+        if (!readFile(fileName, buffer, maxSize, &truncated)) return false;
+
+        const char* last = buffer->data() + buffer->size() - 1;
+        const char* lineBegin = buffer->data();
+        while (lineBegin < last && !headerEnd) {
+            const char* lineEnd = std::find(lineBegin, last, '\n');
+
+            // An incomplete line at the end of the loaded part is not examined.
+            if (lineEnd == last && truncated) break;
+
+            Tokenizer lineTokenizer(lineBegin, lineEnd, commentHead);
+            if (lineTokenizer.next() && isEndLine(lineTokenizer)) {
+                headerEnd = lineBegin;
+            }
+
+            lineBegin = lineEnd + 1;
+        }
+
+        if (!truncated && !headerEnd) {
+            headerEnd = last;
+        }
+    }
+
+    *headerSize = headerEnd - buffer->data();
+
+    return true;
+}
+
+bool reader_utility::readAngles(Tokenizer* tokenizer, std::vector<float>* angles)
+{
+    int numAngles;
+    if (!tokenizer->readInt(&numAngles) || numAngles < 0) {
+        lbError << "[reader_utility::readAngles] Invalid number of angles: " << tokenizer->getToken();
+        return false;
+    }
+
+    for (int i = 0; i < numAngles; ++i) {
+        float angle;
+        if (!tokenizer->readFloat(&angle)) {
+            lbError << "[reader_utility::readAngles] Invalid angle: " << tokenizer->getToken();
+            return false;
+        }
+        angles->push_back(angle);
+    }
+
+    return true;
+}
+
 bool reader_utility::hasSuffix(const std::string &fileName, const std::string &suffix)
 {
     if (fileName.size() >= suffix.size()) {
@@ -81,6 +187,27 @@ bool reader_utility::hasSuffix(const std::string &fileName, const std::string &s
     }
 }
 
+Arrayf reader_utility::computeSpecPhiAngles(const std::vector<float>& degrees, bool planeSymmetrical)
+{
+    const float minAngle = SpecularCoordinateSystem::MIN_ANGLE3;
+    const float maxAngle = SpecularCoordinateSystem::MAX_ANGLE3;
+
+    int numDegrees = static_cast<int>(degrees.size());
+    int numAngles = planeSymmetrical ? numDegrees + (numDegrees - 1) : numDegrees;
+
+    Arrayf angles(numAngles);
+    for (int i = 0; i < numDegrees; ++i) {
+        angles[i] = clamp(toRadian(degrees.at(i)), minAngle, maxAngle);
+    }
+
+    // Copy symmetrical angles.
+    for (int i = numDegrees, reverseIndex = numDegrees - 2; i < numAngles; ++i, --reverseIndex) {
+        angles[i] = clamp(PI_F + (PI_F - angles[reverseIndex]), minAngle, maxAngle);
+    }
+
+    return angles;
+}
+
 FileType reader_utility::classifyFile(const std::string& fileName)
 {
     // std::ios_base::binary is used to read line endings of CR+LF and LF.
@@ -132,6 +259,9 @@ FileType reader_utility::classifyFile(const std::string& fileName)
     else if (hasSuffix(name, ".binary")) {
         return MERL_BINARY_FILE;
     }
+    else if (hasSuffix(name, ".lbb")) {
+        return LIBBSDF_BINARY_FILE;
+    }
 
     return UNKNOWN_FILE;
 }
@@ -166,6 +296,8 @@ std::shared_ptr<Brdf> reader_utility::read(const std::string&   fileName,
         case lb::LIGHTTOOLS_FILE: {
             std::unique_ptr<TwoSidedMaterial> material;
             material.reset(LightToolsBsdfReader::read(fileName));
+            if (!material) break;
+
             std::shared_ptr<Brdf> fBrdf = material->getFrontMaterial()->getBsdf()->getBrdf();
             std::shared_ptr<Btdf> fBtdf = material->getFrontMaterial()->getBsdf()->getBtdf();
             std::shared_ptr<Brdf> bBrdf = material->getBackMaterial()->getBsdf()->getBrdf();
@@ -184,6 +316,9 @@ std::shared_ptr<Brdf> reader_utility::read(const std::string&   fileName,
         case lb::ZEMAX_FILE:
             brdf.reset(ZemaxBsdfReader::read(fileName, dataType));
             break;
+        case lb::LIBBSDF_BINARY_FILE:
+            brdf.reset(BinaryReader::read(fileName, dataType));
+            break;
         default:
             lbError << "[reader_utility::read] Unsupported file type: " << fileType;
             return nullptr;
@@ -191,3 +326,93 @@ std::shared_ptr<Brdf> reader_utility::read(const std::string&   fileName,
 
     return brdf;
 }
+
+std::vector<reader_utility::ReadResult> reader_utility::readAll(const std::vector<std::string>&    fileNames,
+                                                                int                                 numThreads)
+{
+    int numFiles = static_cast<int>(fileNames.size());
+    std::vector<ReadResult> results(numFiles);
+    if (numFiles == 0) return results;
+
+#ifdef _OPENMP
+    if (numThreads <= 0) {
+        numThreads = omp_get_max_threads();
+    }
+#else
+    numThreads = 1;
+#endif
+
+    // Threads are not more than files. A single file is read outside of a team, so the reader can use threads.
+    numThreads = std::min(numThreads, numFiles);
+
+    // Readers switch off the synchronization with stdio. It is done before concurrent calls.
+    // lb::Log serializes messages, so std::cout is not written concurrently.
+    std::ios_base::sync_with_stdio(false);
+
+    #pragma omp parallel for schedule(dynamic) num_threads(numThreads)
+    for (int i = 0; i < numFiles; ++i) {
+        const std::string& fileName = fileNames[i];
+        ReadResult& result = results[i];
+
+        std::ifstream ifs(fileName.c_str());
+        if (ifs.fail()) {
+            result.errorMessage = "Could not open: " + fileName;
+            continue;
+        }
+        ifs.close();
+
+        result.brdf = read(fileName, &result.fileType, &result.dataType);
+        if (!result.brdf) {
+            if (result.fileType == UNKNOWN_FILE) {
+                result.errorMessage = "Unsupported file type: " + fileName;
+            }
+            else {
+                result.errorMessage = "Failed to load: " + fileName;
+            }
+        }
+    }
+
+    return results;
+}
+
+bool reader_utility::readInfo(const std::string& fileName, FileInfo* info)
+{
+    FileType fileType = reader_utility::classifyFile(fileName);
+
+    bool succeeded;
+    switch (fileType) {
+        case ASTM_FILE:
+            succeeded = AstmReader::readInfo(fileName, info);
+            break;
+        case INTEGRA_DDR_FILE:
+        case INTEGRA_DDT_FILE:
+            succeeded = DdrReader::readInfo(fileName, info);
+            info->dataType = (fileType == INTEGRA_DDR_FILE) ? BRDF_DATA : BTDF_DATA;
+            break;
+        case INTEGRA_SDR_FILE:
+        case INTEGRA_SDT_FILE:
+            succeeded = SdrReader::readInfo(fileName, info);
+            info->dataType = (fileType == INTEGRA_SDR_FILE) ? SPECULAR_REFLECTANCE_DATA
+                                                            : SPECULAR_TRANSMITTANCE_DATA;
+            break;
+        case LIGHTTOOLS_FILE:
+            succeeded = LightToolsBsdfReader::readInfo(fileName, info);
+            break;
+        case MERL_BINARY_FILE:
+            succeeded = MerlBinaryReader::readInfo(fileName, info);
+            break;
+        case ZEMAX_FILE:
+            succeeded = ZemaxBsdfReader::readInfo(fileName, info);
+            break;
+        case LIBBSDF_BINARY_FILE:
+            succeeded = BinaryReader::readInfo(fileName, info);
+            break;
+        default:
+            lbError << "[reader_utility::readInfo] Unsupported file type: " << fileType;
+            return false;
+    }
+
+    info->fileType = fileType;
+
+    return succeeded;
+}
@@ -10,6 +10,7 @@
 
 #include <fstream>
 
+#include <libbsdf/Common/SphericalCoordinateSystem.h>
 #include <libbsdf/Reader/DdrSdrUtility.h>
 
 using namespace lb;
@@ -25,95 +26,19 @@ SampleSet2D* SdrReader::read(const std::string& fileName)
 
     std::ios_base::sync_with_stdio(false);
 
-    SourceType sourceType = UNKNOWN_SOURCE;
-    ColorModel colorModel = RGB_MODEL;
+    Header header;
+    if (!readHeader(ifs, &header)) return 0;
 
-    int numWavelengths = 1;
-    std::vector<float> inThetaDegrees;
-
-    ddr_sdr_utility::ignoreCommentLines(ifs);
-    std::ifstream::pos_type pos = ifs.tellg();
-
-    // Read a header.
-    std::string headStr;
-    while (ifs >> headStr) {
-        ddr_sdr_utility::ignoreCommentLines(ifs);
-
-        if (headStr.empty()) {
-            continue;
-        }
-        else if (headStr == "Source") {
-            std::string typeStr;
-            ifs >> typeStr;
-
-            if (typeStr == "Measured") {
-                sourceType = MEASURED_SOURCE;
-            }
-            else if (typeStr == "Generated") {
-                sourceType = GENERATED_SOURCE;
-            }
-            else if (typeStr == "Edited") {
-                sourceType = EDITED_SOURCE;
-            }
-            else if (typeStr == "Morphed") {
-                sourceType = UNKNOWN_SOURCE;
-            }
-            else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-            }
-        }
-        else if (headStr == "TypeColorModel") {
-            std::string typeStr;
-            ifs >> typeStr;
-            typeStr = reader_utility::toLower(typeStr);
-
-            if (typeStr == "rgb") {
-                colorModel = RGB_MODEL;
-            }
-            else if (typeStr == "spectral") {
-                colorModel = SPECTRAL_MODEL;
-                ifs >> numWavelengths;
-            }
-            else if (typeStr == "bw") {
-                colorModel = MONOCHROMATIC_MODEL;
-            }
-            else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-                return 0;
-            }
-        }
-        else if (headStr == "sigma") {
-            int numInTheta;
-            ifs >> numInTheta;
-            for (int i = 0; i < numInTheta; ++i) {
-                float angle;
-                ifs >> angle;
-                inThetaDegrees.push_back(angle);
-            }
-        }
-        else if (reader_utility::toLower(headStr) == "wl" ||
-                 reader_utility::toLower(headStr) == "bw" ||
-                 reader_utility::toLower(headStr) == "red" ||
-                 reader_utility::toLower(headStr) == "gre" ||
-                 reader_utility::toLower(headStr) == "blu") {
-            ifs.seekg(pos, std::ios_base::beg);
-            break;
-        }
-
-        pos = ifs.tellg();
-    }
-
-    if (inThetaDegrees.empty()) {
-        lbError << "[SdrReader::read] Invalid format.";
-        return 0;
-    }
+    const std::vector<float>& inThetaDegrees = header.inThetaDegrees;
+    ColorModel colorModel = header.colorModel;
+    int numWavelengths = header.numWavelengths;
 
     int numInTheta = static_cast<int>(inThetaDegrees.size());
 
     // Initialize the array of reflectance.
     SampleSet2D* ss2 = new SampleSet2D(numInTheta, 1, colorModel, numWavelengths);
 
-    ss2->setSourceType(sourceType);
+    ss2->setSourceType(header.sourceType);
 
     copyArray(inThetaDegrees, &ss2->getThetaArray());
     ss2->getThetaArray() = toRadians(ss2->getThetaArray());
@@ -180,3 +105,117 @@ SampleSet2D* SdrReader::read(const std::string& fileName)
 
     return ss2;
 }
+
+bool SdrReader::readInfo(const std::string& fileName, FileInfo* info)
+{
+    // std::ios_base::binary is used to read line endings of CR+LF and LF.
+    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
+    if (ifs.fail()) {
+        lbError << "[SdrReader::readInfo] Could not open: " << fileName;
+        return false;
+    }
+
+    Header header;
+    if (!readHeader(ifs, &header)) return false;
+
+    *info = FileInfo();
+    info->sourceType = header.sourceType;
+    info->coordinateSystem = SPHERICAL_COORDINATE_SYSTEM;
+    info->colorModel = header.colorModel;
+    info->numWavelengths = header.numWavelengths;
+
+    info->angles0.resize(header.inThetaDegrees.size());
+    copyArray(header.inThetaDegrees, &info->angles0);
+    info->angles0 = toRadians(info->angles0).cwiseMax(SphericalCoordinateSystem::MIN_ANGLE0)
+                                            .cwiseMin(SphericalCoordinateSystem::MAX_ANGLE0);
+
+    info->angles1 = Arrayf::Zero(1);
+
+    return true;
+}
+
+SdrReader::Header::Header() : sourceType(UNKNOWN_SOURCE),
+                              colorModel(RGB_MODEL),
+                              numWavelengths(1) {}
+
+bool SdrReader::readHeader(std::istream& stream, Header* header)
+{
+    ddr_sdr_utility::ignoreCommentLines(stream);
+    std::istream::pos_type pos = stream.tellg();
+
+    // Read a header.
+    std::string headStr;
+    while (stream >> headStr) {
+        ddr_sdr_utility::ignoreCommentLines(stream);
+
+        if (headStr.empty()) {
+            continue;
+        }
+        else if (headStr == "Source") {
+            std::string typeStr;
+            stream >> typeStr;
+
+            if (typeStr == "Measured") {
+                header->sourceType = MEASURED_SOURCE;
+            }
+            else if (typeStr == "Generated") {
+                header->sourceType = GENERATED_SOURCE;
+            }
+            else if (typeStr == "Edited") {
+                header->sourceType = EDITED_SOURCE;
+            }
+            else if (typeStr == "Morphed") {
+                header->sourceType = UNKNOWN_SOURCE;
+            }
+            else {
+                reader_utility::logNotImplementedKeyword(typeStr);
+            }
+        }
+        else if (headStr == "TypeColorModel") {
+            std::string typeStr;
+            stream >> typeStr;
+            typeStr = reader_utility::toLower(typeStr);
+
+            if (typeStr == "rgb") {
+                header->colorModel = RGB_MODEL;
+            }
+            else if (typeStr == "spectral") {
+                header->colorModel = SPECTRAL_MODEL;
+                stream >> header->numWavelengths;
+            }
+            else if (typeStr == "bw") {
+                header->colorModel = MONOCHROMATIC_MODEL;
+            }
+            else {
+                reader_utility::logNotImplementedKeyword(typeStr);
+                return false;
+            }
+        }
+        else if (headStr == "sigma") {
+            int numInTheta;
+            stream >> numInTheta;
+            for (int i = 0; i < numInTheta; ++i) {
+                float angle;
+                stream >> angle;
+                header->inThetaDegrees.push_back(angle);
+            }
+        }
+        else if (reader_utility::toLower(headStr) == "wl" ||
+                 reader_utility::toLower(headStr) == "bw" ||
+                 reader_utility::toLower(headStr) == "red" ||
+                 reader_utility::toLower(headStr) == "gre" ||
+                 reader_utility::toLower(headStr) == "blu") {
+            stream.seekg(pos, std::ios_base::beg);
+            break;
+        }
+
+        pos = stream.tellg();
+    }
+
+    if (header->inThetaDegrees.empty()) {
+        lbError << "[SdrReader::readHeader] Invalid format.";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,150 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Reader/Tokenizer.h>
+
+#include <cstdlib>
+#include <limits>
+
+using namespace lb;
+
+bool Tokenizer::readInt(int* value)
+{
+    if (!next()) return false;
+
+    const char* c = tokenBegin_;
+    bool negative = (*c == '-');
+    if (*c == '-' || *c == '+') {
+        ++c;
+    }
+
+    if (c == tokenEnd_) return false;
+
+    long long integer = 0;
+    for (; c != tokenEnd_; ++c) {
+        if (*c < '0' || *c > '9') return false;
+
+        integer = integer * 10 + (*c - '0');
+        if (integer > std::numeric_limits<int>::max()) return false;
+    }
+
+    *value = static_cast<int>(negative ? -integer : integer);
+    return true;
+}
+
+bool Tokenizer::parseFloat(const char* first, const char* last, float* value)
+{
+    // Powers of ten exactly representable in a float.
+    static const float powers[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+    bool negative;
+    unsigned long long mantissa;
+    int exponent;
+    if (parseDecimal(first, last, &negative, &mantissa, &exponent) &&
+        mantissa <= (1ULL << 24) &&
+        exponent >= -10 && exponent <= 10) {
+        // The result is correctly rounded since both operands are exact.
+        float v = static_cast<float>(mantissa);
+        v = (exponent < 0) ? v / powers[-exponent] : v * powers[exponent];
+        *value = negative ? -v : v;
+        return true;
+    }
+
+    char* end;
+    *value = std::strtof(first, &end);
+
+    // An empty range is not a number although nothing is left.
+    return (end != first && end == last);
+}
+
+bool Tokenizer::parseDouble(const char* first, const char* last, double* value)
+{
+    // Powers of ten exactly representable in a double.
+    static const double powers[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                     1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                     1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    bool negative;
+    unsigned long long mantissa;
+    int exponent;
+    if (parseDecimal(first, last, &negative, &mantissa, &exponent) &&
+        mantissa <= (1ULL << 53) &&
+        exponent >= -22 && exponent <= 22) {
+        double v = static_cast<double>(mantissa);
+        v = (exponent < 0) ? v / powers[-exponent] : v * powers[exponent];
+        *value = negative ? -v : v;
+        return true;
+    }
+
+    char* end;
+    *value = std::strtod(first, &end);
+
+    // An empty range is not a number although nothing is left.
+    return (end != first && end == last);
+}
+
+bool Tokenizer::parseDecimal(const char*            first,
+                             const char*            last,
+                             bool*                  negative,
+                             unsigned long long*    mantissa,
+                             int*                   exponent)
+{
+    const char* c = first;
+
+    *negative = (c != last && *c == '-');
+    if (c != last && (*c == '-' || *c == '+')) {
+        ++c;
+    }
+
+    *mantissa = 0;
+    *exponent = 0;
+
+    int numDigits = 0;
+    int numSignificantDigits = 0;
+
+    for (; c != last && *c >= '0' && *c <= '9'; ++c, ++numDigits) {
+        if (*mantissa != 0 || *c != '0') {
+            if (++numSignificantDigits > 19) return false;
+        }
+        *mantissa = *mantissa * 10 + (*c - '0');
+    }
+
+    if (c != last && *c == '.') {
+        ++c;
+        for (; c != last && *c >= '0' && *c <= '9'; ++c, ++numDigits) {
+            if (*mantissa != 0 || *c != '0') {
+                if (++numSignificantDigits > 19) return false;
+            }
+            *mantissa = *mantissa * 10 + (*c - '0');
+            --*exponent;
+        }
+    }
+
+    if (numDigits == 0) return false;
+
+    if (c != last && (*c == 'e' || *c == 'E')) {
+        ++c;
+
+        bool negativeExponent = (c != last && *c == '-');
+        if (c != last && (*c == '-' || *c == '+')) {
+            ++c;
+        }
+
+        if (c == last) return false;
+
+        int exp = 0;
+        for (; c != last && *c >= '0' && *c <= '9'; ++c) {
+            if (exp > 10000) return false;
+            exp = exp * 10 + (*c - '0');
+        }
+
+        *exponent += negativeExponent ? -exp : exp;
+    }
+
+    return (c == last);
+}
@@ -8,162 +8,41 @@
 
 #include <libbsdf/Reader/ZemaxBsdfReader.h>
 
-#include <fstream>
-#include <set>
+#include <libbsdf/Reader/Tokenizer.h>
 
 using namespace lb;
 
 SpecularCoordinatesBrdf* ZemaxBsdfReader::read(const std::string& fileName, DataType* dataType)
 {
-    // std::ios_base::binary is used to read line endings of CR+LF and LF.
-    std::ifstream ifs(fileName.c_str(), std::ios_base::binary);
-    if (ifs.fail()) {
+    std::vector<char> buffer;
+    if (!reader_utility::readFile(fileName, &buffer)) {
         lbError << "[ZemaxBsdfReader::read] Could not open: " << fileName;
         return 0;
     }
 
-    std::ios_base::sync_with_stdio(false);
+    // The terminating '\0' is excluded.
+    Tokenizer tokenizer(buffer.data(), buffer.data() + buffer.size() - 1, "#");
 
-    SymmetryType symmetryType = UNKNOWN_SYMMETRY;
-    ColorModel colorModel = UNKNOWN_MODEL;
+    Header header;
+    if (!readHeader(&tokenizer, &header)) return 0;
 
-    std::vector<float> inThetaDegrees;
-    std::vector<float> inPhiDegrees;
-    std::vector<float> spThetaDegrees;
-    std::vector<float> spPhiDegrees;
+    const std::vector<float>& inThetaDegrees  = header.inThetaDegrees;
+    const std::vector<float>& inPhiDegrees    = header.inPhiDegrees;
+    const std::vector<float>& spThetaDegrees  = header.spThetaDegrees;
+    const std::vector<float>& spPhiDegrees    = header.spPhiDegrees;
 
-    int numChannels = 1;
+    SymmetryType symmetryType = header.symmetryType;
+    *dataType = header.dataType;
 
-    ignoreCommentLines(ifs);
-    std::ifstream::pos_type pos = ifs.tellg();
-
-    // Read a header.
-    std::string headStr;
-    while (ifs >> headStr) {
-        ignoreCommentLines(ifs);
-
-        if (headStr.empty()) {
-            continue;
-        }
-        else if (headStr == "Symmetry") {
-            std::string typeStr;
-            ifs >> typeStr;
-
-            if (typeStr == "PlaneSymmetrical") {
-                symmetryType = PLANE_SYMMETRICAL;
-            }
-            else if (typeStr == "Asymmetrical") {
-                symmetryType = ASYMMETRICAL;
-            }
-            else if (typeStr == "ASymmetrical4D") {
-                symmetryType = ASYMMETRICAL_4D;
-            }
-            else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-                return 0;
-            }
-        }
-        else if (headStr == "SpectralContent") {
-            std::string typeStr;
-            ifs >> typeStr;
-
-            if (typeStr == "Monochrome") {
-                colorModel = MONOCHROMATIC_MODEL;
-                numChannels = 1;
-            }
-            else if (typeStr == "XYZ") {
-                colorModel = XYZ_MODEL;
-                numChannels = 3;
-            }
-            else {
-                reader_utility::logNotImplementedKeyword(typeStr);
-                return 0;
-            }
-        }
-        else if (headStr == "ScatterType") {
-            std::string scatterStr;
-            ifs >> scatterStr;
-
-            if (scatterStr == "BRDF") {
-                *dataType = BRDF_DATA;
-            }
-            else if (scatterStr == "BTDF") {
-                *dataType = BTDF_DATA;
-            }
-            else {
-                reader_utility::logNotImplementedKeyword(scatterStr);
-                return 0;
-            }
-        }
-        else if (headStr == "SampleRotation") {
-            int numInPhi;
-            ifs >> numInPhi;
-            for (int i = 0; i < numInPhi; ++i) {
-                float angle;
-                ifs >> angle;
-                inPhiDegrees.push_back(angle);
-            }
-        }
-        else if (headStr == "AngleOfIncidence") {
-            int numInTheta;
-            ifs >> numInTheta;
-            for (int i = 0; i < numInTheta; ++i) {
-                float angle;
-                ifs >> angle;
-                inThetaDegrees.push_back(angle);
-            }
-        }
-        else if (headStr == "ScatterAzimuth") {
-            int numSpPhi;
-            ifs >> numSpPhi;
-            for (int i = 0; i < numSpPhi; ++i) {
-                float angle;
-                ifs >> angle;
-                spPhiDegrees.push_back(angle);
-            }
-        }
-        else if (headStr == "ScatterRadial") {
-            int numSpTheta;
-            ifs >> numSpTheta;
-            for (int i = 0; i < numSpTheta; ++i) {
-                float angle;
-                ifs >> angle;
-                spThetaDegrees.push_back(angle);
-            }
-        }
-        else if (headStr == "Monochrome" ||
-                 headStr == "TristimulusX" ||
-                 headStr == "TristimulusY" ||
-                 headStr == "TristimulusZ") {
-            ifs.seekg(pos, std::ios_base::beg);
-            break;
-        }
-
-        pos = ifs.tellg();
-    }
-
-    if (inThetaDegrees.empty() ||
-        spThetaDegrees.empty() ||
-        spPhiDegrees.empty()) {
-        lbError << "[ZemaxBsdfReader::read] Invalid format.";
-        return 0;
-    }
-
-    if (inPhiDegrees.empty()) {
-        inPhiDegrees.push_back(0.0f);
-    }
-
-    size_t numSpecPhi = spPhiDegrees.size();
-    if (symmetryType == PLANE_SYMMETRICAL) {
-        numSpecPhi = spPhiDegrees.size() + (spPhiDegrees.size() - 1);
-    }
+    Arrayf specPhiAngles = reader_utility::computeSpecPhiAngles(spPhiDegrees,
+                                                                symmetryType == PLANE_SYMMETRICAL);
 
     // Initialize BRDF.
     SpecularCoordinatesBrdf* brdf = new SpecularCoordinatesBrdf(static_cast<int>(inThetaDegrees.size()),
                                                                 static_cast<int>(inPhiDegrees.size()),
                                                                 static_cast<int>(spThetaDegrees.size()),
-                                                                static_cast<int>(numSpecPhi),
-                                                                colorModel);
+                                                                static_cast<int>(specPhiAngles.size()),
+                                                                header.colorModel);
     SampleSet* ss = brdf->getSampleSet();
 
     copyArray(inThetaDegrees, &ss->getAngles0());
@@ -174,77 +53,259 @@ SpecularCoordinatesBrdf* ZemaxBsdfReader::read(const std::string& fileName, Data
     ss->getAngles1() = toRadians(ss->getAngles1());
     ss->getAngles2() = toRadians(ss->getAngles2());
 
-    for (int i = 0; i < static_cast<int>(spPhiDegrees.size()); ++i) {
-        brdf->setSpecPhi(i, toRadian(spPhiDegrees.at(i)));
+    for (int i = 0; i < specPhiAngles.size(); ++i) {
+        brdf->setSpecPhi(i, specPhiAngles[i]);
     }
 
-    // Copy symmetrical angles.
-    if (symmetryType == PLANE_SYMMETRICAL) {
-        int numSpecPhiDegrees = static_cast<int>(spPhiDegrees.size());
-        for (int i = numSpecPhiDegrees, reverseIndex = numSpecPhiDegrees - 2;
-             i < brdf->getNumSpecPhi();
-             ++i, --reverseIndex) {
-            brdf->setSpecPhi(i, PI_F + (PI_F - brdf->getSpecPhi(reverseIndex)));
-        }
-    }
+    // Find data blocks. The position of values is recorded for each pair of a channel and an incoming direction.
+    int numInTheta = static_cast<int>(inThetaDegrees.size());
+    int numInDirs = numInTheta * static_cast<int>(inPhiDegrees.size());
+    int numChannels = ss->getNumWavelengths();
+    size_t numValues = spThetaDegrees.size() * spPhiDegrees.size();
+
+    std::vector<const char*> blockPositions(numInDirs * numChannels, 0);
 
-    // Read data.
     int wlIndex = 0;
     int cntTis = 0;
-    std::string dataStr;
-    while (ifs >> dataStr) {
-        ignoreCommentLines(ifs);
-
-        if (dataStr.empty()) {
-            continue;
-        }
-        else if (dataStr == "Monochrome" ||
-                 dataStr == "TristimulusX") {
+    while (tokenizer.next()) {
+        if (tokenizer.isToken("Monochrome") ||
+            tokenizer.isToken("TristimulusX")) {
             wlIndex = 0;
             cntTis = 0;
         }
-        else if (dataStr == "TristimulusY") {
+        else if (tokenizer.isToken("TristimulusY")) {
             wlIndex = 1;
             cntTis = 0;
         }
-        else if (dataStr == "TristimulusZ") {
+        else if (tokenizer.isToken("TristimulusZ")) {
             wlIndex = 2;
             cntTis = 0;
         }
-        else if (dataStr == "TIS") {
-            reader_utility::ignoreLine(ifs);
-
-            int inPhIndex = cntTis / static_cast<int>(inThetaDegrees.size());
-            int inThIndex = cntTis - static_cast<int>(inThetaDegrees.size()) * inPhIndex;
+        else if (tokenizer.isToken("TIS")) {
+            tokenizer.skipLine();
 
-            for (int spPhIndex = 0; spPhIndex < static_cast<int>(spPhiDegrees.size());   ++spPhIndex) {
-            for (int spThIndex = 0; spThIndex < static_cast<int>(spThetaDegrees.size()); ++spThIndex) {
-                std::string brdfValueStr;
-                ifs >> brdfValueStr;
-                float brdfValue = static_cast<float>(std::atof(brdfValueStr.c_str()));
-
-                Spectrum& sp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
-                sp[wlIndex] = brdfValue;
+            if (wlIndex >= numChannels || cntTis >= numInDirs) {
+                lbError << "[ZemaxBsdfReader::read] Invalid format. Data blocks exceed the header.";
+                delete brdf;
+                return 0;
+            }
 
-                if (symmetryType == PLANE_SYMMETRICAL) {
-                    int symmetryIndex = (brdf->getNumSpecPhi() - 1) - spPhIndex;
-                    Spectrum& symmetrySp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, symmetryIndex);
-                    symmetrySp[wlIndex] = brdfValue;
+            // Values are skipped and parsed later.
+            blockPositions.at(cntTis + numInDirs * wlIndex) = tokenizer.getPosition();
+            for (size_t i = 0; i < numValues; ++i) {
+                if (!tokenizer.next()) {
+                    lbError << "[ZemaxBsdfReader::read] Invalid format. Values are not enough.";
+                    delete brdf;
+                    return 0;
                 }
-            }}
+            }
 
             ++cntTis;
         }
+    }
+
+    // The values of blocks are parsed concurrently into the samples of the BRDF.
+    const char* bufferEnd = buffer.data() + buffer.size() - 1;
+    int numBlocks = static_cast<int>(blockPositions.size());
+    int numFailedBlocks = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:numFailedBlocks)
+    for (int i = 0; i < numBlocks; ++i) {
+        if (!blockPositions[i]) continue;
+
+        int inDirIndex = i % numInDirs;
+        int inPhIndex = inDirIndex / numInTheta;
+        int inThIndex = inDirIndex - numInTheta * inPhIndex;
 
-        if (ifs.fail()) {
-            lbError << "[ZemaxBsdfReader::read] Invalid format. Head of line: " << dataStr;
-            delete brdf;
-            return 0;
+        Tokenizer blockTokenizer(blockPositions[i], bufferEnd, "#");
+        if (!readValues(&blockTokenizer, brdf, inThIndex, inPhIndex, i / numInDirs,
+                        symmetryType, static_cast<int>(spPhiDegrees.size()))) {
+            ++numFailedBlocks;
         }
     }
 
+    if (numFailedBlocks > 0) {
+        delete brdf;
+        return 0;
+    }
+
     brdf->clampAngles();
     brdf->setSourceType(MEASURED_SOURCE);
 
     return brdf;
 }
+
+bool ZemaxBsdfReader::readInfo(const std::string& fileName, FileInfo* info)
+{
+    // The header ends at the first line beginning with the keyword of a color channel.
+    std::vector<char> buffer;
+    size_t headerSize;
+    if (!reader_utility::readFileHead(fileName, "#", isChannelKeyword, &buffer, &headerSize)) {
+        lbError << "[ZemaxBsdfReader::readInfo] Could not open: " << fileName;
+        return false;
+    }
+
+    Tokenizer tokenizer(buffer.data(), buffer.data() + headerSize, "#");
+
+    Header header;
+    if (!readHeader(&tokenizer, &header)) return false;
+
+    *info = FileInfo();
+    info->dataType = header.dataType;
+    info->sourceType = MEASURED_SOURCE;
+    info->coordinateSystem = SPECULAR_COORDINATE_SYSTEM;
+    info->colorModel = header.colorModel;
+
+    if (header.colorModel == MONOCHROMATIC_MODEL) {
+        info->numWavelengths = 1;
+    }
+    else if (header.colorModel == XYZ_MODEL) {
+        info->numWavelengths = 3;
+    }
+
+    info->angles0.resize(header.inThetaDegrees.size());
+    info->angles1.resize(header.inPhiDegrees.size());
+    info->angles2.resize(header.spThetaDegrees.size());
+
+    copyArray(header.inThetaDegrees, &info->angles0);
+    copyArray(header.inPhiDegrees,   &info->angles1);
+    copyArray(header.spThetaDegrees, &info->angles2);
+
+    info->angles0 = toRadians(info->angles0).cwiseMax(SpecularCoordinateSystem::MIN_ANGLE0)
+                                            .cwiseMin(SpecularCoordinateSystem::MAX_ANGLE0);
+    info->angles1 = toRadians(info->angles1).cwiseMax(SpecularCoordinateSystem::MIN_ANGLE1)
+                                            .cwiseMin(SpecularCoordinateSystem::MAX_ANGLE1);
+    info->angles2 = toRadians(info->angles2).cwiseMax(SpecularCoordinateSystem::MIN_ANGLE2)
+                                            .cwiseMin(SpecularCoordinateSystem::MAX_ANGLE2);
+    info->angles3 = reader_utility::computeSpecPhiAngles(header.spPhiDegrees,
+                                                         header.symmetryType == PLANE_SYMMETRICAL);
+
+    return true;
+}
+
+ZemaxBsdfReader::Header::Header() : symmetryType(UNKNOWN_SYMMETRY),
+                                    colorModel(UNKNOWN_MODEL),
+                                    dataType(UNKNOWN_DATA) {}
+
+bool ZemaxBsdfReader::readHeader(Tokenizer* tokenizer, Header* header)
+{
+    // Read a header.
+    while (tokenizer->next()) {
+        if (tokenizer->isToken("Symmetry")) {
+            tokenizer->next();
+
+            if (tokenizer->isToken("PlaneSymmetrical")) {
+                header->symmetryType = PLANE_SYMMETRICAL;
+            }
+            else if (tokenizer->isToken("Asymmetrical")) {
+                header->symmetryType = ASYMMETRICAL;
+            }
+            else if (tokenizer->isToken("ASymmetrical4D")) {
+                header->symmetryType = ASYMMETRICAL_4D;
+            }
+            else {
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
+            }
+        }
+        else if (tokenizer->isToken("SpectralContent")) {
+            tokenizer->next();
+
+            if (tokenizer->isToken("Monochrome")) {
+                header->colorModel = MONOCHROMATIC_MODEL;
+            }
+            else if (tokenizer->isToken("XYZ")) {
+                header->colorModel = XYZ_MODEL;
+            }
+            else {
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
+            }
+        }
+        else if (tokenizer->isToken("ScatterType")) {
+            tokenizer->next();
+
+            if (tokenizer->isToken("BRDF")) {
+                header->dataType = BRDF_DATA;
+            }
+            else if (tokenizer->isToken("BTDF")) {
+                header->dataType = BTDF_DATA;
+            }
+            else {
+                reader_utility::logNotImplementedKeyword(tokenizer->getToken());
+                return false;
+            }
+        }
+        else if (tokenizer->isToken("SampleRotation")) {
+            if (!reader_utility::readAngles(tokenizer, &header->inPhiDegrees)) return false;
+        }
+        else if (tokenizer->isToken("AngleOfIncidence")) {
+            if (!reader_utility::readAngles(tokenizer, &header->inThetaDegrees)) return false;
+        }
+        else if (tokenizer->isToken("ScatterAzimuth")) {
+            if (!reader_utility::readAngles(tokenizer, &header->spPhiDegrees)) return false;
+        }
+        else if (tokenizer->isToken("ScatterRadial")) {
+            if (!reader_utility::readAngles(tokenizer, &header->spThetaDegrees)) return false;
+        }
+        else if (isChannelKeyword(*tokenizer)) {
+            tokenizer->setPosition(tokenizer->getTokenBegin());
+            break;
+        }
+    }
+
+    if (header->inThetaDegrees.empty() ||
+        header->spThetaDegrees.empty() ||
+        header->spPhiDegrees.empty()) {
+        lbError << "[ZemaxBsdfReader::readHeader] Invalid format.";
+        return false;
+    }
+
+    if (header->inPhiDegrees.empty()) {
+        header->inPhiDegrees.push_back(0.0f);
+    }
+
+    return true;
+}
+
+bool ZemaxBsdfReader::readValues(Tokenizer*                 tokenizer,
+                                 SpecularCoordinatesBrdf*   brdf,
+                                 int                        inThIndex,
+                                 int                        inPhIndex,
+                                 int                        wlIndex,
+                                 SymmetryType               symmetryType,
+                                 int                        numSpecPhiDegrees)
+{
+    int numSpTheta = brdf->getNumSpecTheta();
+
+    for (int spPhIndex = 0; spPhIndex < numSpecPhiDegrees; ++spPhIndex) {
+    for (int spThIndex = 0; spThIndex < numSpTheta;        ++spThIndex) {
+        double value;
+        if (!tokenizer->next() ||
+            !Tokenizer::parseDouble(tokenizer->getTokenBegin(), tokenizer->getTokenEnd(), &value)) {
+            lbError << "[ZemaxBsdfReader::read] Invalid value: " << tokenizer->getToken();
+            return false;
+        }
+
+        float brdfValue = static_cast<float>(value);
+
+        SpectrumMap sp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
+        sp[wlIndex] = brdfValue;
+
+        if (symmetryType == PLANE_SYMMETRICAL) {
+            int symmetryIndex = (brdf->getNumSpecPhi() - 1) - spPhIndex;
+            SpectrumMap symmetrySp = brdf->getSpectrum(inThIndex, inPhIndex, spThIndex, symmetryIndex);
+            symmetrySp[wlIndex] = brdfValue;
+        }
+    }}
+
+    return true;
+}
+
+bool ZemaxBsdfReader::isChannelKeyword(const Tokenizer& tokenizer)
+{
+    return (tokenizer.isToken("Monochrome") ||
+            tokenizer.isToken("TristimulusX") ||
+            tokenizer.isToken("TristimulusY") ||
+            tokenizer.isToken("TristimulusZ"));
+}
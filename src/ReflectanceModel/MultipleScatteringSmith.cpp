@@ -8,8 +8,15 @@
 
 #include <libbsdf/ReflectanceModel/MultipleScatteringSmith.h>
 
+#include <cstring>
+#include <limits>
+
+#include <libbsdf/Common/Xorshift.h>
+
 using namespace lb;
 
+namespace lb {
+
 /* Abstract class for height distribution */
 class MicrosurfaceHeight
 {
@@ -292,6 +299,8 @@ public:
     virtual float evalSingleScattering(const Vec3f& wi, const Vec3f& wo) const;
 };
 
+} // namespace lb
+
 //
 // Implementation
 //
@@ -299,7 +308,6 @@ public:
 #include <cfloat>
 #include <cmath>
 #include <algorithm>
-#include <random>
 using namespace std;
 
 #ifndef M_PI
@@ -325,13 +333,43 @@ static bool IsFiniteNumber(float x)
     return (x <= FLT_MAX && x >= -FLT_MAX);
 }
 
-static std::random_device rd;
-static std::mt19937 gen(rd());
-static std::uniform_real_distribution<> dis(0, 1);
+// The generator of each thread. It is seeded for each evaluation, so results do not depend on threads.
+static thread_local Xorshift generator;
 
 static float generateRandomNumber()
 {
-    return (float)dis(gen);
+    return generator.next<float>();
+}
+
+// Mixes the bits of a hash value (the finalizer of MurmurHash3).
+static uint32_t mixHash(uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// Seeds the generator of the calling thread with a pair of directions.
+static void seedGenerator(const Vec3f& wi, const Vec3f& wo)
+{
+    uint32_t bits[6];
+    std::memcpy(bits,     wi.data(), sizeof(float) * 3);
+    std::memcpy(bits + 3, wo.data(), sizeof(float) * 3);
+
+    uint32_t hash = 0;
+    for (int i = 0; i < 6; ++i) {
+        hash = mixHash(hash ^ bits[i]) + 0x9e3779b9;
+    }
+
+    // All words of the state are derived from the hash, so streams of nearby directions are not correlated.
+    uint32_t x = mixHash(hash);
+    uint32_t y = mixHash(x + 0x9e3779b9);
+    uint32_t z = mixHash(y + 0x9e3779b9);
+    uint32_t w = mixHash(z + 0x9e3779b9) | 1;
+    generator.setState(x, y, z, w);
 }
 
 static double erfAs(double x)
@@ -1208,6 +1246,112 @@ float MicrosurfaceDiffuse::evalSingleScattering(const Vec3f& wi, const Vec3f& wo
     return 1.0f / M_PI * max(0.0f, wm.dot(wo)) * G2_given_G1;
 }
 
+// Creates a microsurface. Returns 0 if the material type is invalid.
+static Microsurface* createMicrosurface(float                                 roughnessX,
+                                        float                                 roughnessY,
+                                        float                                 refractiveIndex,
+                                        MultipleScatteringSmith::MaterialType materialType,
+                                        MultipleScatteringSmith::HeightType   heightType,
+                                        MultipleScatteringSmith::SlopeType    slopeType)
+{
+    bool uniformHeightUsed = (heightType == MultipleScatteringSmith::UNIFORM_HEIGHT);
+    bool beckmannSlopeUsed = (slopeType == MultipleScatteringSmith::BECKMANN_SLOPE);
+
+    float alphaX = roughnessX * roughnessX;
+    float alphaY = roughnessY * roughnessY;
+
+    switch (materialType) {
+        case MultipleScatteringSmith::CONDUCTOR_MATERIAL:
+            return new MicrosurfaceConductor(uniformHeightUsed, beckmannSlopeUsed, alphaX, alphaY);
+        case MultipleScatteringSmith::DIELECTRIC_MATERIAL:
+            return new MicrosurfaceDielectric(uniformHeightUsed, beckmannSlopeUsed, alphaX, alphaY, refractiveIndex);
+        case MultipleScatteringSmith::DIFFUSE_MATERIAL:
+            return new MicrosurfaceDiffuse(uniformHeightUsed, beckmannSlopeUsed, alphaX, alphaY);
+        default:
+            lbError << "[MultipleScatteringSmith::createMicrosurface] Invalid material type: " << materialType;
+            return 0;
+    }
+}
+
+// Computes the relative standard error of the mean of samples.
+// Infinity is returned with one sample or if all samples are zero, since the error is unknown.
+static double computeRelativeError(double sum, double sqSum, int numSamples)
+{
+    if (numSamples < 2) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double mean = sum / numSamples;
+    if (mean <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double variance = std::max((sqSum - sum * mean) / (numSamples - 1), 0.0);
+    return std::sqrt(variance / numSamples) / mean;
+}
+
+// Evaluates a BSDF value with the random walks of iterations.
+// If targetError is positive, iterations are repeated until the relative standard error falls below it.
+static Vec3 evaluate(const Microsurface&    microsurface,
+                     const Vec3&            L,
+                     const Vec3&            V,
+                     const Vec3&            color,
+                     int                    numIterations,
+                     float                  targetError,
+                     int                    maxNumIterations,
+                     float*                 relativeError = 0,
+                     int*                   numUsedIterations = 0)
+{
+    Vec3f wi = L.cast<Vec3f::Scalar>();
+    Vec3f wo = V.cast<Vec3f::Scalar>();
+
+    // The random walks of all iterations use the stream of the pair of directions.
+    seedGenerator(wi, wo);
+
+    // Random walks are repeated in units of numIterations.
+    const int batchSize = std::max(numIterations, 1);
+
+    // Non-zero walks can be rare at grazing, specular, and transmitted directions. All-zero samples
+    // are accepted if the upper bound of the 95% confidence interval of the probability of
+    // non-zero walks (3 / count by the rule of three) falls below the target error.
+    const double minNumZeroIterations = (targetError > 0.0f) ? 3.0 / targetError : 0.0;
+
+    double sum = 0.0;
+    double sqSum = 0.0;
+    int count = 0;
+    double error;
+    while (true) {
+        for (int i = 0; i < batchSize; ++i) {
+            double value = microsurface.eval(wi, wo, 0);
+            sum += value;
+            sqSum += value * value;
+        }
+        count += batchSize;
+
+        error = computeRelativeError(sum, sqSum, count);
+        if (targetError <= 0.0f ||
+            error <= targetError ||
+            (sum <= 0.0 && count >= minNumZeroIterations) ||
+            count >= maxNumIterations) {
+            break;
+        }
+    }
+    double val = sum / count;
+
+    if (relativeError) {
+        *relativeError = static_cast<float>(error);
+    }
+
+    if (numUsedIterations) {
+        *numUsedIterations = count;
+    }
+
+    using std::abs;
+    using std::max;
+
+    return color * val / max(abs(V.z()), Vec3::Scalar(EPSILON_F));
+}
+
 // Interface to evaluate a BSDF value with iterations.
 Vec3 MultipleScatteringSmith::compute(const Vec3&   L,
                                       const Vec3&   V,
@@ -1220,58 +1364,98 @@ Vec3 MultipleScatteringSmith::compute(const Vec3&   L,
                                       SlopeType     slopeType,
                                       int           numIterations)
 {
-    bool uniformHeightUsed;
-    if (heightType == UNIFORM_HEIGHT) {
-        uniformHeightUsed = true;
-    }
-    else {
-        uniformHeightUsed = false;
+    std::unique_ptr<const Microsurface> microsurface(createMicrosurface(roughnessX, roughnessY, refractiveIndex,
+                                                                        materialType, heightType, slopeType));
+    if (!microsurface) {
+        return Vec3::Zero();
     }
 
-    bool beckmannSlopeUsed;
-    if (slopeType == BECKMANN_SLOPE) {
-        beckmannSlopeUsed = true;
+    return evaluate(*microsurface, L, V, color, numIterations, 0.0f, numIterations);
+}
+
+Vec3 MultipleScatteringSmith::getValue(const Vec3& inDir, const Vec3& outDir) const
+{
+    std::shared_ptr<const Microsurface> microsurface = getMicrosurface();
+    if (!microsurface) {
+        return Vec3::Zero();
     }
-    else {
-        beckmannSlopeUsed = false;
+
+    return evaluate(*microsurface, inDir, outDir, color_, numIterations_, targetError_, maxNumIterations_);
+}
+
+void MultipleScatteringSmith::getValues(const Vec3* inDirs,
+                                        const Vec3* outDirs,
+                                        size_t      numDirs,
+                                        Vec3*       values) const
+{
+    std::shared_ptr<const Microsurface> microsurface = getMicrosurface();
+    if (!microsurface) {
+        std::fill(values, values + numDirs, Vec3(Vec3::Zero()));
+        return;
     }
 
-    float alphaX = roughnessX * roughnessX;
-    float alphaY = roughnessY * roughnessY;
+    for (size_t i = 0; i < numDirs; ++i) {
+        values[i] = evaluate(*microsurface, inDirs[i], outDirs[i], color_,
+                             numIterations_, targetError_, maxNumIterations_);
+    }
+}
 
-    Microsurface* microsurface;
+void MultipleScatteringSmith::getValues(const Vec3* inDirs,
+                                        const Vec3* outDirs,
+                                        size_t      numDirs,
+                                        Vec3*       values,
+                                        float*      relativeErrors,
+                                        int*        numUsedIterations) const
+{
+    std::shared_ptr<const Microsurface> microsurface = getMicrosurface();
+    if (!microsurface) {
+        std::fill(values, values + numDirs, Vec3(Vec3::Zero()));
+        // Errors are unknown without iterations.
+        std::fill(relativeErrors, relativeErrors + numDirs, std::numeric_limits<float>::infinity());
+        if (numUsedIterations) {
+            std::fill(numUsedIterations, numUsedIterations + numDirs, 0);
+        }
+        return;
+    }
 
-    switch (materialType) {
-        case CONDUCTOR_MATERIAL:
-            microsurface = new MicrosurfaceConductor(
-                uniformHeightUsed, beckmannSlopeUsed, alphaX, alphaY);
-            break;
-        case DIELECTRIC_MATERIAL:
-            microsurface = new MicrosurfaceDielectric(
-                uniformHeightUsed, beckmannSlopeUsed, alphaX, alphaY, refractiveIndex);
-            break;
-        case DIFFUSE_MATERIAL:
-            microsurface = new MicrosurfaceDiffuse(
-                uniformHeightUsed, beckmannSlopeUsed, alphaX, alphaY);
-            break;
-        default:
-            lbError << "[MultipleScatteringSmith::compute] Invalid material type: " << materialType;
-            return Vec3::Zero();
-            break;
+    for (size_t i = 0; i < numDirs; ++i) {
+        values[i] = evaluate(*microsurface, inDirs[i], outDirs[i], color_,
+                             numIterations_, targetError_, maxNumIterations_,
+                             &relativeErrors[i],
+                             numUsedIterations ? &numUsedIterations[i] : 0);
     }
+}
 
-    double sum = 0.0;
-    for (int i = 0; i < numIterations; ++i) {
-        Vec3f wi = L.cast<Vec3f::Scalar>();
-        Vec3f wo = V.cast<Vec3f::Scalar>();
-        sum += microsurface->eval(wi, wo, 0);
+std::shared_ptr<const Microsurface> MultipleScatteringSmith::getMicrosurface() const
+{
+    MicrosurfaceParameters params;
+    params.roughnessX       = roughnessX_;
+    params.roughnessY       = roughnessY_;
+    params.refractiveIndex  = refractiveIndex_;
+    params.materialType     = materialType_;
+    params.heightType       = heightType_;
+    params.slopeType        = slopeType_;
+
+    std::shared_ptr<const MicrosurfaceCache> cache = std::atomic_load(&microsurfaceCache_);
+    if (cache && cache->params == params) {
+        return cache->microsurface;
     }
-    double val = sum / numIterations;
 
-    delete microsurface;
+    std::lock_guard<std::mutex> lock(microsurfaceMutex_);
 
-    using std::abs;
-    using std::max;
+    // Another thread may have built the microsurface while the mutex was locked.
+    cache = std::atomic_load(&microsurfaceCache_);
+    if (cache && cache->params == params) {
+        return cache->microsurface;
+    }
 
-    return color * val / max(abs(V.z()), Vec3::Scalar(EPSILON_F));
+    std::shared_ptr<MicrosurfaceCache> newCache = std::make_shared<MicrosurfaceCache>();
+    newCache->params = params;
+    newCache->microsurface.reset(createMicrosurface(roughnessX_, roughnessY_, refractiveIndex_,
+                                                    static_cast<MaterialType>(materialType_),
+                                                    static_cast<HeightType>(heightType_),
+                                                    static_cast<SlopeType>(slopeType_)));
+    std::atomic_store(&microsurfaceCache_, std::shared_ptr<const MicrosurfaceCache>(newCache));
+
+    return newCache->microsurface;
 }
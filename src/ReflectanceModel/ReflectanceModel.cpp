@@ -108,11 +108,31 @@ ReflectanceModel::Parameter& ReflectanceModel::Parameter::operator=(const Parame
     return *this;
 }
 
+void ReflectanceModel::getValues(const Vec3*    inDirs,
+                                 const Vec3*    outDirs,
+                                 size_t         numDirs,
+                                 Vec3*          values) const
+{
+    for (size_t i = 0; i < numDirs; ++i) {
+        values[i] = getValue(inDirs[i], outDirs[i]);
+    }
+}
+
 Vec3 ReflectanceModel::getBrdfValue(const Vec3& inDir, const Vec3& outDir) const
 {
     return getValue(inDir, outDir);
 }
 
+void ReflectanceModel::getBrdfValues(const Vec3*    inDirs,
+                                     const Vec3*    outDirs,
+                                     size_t         numDirs,
+                                     Vec3*          values) const
+{
+    for (size_t i = 0; i < numDirs; ++i) {
+        values[i] = getBrdfValue(inDirs[i], outDirs[i]);
+    }
+}
+
 std::string ReflectanceModel::getName() const
 {
     return "";
@@ -12,13 +12,53 @@
 
 using namespace lb;
 
+namespace {
+
+/*! The number of samples evaluated by a batched call of a reflectance model. */
+const int NUM_BLOCK_SAMPLES = 256;
+
+/*! Gets incoming and outgoing directions adjusted for a reflectance model. */
+void getModelDirections(const Brdf& brdf,
+                        int         index0,
+                        int         index1,
+                        int         index2,
+                        int         index3,
+                        DataType    dataType,
+                        Vec3*       inDir,
+                        Vec3*       outDir)
+{
+    using std::abs;
+    using std::max;
+
+    brdf.getInOutDirection(index0, index1, index2, index3, inDir, outDir);
+
+    // Adjust horizontal and downward directions.
+    const Vec3::Scalar epsilon = Vec3::Scalar(0.001);
+    inDir->z()  = max(inDir->z(),  epsilon);
+    outDir->z() = max(outDir->z(), epsilon);
+
+    // Adjust a downward outgoing direction along the Z-axis.
+    if (abs(outDir->x()) <= epsilon &&
+        abs(outDir->y()) <= epsilon &&
+        outDir->z() <= epsilon) {
+        outDir->x() = 1;
+    }
+
+    inDir->normalize();
+    outDir->normalize();
+
+    if (dataType == BTDF_DATA) {
+        outDir->z() = -outDir->z();
+    }
+}
+
+} // namespace
+
 bool reflectance_model_utility::setupTabularBrdf(const ReflectanceModel&    model,
                                                  Brdf*                      brdf,
                                                  DataType                   dataType,
                                                  float                      maxValue)
 {
-    using std::abs;
-    using std::max;
     using std::min;
 
     SampleSet* ss = brdf->getSampleSet();
@@ -30,49 +70,71 @@ bool reflectance_model_utility::setupTabularBrdf(const ReflectanceModel&    mode
         return false;
     }
 
-    Vec3 inDir, outDir;
-    Vec3 values;
-    Spectrum sp;
-    int i0, i1, i3;
-    #pragma omp parallel for private(inDir, outDir, values, sp, i0, i1, i3) schedule(dynamic)
-    for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
-        for (i0 = 0; i0 < ss->getNumAngles0(); ++i0) {
-        for (i1 = 0; i1 < ss->getNumAngles1(); ++i1) {
-        for (i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
-            brdf->getInOutDirection(i0, i1, i2, i3, &inDir, &outDir);
-
-            // Adjust horizontal and downward directions.
-            const Vec3::Scalar epsilon = Vec3::Scalar(0.001);
-            inDir.z()  = max(inDir.z(),  epsilon);
-            outDir.z() = max(outDir.z(), epsilon);
-
-            // Adjust a downward outgoing direction along the Z-axis.
-            if (abs(outDir.x()) <= epsilon &&
-                abs(outDir.y()) <= epsilon &&
-                outDir.z() <= epsilon) {
-                outDir.x() = 1;
-            }
+    const int numAngles0 = ss->getNumAngles0();
+    const int numAngles1 = ss->getNumAngles1();
+    const int numAngles2 = ss->getNumAngles2();
 
-            inDir.normalize();
-            outDir.normalize();
+    SpectrumArray& spectra = ss->getSpectra();
+    const int numWavelengths = static_cast<int>(spectra.rows());
+    const size_t numSamples = static_cast<size_t>(spectra.cols());
+
+    if (cm == RGB_MODEL && numWavelengths != 3) {
+        lbError << "[reflectance_model_utility::setupTabularBrdf] Invalid number of wavelengths: " << numWavelengths;
+        return false;
+    }
 
-            if (dataType == BTDF_DATA) {
-                outDir.z() = -outDir.z();
+    // Samples are evaluated in blocks in the order of lb::SampleSet::getIndex().
+    const int numBlocks = static_cast<int>((numSamples + NUM_BLOCK_SAMPLES - 1) / NUM_BLOCK_SAMPLES);
+
+    #pragma omp parallel for schedule(static)
+    for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex) {
+        Vec3 inDirs[NUM_BLOCK_SAMPLES];
+        Vec3 outDirs[NUM_BLOCK_SAMPLES];
+        Vec3 values[NUM_BLOCK_SAMPLES];
+
+        const size_t firstIndex = static_cast<size_t>(NUM_BLOCK_SAMPLES) * blockIndex;
+        const size_t numBlockSamples = min(numSamples - firstIndex, static_cast<size_t>(NUM_BLOCK_SAMPLES));
+
+        // Decompose the first index into the indices of angles.
+        size_t index = firstIndex;
+        int i0 = static_cast<int>(index % numAngles0);
+        index /= numAngles0;
+        int i1 = static_cast<int>(index % numAngles1);
+        index /= numAngles1;
+        int i2 = static_cast<int>(index % numAngles2);
+        int i3 = static_cast<int>(index / numAngles2);
+
+        for (size_t i = 0; i < numBlockSamples; ++i) {
+            getModelDirections(*brdf, i0, i1, i2, i3, dataType, &inDirs[i], &outDirs[i]);
+
+            if (++i0 == numAngles0) {
+                i0 = 0;
+                if (++i1 == numAngles1) {
+                    i1 = 0;
+                    if (++i2 == numAngles2) {
+                        i2 = 0;
+                        ++i3;
+                    }
+                }
             }
+        }
+
+        model.getBrdfValues(inDirs, outDirs, numBlockSamples, values);
 
-            values = model.getBrdfValue(inDir, outDir);
-            assert(values.allFinite());
+        float* sp = spectra.data() + numWavelengths * firstIndex;
+        for (size_t i = 0; i < numBlockSamples; ++i, sp += numWavelengths) {
+            const Vec3& value = values[i];
+            assert(value.allFinite());
 
             if (cm == RGB_MODEL) {
-                sp = values.cast<Spectrum::Scalar>();
-                sp = sp.cwiseMin(maxValue);
+                sp[0] = min(static_cast<float>(value[0]), maxValue);
+                sp[1] = min(static_cast<float>(value[1]), maxValue);
+                sp[2] = min(static_cast<float>(value[2]), maxValue);
             }
             else { // MONOCHROMATIC_MODEL
-                sp.resize(1);
-                sp[0] = min(static_cast<float>(values.sum()) / 3.0f, maxValue);
+                sp[0] = min(static_cast<float>(value.sum()) / 3.0f, maxValue);
             }
-            ss->setSpectrum(i0, i1, i2, i3, sp);
-        }}}
+        }
     }
 
     return true;
@@ -0,0 +1,190 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Writer/BinarySlabWriter.h>
+
+#include <algorithm>
+
+using namespace lb;
+using namespace lb::binary_utility;
+
+bool BinarySlabWriter::open(const std::string&  fileName,
+                            const FileInfo&     info,
+                            EncodingType        encoding,
+                            const std::string&  name)
+{
+    if (isOpen()) {
+        lbError << "[BinarySlabWriter::open] A file is already open.";
+        return false;
+    }
+
+    if (!isLittleEndian()) {
+        lbError << "[BinarySlabWriter::open] Big-endian systems are not supported.";
+        return false;
+    }
+
+    if (encoding != RAW_ENCODING && encoding != PREDICTIVE_ENCODING) {
+        lbError << "[BinarySlabWriter::open] Unsupported encoding: " << encoding;
+        return false;
+    }
+
+    if (!createHeader(info, encoding, name, &header_, &metadata_)) return false;
+
+    stream_.open(fileName.c_str(), std::ios_base::in |
+                                   std::ios_base::out |
+                                   std::ios_base::trunc |
+                                   std::ios_base::binary);
+    if (stream_.fail()) {
+        lbError << "[BinarySlabWriter::open] Could not open: " << fileName;
+        return false;
+    }
+
+    numSlabs_ = header_.numAngles[0] * header_.numAngles[1];
+    numWrittenSlabs_ = 0;
+    chunkSizes_.clear();
+
+    uint64_t numSamples = static_cast<uint64_t>(numSlabs_) * header_.numAngles[2] * header_.numAngles[3];
+    if (encoding == RAW_ENCODING) {
+        header_.spectraSize = sizeof(float) * numSamples * header_.numWavelengths;
+    }
+    else {
+        // The table of chunk sizes is written when the file is closed.
+        header_.spectraSize = sizeof(uint64_t) * numSlabs_;
+        chunkSizes_.reserve(numSlabs_);
+    }
+
+    stream_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    stream_.write(metadata_.data(), metadata_.size());
+    writeZeros(header_.spectraSize);
+
+    if (stream_.fail()) {
+        lbError << "[BinarySlabWriter::open] Failed to write data.";
+        stream_.close();
+        return false;
+    }
+
+    return true;
+}
+
+bool BinarySlabWriter::writeSlab(const Brdf& slab)
+{
+    if (!isOpen()) {
+        lbError << "[BinarySlabWriter::writeSlab] A file is not open.";
+        return false;
+    }
+
+    if (numWrittenSlabs_ >= numSlabs_) {
+        lbError << "[BinarySlabWriter::writeSlab] All slabs are already written.";
+        return false;
+    }
+
+    const SampleSet* ss = slab.getSampleSet();
+    if (ss->getNumAngles0() != 1 ||
+        ss->getNumAngles1() != 1 ||
+        ss->getNumAngles2() != header_.numAngles[2] ||
+        ss->getNumAngles3() != header_.numAngles[3] ||
+        ss->getNumWavelengths() != header_.numWavelengths) {
+        lbError
+            << "[BinarySlabWriter::writeSlab] The size of a slab is not matched: "
+            << ss->getNumAngles0() << "x" << ss->getNumAngles1() << "x"
+            << ss->getNumAngles2() << "x" << ss->getNumAngles3() << "x"
+            << ss->getNumWavelengths();
+        return false;
+    }
+
+    if (header_.encoding == RAW_ENCODING) {
+        const uint64_t numAngles2 = header_.numAngles[2];
+
+        const uint64_t spectrumSize = sizeof(float) * header_.numWavelengths;
+
+        for (int i3 = 0; i3 < ss->getNumAngles3(); ++i3) {
+        for (int i2 = 0; i2 < ss->getNumAngles2(); ++i2) {
+            // The index of lb::SampleSet::getIndex() in the whole BRDF.
+            uint64_t index = numWrittenSlabs_ + static_cast<uint64_t>(numSlabs_) * (i2 + numAngles2 * i3);
+
+            stream_.seekp(static_cast<std::streamoff>(header_.spectraOffset + spectrumSize * index));
+            stream_.write(reinterpret_cast<const char*>(ss->getSpectrum(0, 0, i2, i3).data()),
+                          static_cast<std::streamsize>(spectrumSize));
+        }}
+    }
+    else {
+        std::vector<char> chunk;
+        encodeSpectra(*ss, 0, 0, &chunk);
+
+        stream_.seekp(0, std::ios_base::end);
+        stream_.write(chunk.data(), chunk.size());
+
+        chunkSizes_.push_back(chunk.size());
+        header_.spectraSize += chunk.size();
+    }
+
+    if (stream_.fail()) {
+        lbError << "[BinarySlabWriter::writeSlab] Failed to write data.";
+        return false;
+    }
+
+    ++numWrittenSlabs_;
+
+    return true;
+}
+
+bool BinarySlabWriter::close()
+{
+    if (!isOpen()) {
+        lbError << "[BinarySlabWriter::close] A file is not open.";
+        return false;
+    }
+
+    if (numWrittenSlabs_ != numSlabs_) {
+        lbError
+            << "[BinarySlabWriter::close] Slabs are not enough: "
+            << numWrittenSlabs_ << ", " << numSlabs_;
+        stream_.close();
+        return false;
+    }
+
+    if (header_.encoding == PREDICTIVE_ENCODING) {
+        stream_.seekp(static_cast<std::streamoff>(header_.spectraOffset));
+        stream_.write(reinterpret_cast<const char*>(chunkSizes_.data()),
+                      static_cast<std::streamsize>(sizeof(uint64_t) * chunkSizes_.size()));
+    }
+    stream_.flush();
+
+    // The spectra block is read back to compute the checksum.
+    header_.checksum = 0;
+    uint64_t checksum = computeChecksum(&header_, sizeof(header_));
+    checksum = computeChecksum(metadata_.data(), metadata_.size(), checksum);
+
+    stream_.seekg(static_cast<std::streamoff>(header_.spectraOffset));
+    checksum = computeChecksum(stream_, header_.spectraSize, checksum);
+    header_.checksum = checksum;
+
+    stream_.seekp(0);
+    stream_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    stream_.flush();
+
+    bool succeeded = !stream_.fail();
+    stream_.close();
+
+    if (!succeeded) {
+        lbError << "[BinarySlabWriter::close] Failed to write data.";
+        return false;
+    }
+
+    return true;
+}
+
+void BinarySlabWriter::writeZeros(uint64_t size)
+{
+    const std::vector<char> zeros(static_cast<size_t>(std::min<uint64_t>(size, 1 << 20)), '\0');
+
+    for (uint64_t pos = 0; pos < size; pos += zeros.size()) {
+        uint64_t writeSize = std::min<uint64_t>(zeros.size(), size - pos);
+        stream_.write(zeros.data(), static_cast<std::streamsize>(writeSize));
+    }
+}
@@ -0,0 +1,143 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Writer/BinaryWriter.h>
+
+#include <fstream>
+#include <vector>
+
+#include <libbsdf/Brdf/HalfDifferenceCoordinatesBrdf.h>
+#include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
+#include <libbsdf/Brdf/SphericalCoordinatesBrdf.h>
+
+#include <libbsdf/Reader/BinaryUtility.h>
+
+using namespace lb;
+using namespace lb::binary_utility;
+
+bool BinaryWriter::write(const std::string&    fileName,
+                         const Brdf&           brdf,
+                         DataType              dataType,
+                         EncodingType          encoding)
+{
+    std::ofstream fout(fileName.c_str(), std::ios_base::binary);
+    if (fout.fail()) {
+        lbError << "[BinaryWriter::write] Could not open: " << fileName;
+        return false;
+    }
+
+    return output(brdf, fout, dataType, encoding);
+}
+
+bool BinaryWriter::output(const Brdf&      brdf,
+                          std::ostream&    stream,
+                          DataType         dataType,
+                          EncodingType     encoding)
+{
+    if (!isLittleEndian()) {
+        lbError << "[BinaryWriter::output] Big-endian systems are not supported.";
+        return false;
+    }
+
+    const SampleSet* ss = brdf.getSampleSet();
+
+    FileInfo info;
+    info.dataType       = dataType;
+    info.sourceType     = brdf.getSourceType();
+    info.colorModel     = ss->getColorModel();
+    info.numWavelengths = ss->getNumWavelengths();
+    info.wavelengths    = ss->getWavelengths();
+    info.angles0        = ss->getAngles0();
+    info.angles1        = ss->getAngles1();
+    info.angles2        = ss->getAngles2();
+    info.angles3        = ss->getAngles3();
+
+    if (auto specBrdf = dynamic_cast<const SpecularCoordinatesBrdf*>(&brdf)) {
+        info.coordinateSystem = SPECULAR_COORDINATE_SYSTEM;
+        info.specularOffsets = specBrdf->getSpecularOffsets();
+    }
+    else if (dynamic_cast<const SphericalCoordinatesBrdf*>(&brdf)) {
+        info.coordinateSystem = SPHERICAL_COORDINATE_SYSTEM;
+    }
+    else if (dynamic_cast<const HalfDifferenceCoordinatesBrdf*>(&brdf)) {
+        info.coordinateSystem = HALF_DIFFERENCE_COORDINATE_SYSTEM;
+    }
+    else {
+        lbError << "[BinaryWriter::output] Unsupported coordinate system.";
+        return false;
+    }
+
+    Header header;
+    std::vector<char> metadata;
+    if (!createHeader(info, encoding, brdf.getName(), &header, &metadata)) return false;
+
+    std::vector<char> encodedSpectra;
+    const char* spectra;
+    if (encoding == RAW_ENCODING) {
+        spectra = reinterpret_cast<const char*>(ss->getSpectra().data());
+        header.spectraSize = sizeof(float) * static_cast<uint64_t>(ss->getSpectra().size());
+    }
+    else if (encoding == PREDICTIVE_ENCODING) {
+        encodeSpectra(*ss, &encodedSpectra);
+        spectra = encodedSpectra.data();
+        header.spectraSize = encodedSpectra.size();
+    }
+    else {
+        lbError << "[BinaryWriter::output] Unsupported encoding: " << encoding;
+        return false;
+    }
+
+    uint64_t checksum = computeChecksum(&header, sizeof(header));
+    checksum = computeChecksum(metadata.data(), metadata.size(), checksum);
+    checksum = computeChecksum(spectra, static_cast<size_t>(header.spectraSize), checksum);
+    header.checksum = checksum;
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(metadata.data(), metadata.size());
+    stream.write(spectra, static_cast<std::streamsize>(header.spectraSize));
+    stream.flush();
+
+    if (stream.fail()) {
+        lbError << "[BinaryWriter::output] Failed to write data.";
+        return false;
+    }
+
+    return true;
+}
+
+void BinaryWriter::encodeSpectra(const SampleSet& samples, std::vector<char>* data)
+{
+    const int numAngles0 = samples.getNumAngles0();
+    const int numChunks = numAngles0 * samples.getNumAngles1();
+
+    // Chunks of incoming directions are encoded independently.
+    std::vector<std::vector<char>> chunks(numChunks);
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < numChunks; ++i) {
+        binary_utility::encodeSpectra(samples, i % numAngles0, i / numAngles0, &chunks[i]);
+    }
+
+    size_t dataSize = sizeof(uint64_t) * numChunks;
+    for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+        dataSize += it->size();
+    }
+
+    data->clear();
+    data->reserve(dataSize);
+
+    // The table of chunk sizes is followed by chunks.
+    for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+        uint64_t chunkSize = it->size();
+        const char* chunkSizeBytes = reinterpret_cast<const char*>(&chunkSize);
+        data->insert(data->end(), chunkSizeBytes, chunkSizeBytes + sizeof(chunkSize));
+    }
+
+    for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+        data->insert(data->end(), it->begin(), it->end());
+    }
+}
@@ -8,15 +8,34 @@
 
 #include <libbsdf/Writer/DdrWriter.h>
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <libbsdf/Brdf/Processor.h>
 
+#include <libbsdf/Common/CieData.h>
 #include <libbsdf/Common/Version.h>
 
+#include <libbsdf/Writer/WriterUtility.h>
+
 using namespace lb;
 
+// Converts a clamped CIE-XYZ spectrum to a channel of sRGB.
+// The result is equal to the channel of xyzToSrgb(), and only the channel is computed.
+static float xyzToSrgbChannel(const ConstSpectrumMap& xyz, int channel)
+{
+    Eigen::Matrix3f mat;
+    mat << CieData::XYZ_sRGB[0], CieData::XYZ_sRGB[1], CieData::XYZ_sRGB[2],
+           CieData::XYZ_sRGB[3], CieData::XYZ_sRGB[4], CieData::XYZ_sRGB[5],
+           CieData::XYZ_sRGB[6], CieData::XYZ_sRGB[7], CieData::XYZ_sRGB[8];
+
+    Vec3f clampedXyz = xyz.head<3>().cwiseMax(0.0f).matrix();
+    return mat.lazyProduct(clampedXyz).coeff(channel);
+}
+
 bool DdrWriter::write(const std::string&                fileName,
                       const SpecularCoordinatesBrdf&    brdf,
                       const std::string&                comments)
@@ -139,61 +158,90 @@ bool DdrWriter::output(const SpecularCoordinatesBrdf&   brdf,
     }
     stream << std::endl;
 
-    for (int wlIndex = 0; wlIndex < ss->getNumWavelengths(); ++wlIndex) {
+    const int numInTheta    = brdf.getNumInTheta();
+    const int numInPhi      = brdf.getNumInPhi();
+    const int numSpecTheta  = brdf.getNumSpecTheta();
+    const int numSpecPhi    = brdf.getNumSpecPhi();
+    const int numWavelengths = ss->getNumWavelengths();
+
+    const bool xyzUsed = (ss->getColorModel() == XYZ_MODEL);
+
+    const int precision = static_cast<int>(stream.precision());
+
+    // The text of each incoming polar angle is formatted in parallel and written in order.
+    // Values are clamped and converted in each slab of an incoming azimuthal angle without copying samples.
+    std::vector<std::string> texts(numInTheta);
+
+    for (int wlIndex = 0; wlIndex < numWavelengths; ++wlIndex) {
         if (colorModel == MONOCHROMATIC_MODEL) {
-            stream << "bw" << std::endl;
+            stream << "bw\n";
         }
         else if (colorModel == RGB_MODEL) {
             if (wlIndex == 0) {
-                stream << "red" << std::endl;
+                stream << "red\n";
             }
             else if (wlIndex == 1) {
-                stream << "green" << std::endl;
+                stream << "green\n";
             }
             else {
-                stream << "blue" << std::endl;
+                stream << "blue\n";
             }
         }
         else {
-            stream << "wl " << ss->getWavelength(wlIndex) << std::endl;
+            stream << "wl " << ss->getWavelength(wlIndex) << "\n";
         }
 
-        stream << " kbdf" << std::endl;
+        stream << " kbdf\n";
         stream << " ";
-        for (int i = 0; i < brdf.getNumInTheta() * brdf.getNumInPhi(); ++i) {
+        for (int i = 0; i < numInTheta * numInPhi; ++i) {
             stream << " 1.0";
         }
 
-        stream << "\n def" << std::endl;
+        stream << "\n def\n";
 
-        for (int inPhIndex = 0; inPhIndex < brdf.getNumInPhi(); ++inPhIndex) {
-            stream << ";; Psi = " << toDegree(brdf.getInPhi(inPhIndex)) << std::endl;
+        for (int inPhIndex = 0; inPhIndex < numInPhi; ++inPhIndex) {
+            stream << ";; Psi = " << toDegree(brdf.getInPhi(inPhIndex)) << "\n";
 
-            for (int inThIndex = 0; inThIndex < brdf.getNumInTheta(); ++inThIndex) {
-                stream << ";; Sigma = " << toDegree(brdf.getInTheta(inThIndex)) << std::endl;
+            #pragma omp parallel for schedule(dynamic)
+            for (int inThIndex = 0; inThIndex < numInTheta; ++inThIndex) {
+                std::string& text = texts[inThIndex];
+                text.clear();
+                text.reserve(numSpecPhi * (numSpecTheta + 1) * 12 + 32);
 
-                for (int spPhIndex = 0; spPhIndex < brdf.getNumSpecPhi();   ++spPhIndex) {
-                for (int spThIndex = 0; spThIndex < brdf.getNumSpecTheta(); ++spThIndex) {
-                    Spectrum sp = brdf.getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
-                    sp = sp.cwiseMax(0.0);
+                text += ";; Sigma = ";
+                writer_utility::appendFloat(toDegree(brdf.getInTheta(inThIndex)), precision, &text);
+                text += '\n';
 
-                    if (ss->getColorModel() == XYZ_MODEL) {
-                        Spectrum rgb = xyzToSrgb<Vec3f>(sp);
-                        stream << " " << rgb[wlIndex] * PI_F;
-                    }
-                    else {
-                        stream << " " << sp[wlIndex] * PI_F;
+                for (int spPhIndex = 0; spPhIndex < numSpecPhi; ++spPhIndex) {
+                    for (int spThIndex = 0; spThIndex < numSpecTheta; ++spThIndex) {
+                        ConstSpectrumMap sp = ss->getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
+
+                        float value;
+                        if (xyzUsed) {
+                            value = xyzToSrgbChannel(sp, wlIndex);
+                        }
+                        else {
+                            value = std::max(sp[wlIndex], 0.0f);
+                        }
+
+                        text += ' ';
+                        writer_utility::appendFloat(value * PI_F, precision, &text);
                     }
-                }
 
-                stream << std::endl;
+                    text += '\n';
                 }
             }
+
+            for (auto it = texts.begin(); it != texts.end(); ++it) {
+                stream.write(it->data(), it->size());
+            }
         }
 
-        stream << " enddef" << std::endl;
+        stream << " enddef\n";
     }
 
+    stream.flush();
+
     return true;
 }
 
@@ -0,0 +1,151 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <libbsdf/Writer/WriterUtility.h>
+
+#include <cmath>
+#include <cstdio>
+
+using namespace lb;
+
+int writer_utility::formatFloat(float value, int precision, char* buffer)
+{
+    // Powers of ten exactly representable in a double.
+    static const double powers[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                     1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                     1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    if (precision == 0) {
+        precision = 1;
+    }
+
+    double absValue = std::abs(static_cast<double>(value));
+
+    if (value == 0.0f) {
+        int size = 0;
+        if (std::signbit(value)) {
+            buffer[size++] = '-';
+        }
+        buffer[size++] = '0';
+        buffer[size] = '\0';
+        return size;
+    }
+
+    if (precision > 9 || !std::isfinite(absValue)) {
+        return std::snprintf(buffer, FORMAT_BUFFER_SIZE, "%.*g", precision, static_cast<double>(value));
+    }
+
+    // Scale the value so that the integer part has the digits of the precision.
+    int exponent = static_cast<int>(std::floor(std::log10(absValue)));
+    double lowerLimit = powers[precision - 1];
+    double upperLimit = powers[precision];
+
+    double scaledValue = 0.0;
+    for (int i = 0; i < 2; ++i) {
+        int scale = precision - 1 - exponent;
+        if (scale > 22 || scale < -22) {
+            return std::snprintf(buffer, FORMAT_BUFFER_SIZE, "%.*g", precision, static_cast<double>(value));
+        }
+
+        // The relative error of a correctly rounded operation is at most 2^-53.
+        scaledValue = (scale >= 0) ? absValue * powers[scale] : absValue / powers[-scale];
+
+        if (scaledValue >= upperLimit) {
+            ++exponent;
+        }
+        else if (scaledValue < lowerLimit) {
+            --exponent;
+        }
+        else {
+            break;
+        }
+    }
+
+    if (scaledValue < lowerLimit || scaledValue >= upperLimit) {
+        return std::snprintf(buffer, FORMAT_BUFFER_SIZE, "%.*g", precision, static_cast<double>(value));
+    }
+
+    // Fall back if the value is too close to a tie to decide the rounding direction.
+    double integerPart = std::floor(scaledValue);
+    double fraction = scaledValue - integerPart;
+    if (std::abs(fraction - 0.5) < upperLimit * 1e-15) {
+        return std::snprintf(buffer, FORMAT_BUFFER_SIZE, "%.*g", precision, static_cast<double>(value));
+    }
+
+    unsigned long long digits = static_cast<unsigned long long>(integerPart);
+    if (fraction > 0.5) {
+        ++digits;
+    }
+
+    if (digits >= static_cast<unsigned long long>(upperLimit)) {
+        digits /= 10;
+        ++exponent;
+    }
+
+    char digitChars[16];
+    for (int i = precision - 1; i >= 0; --i) {
+        digitChars[i] = static_cast<char>('0' + digits % 10);
+        digits /= 10;
+    }
+
+    // Trailing zeros are removed in the format of "%g".
+    int numDigits = precision;
+    while (numDigits > 1 && digitChars[numDigits - 1] == '0') {
+        --numDigits;
+    }
+
+    int size = 0;
+    if (value < 0.0f) {
+        buffer[size++] = '-';
+    }
+
+    if (exponent < -4 || exponent >= precision) {
+        buffer[size++] = digitChars[0];
+        if (numDigits > 1) {
+            buffer[size++] = '.';
+            for (int i = 1; i < numDigits; ++i) {
+                buffer[size++] = digitChars[i];
+            }
+        }
+
+        buffer[size++] = 'e';
+        buffer[size++] = (exponent < 0) ? '-' : '+';
+
+        int absExponent = std::abs(exponent);
+        if (absExponent >= 100) {
+            buffer[size++] = static_cast<char>('0' + absExponent / 100);
+        }
+        buffer[size++] = static_cast<char>('0' + absExponent / 10 % 10);
+        buffer[size++] = static_cast<char>('0' + absExponent % 10);
+    }
+    else if (exponent >= 0) {
+        for (int i = 0; i <= exponent; ++i) {
+            buffer[size++] = digitChars[i];
+        }
+
+        if (numDigits > exponent + 1) {
+            buffer[size++] = '.';
+            for (int i = exponent + 1; i < numDigits; ++i) {
+                buffer[size++] = digitChars[i];
+            }
+        }
+    }
+    else {
+        buffer[size++] = '0';
+        buffer[size++] = '.';
+        for (int i = 0; i < -exponent - 1; ++i) {
+            buffer[size++] = '0';
+        }
+        for (int i = 0; i < numDigits; ++i) {
+            buffer[size++] = digitChars[i];
+        }
+    }
+
+    buffer[size] = '\0';
+    return size;
+}
@@ -0,0 +1,180 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <libbsdf/Common/SphericalCoordinateSystem.h>
+#include <libbsdf/Common/Utility.h>
+#include <libbsdf/ReflectanceModel/CookTorrance.h>
+#include <libbsdf/ReflectanceModel/Disney.h>
+#include <libbsdf/ReflectanceModel/GGX.h>
+#include <libbsdf/ReflectanceModel/GgxAnisotropic.h>
+
+#include "TestUtility.h"
+
+using namespace lb;
+
+namespace {
+
+/*! Values smaller than this are excluded from relative errors. */
+const double MIN_VALUE = 1e-6;
+
+/*! Creates directions on a grid of polar and azimuthal angles. Polar angles are in [0, 85] degrees. */
+std::vector<Vec3> createDirections(bool lowerHemisphere)
+{
+    const int numTheta = 10;
+    const int numPhi = 12;
+
+    std::vector<Vec3> dirs;
+    for (int thIndex = 0; thIndex < numTheta; ++thIndex) {
+    for (int phIndex = 0; phIndex < numPhi; ++phIndex) {
+        float theta = toRadian(85.0f * thIndex / (numTheta - 1));
+        float phi = 2.0f * PI_F * phIndex / numPhi;
+
+        Vec3 dir = SphericalCoordinateSystem::toXyz(theta, phi);
+        if (lowerHemisphere) {
+            dir.z() = -dir.z();
+        }
+
+        dirs.push_back(dir);
+    }}
+
+    return dirs;
+}
+
+/*! Computes the maximum relative error of float values against double values. */
+template <typename FloatFuncT, typename DoubleFuncT>
+double computeMaxRelativeError(FloatFuncT floatFunc, DoubleFuncT doubleFunc, bool transmission)
+{
+    std::vector<Vec3> inDirs = createDirections(false);
+    std::vector<Vec3> outDirs = createDirections(transmission);
+
+    double maxError = 0.0;
+    for (const Vec3& inDir : inDirs) {
+    for (const Vec3& outDir : outDirs) {
+        Vec3 floatValue = floatFunc(inDir, outDir);
+        Vec3 doubleValue = doubleFunc(inDir, outDir);
+
+        for (int i = 0; i < 3; ++i) {
+            double ref = doubleValue[i];
+            if (!std::isfinite(ref) || std::abs(ref) < MIN_VALUE) continue;
+
+            double error = std::abs(floatValue[i] - ref) / std::abs(ref);
+            maxError = std::max(maxError, std::isfinite(error) ? error : 1.0);
+        }
+    }}
+
+    return maxError;
+}
+
+/*! Checks the maximum relative error of a model. */
+void checkError(const std::string& name, double error, double bound)
+{
+    std::cout << name << ": " << error << " (bound: " << bound << ")" << std::endl;
+    LB_CHECK(error <= bound);
+}
+
+void testGgx(float refractiveIndex, float extinctionCoefficient, bool transmission, const std::string& name)
+{
+    const Vec3 N(0.0, 0.0, 1.0);
+    const Vec3 color(1.0, 1.0, 1.0);
+    const float roughness = 0.3f;
+
+    double error = computeMaxRelativeError(
+        [&](const Vec3& L, const Vec3& V) {
+            return Ggx::compute<float>(L, V, N, color, roughness, refractiveIndex, extinctionCoefficient);
+        },
+        [&](const Vec3& L, const Vec3& V) {
+            return Ggx::compute<double>(L, V, N, color, roughness, refractiveIndex, extinctionCoefficient);
+        },
+        transmission);
+    checkError(name, error, 1e-4);
+
+    // The batched evaluation uses the float kernel of lb::SoaVec3.
+    Ggx model(color, roughness, refractiveIndex, extinctionCoefficient);
+    double batchedError = computeMaxRelativeError(
+        [&](const Vec3& L, const Vec3& V) {
+            Vec3 value;
+            model.getValues(&L, &V, 1, &value);
+            return value;
+        },
+        [&](const Vec3& L, const Vec3& V) { return model.getValue(L, V); },
+        transmission);
+    checkError(name + " (batched)", batchedError, 5e-4);
+}
+
+void testGgxAnisotropic(float refractiveIndex, float extinctionCoefficient, bool transmission, const std::string& name)
+{
+    const Vec3 N(0.0, 0.0, 1.0);
+    const Vec3 T(1.0, 0.0, 0.0);
+    const Vec3 B(0.0, -1.0, 0.0);
+    const Vec3 color(1.0, 1.0, 1.0);
+
+    double error = computeMaxRelativeError(
+        [&](const Vec3& L, const Vec3& V) {
+            return GgxAnisotropic::compute<float>(L, V, N, T, B, color, 0.1f, 0.3f,
+                                                  refractiveIndex, extinctionCoefficient);
+        },
+        [&](const Vec3& L, const Vec3& V) {
+            return GgxAnisotropic::compute<double>(L, V, N, T, B, color, 0.1f, 0.3f,
+                                                   refractiveIndex, extinctionCoefficient);
+        },
+        transmission);
+    checkError(name, error, 1e-4);
+}
+
+void testCookTorrance()
+{
+    const Vec3 N(0.0, 0.0, 1.0);
+    const Vec3 color(1.0, 1.0, 1.0);
+
+    double error = computeMaxRelativeError(
+        [&](const Vec3& L, const Vec3& V) { return CookTorrance::compute<float>(L, V, N, color, 0.3f); },
+        [&](const Vec3& L, const Vec3& V) { return CookTorrance::compute<double>(L, V, N, color, 0.3f); },
+        false);
+    checkError("Cook-Torrance", error, 1e-4);
+}
+
+void testDisney()
+{
+    const Vec3 N(0.0, 0.0, 1.0);
+    const Vec3 T(1.0, 0.0, 0.0);
+    const Vec3 B(0.0, -1.0, 0.0);
+    const Vec3 specularColor(1.0, 1.0, 1.0);
+    const Vec3 diffuseColor(0.5, 0.5, 0.5);
+
+    // Disney has no transmission, so only the upper hemisphere is checked.
+    double error = computeMaxRelativeError(
+        [&](const Vec3& L, const Vec3& V) {
+            return Disney::compute<float>(L, V, N, T, B, specularColor, diffuseColor, 0.2f, 0.4f);
+        },
+        [&](const Vec3& L, const Vec3& V) {
+            return Disney::compute<double>(L, V, N, T, B, specularColor, diffuseColor, 0.2f, 0.4f);
+        },
+        false);
+    checkError("Disney", error, 1e-4);
+}
+
+} // namespace
+
+int main()
+{
+    testGgx(1.5f, 0.0f, false, "GGX (dielectric, reflection)");
+    testGgx(1.5f, 0.0f, true,  "GGX (dielectric, transmission)");
+    testGgx(0.2f, 3.0f, false, "GGX (conductor)");
+    testGgxAnisotropic(1.5f, 0.0f, false, "GGX anisotropic (dielectric, reflection)");
+    testGgxAnisotropic(1.5f, 0.0f, true,  "GGX anisotropic (dielectric, transmission)");
+    testGgxAnisotropic(0.96521f, 6.3995f, false, "GGX anisotropic (conductor)");
+    testCookTorrance();
+    testDisney();
+
+    return getTestResult();
+}
@@ -0,0 +1,309 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <libbsdf/Brdf/SphericalCoordinatesBrdf.h>
+#include <libbsdf/Reader/BinaryReader.h>
+#include <libbsdf/Writer/BinaryWriter.h>
+
+#include "TestUtility.h"
+
+using namespace lb;
+using namespace lb::binary_utility;
+
+namespace {
+
+const char* const TEST_FILE_NAME = "BinaryFormatTest.lbb";
+
+/*! Returns a float with the bit pattern of \a bits. */
+float fromBits(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/*!
+ * Creates a BRDF with special values and random bit patterns.
+ * The values include NaNs with payloads, signed zeros, denormals, and infinities.
+ */
+SphericalCoordinatesBrdf* createBrdf(int numAngles0, int numAngles1, int numAngles2, int numAngles3,
+                                     int numWavelengths, unsigned int seed)
+{
+    SphericalCoordinatesBrdf* brdf = new SphericalCoordinatesBrdf(numAngles0, numAngles1, numAngles2, numAngles3,
+                                                                  SPECTRAL_MODEL, numWavelengths);
+    brdf->setName("Binary format test");
+
+    SampleSet* ss = brdf->getSampleSet();
+    for (int i = 0; i < numAngles0; ++i) ss->setAngle0(i, 0.1f * i);
+    for (int i = 0; i < numAngles1; ++i) ss->setAngle1(i, 0.2f * i);
+    for (int i = 0; i < numAngles2; ++i) ss->setAngle2(i, 0.3f * i);
+    for (int i = 0; i < numAngles3; ++i) ss->setAngle3(i, 0.4f * i);
+    for (int i = 0; i < numWavelengths; ++i) ss->setWavelength(i, 400.0f + 10.0f * i);
+    ss->updateAngleAttributes();
+
+    const uint32_t specialBits[] = {
+        0x00000000, // +0
+        0x80000000, // -0
+        0x00000001, // The smallest positive denormal
+        0x807FFFFF, // The largest negative denormal
+        0x00400000, // A denormal
+        0x7F800000, // +infinity
+        0xFF800000, // -infinity
+        0x7FC00000, // Quiet NaN
+        0xFFC00001, // Negative quiet NaN with a payload
+        0x7F800001, // Signaling NaN
+        0x7FBFFFFF, // Signaling NaN with a payload
+        0x7F7FFFFF, // The largest float
+        0x00800000, // The smallest normal float
+        0x3F800000  // 1
+    };
+    const int numSpecialValues = sizeof(specialBits) / sizeof(specialBits[0]);
+
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<uint32_t> bitsDist;
+    std::uniform_real_distribution<float> valueDist(0.0f, 2.0f);
+
+    SpectrumArray& spectra = ss->getSpectra();
+    for (int i = 0; i < spectra.size(); ++i) {
+        float value;
+        switch (i % 4) {
+            case 0:  value = fromBits(specialBits[(i / 4) % numSpecialValues]); break;
+            case 1:  value = fromBits(bitsDist(engine)); break;
+            default: value = valueDist(engine); break; // Smooth values are predicted well.
+        }
+
+        spectra.data()[i] = value;
+    }
+
+    return brdf;
+}
+
+/*! Writes a BRDF into a buffer. */
+std::string writeToString(const Brdf& brdf, EncodingType encoding)
+{
+    std::ostringstream stream(std::ios_base::out | std::ios_base::binary);
+    LB_CHECK(BinaryWriter::output(brdf, stream, BRDF_DATA, encoding));
+    return stream.str();
+}
+
+/*! Reads a BRDF from a buffer through a file. */
+Brdf* readFromString(const std::string& data)
+{
+    {
+        std::ofstream fout(TEST_FILE_NAME, std::ios_base::binary);
+        fout.write(data.data(), data.size());
+    }
+
+    Brdf* brdf = BinaryReader::read(TEST_FILE_NAME);
+    std::remove(TEST_FILE_NAME);
+
+    return brdf;
+}
+
+/*! Returns true if two sample sets have the same bit patterns. */
+bool isSameBits(const SampleSet& lhs, const SampleSet& rhs)
+{
+    const SpectrumArray& lhsSpectra = lhs.getSpectra();
+    const SpectrumArray& rhsSpectra = rhs.getSpectra();
+
+    return (lhsSpectra.rows() == rhsSpectra.rows() &&
+            lhsSpectra.cols() == rhsSpectra.cols() &&
+            std::memcmp(lhsSpectra.data(), rhsSpectra.data(), sizeof(float) * lhsSpectra.size()) == 0 &&
+            lhs.getAngles0().isApprox(rhs.getAngles0()) &&
+            lhs.getAngles1().isApprox(rhs.getAngles1()) &&
+            lhs.getAngles2().isApprox(rhs.getAngles2()) &&
+            lhs.getAngles3().isApprox(rhs.getAngles3()) &&
+            lhs.getWavelengths().isApprox(rhs.getWavelengths()));
+}
+
+/*! Sets the checksum of data in a buffer after the header or spectra are modified. */
+void updateChecksum(std::string* data)
+{
+    Header header;
+    std::memcpy(&header, data->data(), sizeof(header));
+    header.checksum = 0;
+
+    size_t spectraSize = data->size() - static_cast<size_t>(header.spectraOffset);
+    uint64_t checksum = computeChecksum(&header, sizeof(header));
+    checksum = computeChecksum(data->data() + sizeof(header), header.spectraOffset - sizeof(header), checksum);
+    checksum = computeChecksum(data->data() + header.spectraOffset, spectraSize, checksum);
+    header.checksum = checksum;
+
+    std::memcpy(&(*data)[0], &header, sizeof(header));
+}
+
+/*! Writes and reads BRDFs with both encodings, and compares bit patterns. */
+void testRoundTrip()
+{
+    const int sizes[][5] = {
+        { 1, 1, 1, 1, 1 },  // A 1x1 angle grid
+        { 1, 1, 1, 1, 4 },
+        { 3, 2, 1, 1, 2 },
+        { 1, 1, 7, 1, 3 },
+        { 1, 1, 1, 9, 3 },
+        { 2, 3, 11, 13, 3 },
+        { 4, 1, 31, 17, 1 }
+    };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        std::unique_ptr<SphericalCoordinatesBrdf> brdf(createBrdf(sizes[i][0], sizes[i][1], sizes[i][2], sizes[i][3],
+                                                                  sizes[i][4], static_cast<unsigned int>(i)));
+
+        for (int encoding = RAW_ENCODING; encoding <= PREDICTIVE_ENCODING; ++encoding) {
+            std::string data = writeToString(*brdf, static_cast<EncodingType>(encoding));
+
+            std::unique_ptr<Brdf> loadedBrdf(readFromString(data));
+            LB_CHECK(loadedBrdf);
+            if (!loadedBrdf) continue;
+
+            LB_CHECK(dynamic_cast<SphericalCoordinatesBrdf*>(loadedBrdf.get()));
+            LB_CHECK(loadedBrdf->getName() == brdf->getName());
+            LB_CHECK(isSameBits(*loadedBrdf->getSampleSet(), *brdf->getSampleSet()));
+        }
+    }
+}
+
+/*! Flips bytes of spectra and checks that the checksum rejects them. */
+void testFlippedBytes()
+{
+    std::unique_ptr<SphericalCoordinatesBrdf> brdf(createBrdf(2, 3, 11, 13, 3, 100));
+
+    for (int encoding = RAW_ENCODING; encoding <= PREDICTIVE_ENCODING; ++encoding) {
+        std::string data = writeToString(*brdf, static_cast<EncodingType>(encoding));
+
+        Header header;
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        size_t positions[] = { static_cast<size_t>(header.spectraOffset),
+                               static_cast<size_t>(header.spectraOffset + header.spectraSize / 2),
+                               data.size() - 1 };
+        for (size_t i = 0; i < sizeof(positions) / sizeof(positions[0]); ++i) {
+            std::string brokenData = data;
+            brokenData[positions[i]] ^= 0x10;
+
+            std::unique_ptr<Brdf> loadedBrdf(readFromString(brokenData));
+            LB_CHECK(!loadedBrdf);
+        }
+    }
+}
+
+/*! Truncates the table of chunk sizes and checks that it is rejected even if the checksum is valid. */
+void testTruncatedChunkTable()
+{
+    std::unique_ptr<SphericalCoordinatesBrdf> brdf(createBrdf(2, 3, 5, 4, 3, 200));
+    const size_t numChunks = 2 * 3;
+
+    std::string data = writeToString(*brdf, PREDICTIVE_ENCODING);
+
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    // The spectra block ends in the table.
+    {
+        std::string brokenData = data.substr(0, static_cast<size_t>(header.spectraOffset) +
+                                                sizeof(uint64_t) * (numChunks - 1));
+        Header brokenHeader = header;
+        brokenHeader.spectraSize = sizeof(uint64_t) * (numChunks - 1);
+        std::memcpy(&brokenData[0], &brokenHeader, sizeof(brokenHeader));
+        updateChecksum(&brokenData);
+
+        std::unique_ptr<Brdf> loadedBrdf(readFromString(brokenData));
+        LB_CHECK(!loadedBrdf);
+    }
+
+    // The spectra block ends in a chunk.
+    {
+        std::string brokenData = data.substr(0, data.size() - 1);
+        Header brokenHeader = header;
+        brokenHeader.spectraSize -= 1;
+        std::memcpy(&brokenData[0], &brokenHeader, sizeof(brokenHeader));
+        updateChecksum(&brokenData);
+
+        std::unique_ptr<Brdf> loadedBrdf(readFromString(brokenData));
+        LB_CHECK(!loadedBrdf);
+    }
+
+    // The size of a chunk exceeds the spectra block.
+    {
+        std::string brokenData = data;
+        uint64_t chunkSize = header.spectraSize;
+        std::memcpy(&brokenData[static_cast<size_t>(header.spectraOffset)], &chunkSize, sizeof(chunkSize));
+        updateChecksum(&brokenData);
+
+        std::unique_ptr<Brdf> loadedBrdf(readFromString(brokenData));
+        LB_CHECK(!loadedBrdf);
+    }
+}
+
+/*! Modifies attributes of the header and checks that inconsistent values are rejected before allocation. */
+void testInvalidAttributes()
+{
+    // Spectra and wavelengths of a spectral BRDF are large enough for every color model in the header.
+    std::unique_ptr<SphericalCoordinatesBrdf> brdf(createBrdf(1, 1, 1, 1, 4096, 300));
+    std::string data = writeToString(*brdf, RAW_ENCODING);
+
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    // Each case is the index of a field and a value.
+    const uint32_t attributes[][2] = {
+        { 0, UNKNOWN_COORDINATE_SYSTEM },
+        { 0, HALF_DIFFERENCE_COORDINATE_SYSTEM + 1 },
+        { 1, UNKNOWN_MODEL },
+        { 1, MONOCHROMATIC_MODEL },     // 4096 wavelengths with a monochromatic model
+        { 1, RGB_MODEL },
+        { 1, XYZ_MODEL },
+        { 1, SPECTRAL_MODEL + 1 },
+        { 2, GENERATED_SOURCE + 1 },
+        { 3, SPECULAR_TRANSMITTANCE_DATA + 1 }
+    };
+
+    for (size_t i = 0; i < sizeof(attributes) / sizeof(attributes[0]); ++i) {
+        Header brokenHeader = header;
+        switch (attributes[i][0]) {
+            case 0:  brokenHeader.coordinateSystem = attributes[i][1]; break;
+            case 1:  brokenHeader.colorModel       = attributes[i][1]; break;
+            case 2:  brokenHeader.sourceType       = attributes[i][1]; break;
+            default: brokenHeader.dataType         = attributes[i][1]; break;
+        }
+
+        std::string brokenData = data;
+        std::memcpy(&brokenData[0], &brokenHeader, sizeof(brokenHeader));
+        updateChecksum(&brokenData);
+
+        std::unique_ptr<Brdf> loadedBrdf(readFromString(brokenData));
+        LB_CHECK(!loadedBrdf);
+    }
+
+    // The unmodified file is valid.
+    std::unique_ptr<Brdf> loadedBrdf(readFromString(data));
+    LB_CHECK(loadedBrdf);
+}
+
+} // namespace
+
+int main()
+{
+    testRoundTrip();
+    testFlippedBytes();
+    testTruncatedChunkTable();
+    testInvalidAttributes();
+
+    return getTestResult();
+}
@@ -0,0 +1,92 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <vector>
+
+#include <libbsdf/Brdf/FlatSampleMap.h>
+
+#include "TestUtility.h"
+
+using namespace lb;
+
+namespace {
+
+Spectrum createSpectrum(float value)
+{
+    Spectrum sp(3);
+    sp << value, value + 1.0f, value + 2.0f;
+    return sp;
+}
+
+/*! Reserves storage before the number of wavelengths is set by the first insertion. */
+void testReserveBeforeInsert()
+{
+    FlatSampleMap map;
+    map.reserve(100);
+
+    int index = map.insert(FlatSampleMap::Key{{0.0f, 0.0f, 0.0f, 0.2f}}, createSpectrum(1.0f));
+    LB_CHECK(index == 0);
+    LB_CHECK(map.getNumWavelengths() == 3);
+    LB_CHECK(map.getSpectrum(index).size() == 3);
+    LB_CHECK(map.getSpectrum(index).isApprox(createSpectrum(1.0f)));
+
+    // Many insertions beyond the reserved size.
+    for (int i = 1; i < 200; ++i) {
+        map.insert(FlatSampleMap::Key{{0.0f, 0.0f, 0.1f * i, 0.2f}}, createSpectrum(static_cast<float>(i)));
+    }
+    LB_CHECK(map.size() == 200);
+    LB_CHECK(map.getSpectrum(0).isApprox(createSpectrum(1.0f)));
+    LB_CHECK(map.getSpectrum(199).isApprox(createSpectrum(199.0f)));
+}
+
+/*! Inserts samples at once after reserving storage. */
+void testReserveBeforeBulkInsert()
+{
+    FlatSampleMap map;
+    map.reserve(10);
+
+    std::vector<FlatSampleMap::Key> angleList;
+    SpectrumArray spectra(3, 4);
+    for (int i = 0; i < 4; ++i) {
+        angleList.push_back(FlatSampleMap::Key{{0.0f, 0.1f * i, 0.0f, 0.0f}});
+        spectra.col(i) = createSpectrum(static_cast<float>(i));
+    }
+
+    LB_CHECK(map.insert(angleList, spectra));
+    LB_CHECK(map.size() == 4);
+    for (int i = 0; i < 4; ++i) {
+        int index = map.find(angleList[i]);
+        LB_CHECK(index == i);
+        LB_CHECK(map.getSpectrum(index).isApprox(createSpectrum(static_cast<float>(i))));
+    }
+}
+
+/*! Overwrites an existing sample. Negative zeros are equal to positive zeros. */
+void testOverwrite()
+{
+    FlatSampleMap map(3);
+
+    int index0 = map.insert(FlatSampleMap::Key{{0.0f, 0.0f, 0.0f, 0.0f}}, createSpectrum(1.0f));
+    int index1 = map.insert(FlatSampleMap::Key{{-0.0f, 0.0f, 0.0f, 0.0f}}, createSpectrum(5.0f));
+    LB_CHECK(index0 == index1);
+    LB_CHECK(map.size() == 1);
+    LB_CHECK(map.getSpectrum(index0).isApprox(createSpectrum(5.0f)));
+
+    LB_CHECK(map.insert(FlatSampleMap::Key{{0.0f, 0.0f, 0.0f, 1.0f}}, Spectrum::Zero(2)) == -1);
+}
+
+} // namespace
+
+int main()
+{
+    testReserveBeforeInsert();
+    testReserveBeforeBulkInsert();
+    testOverwrite();
+
+    return getTestResult();
+}
@@ -0,0 +1,150 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <libbsdf/Brdf/RandomSampleSet.h>
+#include <libbsdf/Common/SpecularCoordinateSystem.h>
+#include <libbsdf/Common/SphericalCoordinateSystem.h>
+
+#include "TestUtility.h"
+
+using namespace lb;
+
+namespace {
+
+using SampleSet = RandomSampleSet<SphericalCoordinateSystem>;
+using AngleList = SampleSet::AngleList;
+
+AngleList createRandomAngles(std::mt19937* engine)
+{
+    std::uniform_real_distribution<float> thetaDist(0.0f, SphericalCoordinateSystem::MAX_ANGLE0);
+    std::uniform_real_distribution<float> phiDist(0.0f, SphericalCoordinateSystem::MAX_ANGLE1);
+
+    return AngleList{{ thetaDist(*engine), phiDist(*engine), thetaDist(*engine), phiDist(*engine) }};
+}
+
+/*!
+ * Creates samples on a coarse grid and at random angles.
+ * The grid produces many ties of distances, which must be resolved in the same way as linear searches.
+ */
+void createSamples(SampleSet* samples, std::mt19937* engine)
+{
+    SampleSet::SampleMap& sampleMap = samples->getSampleMap();
+
+    int numSamples = 0;
+    for (int i0 = 0; i0 < 4; ++i0) {
+    for (int i1 = 0; i1 < 4; ++i1) {
+    for (int i2 = 0; i2 < 4; ++i2) {
+    for (int i3 = 0; i3 < 4; ++i3) {
+        AngleList angles{{ SphericalCoordinateSystem::MAX_ANGLE0 / 3.0f * i0,
+                           SphericalCoordinateSystem::MAX_ANGLE1 / 4.0f * i1,
+                           SphericalCoordinateSystem::MAX_ANGLE2 / 3.0f * i2,
+                           SphericalCoordinateSystem::MAX_ANGLE3 / 4.0f * i3 }};
+        sampleMap.insert(angles, Spectrum::Constant(1, static_cast<float>(numSamples++)));
+    }}}}
+
+    for (int i = 0; i < 300; ++i) {
+        sampleMap.insert(createRandomAngles(engine), Spectrum::Constant(1, static_cast<float>(numSamples++)));
+    }
+}
+
+/*! Creates queries at random angles, at angles of samples, and at invalid angles. */
+std::vector<AngleList> createQueries(const SampleSet& samples, std::mt19937* engine)
+{
+    std::vector<AngleList> queries;
+
+    for (int i = 0; i < 200; ++i) {
+        queries.push_back(createRandomAngles(engine));
+    }
+
+    const SampleSet::SampleMap& sampleMap = samples.getSampleMap();
+    for (int i = 0; i < sampleMap.size(); i += 13) {
+        queries.push_back(sampleMap.getAngles(i));
+    }
+
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    queries.push_back(AngleList{{ nan, 0.0f, 0.5f, 1.0f }});
+    queries.push_back(AngleList{{ nan, nan, nan, nan }});
+    queries.push_back(AngleList{{ 0.3f, std::numeric_limits<float>::infinity(), 0.5f, 1.0f }});
+
+    return queries;
+}
+
+/*! Compares the results of k-d trees with linear searches using both metrics. */
+void testIndexedQueries()
+{
+    std::mt19937 engine(12345);
+
+    SampleSet samples;
+    createSamples(&samples, &engine);
+    std::vector<AngleList> queries = createQueries(samples, &engine);
+
+    const SampleSet& constSamples = samples;
+
+    // Results of linear searches are collected first since updating the index for each query is slow.
+    std::vector<const float*> linearSpectra, indexedSpectra;
+    std::vector<std::vector<int>> linearSamples, indexedSamples;
+
+    samples.clearIndex();
+    for (auto it = queries.begin(); it != queries.end(); ++it) {
+        for (int reciprocity = 0; reciprocity < 2; ++reciprocity) {
+            linearSpectra.push_back(constSamples.findSpectrumOfNearestSample(*it, reciprocity != 0).data());
+            linearSamples.push_back(constSamples.findNearestSamples(*it, 5, reciprocity != 0));
+        }
+    }
+
+    samples.updateIndex();
+    for (auto it = queries.begin(); it != queries.end(); ++it) {
+        for (int reciprocity = 0; reciprocity < 2; ++reciprocity) {
+            indexedSpectra.push_back(constSamples.findSpectrumOfNearestSample(*it, reciprocity != 0).data());
+            indexedSamples.push_back(constSamples.findNearestSamples(*it, 5, reciprocity != 0));
+        }
+    }
+
+    LB_CHECK(linearSpectra == indexedSpectra);
+    LB_CHECK(linearSamples == indexedSamples);
+
+    // Conversion of coordinate systems asserts that angles are finite.
+    std::vector<AngleList> finiteQueries;
+    for (auto it = queries.begin(); it != queries.end(); ++it) {
+        if (std::isfinite((*it)[0]) && std::isfinite((*it)[1]) &&
+            std::isfinite((*it)[2]) && std::isfinite((*it)[3])) {
+            finiteQueries.push_back(*it);
+        }
+    }
+
+    linearSpectra.clear();
+    indexedSpectra.clear();
+
+    samples.clearIndex();
+    for (auto it = finiteQueries.begin(); it != finiteQueries.end(); ++it) {
+        linearSpectra.push_back(
+            constSamples.estimateSpectrum<SpecularCoordinateSystem>(*it, 1.0f, 0.5f, 2.0f, 0.25f).data());
+    }
+
+    samples.updateIndex<SpecularCoordinateSystem>();
+    for (auto it = finiteQueries.begin(); it != finiteQueries.end(); ++it) {
+        indexedSpectra.push_back(
+            constSamples.estimateSpectrum<SpecularCoordinateSystem>(*it, 1.0f, 0.5f, 2.0f, 0.25f).data());
+    }
+
+    LB_CHECK(linearSpectra == indexedSpectra);
+}
+
+} // namespace
+
+int main()
+{
+    testIndexedQueries();
+
+    return getTestResult();
+}
@@ -0,0 +1,173 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+#include <libbsdf/Brdf/Processor.h>
+#include <libbsdf/Brdf/SpecularCoordinatesBrdf.h>
+#include <libbsdf/Reader/DdrReader.h>
+#include <libbsdf/Reader/DdrSlabReader.h>
+#include <libbsdf/Writer/DdrWriter.h>
+
+#include "TestUtility.h"
+
+using namespace lb;
+
+namespace {
+
+const char* const TEST_FILE_NAME = "SlabProcessingTest.ddr";
+
+/*! Creates a BRDF with random values including negative ones. */
+SpecularCoordinatesBrdf* createBrdf(ColorModel colorModel, unsigned int seed)
+{
+    SpecularCoordinatesBrdf* brdf = new SpecularCoordinatesBrdf(4, 3, 19, 13, 2.0f, colorModel, 3);
+
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> valueDist(-0.5f, 2.0f);
+
+    SpectrumArray& spectra = brdf->getSampleSet()->getSpectra();
+    for (int i = 0; i < spectra.size(); ++i) {
+        spectra.data()[i] = valueDist(engine);
+    }
+
+    return brdf;
+}
+
+/*! Copies the samples of an incoming direction to a slab. */
+SpecularCoordinatesBrdf* createSlab(const SpecularCoordinatesBrdf& brdf, int inThIndex, int inPhIndex)
+{
+    const SampleSet* ss = brdf.getSampleSet();
+
+    SpecularCoordinatesBrdf* slab = new SpecularCoordinatesBrdf(1, 1,
+                                                                brdf.getNumSpecTheta(),
+                                                                brdf.getNumSpecPhi(),
+                                                                ss->getColorModel(),
+                                                                ss->getNumWavelengths());
+    SampleSet* slabSs = slab->getSampleSet();
+
+    slabSs->getAngles0()[0] = brdf.getInTheta(inThIndex);
+    slabSs->getAngles1()[0] = brdf.getInPhi(inPhIndex);
+    slabSs->getAngles2() = ss->getAngles2();
+    slabSs->getAngles3() = ss->getAngles3();
+    slabSs->getWavelengths() = ss->getWavelengths();
+    slabSs->updateAngleAttributes();
+
+    for (int spThIndex = 0; spThIndex < brdf.getNumSpecTheta(); ++spThIndex) {
+    for (int spPhIndex = 0; spPhIndex < brdf.getNumSpecPhi();   ++spPhIndex) {
+        slab->setSpectrum(0, 0, spThIndex, spPhIndex, brdf.getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex));
+    }}
+
+    return slab;
+}
+
+/*! Applies the processors used by lbconv. */
+void process(Brdf* brdf, bool srgbConverted)
+{
+    divideByCosineOutTheta(brdf);
+    fixNegativeSpectra(brdf);
+    multiplySpectra(brdf->getSampleSet(), 0.5f);
+
+    if (srgbConverted) {
+        xyzToSrgb(brdf->getSampleSet());
+    }
+}
+
+/*!
+ * Returns true if a slab is equal to the samples of an incoming direction.
+ * NaNs are regarded as equal since directions at grazing angles are divided by zero.
+ */
+bool isSameSlab(const SpecularCoordinatesBrdf& brdf, int inThIndex, int inPhIndex,
+                const SpecularCoordinatesBrdf& slab)
+{
+    if (slab.getSampleSet()->getColorModel() != brdf.getSampleSet()->getColorModel() ||
+        slab.getNumSpecTheta() != brdf.getNumSpecTheta() ||
+        slab.getNumSpecPhi()   != brdf.getNumSpecPhi()) {
+        return false;
+    }
+
+    for (int spThIndex = 0; spThIndex < brdf.getNumSpecTheta(); ++spThIndex) {
+    for (int spPhIndex = 0; spPhIndex < brdf.getNumSpecPhi();   ++spPhIndex) {
+        Spectrum sp     = brdf.getSpectrum(inThIndex, inPhIndex, spThIndex, spPhIndex);
+        Spectrum slabSp = slab.getSpectrum(0, 0, spThIndex, spPhIndex);
+
+        for (int i = 0; i < sp.size(); ++i) {
+            if (sp[i] != slabSp[i] && !(std::isnan(sp[i]) && std::isnan(slabSp[i]))) {
+                return false;
+            }
+        }
+    }}
+
+    return true;
+}
+
+/*! Compares slabs processed one by one with a BRDF processed at once. */
+void testSlabs()
+{
+    std::unique_ptr<SpecularCoordinatesBrdf> brdf(createBrdf(XYZ_MODEL, 1));
+
+    std::unique_ptr<SpecularCoordinatesBrdf> processedBrdf(new SpecularCoordinatesBrdf(*brdf));
+    process(processedBrdf.get(), true);
+
+    for (int inPhIndex = 0; inPhIndex < brdf->getNumInPhi();   ++inPhIndex) {
+    for (int inThIndex = 0; inThIndex < brdf->getNumInTheta(); ++inThIndex) {
+        std::unique_ptr<SpecularCoordinatesBrdf> slab(createSlab(*brdf, inThIndex, inPhIndex));
+        process(slab.get(), true);
+
+        LB_CHECK(isSameSlab(*processedBrdf, inThIndex, inPhIndex, *slab));
+    }}
+}
+
+/*! Compares slabs of lb::DdrSlabReader with lb::DdrReader after processing. */
+void testDdrSlabs()
+{
+    std::unique_ptr<SpecularCoordinatesBrdf> brdf(createBrdf(RGB_MODEL, 2));
+    LB_CHECK(DdrWriter::write(TEST_FILE_NAME, *brdf));
+
+    // The file is closed before it is removed.
+    {
+        std::unique_ptr<SpecularCoordinatesBrdf> processedBrdf(DdrReader::read(TEST_FILE_NAME));
+        LB_CHECK(processedBrdf);
+
+        DdrSlabReader reader;
+        LB_CHECK(reader.open(TEST_FILE_NAME));
+
+        if (processedBrdf && reader.getNumInTheta() == processedBrdf->getNumInTheta() &&
+                             reader.getNumInPhi()   == processedBrdf->getNumInPhi()) {
+            process(processedBrdf.get(), false);
+
+            for (int inPhIndex = 0; inPhIndex < reader.getNumInPhi();   ++inPhIndex) {
+            for (int inThIndex = 0; inThIndex < reader.getNumInTheta(); ++inThIndex) {
+                std::unique_ptr<SpecularCoordinatesBrdf> slab(reader.readSlab(inThIndex, inPhIndex));
+                LB_CHECK(slab);
+                if (!slab) continue;
+
+                process(slab.get(), false);
+
+                LB_CHECK(isSameSlab(*processedBrdf, inThIndex, inPhIndex, *slab));
+            }}
+        }
+        else {
+            LB_CHECK(false);
+        }
+    }
+
+    std::remove(TEST_FILE_NAME);
+}
+
+} // namespace
+
+int main()
+{
+    testSlabs();
+    testDdrSlabs();
+
+    return getTestResult();
+}
@@ -0,0 +1,38 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#ifndef LIBBSDF_TEST_UTILITY_H
+#define LIBBSDF_TEST_UTILITY_H
+
+#include <iostream>
+
+/*! The number of failed checks in a test executable. */
+static int numFailures = 0;
+
+/*! Reports a failure if \a condition is false. The test continues. */
+#define LB_CHECK(condition)                                                         \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": Check failed: "          \
+                      << #condition << std::endl;                                   \
+            ++numFailures;                                                          \
+        }                                                                           \
+    } while (false)
+
+/*! Returns the exit code of a test executable. */
+inline int getTestResult()
+{
+    if (numFailures > 0) {
+        std::cerr << numFailures << " check(s) failed." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif // LIBBSDF_TEST_UTILITY_H
@@ -0,0 +1,210 @@
+// =================================================================== //
+// Copyright (C) 2019 Kimura Ryo                                       //
+//                                                                     //
+// This Source Code Form is subject to the terms of the Mozilla Public //
+// License, v. 2.0. If a copy of the MPL was not distributed with this //
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.            //
+// =================================================================== //
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <libbsdf/Reader/Tokenizer.h>
+
+#include "TestUtility.h"
+
+using namespace lb;
+
+namespace {
+
+/*! Returns true if two values have the same bits or both are NaN. */
+template <typename T>
+bool isSameValue(T lhs, T rhs)
+{
+    if (std::isnan(lhs) && std::isnan(rhs)) return true;
+
+    return (std::memcmp(&lhs, &rhs, sizeof(T)) == 0);
+}
+
+/*! Compares Tokenizer::parseFloat() and Tokenizer::parseDouble() with std::strtof() and std::strtod(). */
+bool checkToken(const std::string& token)
+{
+    const char* first = token.c_str();
+    const char* last = first + token.size();
+
+    char* end;
+    float expectedFloat = std::strtof(first, &end);
+    bool floatParsed = (!token.empty() && end == last);
+
+    double expectedDouble = std::strtod(first, &end);
+    bool doubleParsed = (!token.empty() && end == last);
+
+    float floatValue = 0.0f;
+    double doubleValue = 0.0;
+    bool floatSucceeded = Tokenizer::parseFloat(first, last, &floatValue);
+    bool doubleSucceeded = Tokenizer::parseDouble(first, last, &doubleValue);
+
+    bool passed = (floatSucceeded == floatParsed && doubleSucceeded == doubleParsed);
+    if (passed && floatParsed) {
+        passed = isSameValue(floatValue, expectedFloat);
+    }
+    if (passed && doubleParsed) {
+        passed = isSameValue(doubleValue, expectedDouble);
+    }
+
+    if (!passed) {
+        std::cerr << "Mismatch: \"" << token << "\"" << std::endl;
+    }
+
+    return passed;
+}
+
+std::string formatString(const char* format, int precision, double value)
+{
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), format, precision, value);
+    return buffer;
+}
+
+std::string formatString(const char* format, int precision, long double value)
+{
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), format, precision, value);
+    return buffer;
+}
+
+/*! Parses edge cases of signs, zeros, the limits of mantissas and exponents, and malformed input. */
+void testEdgeCases()
+{
+    const char* tokens[] = {
+        // Signs and zeros
+        "0", "-0", "+0", "0.0", "-0.0", ".0", "0.", "-.0", "0e0", "-0e-500", "0e500", "000000000000000000000000000",
+        // Integers around the limits of exact mantissas
+        "16777215", "16777216", "16777217", "16777218", "-16777217",
+        "9007199254740991", "9007199254740992", "9007199254740993", "9007199254740994",
+        "9999999999999999999", "10000000000000000000", "18446744073709551615", "18446744073709551616",
+        "1234567890123456789", "12345678901234567890", "123456789012345678901234567890",
+        // Long mantissas
+        "0.1", "0.2", "0.3", "3.14159265358979323846264338327950288",
+        "0.30000000000000000000000000000000000000001", "1.00000000000000000000000000000000000001",
+        "0.000000000000000000000000000000000000000000000000000000001",
+        "00000000000000000000000000000001.5", "1.50000000000000000000000000000000",
+        // Exponents around the limits of exact powers and of the formats
+        "1e10", "1e11", "1e-10", "1e-11", "1e22", "1e23", "1e-22", "1e-23",
+        "16777216e10", "16777217e10", "16777216e-10", "16777217e-10",
+        "9007199254740992e22", "9007199254740993e22", "9007199254740992e-22",
+        "3.4028234e38", "3.4028235e38", "3.4028236e38", "3.5e38", "1e39", "-1e39",
+        "1.17549435e-38", "1.17549434e-38", "1.4e-45", "1.401298464e-45", "7e-46", "7.1e-46", "1e-46",
+        "1.7976931348623157e308", "1.7976931348623158e308", "1.8e308", "1e309",
+        "2.2250738585072014e-308", "2.2250738585072011e-308", "4.9406564584124654e-324", "2.4e-324", "2.5e-324",
+        "1e-400", "1e400", "1e10000", "1e-10000", "1e100000", "1e-100000", "1E5", "1e+5", "1e-5", "1e05",
+        "0.0000001e7", "100000000000e-11",
+        // Special values and hexadecimal numbers accepted by std::strtod()
+        "inf", "-inf", "infinity", "INF", "nan", "-nan", "NaN", "0x10", "0x1p-3", "0X1.8P1",
+        // Malformed input
+        "", "-", "+", ".", "-.", "+.", "e", "e5", ".e5", "1e", "1e+", "1e-", "1.2.3", "1e5e", "1e5.0",
+        "--1", "+-1", "1-", "1+", "abc", "1a", "a1", "1,5", "1 5", "0x", "1e 5", "1..", "..1", "1e--5", "nanx", "infx"
+    };
+
+    for (size_t i = 0; i < sizeof(tokens) / sizeof(tokens[0]); ++i) {
+        LB_CHECK(checkToken(tokens[i]));
+    }
+}
+
+/*! Parses random numbers with various lengths of mantissas and exponents. */
+void testRandomTokens()
+{
+    std::mt19937 engine(54321);
+    std::uniform_int_distribution<int> numDigitsDist(0, 24);
+    std::uniform_int_distribution<int> digitDist(0, 9);
+    std::uniform_int_distribution<int> exponentDist(-340, 340);
+    std::uniform_int_distribution<int> smallExponentDist(-25, 25);
+    std::uniform_int_distribution<int> choiceDist(0, 3);
+
+    for (int i = 0; i < 200000; ++i) {
+        std::string token;
+
+        int sign = choiceDist(engine);
+        if (sign == 1) token += '-';
+        else if (sign == 2) token += '+';
+
+        int numIntegerDigits = numDigitsDist(engine);
+        int numFractionDigits = numDigitsDist(engine);
+        if (numIntegerDigits + numFractionDigits == 0) {
+            numIntegerDigits = 1;
+        }
+
+        for (int j = 0; j < numIntegerDigits; ++j) {
+            token += static_cast<char>('0' + digitDist(engine));
+        }
+
+        if (numFractionDigits > 0 || choiceDist(engine) == 0) {
+            token += '.';
+        }
+
+        for (int j = 0; j < numFractionDigits; ++j) {
+            token += static_cast<char>('0' + digitDist(engine));
+        }
+
+        int exponentType = choiceDist(engine);
+        if (exponentType == 1) {
+            token += 'e' + std::to_string(smallExponentDist(engine));
+        }
+        else if (exponentType == 2) {
+            token += 'E' + std::to_string(exponentDist(engine));
+        }
+
+        LB_CHECK(checkToken(token));
+    }
+}
+
+/*! Parses numbers at and next to the midpoints of adjacent floats and doubles. */
+void testHalfwayCases()
+{
+    std::mt19937 engine(13579);
+    std::uniform_int_distribution<int> floatExponentDist(-40, 38);
+    std::uniform_int_distribution<int> doubleExponentDist(-300, 300);
+    std::uniform_real_distribution<double> mantissaDist(1.0, 10.0);
+
+    const char* formats[] = { "%.*e", "%.*g" };
+    const int precisions[] = { 6, 7, 8, 9, 10, 15, 16, 17, 18, 19, 20, 25, 40, 60 };
+
+    for (int i = 0; i < 3000; ++i) {
+        float f = static_cast<float>(mantissaDist(engine) * std::pow(10.0, floatExponentDist(engine)));
+        float nextF = std::nextafter(f, std::numeric_limits<float>::infinity());
+        double floatMidpoint = (static_cast<double>(f) + static_cast<double>(nextF)) / 2.0;
+
+        double d = mantissaDist(engine) * std::pow(10.0, doubleExponentDist(engine));
+        double nextD = std::nextafter(d, std::numeric_limits<double>::infinity());
+        long double doubleMidpoint = (static_cast<long double>(d) + static_cast<long double>(nextD)) / 2.0L;
+
+        for (size_t j = 0; j < sizeof(formats) / sizeof(formats[0]); ++j) {
+            for (size_t k = 0; k < sizeof(precisions) / sizeof(precisions[0]); ++k) {
+                LB_CHECK(checkToken(formatString(formats[j], precisions[k], floatMidpoint)));
+                LB_CHECK(checkToken(formatString(formats[j], precisions[k], static_cast<double>(f))));
+                LB_CHECK(checkToken(formatString(formats[j], precisions[k], d)));
+
+                std::string longFormat(formats[j]);
+                longFormat.insert(longFormat.size() - 1, "L");
+                LB_CHECK(checkToken(formatString(longFormat.c_str(), precisions[k], doubleMidpoint)));
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testEdgeCases();
+    testRandomTokens();
+    testHalfwayCases();
+
+    return getTestResult();
+}